@@ -0,0 +1,25 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+
+//q[v̊mۂ̉
+//main.cppŒuoperator newĂяo邽тɐ
+//t[̑Oŉ񐔂ׂƁAԂ̃t[ŊmۂNĂȂƂm߂
+class AllocationCounter {
+	//mۂ̉
+	static std::atomic<std::size_t>& counter() {
+		static std::atomic<std::size_t> count(0);
+		return count;
+	}
+
+public:
+	//mۂL^
+	static void add() {
+		counter().fetch_add(1, std::memory_order_relaxed);
+	}
+
+	//܂ł̊mۂ̉
+	static std::size_t count() {
+		return counter().load(std::memory_order_relaxed);
+	}
+};
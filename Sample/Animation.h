@@ -0,0 +1,300 @@
+#pragma once
+#include <vector>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <algorithm>
+#include <GL/glew.h>
+
+//ϊsƎl
+#include "Matrix.h"
+#include "FixedMath.h"
+
+//4vfSIMDZ
+#include "Simd.h"
+
+//[J[Xbh
+#include "ThreadPool.h"
+
+//v
+#include "Profiler.h"
+
+//L[t[ŕ\sړA]iljAgk̃gbNĐ
+//L[͐Ƃ̔ziSoAjɑSgbN𑱂Ċi[A4gbNSIMDŕԂ
+//]͐K`ԁinlerpjŕԂ̂ŁAL[̊Ԋu]90x𒴂Ȃ悤ɂĂ
+//ʂ̓gbN̔ԍ̏Matrix̔zɒڏނ̂ŁÂ܂܃fϊsɎg
+class Animation {
+public:
+	//L[
+	struct Key {
+		//ibj
+		GLfloat time;
+
+		//sړ
+		Vec<3> translation;
+
+		//]
+		Quat rotation;
+
+		//gk
+		Vec<3> scale;
+	};
+
+	//v
+	struct Stats {
+		//gbN̐
+		unsigned int tracks;
+
+		//i[L[̐
+		std::size_t keys;
+
+		//kŎ菜L[̐
+		std::size_t removed;
+
+		//Osampleɂԁi~bj
+		double sampleTime;
+	};
+
+private:
+	//xɕԂgbN̐
+	static constexpr unsigned int Lanes = 4;
+
+	//WuŕԂgbN̐
+	static constexpr unsigned int Grain = 256;
+
+	//L[̎ƐiSgbÑL[𑱂Ċi[j
+	std::vector<GLfloat> time;
+	std::vector<GLfloat> tx, ty, tz;
+	std::vector<GLfloat> qx, qy, qz, qw;
+	std::vector<GLfloat> sx, sy, sz;
+
+	//gbNƂ̍ŏ̃L[̈ʒuƃL[̐
+	std::vector<std::uint32_t> first, count;
+
+	//gbNƂɑOԂL[̈ʒuiiނȂTȂj
+	std::vector<std::uint32_t> cursor;
+
+	//ԂɎg[J[Xbh
+	ThreadPool& pool;
+
+	//v
+	Stats stats;
+
+	//Rs[֎~
+	Animation(const Animation&) = delete;
+	Animation& operator=(const Animation&) = delete;
+
+	//L[ab̊ԂԂ̂L[kǂꂾ邩
+	static GLfloat error(const Key& a, const Key& b, const Key& k) {
+		const GLfloat u((k.time - a.time) / (b.time - a.time));
+		const Vec<3> t(a.translation + (b.translation - a.translation) * u);
+		const Vec<3> s(a.scale + (b.scale - a.scale) * u);
+		const Quat q(Quat::nlerp(a.rotation, b.rotation, u));
+		GLfloat e(0.0f);
+		for (int i = 0; i < 3; ++i) {
+			e = std::max(e, std::abs(t[i] - k.translation[i]));
+			e = std::max(e, std::abs(s[i] - k.scale[i]));
+		}
+		const GLfloat d(q.x * k.rotation.x + q.y * k.rotation.y + q.z * k.rotation.z + q.w * k.rotation.w);
+		return std::max(e, 1.0f - std::abs(d));
+	}
+
+	//gbN̎ł̃L[̈ʒuƕԂ̊߂
+	//track:gbN̔ԍ
+	//t:iŌ̃L[̎𒴂ŏɖ߂ČJԂj
+	//a, b:Ԃ̃L[̈ʒu
+	//u:Ԃ̊
+	void locate(unsigned int track, GLfloat t, std::uint32_t& a, std::uint32_t& b, GLfloat& u) {
+		const std::uint32_t f(first[track]), n(count[track]);
+		if (n < 2) {
+			a = b = f;
+			u = 0.0f;
+			return;
+		}
+
+		//JԂ̒̎ɂ
+		const GLfloat start(time[f]), duration(time[f + n - 1] - start);
+		t = duration > 0.0f ? start + std::fmod(std::max(t - start, 0.0f), duration) : start;
+
+		//Öʒui߂邩A߂Ă񕪒T
+		std::uint32_t k(cursor[track]);
+		if (k < f || k >= f + n - 1 || time[k] > t) {
+			k = static_cast<std::uint32_t>(std::upper_bound(time.begin() + f, time.begin() + f + n, t) - time.begin());
+			k = std::min(std::max(k, f + 1), f + n - 1) - 1;
+		}
+		while (k + 2 < f + n && time[k + 1] <= t) ++k;
+		cursor[track] = k;
+
+		a = k;
+		b = k + 1;
+		const GLfloat dt(time[b] - time[a]);
+		u = dt > 0.0f ? std::min(std::max((t - time[a]) / dt, 0.0f), 1.0f) : 0.0f;
+	}
+
+	//4gbÑL[̐W߂
+	static Float4 gather(const std::vector<GLfloat>& v, const std::uint32_t* k) {
+		return Float4(v[k[0]], v[k[1]], v[k[2]], v[k[3]]);
+	}
+
+	//gbN͈̔͂Ԃ
+	//begin, end:gbN̔ԍ͈̔
+	//t:
+	//out:gbN̔ԍ̏ɕׂϊs̔z
+	void sampleRange(unsigned int begin, unsigned int end, GLfloat t, Matrix* out) {
+		const Float4 zero(0.0f), one(1.0f), two(2.0f);
+		for (unsigned int i = begin; i < end; i += Lanes) {
+			//4gbÑL[̈ʒuƕԂ̊߂i]vf͍Ō̃gbNJԂj
+			const unsigned int lanes(std::min(Lanes, end - i));
+			std::uint32_t a[Lanes], b[Lanes];
+			alignas(16) GLfloat u[Lanes];
+			for (unsigned int l = 0; l < Lanes; ++l) {
+				if (l < lanes) locate(i + l, t, a[l], b[l], u[l]);
+				else {
+					a[l] = a[0];
+					b[l] = b[0];
+					u[l] = u[0];
+				}
+			}
+			const Float4 w(Float4::load(u));
+
+			//sړƊgk`Ԃ
+			const Float4 x0(gather(tx, a)), y0(gather(ty, a)), z0(gather(tz, a));
+			const Float4 px(x0 + (gather(tx, b) - x0) * w);
+			const Float4 py(y0 + (gather(ty, b) - y0) * w);
+			const Float4 pz(z0 + (gather(tz, b) - z0) * w);
+			const Float4 sx0(gather(sx, a)), sy0(gather(sy, a)), sz0(gather(sz, a));
+			const Float4 cx(sx0 + (gather(sx, b) - sx0) * w);
+			const Float4 cy(sy0 + (gather(sy, b) - sy0) * w);
+			const Float4 cz(sz0 + (gather(sz, b) - sz0) * w);
+
+			//]𐳋K`Ԃiׂ荇L[͒ǉƂɓɂ낦Ăj
+			const Float4 qx0(gather(qx, a)), qy0(gather(qy, a)), qz0(gather(qz, a)), qw0(gather(qw, a));
+			Float4 x(qx0 + (gather(qx, b) - qx0) * w);
+			Float4 y(qy0 + (gather(qy, b) - qy0) * w);
+			Float4 z(qz0 + (gather(qz, b) - qz0) * w);
+			Float4 r(qw0 + (gather(qw, b) - qw0) * w);
+			const Float4 length(Float4::sqrt(x * x + y * y + z * z + r * r));
+			const Float4 inverse(Float4::select(length > zero, one / length, zero));
+			x = x * inverse;
+			y = y * inverse;
+			z = z * inverse;
+			r = r * inverse;
+
+			//sړ * ] * gk̕ϊs̐߂
+			const Float4 xx(x * x), yy(y * y), zz(z * z);
+			const Float4 xy(x * y), yz(y * z), zx(z * x);
+			const Float4 wx(r * x), wy(r * y), wz(r * z);
+			alignas(16) GLfloat m[12][Lanes];
+			((one - two * (yy + zz)) * cx).store(m[0]);
+			(two * (xy + wz) * cx).store(m[1]);
+			(two * (zx - wy) * cx).store(m[2]);
+			(two * (xy - wz) * cy).store(m[3]);
+			((one - two * (zz + xx)) * cy).store(m[4]);
+			(two * (yz + wx) * cy).store(m[5]);
+			(two * (zx + wy) * cz).store(m[6]);
+			(two * (yz - wx) * cz).store(m[7]);
+			((one - two * (xx + yy)) * cz).store(m[8]);
+			px.store(m[9]);
+			py.store(m[10]);
+			pz.store(m[11]);
+
+			//gbNƂ̕ϊsɏ
+			for (unsigned int l = 0; l < lanes; ++l) {
+				Matrix& o(out[i + l]);
+				o[0] = m[0][l]; o[1] = m[1][l]; o[2] = m[2][l]; o[3] = 0.0f;
+				o[4] = m[3][l]; o[5] = m[4][l]; o[6] = m[5][l]; o[7] = 0.0f;
+				o[8] = m[6][l]; o[9] = m[7][l]; o[10] = m[8][l]; o[11] = 0.0f;
+				o[12] = m[9][l]; o[13] = m[10][l]; o[14] = m[11][l]; o[15] = 1.0f;
+			}
+		}
+	}
+
+public:
+	//RXgN^
+	//pool:ԂɎg[J[Xbh
+	Animation(ThreadPool& pool) :pool(pool), stats() {}
+
+	//fXgN^
+	virtual ~Animation() {}
+
+	//gbNǉ
+	//keys:̏ɕׂL[
+	//n:L[̐
+	//tolerance:0傫ΕԂł̌덷ȓɍČłL[菜
+	//߂l:gbN̔ԍisampleout̓Yj
+	unsigned int addTrack(const Key* keys, std::size_t n, GLfloat tolerance = 0.0f) {
+		//cL[IԁiOɎcL[玟̃L[܂ł̕ԂŊԂ̃L[ČłȂΎcj
+		std::vector<Key> kept;
+		kept.reserve(n);
+		Quat previous(Quat::identity());
+		for (std::size_t i = 0; i < n; ++i) {
+			//]ÕL[Ɠɂ낦inlerp肵Ȃ悤ɂj
+			Key k(keys[i]);
+			if (i > 0 && previous.x * k.rotation.x + previous.y * k.rotation.y + previous.z * k.rotation.z + previous.w * k.rotation.w < 0.0f) {
+				k.rotation = Quat{ -k.rotation.x, -k.rotation.y, -k.rotation.z, -k.rotation.w };
+			}
+			previous = k.rotation;
+
+			//OɎcL[菜Ă̑OɎcL[k܂ł̕ԂŊԂ̃L[ׂčČłΒu
+			if (tolerance > 0.0f && kept.size() >= 2) {
+				const Key& a(kept[kept.size() - 2]);
+				bool removable(true);
+				for (std::size_t j = 0; removable && j < i; ++j) {
+					if (keys[j].time > a.time) removable = error(a, k, keys[j]) <= tolerance;
+				}
+				if (removable) {
+					kept.back() = k;
+					++stats.removed;
+					continue;
+				}
+			}
+			kept.push_back(k);
+		}
+
+		//Ƃ̔zɒǉ
+		const unsigned int track(static_cast<unsigned int>(first.size()));
+		first.push_back(static_cast<std::uint32_t>(time.size()));
+		count.push_back(static_cast<std::uint32_t>(kept.size()));
+		cursor.push_back(first.back());
+		for (const Key& k : kept) {
+			time.push_back(k.time);
+			tx.push_back(k.translation[0]); ty.push_back(k.translation[1]); tz.push_back(k.translation[2]);
+			qx.push_back(k.rotation.x); qy.push_back(k.rotation.y); qz.push_back(k.rotation.z); qw.push_back(k.rotation.w);
+			sx.push_back(k.scale[0]); sy.push_back(k.scale[1]); sz.push_back(k.scale[2]);
+		}
+		stats.tracks = track + 1;
+		stats.keys = time.size();
+		return track;
+	}
+
+	//ׂẴgbN
+	void clear() {
+		for (std::vector<GLfloat>* v : { &time, &tx, &ty, &tz, &qx, &qy, &qz, &qw, &sx, &sy, &sz }) v->clear();
+		first.clear();
+		count.clear();
+		cursor.clear();
+		stats = Stats();
+	}
+
+	//ׂẴgbNԂĕϊs߂
+	//t:ibAgbNƂɌJԂj
+	//out:gbN̗̐vfϊs̔z
+	//parallel:trueȂ烏[J[XbhŕS
+	void sample(GLfloat t, Matrix* out, bool parallel = true) {
+		const auto t0(std::chrono::high_resolution_clock::now());
+		const unsigned int n(static_cast<unsigned int>(first.size()));
+		if (parallel) {
+			pool.parallelFor((n + Grain - 1) / Grain, [&](unsigned int job, unsigned int) {
+				sampleRange(job * Grain, std::min(n, (job + 1) * Grain), t, out);
+			});
+		}
+		else sampleRange(0, n, t, out);
+		stats.sampleTime = Profiler::elapsed(t0);
+	}
+
+	//gbN̐
+	unsigned int size() const { return static_cast<unsigned int>(first.size()); }
+
+	//vo
+	const Stats& getStats() const { return stats; }
+};
@@ -0,0 +1,1480 @@
+#pragma once
+#include <iostream>
+#include <iomanip>
+#include <cstring>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <GL/glew.h>
+
+//VF[_[
+#include "Shader.h"
+
+//ϊs
+#include "Matrix.h"
+#include "FixedMath.h"
+
+//ގ
+#include "Uniform.h"
+#include "Material.h"
+
+//v
+#include "Profiler.h"
+
+//`̂܂Ƃߔs
+#include "MeshBuffer.h"
+#include "IndirectBatch.h"
+
+//[J[Xbh
+#include "ThreadPool.h"
+
+//t[Ƃ̈ꎞIȃf[^̊mۂƃq[v̊mۂ̉
+#include "FrameArena.h"
+#include "AllocationCounter.h"
+
+//ϊ̊Kw
+#include "SceneGraph.h"
+
+//OpenGL̃IuWFNg̃nhƃv[
+#include "GLHandle.h"
+#include "ResourcePool.h"
+
+//L[t[Aj[V
+#include "Animation.h"
+
+//O`ƒx`
+#include "Sphere.h"
+#include "PointLights.h"
+#include "DeferredRenderer.h"
+
+//sbLO
+#include "Picker.h"
+
+//eNX`
+#include "TextureCache.h"
+
+//bVbg̃JO
+#include "Meshlets.h"
+
+//p[eBN
+#include "Particles.h"
+
+//mFp̐ƕ
+#include "DebugDraw.h"
+
+//̃v[u
+#include "LightProbes.h"
+
+//I𑜓x
+#include "DynamicResolution.h"
+
+//\̌v
+//N --bench [O] w肷ƕ`惋[v̑Ɏs
+//OpenGL̃ReLXgɌĂяo
+class Benchmark {
+	//v̊֐
+	typedef void (*Function)(std::ostream& out);
+
+	//o^ꂽv
+	struct Entry {
+		//O
+		const char* name;
+
+		//v̊֐
+		Function function;
+	};
+
+	//v̒Ŋm߂藧Ȃ
+	static unsigned int& failures() {
+		static unsigned int count(0);
+		return count;
+	}
+
+	//m߂藧ȂƂL^irunfalseԂ悤ɂȂj
+	//message:o͂e
+	static void fail(std::ostream& out, const char* message) {
+		out << "Error: " << message << std::endl;
+		++failures();
+	}
+
+	//1̐}`̕`̔sɂCPUԂ`@ƂɌv
+	static void indirect(std::ostream& out) {
+		//}`̐
+		const int count(10000);
+
+		//vt[
+		const int frames(50);
+
+		//ʑ
+		static const Object::Vertex vertex[] = {
+			{ 1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f }, { -1.0f, 0.0f, 0.0f, -1.0f, 0.0f, 0.0f, 0.0f, 0.0f },
+			{ 0.0f, 1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f }, { 0.0f, -1.0f, 0.0f, 0.0f, -1.0f, 0.0f, 0.0f, 0.0f },
+			{ 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, -1.0f, 0.0f, 0.0f, -1.0f, 0.0f, 0.0f }
+		};
+		static const GLuint index[] = {
+			0, 2, 4, 2, 1, 4, 1, 3, 4, 3, 0, 4, 2, 0, 5, 1, 2, 5, 3, 1, 5, 0, 3, 5
+		};
+		MeshBuffer meshes(6, 24);
+		const MeshBuffer::Mesh mesh(meshes.get(meshes.add(6, vertex, 24, index)));
+
+		//}`Ƃ̃fr[ϊs
+		std::vector<Matrix> modelview;
+		for (int i = 0; i < count; ++i) {
+			modelview.push_back(Matrix::translate(static_cast<GLfloat>(i % 100) - 50.0f,
+				static_cast<GLfloat>(i / 100) - 50.0f, -150.0f) * Matrix::scale(0.4f, 0.4f, 0.4f));
+		}
+
+		static const Material color = { 0.6f, 0.6f, 0.2f, 1.0f, 0.0f, 1.0f, 0.3f, 0.3f, 0.3f, 30.0f, 0 };
+		const Uniform<Material> material(&color, 1);
+		const Matrix projection(Matrix::perspective(1.0f, 1.0f, 1.0f, 300.0f));
+
+		//}`Ƃuniformϐݒ肵ĕ`悷
+		{
+			const GLProgram program(loadProgram("point.vert", "point.frag"));
+			const GLint modelviewLoc(glGetUniformLocation(program.get(), "modelview"));
+			const GLint normalMatrixLoc(glGetUniformLocation(program.get(), "normalMatrix"));
+			glUseProgram(program.get());
+			glUniformMatrix4fv(glGetUniformLocation(program.get(), "projection"), 1, GL_FALSE, projection.data());
+			//VhE}bvƌ̃v[u͍ގ̃eNX`̃jbg0ƌ^Ⴄ̂Ńjbg12ɂĂ
+			glUniform1i(glGetUniformLocation(program.get(), "shadowMap"), 1);
+			glUniform1i(glGetUniformLocation(program.get(), "probeMap"), 2);
+			material.select(0, 0);
+
+			double time(0.0);
+			for (int f = 0; f < frames; ++f) {
+				glFinish();
+				const auto t0(std::chrono::high_resolution_clock::now());
+				for (int i = 0; i < count; ++i) {
+					GLfloat normalMatrix[9];
+					modelview[i].getNormalMatrix(normalMatrix);
+					glUniformMatrix4fv(modelviewLoc, 1, GL_FALSE, modelview[i].data());
+					glUniformMatrix3fv(normalMatrixLoc, 1, GL_FALSE, normalMatrix);
+					meshes.bind();
+					glDrawElementsBaseVertex(GL_TRIANGLES, mesh.indexcount, GL_UNSIGNED_INT,
+						static_cast<const GLuint*>(0) + mesh.firstIndex, mesh.baseVertex);
+				}
+				time += Profiler::elapsed(t0);
+			}
+			glFinish();
+			out << "per-object draw:          " << time / frames << " ms / 10k objects, "
+				<< count << " calls" << std::endl;
+		}
+
+		//܂Ƃ߂Ĕs
+		const GLProgram program(loadProgram("batch.vert", "point.frag"));
+		glUseProgram(program.get());
+		glUniformMatrix4fv(glGetUniformLocation(program.get(), "projection"), 1, GL_FALSE, projection.data());
+		glUniform1i(glGetUniformLocation(program.get(), "shadowMap"), 1);
+		glUniform1i(glGetUniformLocation(program.get(), "probeMap"), 2);
+		IndirectBatch batch(meshes);
+		for (int pass = 0; pass < 2; ++pass) {
+			batch.setIndirect(pass == 1);
+			if (pass == 1 && !batch.isIndirect()) {
+				out << "multi-draw indirect:      GL_ARB_multi_draw_indirect is not supported" << std::endl;
+				break;
+			}
+
+			double time(0.0);
+			for (int f = 0; f < frames; ++f) {
+				glFinish();
+				const auto t0(std::chrono::high_resolution_clock::now());
+				batch.clear();
+				for (int i = 0; i < count; ++i) batch.add(mesh, modelview[i]);
+				batch.draw(GL_TRIANGLES, material);
+				time += Profiler::elapsed(t0);
+			}
+			glFinish();
+			out << (pass == 0 ? "batch fallback loop:      " : "multi-draw indirect:      ")
+				<< time / frames << " ms / 10k objects, " << batch.getCallCount() << " calls" << std::endl;
+		}
+	}
+
+	//1̃obt@IuWFNgv[ō쐬č폜鎞Ԃv
+	static void pool(std::ostream& out) {
+		//obt@IuWFNg̐
+		const int count(10000);
+
+		//JԂ
+		const int rounds(10);
+
+		ResourcePool<GLBuffer> buffers(count);
+		std::vector<ResourcePool<GLBuffer>::Handle> handles(count);
+
+		double createTime(0.0), destroyTime(0.0);
+		for (int r = 0; r < rounds; ++r) {
+			const auto t0(std::chrono::high_resolution_clock::now());
+			for (int i = 0; i < count; ++i) handles[i] = buffers.create(GLBuffer::create());
+			createTime += Profiler::elapsed(t0);
+
+			const auto t1(std::chrono::high_resolution_clock::now());
+			for (int i = 0; i < count; ++i) buffers.destroy(handles[i]);
+			destroyTime += Profiler::elapsed(t1);
+
+			//폜nhɂȂĂ邱Ƃm߂
+			if (buffers.size() != 0 || buffers.valid(handles[0])) {
+				fail(out, "pool: stale handle is still valid");
+				return;
+			}
+		}
+		out << "pool create:  " << createTime / rounds << " ms / 10k buffers" << std::endl;
+		out << "pool destroy: " << destroyTime / rounds << " ms / 10k buffers" << std::endl;
+	}
+
+	//1̐}`̃JOʂƕ`惊XgƌXg𖈃t[鎞Ԃƃq[v̊mۂ̉񐔂ׂ
+	static void arena(std::ostream& out) {
+		//}`̐
+		const unsigned int count(10000);
+
+		//vt[ƁAvOŏ̃t[
+		const unsigned int frames(100), warmup(3);
+
+		//[J[ɓn}`̐
+		const unsigned int chunk(256), chunks((count + chunk - 1) / chunk);
+
+		//}`̈ʒuƔaƍގ
+		struct Item {
+			float x, y, z, radius;
+			unsigned int material;
+		};
+
+		//ގƉsŕבւ`
+		struct Draw {
+			std::uint64_t key;
+			unsigned int item;
+			bool operator<(const Draw& d) const { return key < d.key; }
+		};
+
+		std::vector<Item> items(count);
+		for (unsigned int i = 0; i < count; ++i) {
+			const Item item = { static_cast<float>(i % 100) - 50.0f, static_cast<float>(i / 100) - 50.0f,
+				static_cast<float>((i * 7919) % 200) - 100.0f, 0.5f, i % 16 };
+			items[i] = item;
+		}
+
+		//t[Ƃɉ镽ʂ̕\ɂ}`Ƃ
+		const auto visible = [&](unsigned int i, unsigned int frame) {
+			const float a(static_cast<float>(frame) * 0.05f);
+			return items[i].x * std::cos(a) + items[i].z * std::sin(a) > -items[i].radius;
+		};
+		const auto key = [&](unsigned int i) {
+			return (static_cast<std::uint64_t>(items[i].material) << 32) | static_cast<std::uint32_t>((items[i].z + 100.0f) * 1000.0f);
+		};
+
+		ThreadPool pool;
+		FrameArena frameArena(pool.size(), 1 << 20);
+
+		//t[Ƃstd::vector
+		double heapTime(0.0);
+		std::size_t heapAllocations(0), heapDraws(0);
+		for (unsigned int f = 0; f < frames; ++f) {
+			const std::size_t allocations(AllocationCounter::count());
+			const auto t0(std::chrono::high_resolution_clock::now());
+
+			std::vector<std::vector<unsigned int>> culled(chunks);
+			pool.parallelFor(chunks, [&](unsigned int c, unsigned int) {
+				for (unsigned int i = c * chunk; i < count && i < (c + 1) * chunk; ++i) {
+					if (visible(i, f)) culled[c].push_back(i);
+				}
+			});
+			std::vector<Draw> draws;
+			for (const auto& list : culled) {
+				for (const unsigned int i : list) draws.push_back(Draw{ key(i), i });
+			}
+			std::sort(draws.begin(), draws.end());
+			std::vector<unsigned int> lights;
+			for (unsigned int i = 0; i < count; i += 97) lights.push_back(i);
+			heapDraws = draws.size();
+
+			if (f >= warmup) {
+				heapTime += Profiler::elapsed(t0);
+				heapAllocations += AllocationCounter::count() - allocations;
+			}
+		}
+
+		//t[̈ꎞIȃf[^FrameArenamۂ
+		double arenaTime(0.0);
+		std::size_t arenaAllocations(0), arenaDraws(0);
+		for (unsigned int f = 0; f < frames; ++f) {
+			const std::size_t allocations(AllocationCounter::count());
+			const auto t0(std::chrono::high_resolution_clock::now());
+
+			frameArena.beginFrame();
+			unsigned int** const culled(frameArena.allocate<unsigned int*>(chunks));
+			unsigned int* const culledCount(frameArena.allocate<unsigned int>(chunks));
+			pool.parallelFor(chunks, [&](unsigned int c, unsigned int thread) {
+				//[J[͎̃Xbḧ̗悩mۂ
+				culled[c] = frameArena.allocate<unsigned int>(chunk, thread);
+				culledCount[c] = 0;
+				for (unsigned int i = c * chunk; i < count && i < (c + 1) * chunk; ++i) {
+					if (visible(i, f)) culled[c][culledCount[c]++] = i;
+				}
+			});
+			FrameVector<Draw> draws((FrameAllocator<Draw>(frameArena)));
+			for (unsigned int c = 0; c < chunks; ++c) {
+				for (unsigned int j = 0; j < culledCount[c]; ++j) draws.push_back(Draw{ key(culled[c][j]), culled[c][j] });
+			}
+			std::sort(draws.begin(), draws.end());
+			FrameVector<unsigned int> lights((FrameAllocator<unsigned int>(frameArena)));
+			for (unsigned int i = 0; i < count; i += 97) lights.push_back(i);
+			arenaDraws = draws.size();
+
+			if (f >= warmup) {
+				arenaTime += Profiler::elapsed(t0);
+				arenaAllocations += AllocationCounter::count() - allocations;
+			}
+		}
+
+		const unsigned int measured(frames - warmup);
+		const FrameArena::Stats stats(frameArena.getStats());
+		out << "heap vectors: " << heapTime / measured << " ms / frame, "
+			<< static_cast<double>(heapAllocations) / measured << " allocations / frame, " << heapDraws << " draws" << std::endl;
+		out << "frame arena:  " << arenaTime / measured << " ms / frame, "
+			<< static_cast<double>(arenaAllocations) / measured << " allocations / frame, " << arenaDraws << " draws, peak "
+			<< stats.peak / 1024 << " KB (thread peak " << stats.threadPeak / 1024 << " KB, overflows " << stats.overflows << ")" << std::endl;
+		if (arenaAllocations > 0) fail(out, "frame arena: steady-state frames are not allocation-free");
+	}
+
+	//10̐ߓ_̂1%̃[JϊsςƂ̕ϊ̊Kw̍XVԂv
+	static void scene(std::ostream& out) {
+		//vt[
+		const int frames(100);
+
+		//100̍̉10̎qẢ10̑Ả9̗t[D̏ɍ
+		ThreadPool pool;
+		SceneGraph graph(pool);
+		graph.reserve(101100);
+		for (int r = 0; r < 100; ++r) {
+			const SceneGraph::Node root(graph.addNode(SceneGraph::None,
+				Matrix::translate(static_cast<GLfloat>(r % 10) * 10.0f, 0.0f, static_cast<GLfloat>(r / 10) * 10.0f)));
+			for (int c = 0; c < 10; ++c) {
+				const SceneGraph::Node child(graph.addNode(root, Matrix::rotate(static_cast<GLfloat>(c), 0.0f, 1.0f, 0.0f)));
+				for (int g = 0; g < 10; ++g) {
+					const SceneGraph::Node grandchild(graph.addNode(child, Matrix::translate(1.0f, 0.0f, 0.0f)));
+					for (int l = 0; l < 9; ++l) graph.addNode(grandchild, Matrix::scale(0.5f, 0.5f, 0.5f));
+				}
+			}
+		}
+		const unsigned int count(static_cast<unsigned int>(graph.getSize()));
+		graph.update();
+
+		//1%̐ߓ_Iԗ
+		unsigned int seed(12345);
+		const auto random = [&seed]() { seed = seed * 1664525u + 1013904223u; return seed >> 8; };
+
+		//ς؂vZ
+		double time(0.0);
+		unsigned long long updated(0);
+		for (int f = 0; f < frames; ++f) {
+			for (unsigned int i = 0; i < count / 100; ++i) {
+				graph.setLocal(random() % count, Matrix::rotate(static_cast<GLfloat>(f) * 0.01f, 0.0f, 1.0f, 0.0f));
+			}
+			graph.update();
+			time += graph.getStats().updateTime;
+			updated += graph.getStats().updated;
+		}
+
+		//ׂĂ̐ߓ_̃XbhŌvZ
+		std::vector<Matrix> world(count);
+		std::vector<GLfloat> normal(count * 9);
+		std::vector<std::uint32_t> parent(count);
+		for (unsigned int i = 0; i < count; ++i) parent[i] = graph.getParent(i);
+		double fullTime(0.0);
+		for (int f = 0; f < frames; ++f) {
+			const auto t0(std::chrono::high_resolution_clock::now());
+			for (unsigned int i = 0; i < count; ++i) {
+				world[i] = parent[i] == SceneGraph::None ? graph.getLocal(i) : world[parent[i]] * graph.getLocal(i);
+				world[i].getNormalMatrix(&normal[i * 9]);
+			}
+			fullTime += Profiler::elapsed(t0);
+		}
+
+		out << "full recompute:  " << fullTime / frames << " ms / " << count << " nodes" << std::endl;
+		out << "dirty subtrees:  " << time / frames << " ms / " << count << " nodes, 1% changed, "
+			<< updated / frames << " nodes updated, " << graph.getStats().tasks << " tasks on "
+			<< pool.size() << " threads" << std::endl;
+	}
+
+	//dȂ̐Ɠ_̐ςđO`ƒx`̃t[Ԃׂ
+	//\̃EBhE̊̃t[obt@ɕ`AglFinish܂ł̎Ԃv
+	static void deferred(std::ostream& out) {
+		//vt[
+		const int frames(20);
+
+		//w̋̐i~cj
+		const int columns(16), rows(9);
+
+		//
+		std::vector<Object::Vertex> sphereVertex, volumeVertex;
+		std::vector<GLuint> sphereIndex, volumeIndex;
+		makeSphere(32, 16, sphereVertex, sphereIndex);
+		makeSphere(16, 8, volumeVertex, volumeIndex);
+		MeshBuffer meshes(static_cast<GLsizei>(sphereVertex.size() + volumeVertex.size()),
+			static_cast<GLsizei>(sphereIndex.size() + volumeIndex.size()));
+		const MeshBuffer::Mesh sphere(meshes.get(meshes.add(static_cast<GLsizei>(sphereVertex.size()), sphereVertex.data(),
+			static_cast<GLsizei>(sphereIndex.size()), sphereIndex.data())));
+		const MeshBuffer::Handle volume(meshes.add(static_cast<GLsizei>(volumeVertex.size()), volumeVertex.data(),
+			static_cast<GLsizei>(volumeIndex.size()), volumeIndex.data()));
+
+		static const Material color = { 0.6f, 0.6f, 0.2f, 1.0f, 0.0f, 1.0f, 0.3f, 0.3f, 0.3f, 30.0f, 0 };
+		const Uniform<Material> material(&color, 1);
+
+		//sipoint.frag̓ڂ͎̌gȂj
+		const Vector light = { 0.0f, 0.0f, 1.0f, 0.0f };
+		static const GLfloat Lamb[] = { 0.2f, 0.2f, 0.2f, 0.0f, 0.0f, 0.0f };
+		static const GLfloat Ldiff[] = { 0.5f, 0.5f, 0.5f, 0.0f, 0.0f, 0.0f };
+		static const GLfloat Lspec[] = { 0.5f, 0.5f, 0.5f, 0.0f, 0.0f, 0.0f };
+
+		//̃t[obt@̃r[|[g
+		GLint viewport[4];
+		glGetIntegerv(GL_VIEWPORT, viewport);
+		const Matrix projection(Matrix::perspective(1.0f,
+			static_cast<GLfloat>(viewport[2]) / static_cast<GLfloat>(viewport[3]), 1.0f, 100.0f));
+
+		//O`̃VF[_[
+		const GLProgram forward(loadProgram("batch.vert", "point.frag"));
+		glUniformBlockBinding(forward.get(), glGetUniformBlockIndex(forward.get(), "Material"), 0);
+		glUniformBlockBinding(forward.get(), glGetUniformBlockIndex(forward.get(), "PointLights"), 1);
+		const GLint projectionLoc(glGetUniformLocation(forward.get(), "projection"));
+		const GLint LposLoc(glGetUniformLocation(forward.get(), "Lpos"));
+		const GLint LambLoc(glGetUniformLocation(forward.get(), "Lamb"));
+		const GLint LdiffLoc(glGetUniformLocation(forward.get(), "Ldiff"));
+		const GLint LspecLoc(glGetUniformLocation(forward.get(), "Lspec"));
+		const GLint pointLightCountLoc(glGetUniformLocation(forward.get(), "pointLightCount"));
+		const GLint cascadeCountLoc(glGetUniformLocation(forward.get(), "cascadeCount"));
+		const GLint shadowMapLoc(glGetUniformLocation(forward.get(), "shadowMap"));
+		const GLint probeMapLoc(glGetUniformLocation(forward.get(), "probeMap"));
+
+		DeferredRenderer renderer(meshes, volume);
+		PointLights lights;
+		IndirectBatch batch(meshes);
+		glEnable(GL_DEPTH_TEST);
+		glEnable(GL_CULL_FACE);
+
+		out << "layers  lights   forward (ms)  deferred (ms)" << std::endl;
+		static const int layerCounts[] = { 1, 4 };
+		static const int lightCounts[] = { 16, 64, 256 };
+		for (const int layers : layerCounts) {
+			//OɌē傫̑wd˂āAʂ̊ef𕽋layersh
+			batch.clear();
+			for (int l = 0; l < layers; ++l) {
+				for (int i = 0; i < columns * rows; ++i) {
+					batch.add(sphere, Matrix::translate(static_cast<GLfloat>(i % columns) - 7.5f,
+						static_cast<GLfloat>(i / columns) - 4.0f, -8.0f - static_cast<GLfloat>(layers - l) * 0.5f)
+						* Matrix::scale(0.6f, 0.6f, 0.6f));
+				}
+			}
+
+			for (const int count : lightCounts) {
+				//}`̎Ȏwɓ_iqɕׂ
+				lights.clear();
+				for (int i = 0; i < count; ++i) {
+					const GLfloat u((static_cast<GLfloat>(i % 16) + 0.5f) / 16.0f);
+					const GLfloat v((static_cast<GLfloat>(i / 16) + 0.5f) / static_cast<GLfloat>((count + 15) / 16));
+					const PointLights::Light point = {
+						{ 16.0f * u - 8.0f, 9.0f * v - 4.5f, -7.5f }, 2.0f,
+						{ 0.5f + 0.5f * u, 0.5f + 0.5f * v, 1.0f - 0.5f * u }
+					};
+					lights.add(point);
+				}
+				lights.upload(Matrix::identity());
+				lights.select(1);
+
+				//O`FׂẲfłׂĂ̓_]
+				double forwardTime(0.0);
+				for (int f = 0; f < frames; ++f) {
+					glFinish();
+					const auto t0(std::chrono::high_resolution_clock::now());
+					glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+					glUseProgram(forward.get());
+					glUniformMatrix4fv(projectionLoc, 1, GL_FALSE, projection.data());
+					glUniform4fv(LposLoc, 1, light.data());
+					glUniform3fv(LambLoc, 2, Lamb);
+					glUniform3fv(LdiffLoc, 2, Ldiff);
+					glUniform3fv(LspecLoc, 2, Lspec);
+					glUniform1i(pointLightCountLoc, lights.size());
+					glUniform1i(cascadeCountLoc, 0);
+					glUniform1i(shadowMapLoc, 1);
+					glUniform1i(probeMapLoc, 2);
+					batch.draw(GL_TRIANGLES, material);
+					glFinish();
+					forwardTime += Profiler::elapsed(t0);
+				}
+
+				//x`FĂfɓ_]
+				double deferredTime(0.0);
+				for (int f = 0; f < frames; ++f) {
+					glFinish();
+					const auto t0(std::chrono::high_resolution_clock::now());
+					if (!renderer.beginGeometry(viewport, projection)) return;
+					batch.draw(GL_TRIANGLES, material);
+					renderer.endGeometry();
+					glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+					glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+					renderer.light(viewport, projection, light, Lamb, Ldiff, Lspec, NULL, NULL, Matrix::identity(), lights);
+					glFinish();
+					deferredTime += Profiler::elapsed(t0);
+				}
+
+				out << std::setw(6) << layers << std::setw(8) << count
+					<< std::setw(15) << forwardTime / frames << std::setw(15) << deferredTime / frames << std::endl;
+			}
+		}
+		out << columns * rows << " spheres per layer, " << viewport[2] << "x" << viewport[3] << " pixels" << std::endl;
+	}
+
+	//fvX̐s`ƎO牜ւ̕בւŃtOgVF[_[̎s񐔂ƃt[Ԃǂς邩v
+	//s񐔂GL_ARB_pipeline_statistics_queryŉAet̃pX𐔂
+	static void prepass(std::ostream& out) {
+		//vt[
+		const int frames(20);
+
+		//w̋̐i~cjƑw̐
+		const int columns(16), rows(9), layers(8);
+
+		//_̐itOgVF[_[dj
+		const int lightCount(64);
+
+		//
+		std::vector<Object::Vertex> sphereVertex;
+		std::vector<GLuint> sphereIndex;
+		makeSphere(32, 16, sphereVertex, sphereIndex);
+		MeshBuffer meshes(static_cast<GLsizei>(sphereVertex.size()), static_cast<GLsizei>(sphereIndex.size()));
+		const MeshBuffer::Mesh sphere(meshes.get(meshes.add(static_cast<GLsizei>(sphereVertex.size()), sphereVertex.data(),
+			static_cast<GLsizei>(sphereIndex.size()), sphereIndex.data())));
+
+		static const Material color = { 0.6f, 0.6f, 0.2f, 1.0f, 0.0f, 1.0f, 0.3f, 0.3f, 0.3f, 30.0f, 0 };
+		const Uniform<Material> material(&color, 1);
+
+		//sipoint.frag̓ڂ͎̌gȂj
+		const Vector light = { 0.0f, 0.0f, 1.0f, 0.0f };
+		static const GLfloat Lamb[] = { 0.2f, 0.2f, 0.2f, 0.0f, 0.0f, 0.0f };
+		static const GLfloat Ldiff[] = { 0.5f, 0.5f, 0.5f, 0.0f, 0.0f, 0.0f };
+		static const GLfloat Lspec[] = { 0.5f, 0.5f, 0.5f, 0.0f, 0.0f, 0.0f };
+
+		GLint viewport[4];
+		glGetIntegerv(GL_VIEWPORT, viewport);
+		const Matrix projection(Matrix::perspective(1.0f,
+			static_cast<GLfloat>(viewport[2]) / static_cast<GLfloat>(viewport[3]), 1.0f, 100.0f));
+
+		//AetVF[_[
+		const GLProgram program(loadProgram("batch.vert", "point.frag"));
+		glUniformBlockBinding(program.get(), glGetUniformBlockIndex(program.get(), "Material"), 0);
+		glUniformBlockBinding(program.get(), glGetUniformBlockIndex(program.get(), "PointLights"), 1);
+		glUseProgram(program.get());
+		glUniformMatrix4fv(glGetUniformLocation(program.get(), "projection"), 1, GL_FALSE, projection.data());
+		glUniform4fv(glGetUniformLocation(program.get(), "Lpos"), 1, light.data());
+		glUniform3fv(glGetUniformLocation(program.get(), "Lamb"), 2, Lamb);
+		glUniform3fv(glGetUniformLocation(program.get(), "Ldiff"), 2, Ldiff);
+		glUniform3fv(glGetUniformLocation(program.get(), "Lspec"), 2, Lspec);
+		glUniform1i(glGetUniformLocation(program.get(), "pointLightCount"), lightCount);
+		glUniform1i(glGetUniformLocation(program.get(), "cascadeCount"), 0);
+		glUniform1i(glGetUniformLocation(program.get(), "shadowMap"), 1);
+		glUniform1i(glGetUniformLocation(program.get(), "probeMap"), 2);
+
+		//fvX`VF[_[
+		const GLProgram depth(loadProgram("depth.vert", "shadow.frag"));
+		glUseProgram(depth.get());
+		glUniformMatrix4fv(glGetUniformLocation(depth.get(), "projection"), 1, GL_FALSE, projection.data());
+
+		//_
+		PointLights lights;
+		for (int i = 0; i < lightCount; ++i) {
+			const GLfloat u((static_cast<GLfloat>(i % 16) + 0.5f) / 16.0f);
+			const GLfloat v((static_cast<GLfloat>(i / 16) + 0.5f) / static_cast<GLfloat>(lightCount / 16));
+			const PointLights::Light point = { { 16.0f * u - 8.0f, 9.0f * v - 4.5f, -7.5f }, 3.0f, { 1.0f, 0.8f, 0.6f } };
+			lights.add(point);
+		}
+		lights.upload(Matrix::identity());
+		lights.select(1);
+
+		//̑w珇ɒǉiבւȂ΍łdȂ肪Ȃj
+		IndirectBatch batch(meshes);
+		for (int l = 0; l < layers; ++l) {
+			for (int i = 0; i < columns * rows; ++i) {
+				batch.add(sphere, Matrix::translate(static_cast<GLfloat>(i % columns) - 7.5f,
+					static_cast<GLfloat>(i / columns) - 4.0f, -8.0f - static_cast<GLfloat>(layers - l) * 0.5f)
+					* Matrix::scale(0.6f, 0.6f, 0.6f));
+			}
+		}
+
+		//tOgVF[_[̎s񐔂𐔂₢킹
+		const bool statistics(GLEW_ARB_pipeline_statistics_query != GL_FALSE);
+		const GLQuery query(statistics ? GLQuery::create() : GLQuery());
+		glEnable(GL_DEPTH_TEST);
+		glEnable(GL_CULL_FACE);
+
+		static const char* const names[] = {
+			"submission order:         ",
+			"front-to-back:            ",
+			"front-to-back + pre-pass: "
+		};
+		for (int mode = 0; mode < 3; ++mode) {
+			batch.setFrontToBack(mode > 0);
+			double time(0.0);
+			GLuint64 invocations(0);
+			for (int f = 0; f < frames; ++f) {
+				glFinish();
+				const auto t0(std::chrono::high_resolution_clock::now());
+				glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+				if (mode == 2) {
+					glUseProgram(depth.get());
+					glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+					batch.drawDepth(GL_TRIANGLES);
+					glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+					glDepthFunc(GL_EQUAL);
+					glDepthMask(GL_FALSE);
+				}
+				glUseProgram(program.get());
+				if (statistics) glBeginQuery(GL_FRAGMENT_SHADER_INVOCATIONS_ARB, query.get());
+				batch.draw(GL_TRIANGLES, material);
+				if (statistics) glEndQuery(GL_FRAGMENT_SHADER_INVOCATIONS_ARB);
+				glDepthMask(GL_TRUE);
+				glDepthFunc(GL_LESS);
+				glFinish();
+				time += Profiler::elapsed(t0);
+
+				if (statistics) {
+					GLuint64 count;
+					glGetQueryObjectui64v(query.get(), GL_QUERY_RESULT, &count);
+					invocations += count;
+				}
+			}
+			out << names[mode] << time / frames << " ms";
+			if (statistics) out << ", " << invocations / frames << " fragment shader invocations";
+			out << std::endl;
+		}
+		if (!statistics) out << "fragment shader invocations: GL_ARB_pipeline_statistics_query is not supported" << std::endl;
+		out << columns * rows * layers << " spheres in " << layers << " layers, " << lightCount << " point lights, "
+			<< viewport[2] << "x" << viewport[3] << " pixels" << std::endl;
+	}
+
+	//10̕ϊ̍Ɩ@ϊšvZMatrixAffineŔׂ
+	static void math(std::ostream& out) {
+		//ϊ̐
+		const int count(100000);
+
+		//JԂ
+		const int rounds(20);
+
+		//}`Ƃ̕sړA]Agk
+		std::vector<Vec<3>> t(count), s(count);
+		std::vector<Quat> q(count);
+		std::vector<Matrix> r(count);
+		for (int i = 0; i < count; ++i) {
+			const GLfloat a(static_cast<GLfloat>(i) * 0.001f);
+			t[i] = Vec<3>{ static_cast<GLfloat>(i % 100), static_cast<GLfloat>(i / 100 % 100), -static_cast<GLfloat>(i / 10000) };
+			s[i] = Vec<3>{ 1.0f + a, 1.0f, 1.0f - a * 0.5f };
+			q[i] = Quat::rotate(a, 0.0f, 1.0f, 0.0f);
+			r[i] = Matrix::rotate(a, 0.0f, 1.0f, 0.0f);
+		}
+		const Matrix view(Matrix::lookat(3.0f, 4.0f, 5.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f));
+		const Affine affineView(Affine::fromMatrix(view));
+
+		//ʁiœKŌvZȂȂ悤Ɏgj
+		std::vector<Matrix> matrixResult(count);
+		std::vector<Affine> affineResult(count);
+		std::vector<GLfloat> normal(count * 9);
+
+		//translate * rotate * scaleMatrix̐ςŋ߁Ar[ϊs|Ė@ϊs߂
+		double matrixTime(0.0);
+		for (int n = 0; n < rounds; ++n) {
+			const auto t0(std::chrono::high_resolution_clock::now());
+			for (int i = 0; i < count; ++i) {
+				matrixResult[i] = view * (Matrix::translate(t[i][0], t[i][1], t[i][2]) * r[i] * Matrix::scale(s[i][0], s[i][1], s[i][2]));
+				matrixResult[i].getNormalMatrix(&normal[i * 9]);
+			}
+			matrixTime += Profiler::elapsed(t0);
+		}
+
+		//vZAffine̐ςŋ߂
+		double affineTime(0.0);
+		for (int n = 0; n < rounds; ++n) {
+			const auto t0(std::chrono::high_resolution_clock::now());
+			for (int i = 0; i < count; ++i) {
+				affineResult[i] = affineView * (Affine::translate(t[i][0], t[i][1], t[i][2]) * Affine::rotate(q[i]) * Affine::scale(s[i][0], s[i][1], s[i][2]));
+				affineResult[i].getNormalMatrix(&normal[i * 9]);
+			}
+			affineTime += Profiler::elapsed(t0);
+		}
+
+		//]Ɗgk܂Ƃ߂đgݗĂ
+		double fusedTime(0.0);
+		for (int n = 0; n < rounds; ++n) {
+			const auto t0(std::chrono::high_resolution_clock::now());
+			for (int i = 0; i < count; ++i) {
+				affineResult[i] = affineView * Affine::trs(t[i], q[i], s[i]);
+				affineResult[i].getNormalMatrix(&normal[i * 9]);
+			}
+			fusedTime += Profiler::elapsed(t0);
+		}
+
+		//̌ʂ̍ő̍
+		GLfloat error(0.0f);
+		for (int i = 0; i < count; ++i) {
+			const Matrix a(affineResult[i].toMatrix());
+			for (int j = 0; j < 16; ++j) error = std::max(error, std::abs(a[j] - matrixResult[i][j]));
+		}
+
+		const double scale(1.0e6 / (static_cast<double>(rounds) * count));
+		out << "Matrix T*R*S, view, normal: " << matrixTime * scale << " ns / transform" << std::endl;
+		out << "Affine T*R*S, view, normal: " << affineTime * scale << " ns / transform" << std::endl;
+		out << "Affine trs, view, normal:   " << fusedTime * scale << " ns / transform" << std::endl;
+		out << "max difference:             " << error << std::endl;
+	}
+
+	//1{̃gbNԂ鑬Xbh̐ƃL[̈k̗LŔׂ
+	static void animation(std::ostream& out) {
+		//gbN̐ƃgbNƂ̃L[̐
+		const int count(10000), keyCount(65);
+
+		//vt[
+		const int frames(100);
+
+		//gbNƂɈʑƑ̈ႤO0.125bƂ̃L[ŕ\i㔼4b͎~܂Ăj
+		ThreadPool pool;
+		Animation plain(pool), compressed(pool);
+		std::vector<Animation::Key> keys(keyCount);
+		for (int i = 0; i < count; ++i) {
+			const GLfloat phase(static_cast<GLfloat>(i) * 0.01f), speed(0.5f + static_cast<GLfloat>(i % 7) * 0.1f);
+			for (int k = 0; k < keyCount; ++k) {
+				const GLfloat t(0.125f * static_cast<GLfloat>(k)), m(std::min(t, 4.0f));
+				keys[k] = Animation::Key{ t,
+					Vec<3>{ std::cos(phase + speed * m), 0.1f * m, std::sin(phase + speed * m) },
+					Quat::rotate(phase + speed * m, 0.0f, 1.0f, 0.0f),
+					Vec<3>{ 1.0f, 1.0f + 0.1f * std::sin(m), 1.0f } };
+			}
+			plain.addTrack(keys.data(), keyCount);
+			compressed.addTrack(keys.data(), keyCount, 1.0e-3f);
+		}
+		std::vector<Matrix> transforms(count);
+
+		//̃XbhƑSXbhŕԂ
+		const auto run = [&](Animation& animation, bool parallel) {
+			double time(0.0);
+			for (int f = 0; f < frames; ++f) {
+				animation.sample(static_cast<GLfloat>(f) * 0.016f, transforms.data(), parallel);
+				time += animation.getStats().sampleTime;
+			}
+			return static_cast<double>(count) * frames / time;
+		};
+		out << "1 thread:               " << run(plain, false) << " tracks / ms" << std::endl;
+		out << pool.size() << " threads:              " << run(plain, true) << " tracks / ms" << std::endl;
+		out << pool.size() << " threads, compressed:  " << run(compressed, true) << " tracks / ms, "
+			<< compressed.getStats().keys << " / " << plain.getStats().keys << " keys" << std::endl;
+	}
+
+	//J[\̉̐}`Iԕ@ƂɃt[Ԃƌʂo܂ł̒xׂ
+	static void pick(std::ostream& out) {
+		//vt[
+		const int frames(20);
+
+		//w̋̐i~cjƑw̐A_̐it[GPUׂ̕ɂj
+		const int columns(16), rows(9), layers(4), lightCount(32);
+
+		//
+		std::vector<Object::Vertex> sphereVertex;
+		std::vector<GLuint> sphereIndex;
+		makeSphere(32, 16, sphereVertex, sphereIndex);
+		MeshBuffer meshes(static_cast<GLsizei>(sphereVertex.size()), static_cast<GLsizei>(sphereIndex.size()));
+		const MeshBuffer::Mesh sphere(meshes.get(meshes.add(static_cast<GLsizei>(sphereVertex.size()), sphereVertex.data(),
+			static_cast<GLsizei>(sphereIndex.size()), sphereIndex.data())));
+
+		static const Material color = { 0.6f, 0.6f, 0.2f, 1.0f, 0.0f, 1.0f, 0.3f, 0.3f, 0.3f, 30.0f, 0 };
+		const Uniform<Material> material(&color, 1);
+
+		GLint viewport[4];
+		glGetIntegerv(GL_VIEWPORT, viewport);
+		const Matrix projection(Matrix::perspective(1.0f,
+			static_cast<GLfloat>(viewport[2]) / static_cast<GLfloat>(viewport[3]), 1.0f, 100.0f));
+
+		//AetVF[_[is͎g킸_ŏƂ炷j
+		static const GLfloat black[] = { 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f };
+		const GLProgram program(loadProgram("batch.vert", "point.frag"));
+		glUniformBlockBinding(program.get(), glGetUniformBlockIndex(program.get(), "Material"), 0);
+		glUniformBlockBinding(program.get(), glGetUniformBlockIndex(program.get(), "PointLights"), 1);
+		glUseProgram(program.get());
+		glUniformMatrix4fv(glGetUniformLocation(program.get(), "projection"), 1, GL_FALSE, projection.data());
+		glUniform3fv(glGetUniformLocation(program.get(), "Lamb"), 2, black);
+		glUniform3fv(glGetUniformLocation(program.get(), "Ldiff"), 2, black);
+		glUniform3fv(glGetUniformLocation(program.get(), "Lspec"), 2, black);
+		glUniform1i(glGetUniformLocation(program.get(), "pointLightCount"), lightCount);
+		glUniform1i(glGetUniformLocation(program.get(), "cascadeCount"), 0);
+		glUniform1i(glGetUniformLocation(program.get(), "shadowMap"), 1);
+		glUniform1i(glGetUniformLocation(program.get(), "probeMap"), 2);
+
+		PointLights lights;
+		for (int i = 0; i < lightCount; ++i) {
+			const PointLights::Light point = { { static_cast<GLfloat>(i % 8) * 2.0f - 7.0f, static_cast<GLfloat>(i / 8) * 2.0f - 3.0f, -7.5f },
+				3.0f, { 1.0f, 0.8f, 0.6f } };
+			lights.add(point);
+		}
+		lights.upload(Matrix::identity());
+		lights.select(1);
+
+		//sbLO̔ԍ͒ǉ1t
+		IndirectBatch batch(meshes);
+		std::vector<Matrix> models;
+		for (int l = 0; l < layers; ++l) {
+			for (int i = 0; i < columns * rows; ++i) {
+				models.push_back(Matrix::translate(static_cast<GLfloat>(i % columns) - 7.5f,
+					static_cast<GLfloat>(i / columns) - 4.0f, -8.0f - static_cast<GLfloat>(l) * 0.5f) * Matrix::scale(0.6f, 0.6f, 0.6f));
+				batch.add(sphere, models.back(), 0u, static_cast<GLuint>(models.size()));
+			}
+		}
+		glEnable(GL_DEPTH_TEST);
+		glEnable(GL_CULL_FACE);
+
+		//J[\͉ʂ̒班Eɒu
+		const GLfloat x(viewport[0] + viewport[2] * 0.55f), y(viewport[1] + viewport[3] * 0.55f);
+
+		Picker picker;
+		static const char* const names[] = {
+			"no picking:   ",
+			"glReadPixels: ",
+			"PBO + fence:  "
+		};
+		GLuint ids[3] = {}, primitives[3] = {};
+		for (int mode = 0; mode < 3; ++mode) {
+			double pickTime(0.0), latency(0.0);
+			unsigned int results(0), latencyFrames(0);
+			glFinish();
+			const auto t0(std::chrono::high_resolution_clock::now());
+			for (int f = 0; f < frames; ++f) {
+				glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+				glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+				glUseProgram(program.get());
+				batch.draw(GL_TRIANGLES, material);
+
+				//sbLOŕ`̃XbhgԂv
+				const auto t1(std::chrono::high_resolution_clock::now());
+				if (mode == 1) {
+					const Picker::Result r(picker.pickNow(batch, projection, viewport, x, y));
+					ids[mode] = r.id;
+					primitives[mode] = r.primitive;
+					latency += r.latency;
+					++results;
+				}
+				else if (mode == 2) {
+					picker.request(batch, projection, viewport, x, y);
+					if (picker.poll()) {
+						ids[mode] = picker.getResult().id;
+						primitives[mode] = picker.getResult().primitive;
+						latency += picker.getResult().latency;
+						latencyFrames += picker.getResult().frames;
+						++results;
+					}
+				}
+				pickTime += Profiler::elapsed(t1);
+
+				//t[̏Ȋɑo
+				glFlush();
+			}
+			glFinish();
+			const double time(Profiler::elapsed(t0));
+
+			out << names[mode] << time / frames << " ms / frame";
+			if (mode > 0) {
+				out << ", " << pickTime / frames << " ms / frame in picking, latency "
+					<< (results > 0 ? latency / results : 0.0) << " ms";
+			}
+			if (mode == 2) {
+				out << " (" << (results > 0 ? static_cast<double>(latencyFrames) / results : 0.0) << " frames, "
+					<< picker.getStats().dropped << " dropped)";
+			}
+			out << std::endl;
+		}
+
+		//CPUŌƎOp`̌𒲂ׂ
+		const int casts(20);
+		GLuint cpuId(0), cpuPrimitive(0);
+		const auto t0(std::chrono::high_resolution_clock::now());
+		for (int c = 0; c < casts; ++c) {
+			const Picker::Ray ray(projection, 2.0f * (x - viewport[0]) / viewport[2] - 1.0f, 2.0f * (y - viewport[1]) / viewport[3] - 1.0f);
+			GLfloat t(1.0f);
+			cpuId = 0;
+			for (std::size_t i = 0; i < models.size(); ++i) {
+				if (ray.intersect(models[i], 1.0f, sphereVertex.data(), sphereIndex.data(), static_cast<GLsizei>(sphereIndex.size()), t, cpuPrimitive))
+					cpuId = static_cast<GLuint>(i + 1);
+			}
+		}
+		out << "CPU ray cast:  " << Profiler::elapsed(t0) / casts << " ms / pick" << std::endl;
+		out << "picked id (triangle): glReadPixels " << ids[1] << " (" << primitives[1] << "), PBO + fence " << ids[2]
+			<< " (" << primitives[2] << "), CPU " << cpuId << " (" << cpuPrimitive << "); "
+			<< models.size() << " spheres, " << Picker::Size << "x" << Picker::Size << " pixels read back" << std::endl;
+	}
+
+	//eNX`̃t@Č`Ƃ̓ǂݍ݂̑ƁA\Z̉GPUɒueNX`̗ʂv
+	//eNX`̃t@C͓ĂȂ̂ŁA`ƂɃwb_ƒgɍēǂݍ
+	static void texture(std::ostream& out) {
+		//摜̑傫ƌJԂ
+		const GLsizei size(2048);
+		const int repeat(4);
+
+		ThreadPool pool;
+		unsigned int seed(12345);
+		const auto random = [&seed]() { seed = seed * 1664525u + 1013904223u; return seed >> 8; };
+		const auto set32 = [](std::vector<unsigned char>& file, std::size_t offset, std::uint32_t x) {
+			for (int i = 0; i < 4; ++i) file[offset + i] = static_cast<unsigned char>(x >> (i * 8));
+		};
+
+		//~bv}bṽx̐ƃxƂ̃oCgiblock4x4f̃oCgA0Ȃ񈳏kRGBA8j
+		const auto levelBytes = [size](std::size_t block, std::vector<std::size_t>& bytes) {
+			bytes.clear();
+			for (GLsizei s = size; ; s /= 2) {
+				bytes.push_back(block > 0 ? static_cast<std::size_t>((s + 3) / 4) * ((s + 3) / 4) * block : static_cast<std::size_t>(s) * s * 4);
+				if (s == 1) break;
+			}
+		};
+
+		//DDS̃t@Cidxgi0łȂDX10̊gwb_tj
+		const auto dds = [&](const char* fourCC, std::uint32_t dxgi, std::size_t block, bool mipmaps) {
+			std::vector<std::size_t> bytes;
+			levelBytes(block, bytes);
+			if (!mipmaps) bytes.resize(1);
+			std::vector<unsigned char> file(dxgi > 0 ? 148 : 128);
+			std::memcpy(file.data(), "DDS ", 4);
+			set32(file, 4, 124);
+			set32(file, 8, 0x21007);
+			set32(file, 12, size);
+			set32(file, 16, size);
+			set32(file, 28, static_cast<std::uint32_t>(bytes.size()));
+			set32(file, 76, 32);
+			if (fourCC != NULL) {
+				set32(file, 80, 0x4);
+				std::memcpy(&file[84], fourCC, 4);
+			}
+			else {
+				set32(file, 80, 0x41);
+				set32(file, 88, 32);
+				set32(file, 92, 0xff);
+				set32(file, 96, 0xff00);
+				set32(file, 100, 0xff0000);
+				set32(file, 104, 0xff000000);
+			}
+			set32(file, 108, 0x401008);
+			if (dxgi > 0) {
+				set32(file, 128, dxgi);
+				set32(file, 132, 3);
+				set32(file, 140, 1);
+			}
+			for (const std::size_t b : bytes)
+				for (std::size_t i = 0; i < b; ++i) file.push_back(static_cast<unsigned char>(random()));
+			return file;
+		};
+
+		//KTX̃t@CiglInternalFormatk`łȂΔ񈳏kRGBA8j
+		const auto ktx = [&](std::uint32_t glInternalFormat, std::size_t block, bool mipmaps) {
+			static const unsigned char identifier[12] = { 0xAB, 'K', 'T', 'X', ' ', '1', '1', 0xBB, '\r', '\n', 0x1A, '\n' };
+			std::vector<std::size_t> bytes;
+			levelBytes(block, bytes);
+			if (!mipmaps) bytes.resize(1);
+			std::vector<unsigned char> file(64);
+			std::memcpy(file.data(), identifier, sizeof identifier);
+			set32(file, 12, 0x04030201);
+			set32(file, 16, block > 0 ? 0 : GL_UNSIGNED_BYTE);
+			set32(file, 20, 1);
+			set32(file, 24, block > 0 ? 0 : GL_RGBA);
+			set32(file, 28, glInternalFormat);
+			set32(file, 32, GL_RGBA);
+			set32(file, 36, size);
+			set32(file, 40, size);
+			set32(file, 52, 1);
+			set32(file, 56, static_cast<std::uint32_t>(bytes.size()));
+			for (const std::size_t b : bytes) {
+				file.resize(file.size() + 4);
+				set32(file, file.size() - 4, static_cast<std::uint32_t>(b));
+				for (std::size_t i = 0; i < b; ++i) file.push_back(static_cast<unsigned char>(random()));
+			}
+			return file;
+		};
+
+		//񈳏k̉摜̃~bv}bv1̃XbhƑSXbhō
+		const std::vector<unsigned char> rgba(dds(NULL, 0, 0, false));
+		for (const bool parallel : { false, true }) {
+			double time(0.0);
+			for (int r = 0; r < repeat; ++r) {
+				TextureImage image;
+				image.loadDds(rgba.data(), rgba.size());
+				const auto t0(std::chrono::high_resolution_clock::now());
+				image.generateMipmaps(pool, parallel);
+				time += Profiler::elapsed(t0);
+			}
+			out << "mipmaps, " << (parallel ? pool.size() : 1) << (parallel ? " threads: " : " thread:  ")
+				<< static_cast<double>(size) * size * 4 * repeat / (time * 1000.0) << " MB/s (" << size << "x" << size << " RGBA8)" << std::endl;
+		}
+
+		//`ƂɃ̃t@Cǂݍ݁A񈳏kȂ~bv}bvđSx]
+		struct Format {
+			const char* name;
+			std::vector<unsigned char> file;
+		};
+		const Format formats[] = {
+			{ "DDS RGBA8 + mipmaps", rgba },
+			{ "DDS BC1", dds("DXT1", 0, 8, true) },
+			{ "DDS BC3", dds("DXT5", 0, 16, true) },
+			{ "DDS BC5", dds("ATI2", 0, 16, true) },
+			{ "DDS BC7", dds("DX10", 98, 16, true) },
+			{ "KTX BC7", ktx(GL_COMPRESSED_RGBA_BPTC_UNORM, 16, true) },
+			{ "KTX ETC2", ktx(GL_COMPRESSED_RGB8_ETC2, 8, true) },
+			{ "KTX ETC2 EAC", ktx(GL_COMPRESSED_RGBA8_ETC2_EAC, 16, true) },
+		};
+		//ǂݍ񂾃eNX`͈xupdateőSxu悤ɓ]̏傫
+		for (const Format& format : formats) {
+			TextureCache cache(0, 64 << 20);
+			double time(0.0);
+			bool supported(true);
+			for (int r = 0; r < repeat && supported; ++r) {
+				const auto t0(std::chrono::high_resolution_clock::now());
+				TextureImage image;
+				image.load(format.file.data(), format.file.size());
+				image.generateMipmaps(pool);
+				supported = image.isSupported();
+				const TextureCache::Handle handle(supported ? cache.add(std::move(image)) : 0);
+				cache.request(handle, static_cast<GLfloat>(size));
+				cache.update();
+				glFinish();
+				time += Profiler::elapsed(t0);
+			}
+			out << std::left << std::setw(22) << format.name << std::right;
+			if (!supported) {
+				out << "not supported" << std::endl;
+				continue;
+			}
+			out << static_cast<double>(format.file.size()) * repeat / (time * 1000.0) << " MB/s, "
+				<< static_cast<double>(cache.getStats().resident) / repeat / (1 << 20) << " MB resident / texture" << std::endl;
+		}
+
+		//RGBA81024x102432̃eNX`32MB̗\ZŒuAʏ̑傫ςȂGPUɒuʂ𒲂ׂ
+		const int count(32), frames(240);
+		TextureCache cache(32 << 20, 4 << 20);
+		std::vector<TextureCache::Handle> handles;
+		for (int i = 0; i < count; ++i) {
+			std::vector<unsigned char> pixels(1024 * 1024 * 4);
+			for (std::size_t p = 0; p < pixels.size(); ++p) pixels[p] = static_cast<unsigned char>(random());
+			TextureImage image;
+			image.create(1024, 1024, pixels.data());
+			image.generateMipmaps(pool);
+			handles.push_back(cache.add(std::move(image)));
+		}
+		std::size_t peak(0), wanted(0), uploaded(0);
+		double updateTime(0.0);
+		for (int f = 0; f < frames; ++f) {
+			//eNX`ƂɈʑ炵ĉʏ̑傫32f1024f܂ŕςA͓rŌȂ
+			for (int i = 0; i < count; ++i) {
+				if (i % 2 != 0 && f > frames / 2) continue;
+				const GLfloat s(0.5f + 0.5f * std::sin(static_cast<GLfloat>(f) * 0.05f + static_cast<GLfloat>(i)));
+				cache.request(handles[i], 32.0f * std::pow(32.0f, s));
+			}
+			cache.update();
+			peak = std::max(peak, cache.getStats().resident);
+			wanted = std::max(wanted, cache.getStats().wanted);
+			uploaded += cache.getStats().uploaded;
+			updateTime += cache.getStats().updateTime;
+		}
+		glFinish();
+		out << "streaming: " << count << " textures, budget " << (cache.getStats().budget >> 20) << " MB, wanted up to "
+			<< static_cast<double>(wanted) / (1 << 20) << " MB, resident " << static_cast<double>(cache.getStats().resident) / (1 << 20)
+			<< " MB (peak " << static_cast<double>(peak) / (1 << 20) << " MB), upload " << static_cast<double>(uploaded) / frames / (1 << 10)
+			<< " KB / frame, update " << updateTime / frames << " ms / frame" << std::endl;
+	}
+
+	//ׂbVbgɕAƎ̊Ô܂Ƃ܂̂ĂƂ̎Op`̐ƃJO̎Ԃƕ`掞Ԃv
+	//̂ĂƂ̉摜Ŝ`̂ƓɂȂ邩ǂׂ
+	static void meshlet(std::ostream& out) {
+		//vt[
+		const int frames(5);
+
+		//̕сi~cA͉ʂ͂ݏoj
+		const int columns(8), rows(3);
+
+		//bVbgɕ
+		ThreadPool pool;
+		std::vector<Object::Vertex> sphereVertex;
+		std::vector<GLuint> sphereIndex;
+		makeSphere(512, 256, sphereVertex, sphereIndex);
+		const auto t0(std::chrono::high_resolution_clock::now());
+		const Meshlets meshlets(pool, sphereVertex.data(), static_cast<GLsizei>(sphereVertex.size()),
+			sphereIndex.data(), static_cast<GLsizei>(sphereIndex.size()));
+		const double buildTime(Profiler::elapsed(t0));
+		GLsizei disabled(0);
+		for (GLsizei i = 0; i < meshlets.getCount(); ++i) if (meshlets.get(i).cutoff >= 1.0f) ++disabled;
+		out << "build: " << meshlets.getCount() << " meshlets, " << static_cast<double>(meshlets.getIndexCount()) / 3 / meshlets.getCount()
+			<< " triangles / meshlet, " << disabled << " without a normal cone, " << buildTime << " ms" << std::endl;
+
+		MeshBuffer meshes(static_cast<GLsizei>(sphereVertex.size()), meshlets.getIndexCount());
+		const MeshBuffer::Mesh sphere(meshes.get(meshes.add(static_cast<GLsizei>(sphereVertex.size()), sphereVertex.data(),
+			meshlets.getIndexCount(), meshlets.getIndices())));
+
+		static const Material color = { 0.6f, 0.6f, 0.2f, 1.0f, 0.0f, 1.0f, 0.3f, 0.3f, 0.3f, 30.0f, 0 };
+		const Uniform<Material> material(&color, 1);
+
+		GLint viewport[4];
+		glGetIntegerv(GL_VIEWPORT, viewport);
+		const Matrix projection(Matrix::perspective(1.0f,
+			static_cast<GLfloat>(viewport[2]) / static_cast<GLfloat>(viewport[3]), 1.0f, 100.0f));
+
+		//AetVF[_[
+		const Vector light = { 0.0f, 0.0f, 1.0f, 0.0f };
+		static const GLfloat Lamb[] = { 0.2f, 0.2f, 0.2f, 0.0f, 0.0f, 0.0f };
+		static const GLfloat Ldiff[] = { 0.5f, 0.5f, 0.5f, 0.0f, 0.0f, 0.0f };
+		static const GLfloat Lspec[] = { 0.5f, 0.5f, 0.5f, 0.0f, 0.0f, 0.0f };
+		const GLProgram program(loadProgram("batch.vert", "point.frag"));
+		glUniformBlockBinding(program.get(), glGetUniformBlockIndex(program.get(), "Material"), 0);
+		glUseProgram(program.get());
+		glUniformMatrix4fv(glGetUniformLocation(program.get(), "projection"), 1, GL_FALSE, projection.data());
+		glUniform4fv(glGetUniformLocation(program.get(), "Lpos"), 1, light.data());
+		glUniform3fv(glGetUniformLocation(program.get(), "Lamb"), 2, Lamb);
+		glUniform3fv(glGetUniformLocation(program.get(), "Ldiff"), 2, Ldiff);
+		glUniform3fv(glGetUniformLocation(program.get(), "Lspec"), 2, Lspec);
+		glUniform1i(glGetUniformLocation(program.get(), "pointLightCount"), 0);
+		glUniform1i(glGetUniformLocation(program.get(), "cascadeCount"), 0);
+		glUniform1i(glGetUniformLocation(program.get(), "shadowMap"), 1);
+		glUniform1i(glGetUniformLocation(program.get(), "probeMap"), 2);
+		glEnable(GL_DEPTH_TEST);
+		glEnable(GL_CULL_FACE);
+
+		//ƂɌς
+		std::vector<Matrix> modelview;
+		for (int i = 0; i < columns * rows; ++i) {
+			modelview.push_back(Matrix::translate(static_cast<GLfloat>(i % columns) * 2.5f - 8.75f,
+				static_cast<GLfloat>(i / columns) * 2.5f - 2.5f, -8.0f)
+				* Matrix::rotate(static_cast<GLfloat>(i) * 0.7f, 0.3f, 1.0f, 0.2f));
+		}
+
+		//Ŝ`ƂƃbVbĝĂƂŕ`掞ԂƉ摜ׂ
+		IndirectBatch batch(meshes);
+		std::vector<MeshBuffer::Mesh> ranges(meshlets.getCount());
+		std::vector<GLubyte> image[2];
+		static const char* const names[] = {
+			"full mesh:           ",
+			"meshlet culled:      "
+		};
+		Meshlets::Stats stats = Meshlets::Stats();
+		for (int mode = 0; mode < 2; ++mode) {
+			batch.clear();
+			for (const Matrix& m : modelview) {
+				if (mode == 0) batch.add(sphere, m);
+				else batch.add(ranges.data(), meshlets.cull(sphere, m, projection, ranges.data(), stats), m);
+			}
+			double time(0.0);
+			for (int f = 0; f < frames; ++f) {
+				glFinish();
+				const auto t1(std::chrono::high_resolution_clock::now());
+				glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+				batch.draw(GL_TRIANGLES, material);
+				glFinish();
+				time += Profiler::elapsed(t1);
+			}
+			image[mode].resize(viewport[2] * viewport[3] * 4);
+			glReadPixels(0, 0, viewport[2], viewport[3], GL_RGBA, GL_UNSIGNED_BYTE, image[mode].data());
+			out << names[mode] << time / frames << " ms, " << batch.getDrawCount() << " ranges" << std::endl;
+		}
+
+		//JO̎Ԃ̃XbhƑSXbhŌv
+		const auto run = [&](bool parallel) {
+			Meshlets::Stats s = Meshlets::Stats();
+			for (int f = 0; f < 100; ++f)
+				for (const Matrix& m : modelview) meshlets.cull(sphere, m, projection, ranges.data(), s, parallel);
+			return s.cullTime / 100;
+		};
+		out << "cull, 1 thread:      " << run(false) << " ms / frame" << std::endl;
+		out << "cull, " << pool.size() << " threads:     " << run(true) << " ms / frame" << std::endl;
+
+		std::size_t differences(0);
+		for (std::size_t i = 0; i < image[0].size(); ++i) if (image[0][i] != image[1][i]) ++differences;
+		const GLsizei total(stats.triangles + stats.rejected);
+		out << "triangles: " << stats.triangles << " / " << total << " drawn, " << stats.rejected << " rejected ("
+			<< 100.0 * stats.rejected / total << "%), meshlets: " << stats.backfacing << " back-facing, "
+			<< stats.outside << " outside / " << stats.tested << std::endl;
+		out << columns * rows << " spheres, " << differences << " bytes differ from the full mesh" << std::endl;
+	}
+
+	//50̃p[eBNϕċlߒXbh̐ƂɌvA]ƕ`GPUł̐ϕ̎ԂƔׂ
+	static void particles(std::ostream& out) {
+		//p[eBN̐̏ƎiςŐɂނ荇悤ɕoj
+		const std::size_t capacity(500000);
+		const GLfloat life(2.0f), dt(1.0f / 60.0f);
+
+		//vt[
+		const int frames(60);
+
+		ThreadPool pool;
+		Particles system(pool, capacity);
+		Particles::Emitter emitter(system.getEmitter());
+		emitter.life = life;
+		emitter.spread = 1.5f;
+		emitter.rate = static_cast<GLfloat>(capacity) / life;
+		system.setEmitter(emitter);
+
+		//̊Ԑi߂Đɂނ荇悤ɂĂ
+		for (int f = 0; f < static_cast<int>(life / dt); ++f) system.simulate(dt);
+
+		//̃XbhƑSXbhŐϕ
+		const auto run = [&](bool parallel) {
+			double time(0.0);
+			std::size_t updated(0);
+			for (int f = 0; f < frames; ++f) {
+				updated += system.size();
+				system.simulate(dt, parallel);
+				time += system.getStats().simulateTime + system.getStats().emitTime;
+			}
+			return static_cast<double>(updated) / time;
+		};
+		const double single(run(false)), all(run(true));
+		out << "1 thread:           " << single << " particles / ms" << std::endl;
+		out << pool.size() << " threads:          " << all << " particles / ms, " << all / pool.size() << " / ms / core" << std::endl;
+		out << "alive " << system.size() << " / " << capacity << ", emitted " << system.getStats().emitted
+			<< " and died " << system.getStats().died << " in the last frame" << std::endl;
+
+		//`̏
+		GLint viewport[4];
+		glGetIntegerv(GL_VIEWPORT, viewport);
+		const Matrix projection(Matrix::perspective(1.0f,
+			static_cast<GLfloat>(viewport[2]) / static_cast<GLfloat>(viewport[3]), 1.0f, 100.0f));
+		const Matrix view(Matrix::lookat(0.0f, 1.0f, 8.0f, 0.0f, 1.0f, 0.0f, 0.0f, 1.0f, 0.0f));
+		glEnable(GL_DEPTH_TEST);
+
+		//CPUŐϕē]ĕ`ƂGPUŐϕĕ`Ƃ̃t[Ԃׂ
+		static const char* const names[] = {
+			"CPU + stream upload:",
+			"transform feedback: "
+		};
+		for (int mode = 0; mode < 2; ++mode) {
+			system.setGpu(mode == 1);
+			for (int f = 0; f < static_cast<int>(life / dt); ++f) system.update(dt);
+			glFinish();
+			double time(0.0), upload(0.0);
+			for (int f = 0; f < frames / 4; ++f) {
+				const auto t0(std::chrono::high_resolution_clock::now());
+				system.update(dt);
+				glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+				system.draw(view, projection);
+				glFinish();
+				time += Profiler::elapsed(t0);
+				upload += system.getStats().uploadTime;
+			}
+			if (mode == 1 && !system.isGpu()) {
+				out << names[mode] << " not supported" << std::endl;
+				break;
+			}
+			out << names[mode] << " " << time / (frames / 4) << " ms / frame (upload or dispatch " << upload / (frames / 4)
+				<< " ms), " << system.size() << " particles" << std::endl;
+		}
+	}
+
+	//1̔Ɛ̋ƕ𖈃t[L^ĕ`ԂXbh̐ƂɌvAƂɕ`施߂𔭍sꍇƔׂ
+	static void debugdraw(std::ostream& out) {
+#if DEBUG_DRAW
+		//Ƌ̐ƌvt[
+		const int boxes(10000), spheres(1000), frames(10);
+
+		ThreadPool pool;
+		DebugDraw debug(pool.size());
+		GLint viewport[4];
+		glGetIntegerv(GL_VIEWPORT, viewport);
+		const Matrix viewProjection(Matrix::perspective(1.0f,
+			static_cast<GLfloat>(viewport[2]) / static_cast<GLfloat>(viewport[3]), 1.0f, 100.0f)
+			* Matrix::lookat(0.0f, 0.0f, 30.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f));
+
+		//Ƌ64̎dɕċL^
+		const unsigned int jobs(64);
+		const auto record = [&](unsigned int job, unsigned int thread) {
+			for (int i = job; i < boxes; i += jobs) {
+				const GLfloat x(static_cast<GLfloat>(i % 100) * 0.2f - 10.0f), y(static_cast<GLfloat>(i / 100) * 0.2f - 10.0f);
+				const GLfloat min[] = { x, y, 0.0f }, max[] = { x + 0.1f, y + 0.1f, 0.1f };
+				debug.box(min, max, DebugDraw::color(0.0f, 1.0f, 0.0f), thread);
+			}
+			for (int i = job; i < spheres; i += jobs) {
+				const GLfloat center[] = { static_cast<GLfloat>(i % 40) * 0.5f - 10.0f, static_cast<GLfloat>(i / 40) * 0.8f - 10.0f, 1.0f };
+				debug.sphere(center, 0.2f, DebugDraw::color(1.0f, 1.0f, 0.0f, 0.5f), thread);
+			}
+		};
+		const auto run = [&](bool parallel, double& upload, double& draw) {
+			double time(0.0);
+			upload = draw = 0.0;
+			for (int f = 0; f < frames; ++f) {
+				const auto t0(std::chrono::high_resolution_clock::now());
+				debug.clear();
+				if (parallel) pool.parallelFor(jobs, record);
+				else for (unsigned int job = 0; job < jobs; ++job) record(job, 0);
+				debug.text(16.0f, 16.0f, "DEBUG DRAW 0123456789\nthe quick brown fox", DebugDraw::color(1.0f, 1.0f, 1.0f));
+				time += Profiler::elapsed(t0);
+
+				glFinish();
+				const auto t1(std::chrono::high_resolution_clock::now());
+				debug.upload();
+				upload += Profiler::elapsed(t1);
+				glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+				debug.draw(viewProjection, viewport);
+				glFinish();
+				draw += Profiler::elapsed(t1);
+			}
+			upload /= frames;
+			draw /= frames;
+			return time / frames;
+		};
+		double upload, draw;
+		out << "record, 1 thread:   " << run(false, upload, draw) << " ms / frame" << std::endl;
+		out << "record, " << pool.size() << " threads:  " << run(true, upload, draw) << " ms / frame" << std::endl;
+		out << "upload + draw:      " << draw << " ms / frame (upload " << upload << " ms), " << debug.getStats().lines << " lines, "
+			<< debug.getStats().overlayTriangles << " overlay triangles, 2 draw calls" << std::endl;
+
+		//_𔠂ƂɈ̕`施߂ŕ`i}`Ƃɒ_zIuWFNg`ɋ߂j
+		double separate(0.0);
+		for (int f = 0; f < frames; ++f) {
+			glFinish();
+			const auto t0(std::chrono::high_resolution_clock::now());
+			glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+			for (int i = 0; i < boxes; ++i) glDrawArrays(GL_LINES, i * 24, 24);
+			glFinish();
+			separate += Profiler::elapsed(t0);
+		}
+		out << "one call per box:   " << separate / frames << " ms / frame, " << boxes << " draw calls" << std::endl;
+#else
+		out << "debug draw is compiled out (DEBUG_DRAW is 0)" << std::endl;
+#endif
+	}
+
+	//̏ɍׂuʂŌ̃v[uĂtAXbh̐Ƃ̌̐ƎԂv
+	static void probes(std::ostream& out) {
+		//v[ůiqƌ̐
+		static constexpr GLfloat min[] = { -6.0f, -1.5f, -6.0f }, max[] = { 6.0f, 2.5f, 6.0f };
+		static constexpr int count[] = { 8, 4, 8 };
+		const ProbeBaker::Settings settings = { 256, 2, { 0.2f, 0.1f, 0.1f }, { 0.267f, 0.802f, 0.535f }, { 1.0f, 0.5f, 0.5f } };
+
+		//Əi`j
+		std::vector<Object::Vertex> sphereVertex;
+		std::vector<GLuint> sphereIndex;
+		makeSphere(512, 256, sphereVertex, sphereIndex);
+		static const Object::Vertex groundVertex[] = {
+			{ -6.0f, -1.9f, -6.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f }, { -6.0f, -1.9f, 6.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f },
+			{ 6.0f, -1.9f, 6.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f }, { 6.0f, -1.9f, -6.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f }
+		};
+		static const GLuint groundIndex[] = { 0, 1, 2, 0, 2, 3 };
+		static const GLfloat magenta[] = { 1.0f, 0.0f, 1.0f }, gray[] = { 0.8f, 0.8f, 0.8f };
+		ProbeBaker baker;
+		baker.add(Matrix::identity(), sphereVertex.data(), sphereIndex.data(), static_cast<GLsizei>(sphereIndex.size()), magenta);
+		baker.add(Matrix::translate(0.0f, 0.0f, 3.0f), sphereVertex.data(), sphereIndex.data(), static_cast<GLsizei>(sphereIndex.size()), magenta);
+		baker.add(Matrix::identity(), groundVertex, groundIndex, 6, gray);
+		baker.build();
+		out << baker.getStats().triangles << " triangles, " << baker.getStats().nodes << " BVH nodes, built in "
+			<< baker.getStats().buildTime << " ms" << std::endl;
+
+		//Xbh̐{ɂȂĂtiʂ̓Xbh̐ɂ炸ɂȂ͂j
+		const unsigned int hardware(std::max(1u, std::thread::hardware_concurrency()));
+		std::vector<GLfloat> reference, coefficient;
+		double single(0.0);
+		out << "threads   bake (ms)   Mrays/s   speedup   steals   identical" << std::endl;
+		for (unsigned int threads = 1;; threads = std::min(threads * 2, hardware)) {
+			ThreadPool pool(threads);
+			baker.bake(pool, min, max, count, settings, coefficient);
+			const ProbeBaker::Stats& stats(baker.getStats());
+			if (threads == 1) {
+				single = stats.bakeTime;
+				reference = coefficient;
+			}
+			out << std::setw(7) << threads << std::setw(12) << stats.bakeTime
+				<< std::setw(10) << static_cast<double>(stats.rays) / stats.bakeTime * 1.0e-3
+				<< std::setw(10) << single / stats.bakeTime << std::setw(9) << stats.steals
+				<< std::setw(12) << (coefficient == reference ? "yes" : "no") << std::endl;
+			if (threads == hardware) break;
+		}
+		out << baker.getStats().rays << " rays, " << baker.getStats().invalid << " probes inside geometry filled from neighbors" << std::endl;
+
+		//ۑēǂݒA̐^ƊJ̏̕ˏƓxׂ
+		LightProbes grid;
+		grid.set(min, max, count, coefficient);
+		const char* const name("bench_probes.shpb");
+		LightProbes loaded;
+		if (grid.save(name) && loaded.load(name)) {
+			static const GLfloat up[] = { 0.0f, 1.0f, 0.0f };
+			static const GLfloat under[] = { 0.0f, -1.5f, 0.0f }, open[] = { -5.0f, -1.5f, -5.0f };
+			GLfloat a[3], b[3], c[3];
+			grid.irradiance(under, up, a);
+			grid.irradiance(open, up, b);
+			loaded.irradiance(open, up, c);
+			out << "file " << grid.fileSize() << " bytes; irradiance under sphere " << a[0] << " " << a[1] << " " << a[2]
+				<< ", open ground " << b[0] << " " << b[1] << " " << b[2] << " (loaded " << c[0] << " " << c[1] << " " << c[2] << ")" << std::endl;
+		}
+		std::remove(name);
+	}
+
+	//I𑜓x̊g̎Ԃ{ƂɌvi̐U镑SelfTestresolutionŊm߂j
+	static void resolution(std::ostream& out) {
+		//̃t[obt@ɔ{Ƃɕ`Ċg債AGPŮ܂ł̎Ԃv
+		GLint viewport[4];
+		glGetIntegerv(GL_VIEWPORT, viewport);
+		const GLProgram upscale(loadProgram("deferred.vert", "upscale.frag"));
+		DynamicResolution target(upscale.get());
+		const int passes(50);
+		out << "output " << viewport[2] << "x" << viewport[3] << std::endl;
+		out << " scale   pixels   upscale (ms)" << std::endl;
+		static const GLfloat scales[] = { 0.5f, 0.75f, 1.0f };
+		for (const GLfloat scale : scales) {
+			const GLint region[] = { 0, 0, static_cast<GLint>(viewport[2] * scale + 0.5f), static_cast<GLint>(viewport[3] * scale + 0.5f) };
+			target.begin(viewport);
+			target.end(region, viewport);
+			glFinish();
+			const auto t0(std::chrono::high_resolution_clock::now());
+			for (int i = 0; i < passes; ++i) {
+				target.begin(viewport);
+				glViewport(region[0], region[1], region[2], region[3]);
+				glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+				target.end(region, viewport);
+			}
+			glFinish();
+			out << std::setw(6) << scale << std::setw(9) << region[2] * region[3]
+				<< std::setw(15) << Profiler::elapsed(t0) / passes << std::endl;
+		}
+		glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+	}
+
+	//o^ꂽvo
+	static const Entry* entries(std::size_t& count) {
+		static const Entry table[] = {
+			{ "indirect", indirect },
+			{ "pool", pool },
+			{ "arena", arena },
+			{ "scene", scene },
+			{ "deferred", deferred },
+			{ "prepass", prepass },
+			{ "math", math },
+			{ "animation", animation },
+			{ "pick", pick },
+			{ "texture", texture },
+			{ "meshlet", meshlet },
+			{ "particles", particles },
+			{ "debugdraw", debugdraw },
+			{ "probes", probes },
+			{ "resolution", resolution },
+		};
+		count = sizeof table / sizeof table[0];
+		return table;
+	}
+
+public:
+	//vs
+	//name:v̖OiNULLȂ炷ׂāj
+	//out:ʂ̏o͐
+	//߂l:YvAm߂ׂĐ藧Ătrue
+	static bool run(const char* name, std::ostream& out) {
+		std::size_t count;
+		const Entry* const table(entries(count));
+		bool found(false);
+		failures() = 0;
+		for (std::size_t i = 0; i < count; ++i) {
+			if (name != NULL && std::strcmp(name, table[i].name) != 0) continue;
+			out << "=== " << table[i].name << " ===" << std::endl;
+			table[i].function(out);
+			found = true;
+		}
+		if (!found) {
+			std::cerr << "Error: Unknown benchmark: " << name << std::endl;
+			for (std::size_t i = 0; i < count; ++i) std::cerr << "  " << table[i].name << std::endl;
+		}
+		return found && failures() == 0;
+	}
+};
@@ -0,0 +1,400 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <algorithm>
+
+//obt@͈̔͂̊蓖āiTLSF: Two-Level Segregated Fitj
+//OpenGLgȂ̂ŒP̂œm߂
+//傫ƈʒu͒Pʁi_̐oCgȂǎgŌ߂jŕ\
+//󂫗̈傫̑ΐƂ̍וŕނĩXgŊǗA蓖ĂƉ萔Ԃōs
+class BufferAllocator {
+public:
+	//蓖Ă͈͂̃nh
+	typedef std::uint32_t Handle;
+
+	//ȃnh
+	static constexpr Handle Invalid = 0xffffffffu;
+
+	//v
+	struct Stats {
+		//Ŝ̑傫
+		std::size_t capacity;
+
+		//蓖čς݂̑傫
+		std::size_t used;
+
+		//ő̋󂫗̈̑傫
+		std::size_t largestFree;
+
+		//蓖Ă̐
+		std::size_t allocations;
+
+		//󂫗̈̐
+		std::size_t freeBlocks;
+	};
+
+private:
+	//ĩ̕rbg
+	static constexpr unsigned int SecondLevelBits = 4;
+	static constexpr unsigned int SecondLevelCount = 1u << SecondLevelBits;
+
+	//i̐
+	static constexpr unsigned int FirstLevelCount = 48;
+
+	//Xg̏I[
+	static constexpr std::uint32_t Null = 0xffffffffu;
+
+	//̈
+	struct Block {
+		//ʒuƑ傫
+		std::size_t offset, size;
+
+		//蓖ĂƂ̋E
+		std::size_t alignment;
+
+		//AhXőÖ̗
+		std::uint32_t prevPhys, nextPhys;
+
+		//󂫃Xg̑Ö̗
+		std::uint32_t prevFree, nextFree;
+
+		//󂫗̈Ȃtrue
+		bool free;
+
+		//gĂȂL^Ȃtrue
+		bool unused;
+	};
+
+	//̈̋L^
+	std::vector<Block> blocks;
+
+	//gĂȂL^̔ԍ
+	std::vector<std::uint32_t> unusedBlocks;
+
+	//󂫃Xg̐擪
+	std::uint32_t heads[FirstLevelCount][SecondLevelCount];
+
+	//󂫃Xg邩ǂ̃rbg
+	std::uint64_t firstBitmap;
+	std::uint32_t secondBitmap[FirstLevelCount];
+
+	//Ŝ̑傫
+	const std::size_t capacity;
+
+	//ŏ̑傫ƋE
+	const std::size_t granularity;
+
+	//蓖čς݂̑傫Ɛ
+	std::size_t used, allocations;
+
+	//ŏʂ̃rbg̈ʒu
+	static unsigned int log2(std::size_t x) {
+		unsigned int n(0);
+		while (x >>= 1) ++n;
+		return n;
+	}
+
+	//ŉʂ̃rbg̈ʒu
+	static unsigned int lowest(std::uint64_t x) {
+		unsigned int n(0);
+		while (!(x & 1)) {
+			x >>= 1;
+			++n;
+		}
+		return n;
+	}
+
+	//Eɂ낦
+	static std::size_t alignUp(std::size_t x, std::size_t alignment) {
+		return (x + alignment - 1) / alignment * alignment;
+	}
+
+	//傫烊Xg̈ʒu߂
+	void mapping(std::size_t size, unsigned int& fl, unsigned int& sl) const {
+		const std::size_t u(size / granularity);
+		fl = log2(u);
+		sl = fl >= SecondLevelBits
+			? static_cast<unsigned int>(u >> (fl - SecondLevelBits)) & (SecondLevelCount - 1)
+			: static_cast<unsigned int>(u << (SecondLevelBits - fl)) & (SecondLevelCount - 1);
+	}
+
+	//L^mۂ
+	std::uint32_t newBlock() {
+		if (!unusedBlocks.empty()) {
+			const std::uint32_t i(unusedBlocks.back());
+			unusedBlocks.pop_back();
+			blocks[i].unused = false;
+			return i;
+		}
+		blocks.push_back(Block());
+		blocks.back().unused = false;
+		return static_cast<std::uint32_t>(blocks.size() - 1);
+	}
+
+	//L^߂
+	void deleteBlock(std::uint32_t i) {
+		blocks[i].unused = true;
+		unusedBlocks.push_back(i);
+	}
+
+	//󂫃Xgɓ
+	void insert(std::uint32_t i) {
+		Block& b(blocks[i]);
+		unsigned int fl, sl;
+		mapping(b.size, fl, sl);
+		b.free = true;
+		b.prevFree = Null;
+		b.nextFree = heads[fl][sl];
+		if (b.nextFree != Null) blocks[b.nextFree].prevFree = i;
+		heads[fl][sl] = i;
+		firstBitmap |= std::uint64_t(1) << fl;
+		secondBitmap[fl] |= 1u << sl;
+	}
+
+	//󂫃XgO
+	void remove(std::uint32_t i) {
+		Block& b(blocks[i]);
+		unsigned int fl, sl;
+		mapping(b.size, fl, sl);
+		if (b.prevFree != Null) blocks[b.prevFree].nextFree = b.nextFree;
+		else heads[fl][sl] = b.nextFree;
+		if (b.nextFree != Null) blocks[b.nextFree].prevFree = b.prevFree;
+		if (heads[fl][sl] == Null) {
+			secondBitmap[fl] &= ~(1u << sl);
+			if (secondBitmap[fl] == 0) firstBitmap &= ~(std::uint64_t(1) << fl);
+		}
+		b.free = false;
+	}
+
+	//sizeȏ̋󂫗̈T
+	std::uint32_t find(std::size_t size) const {
+		//؂グĂ烊Xg̈ʒu߂Ƃ̃Xgׂ̗̈͂sizeȏɂȂ
+		const unsigned int f(log2(size / granularity));
+		const std::size_t rounded(f >= SecondLevelBits ? size + (granularity << (f - SecondLevelBits)) - granularity : size);
+		unsigned int fl, sl;
+		mapping(rounded, fl, sl);
+		if (fl < FirstLevelCount) {
+			std::uint32_t bits(secondBitmap[fl] & (~0u << sl));
+			if (bits == 0) {
+				const std::uint64_t first(fl + 1 < 64 ? firstBitmap & (~std::uint64_t(0) << (fl + 1)) : 0);
+				if (first != 0) {
+					fl = lowest(first);
+					bits = secondBitmap[fl];
+				}
+			}
+			if (bits != 0) return heads[fl][lowest(bits)];
+		}
+
+		//Ȃsize郊Xgǂsizeȏ̗̈T
+		//i󂫗̈悪傤Ǘv̑傫cĂȂƂɕKvɂȂj
+		if (rounded == size) return Null;
+		mapping(size, fl, sl);
+		if (fl >= FirstLevelCount) return Null;
+		for (std::uint32_t i(heads[fl][sl]); i != Null; i = blocks[i].nextFree) {
+			if (blocks[i].size >= size) return i;
+		}
+		return Null;
+	}
+
+	//̈ǐsizeŐ؂蕪Ďc󂫗̈ɂ
+	void splitTail(std::uint32_t i, std::size_t size) {
+		if (blocks[i].size - size < granularity) return;
+		const std::uint32_t j(newBlock());
+		Block& b(blocks[i]);
+		Block& r(blocks[j]);
+		r.offset = b.offset + size;
+		r.size = b.size - size;
+		r.alignment = granularity;
+		r.prevPhys = i;
+		r.nextPhys = b.nextPhys;
+		if (r.nextPhys != Null) blocks[r.nextPhys].prevPhys = j;
+		b.nextPhys = j;
+		b.size = size;
+		merge(j);
+	}
+
+	//󂫗̈iŐ󂫗̈ƂȂĂ󂫃Xgɓ
+	void merge(std::uint32_t i) {
+		//̋󂫗̈荞
+		const std::uint32_t n(blocks[i].nextPhys);
+		if (n != Null && blocks[n].free) {
+			remove(n);
+			blocks[i].size += blocks[n].size;
+			blocks[i].nextPhys = blocks[n].nextPhys;
+			if (blocks[i].nextPhys != Null) blocks[blocks[i].nextPhys].prevPhys = i;
+			deleteBlock(n);
+		}
+
+		//Ő󂫗̈Ɏ荞܂
+		const std::uint32_t p(blocks[i].prevPhys);
+		if (p != Null && blocks[p].free) {
+			remove(p);
+			blocks[p].size += blocks[i].size;
+			blocks[p].nextPhys = blocks[i].nextPhys;
+			if (blocks[p].nextPhys != Null) blocks[blocks[p].nextPhys].prevPhys = p;
+			deleteBlock(i);
+			insert(p);
+			return;
+		}
+		insert(i);
+	}
+
+	//Ŝ̋󂫗̈ɂ
+	void initialize() {
+		blocks.clear();
+		unusedBlocks.clear();
+		for (auto& h : heads) std::fill(h, h + SecondLevelCount, std::uint32_t(Null));
+		firstBitmap = 0;
+		std::fill(secondBitmap, secondBitmap + FirstLevelCount, 0u);
+		used = allocations = 0;
+
+		if (capacity < granularity) return;
+		const std::uint32_t i(newBlock());
+		blocks[i].offset = 0;
+		blocks[i].size = capacity / granularity * granularity;
+		blocks[i].alignment = granularity;
+		blocks[i].prevPhys = blocks[i].nextPhys = Null;
+		insert(i);
+	}
+
+public:
+	//RXgN^
+	//capacity:Ŝ̑傫
+	//granularity:ŏ̑傫ƋEi2ׂ̂j
+	BufferAllocator(std::size_t capacity, std::size_t granularity = 1)
+		:capacity(capacity), granularity(granularity)
+	{
+		initialize();
+	}
+
+	//͈͂蓖Ă
+	//size:傫
+	//alignment:ʒűEi2ׂ̂܂granularity̔{j
+	//߂l:nhi蓖ĂȂInvalidj
+	Handle allocate(std::size_t size, std::size_t alignment = 1) {
+		size = alignUp(std::max(size, std::size_t(1)), granularity);
+		alignment = alignUp(std::max(alignment, granularity), granularity);
+
+		//E낦邽߂̗]TĒT
+		const std::uint32_t i(find(size + alignment - granularity));
+		if (i == Null) return Invalid;
+		remove(i);
+
+		//O̗]󂫗̈ƂĐ؂藣
+		const std::size_t pad(alignUp(blocks[i].offset, alignment) - blocks[i].offset);
+		std::uint32_t k(i);
+		if (pad > 0) {
+			splitTail(i, pad);
+			k = blocks[i].nextPhys;
+			remove(k);
+			insert(i);
+		}
+
+		//̗]󂫗̈ƂĐ؂藣
+		splitTail(k, size);
+		blocks[k].free = false;
+		blocks[k].alignment = alignment;
+		used += blocks[k].size;
+		++allocations;
+		return k;
+	}
+
+	//͈͂
+	//handle:allocateœnh
+	void free(Handle handle) {
+		if (handle >= blocks.size() || blocks[handle].unused || blocks[handle].free) return;
+		used -= blocks[handle].size;
+		--allocations;
+		merge(handle);
+	}
+
+	//ׂĂ̊蓖Ă
+	void reset() {
+		initialize();
+	}
+
+	//蓖Ă͈͂̈ʒu
+	std::size_t offset(Handle handle) const { return blocks[handle].offset; }
+
+	//蓖Ă͈͂̑傫i؂グ̑傫j
+	std::size_t size(Handle handle) const { return blocks[handle].size; }
+
+	//蓖Ă͈͂擪ɋl߂ċ󂫗̈ɂ܂Ƃ߂
+	//move:move(from, to, size)̌`ňړƂɌĂяoito͏fromȉŁA擪珇ɌĂԁj
+	//nh͂̂܂܎g邪ʒu͕ς
+	template<typename F>
+	void defragment(F move) {
+		//AhXɊ蓖čς݂̗̈W߂
+		std::vector<std::uint32_t> live;
+		live.reserve(allocations);
+		std::uint32_t first(Null);
+		for (std::uint32_t i = 0; i < blocks.size(); ++i) {
+			if (!blocks[i].unused && blocks[i].prevPhys == Null) first = i;
+		}
+		for (std::uint32_t i = first; i != Null; i = blocks[i].nextPhys) {
+			if (blocks[i].free) {
+				remove(i);
+				deleteBlock(i);
+			}
+			else live.push_back(i);
+		}
+
+		//擪l߂ĕג
+		std::size_t cursor(0);
+		std::uint32_t prev(Null);
+		for (const std::uint32_t i : live) {
+			const std::size_t to(alignUp(cursor, blocks[i].alignment));
+
+			//E낦邽߂̌Ԃ͋󂫗̈ɂ
+			if (to > cursor) {
+				const std::uint32_t g(newBlock());
+				blocks[g].offset = cursor;
+				blocks[g].size = to - cursor;
+				blocks[g].alignment = granularity;
+				blocks[g].prevPhys = prev;
+				if (prev != Null) blocks[prev].nextPhys = g;
+				insert(g);
+				prev = g;
+			}
+
+			if (blocks[i].offset != to) move(blocks[i].offset, to, blocks[i].size);
+			blocks[i].offset = to;
+			blocks[i].prevPhys = prev;
+			if (prev != Null) blocks[prev].nextPhys = i;
+			prev = i;
+			cursor = to + blocks[i].size;
+		}
+
+		//c̋󂫗̈ɂ
+		const std::size_t end(capacity / granularity * granularity);
+		if (cursor < end) {
+			const std::uint32_t g(newBlock());
+			blocks[g].offset = cursor;
+			blocks[g].size = end - cursor;
+			blocks[g].alignment = granularity;
+			blocks[g].prevPhys = prev;
+			if (prev != Null) blocks[prev].nextPhys = g;
+			insert(g);
+			prev = g;
+		}
+		if (prev != Null) blocks[prev].nextPhys = Null;
+	}
+
+	//v߂
+	Stats getStats() const {
+		Stats stats = { capacity, used, 0, allocations, 0 };
+		for (const auto& b : blocks) {
+			if (b.unused || !b.free) continue;
+			stats.largestFree = std::max(stats.largestFree, b.size);
+			++stats.freeBlocks;
+		}
+		return stats;
+	}
+
+	//Ŝ̑傫
+	std::size_t getCapacity() const { return capacity; }
+
+	//蓖čς݂̑傫
+	std::size_t getUsed() const { return used; }
+};
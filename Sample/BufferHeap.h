@@ -0,0 +1,133 @@
+#pragma once
+#include <algorithm>
+#include <GL/glew.h>
+
+//OpenGL̃IuWFNg̃nh
+#include "GLHandle.h"
+
+//͈͂̊蓖
+#include "BufferAllocator.h"
+
+//GPU̎gpʂ̋L^
+#include "GpuMemory.h"
+
+//傫ȃobt@IuWFNgmۂÄꕔ蓖ĂĎg
+//ʒu傫͒PʁiunitoCgjŕ\
+//f[^̓]ɂ͌|CgGL_COPY_WRITE_BUFFERĝŒ_zIuWFNg̏Ԃ͕ςȂ
+class BufferHeap {
+public:
+	//蓖Ă͈͂̃nh
+	typedef BufferAllocator::Handle Handle;
+
+private:
+	//obt@IuWFNg
+	GLBuffer buffer;
+
+	//Pʂ̃oCg
+	const GLsizeiptr unit;
+
+	//͈͂̊蓖
+	BufferAllocator allocator;
+
+	//GPU̎
+	const GpuMemory::Category category;
+
+	//Rs[֎~
+	BufferHeap(const BufferHeap&) = delete;
+	BufferHeap& operator=(const BufferHeap&) = delete;
+
+public:
+	//RXgN^
+	//capacity:mۂPʂ̐
+	//unit:Pʂ̃oCg
+	//category:GPU̎
+	//usage:obt@IuWFNg̎g
+	BufferHeap(std::size_t capacity, GLsizeiptr unit, GpuMemory::Category category, GLenum usage = GL_STATIC_DRAW)
+		:buffer(GLBuffer::create()), unit(unit), allocator(capacity), category(category)
+	{
+		glBindBuffer(GL_COPY_WRITE_BUFFER, buffer.get());
+		glBufferData(GL_COPY_WRITE_BUFFER, capacity * unit, NULL, usage);
+		GpuMemory::instance().allocate(category, capacity * unit);
+	}
+
+	//fXgN^
+	virtual ~BufferHeap() {
+		GpuMemory::instance().release(category, allocator.getCapacity() * unit);
+	}
+
+	//͈͂蓖Ă
+	//count:Pʂ̐
+	//alignment:ʒűE̒Pʂ̐
+	//data:]f[^iNULLȂ]Ȃj
+	//߂l:nhi蓖ĂȂBufferAllocator::Invalidj
+	Handle allocate(std::size_t count, std::size_t alignment = 1, const void* data = NULL) {
+		const Handle handle(allocator.allocate(count, alignment));
+		if (handle != BufferAllocator::Invalid && data != NULL) upload(handle, data, count);
+		return handle;
+	}
+
+	//͈͂
+	void free(Handle handle) {
+		allocator.free(handle);
+	}
+
+	//蓖Ă͈͂Ƀf[^]
+	//handle:蓖Ă͈
+	//data:]f[^
+	//count:Pʂ̐
+	//first:͈͂̐擪琔]̈ʒu
+	void upload(Handle handle, const void* data, std::size_t count, std::size_t first = 0) const {
+		glBindBuffer(GL_COPY_WRITE_BUFFER, buffer.get());
+		glBufferSubData(GL_COPY_WRITE_BUFFER, (allocator.offset(handle) + first) * unit, count * unit, data);
+	}
+
+	//蓖Ă͈͂擪ɋl߂
+	//ړnḧʒuς̂ŁAg͈ʒuo
+	//߂l:ړ͈͂̐
+	unsigned int defragment() {
+		unsigned int moves(0);
+
+		//dȂړ̂߂̈ꎞIȃobt@IuWFNg
+		GLBuffer scratch;
+		GLsizeiptr scratchSize(0);
+
+		glBindBuffer(GL_COPY_READ_BUFFER, buffer.get());
+		glBindBuffer(GL_COPY_WRITE_BUFFER, buffer.get());
+		allocator.defragment([&](std::size_t from, std::size_t to, std::size_t size) {
+			const GLsizeiptr bytes(size * unit);
+			if (to + size <= from) {
+				//dȂȂ΂̂܂ܕʂ
+				glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, from * unit, to * unit, bytes);
+			}
+			else {
+				//dȂƂ͈ꎞIȃobt@IuWFNgoR
+				if (bytes > scratchSize) {
+					if (!scratch) scratch = GLBuffer::create();
+					scratchSize = bytes;
+					glBindBuffer(GL_COPY_WRITE_BUFFER, scratch.get());
+					glBufferData(GL_COPY_WRITE_BUFFER, scratchSize, NULL, GL_STREAM_COPY);
+				}
+				glBindBuffer(GL_COPY_WRITE_BUFFER, scratch.get());
+				glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, from * unit, 0, bytes);
+				glBindBuffer(GL_COPY_READ_BUFFER, scratch.get());
+				glBindBuffer(GL_COPY_WRITE_BUFFER, buffer.get());
+				glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, to * unit, bytes);
+				glBindBuffer(GL_COPY_READ_BUFFER, buffer.get());
+			}
+			++moves;
+		});
+		return moves;
+	}
+
+	//obt@IuWFNg
+	GLuint name() const { return buffer.get(); }
+
+	//蓖Ă͈͂̈ʒuiPʂ̐j
+	std::size_t offset(Handle handle) const { return allocator.offset(handle); }
+
+	//蓖Ă͈͂̈ʒuioCgj
+	GLintptr byteOffset(Handle handle) const { return static_cast<GLintptr>(allocator.offset(handle) * unit); }
+
+	//蓖Ă̓v
+	BufferAllocator::Stats getStats() const { return allocator.getStats(); }
+};
@@ -0,0 +1,386 @@
+#pragma once
+#include <cmath>
+#include <chrono>
+#include <memory>
+#include <limits>
+#include <vector>
+#include <algorithm>
+#include <iostream>
+#include <GL/glew.h>
+
+//ϊsƃxNg
+#include "Matrix.h"
+#include "vector.h"
+
+//OpenGL̃IuWFNg̏L
+#include "GLHandle.h"
+
+//GPU̎gpʂ̋L^
+#include "GpuMemory.h"
+
+//`܂Ƃ߂Ĕs
+#include "IndirectBatch.h"
+
+//v
+#include "Profiler.h"
+
+//s̃JXP[hVhE}bv
+//J̎sɕAƂɂ͈̔͂͂ޒ𓊉eŃfvX`
+//`悷Ƃ̓tOg̉sŕIсAPCFŉeW{ipoint.fragj
+//update:ƌ̒𓊉e͈̔͂߂
+//record:e𗎂Ƃ̂𕪊ƂɃJOăob`ɏW߂iOpenGLĂ΂Ȃj
+//render:ƂɃfvX`
+//t[obt@IuWFNgƃNG̓ReLXg̊ԂŋLȂ̂ŁArender͈̃ReLXgŌĂ
+class CascadedShadow {
+public:
+	//̍ő吔ipoint.fragƍ킹j
+	static constexpr int MaxCascades = 4;
+
+	//v
+	struct Stats {
+		//Ƃ̉e𗎂Ƃ̂̐
+		unsigned int casters[MaxCascades];
+
+		//Ƃ̕`̔sɂԁi~bj
+		double submitTime[MaxCascades];
+
+		//ƂGPU̕`掞ԁi~bAvłȂ0j
+		double gpuTime[MaxCascades];
+
+		//recordɂԁi~bj
+		double cullTime;
+	};
+
+private:
+	//fvX`vOIuWFNg
+	const GLuint program;
+
+	//fvX`vO̓eϊsuniformϐ̏ꏊ
+	const GLint projectionLoc;
+
+	//̐
+	const int count;
+
+	//VhE}bv̉𑜓x
+	const GLsizei resolution;
+
+	//ΐƋϓ銄i1Ȃΐj
+	GLfloat lambda;
+
+	//VhE}bviƂ̑wfvXeNX`̔zj
+	GLTexture texture;
+
+	//VhE}bvɕ`t[obt@IuWFNgiŏrenderō쐬j
+	GLFramebuffer framebuffer;
+
+	//t[obt@IuWFNggȂtrue
+	bool incomplete;
+
+	//ƂGPU̕`掞Ԃ𑪂NG
+	GLQuery queries[MaxCascades];
+
+	//ʂ҂ĂNG
+	bool pending[MaxCascades];
+
+	//GL_ARB_timer_querygtrue
+	const bool timer;
+
+	//̃r[ϊs
+	Matrix lightView;
+
+	//J̃r[ϊs̋ts
+	Matrix cameraInverse;
+
+	//Ƃ̉̎_̋
+	GLfloat splits[MaxCascades];
+
+	//Ƃ̌̍Wnł͈̔
+	GLfloat boundsMin[MaxCascades][3], boundsMax[MaxCascades][3];
+
+	//Ƃ̌̒𓊉eϊs
+	Matrix projection[MaxCascades];
+
+	//Ƃ̃J̎_WnVhE}bṽeNX`Wւ̕ϊs
+	Matrix shadowMatrix[MaxCascades];
+
+	//Ƃ̉e𗎂Ƃ̂̕`
+	std::vector<std::unique_ptr<IndirectBatch>> batches;
+
+	//v
+	Stats stats;
+
+	//Rs[֎~
+	CascadedShadow(const CascadedShadow&) = delete;
+	CascadedShadow& operator=(const CascadedShadow&) = delete;
+
+	//VhE}bṽoCg
+	std::size_t bytes() const {
+		return static_cast<std::size_t>(resolution) * resolution * count * 4;
+	}
+
+public:
+	//RXgN^
+	//meshes:e𗎂Ƃ}`i[obt@
+	//program:fvX`vOIuWFNgishadow.vert, shadow.fragj
+	//cascades:̐i1`MaxCascadesj
+	//resolution:VhE}bv̉𑜓x
+	CascadedShadow(const MeshBuffer& meshes, GLuint program, int cascades = 3, GLsizei resolution = 1024)
+		:program(program), projectionLoc(glGetUniformLocation(program, "projection"))
+		, count(std::min(std::max(cascades, 1), static_cast<int>(MaxCascades))), resolution(resolution), lambda(0.5f)
+		, texture(GLTexture::create()), incomplete(false), pending()
+		, timer(GLEW_ARB_timer_query != GL_FALSE)
+		, lightView(Matrix::identity()), cameraInverse(Matrix::identity()), splits(), boundsMin(), boundsMax()
+		, stats()
+	{
+		for (int c = 0; c < count; ++c) {
+			projection[c] = shadowMatrix[c] = Matrix::identity();
+			batches.emplace_back(new IndirectBatch(meshes));
+		}
+
+		//VhE}bv쐬
+		//r[hɂƐ`Ԃ2~2̕W{̔rʂς
+		glBindTexture(GL_TEXTURE_2D_ARRAY, texture.get());
+		glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_DEPTH_COMPONENT24, resolution, resolution, count, 0,
+			GL_DEPTH_COMPONENT, GL_FLOAT, NULL);
+		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_COMPARE_MODE, GL_COMPARE_REF_TO_TEXTURE);
+		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_COMPARE_FUNC, GL_LEQUAL);
+		glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+		GpuMemory::instance().allocate(GpuMemory::Texture, bytes());
+	}
+
+	//fXgN^
+	virtual ~CascadedShadow() {
+		GpuMemory::instance().release(GpuMemory::Texture, bytes());
+	}
+
+	//ΐƋϓ銄ݒ肷
+	//l:0ȂϓA1Ȃΐ
+	void setSplitLambda(GLfloat l) { lambda = l; }
+
+	//̕ݒ肷
+	//light:[hWň̕iɌj
+	void setLight(const Vector& light) {
+		//̕ƕsɂȂȂI
+		const GLfloat d(std::sqrt(light[0] * light[0] + light[1] * light[1] + light[2] * light[2]));
+		const bool vertical(d > 0.0f && std::fabs(light[1]) > 0.99f * d);
+		lightView = Matrix::lookat(0.0f, 0.0f, 0.0f, -light[0], -light[1], -light[2],
+			vertical ? 1.0f : 0.0f, vertical ? 0.0f : 1.0f, 0.0f);
+	}
+
+	//J̎𕪊āAƂɌ̍Wnł͈̔͂߂
+	//view:J̃r[ϊs
+	//fovy, aspect, zNear, zFar:J̓ẻpAcAOʂƌʂ̋
+	void update(const Matrix& view, GLfloat fovy, GLfloat aspect, GLfloat zNear, GLfloat zFar) {
+		cameraInverse = view.inverse();
+		const Matrix toLight(lightView * cameraInverse);
+		const GLfloat t(std::tan(fovy * 0.5f));
+
+		GLfloat previous(zNear);
+		for (int c = 0; c < count; ++c) {
+			//ΐƋϓĕ̉̋߂
+			const GLfloat s(static_cast<GLfloat>(c + 1) / static_cast<GLfloat>(count));
+			const GLfloat logarithmic(zNear * std::pow(zFar / zNear, s));
+			const GLfloat uniform(zNear + (zFar - zNear) * s);
+			splits[c] = lambda * logarithmic + (1.0f - lambda) * uniform;
+
+			//̎8_̍WnɈڂĉs͈̔͂߂
+			GLfloat* const lo(boundsMin[c]);
+			GLfloat* const hi(boundsMax[c]);
+			lo[2] = std::numeric_limits<GLfloat>::max();
+			hi[2] = -std::numeric_limits<GLfloat>::max();
+			for (int k = 0; k < 8; ++k) {
+				const GLfloat z((k & 4) ? splits[c] : previous);
+				const GLfloat y(z * t), x(y * aspect);
+				const Vector p(toLight * Vector{ (k & 1) ? x : -x, (k & 2) ? y : -y, -z, 1.0f });
+				lo[2] = std::min(lo[2], p[2]);
+				hi[2] = std::max(hi[2], p[2]);
+			}
+
+			//c͈͕̔͂̎͂ދŌ߁AJĂ傫ςȂ悤ɂ
+			//̒S͑O̖ʂ̎l܂ł̋Ȃ鎋̓_iʂzȂʂ̒Sj
+			const GLfloat n2(previous * previous * t * t * (1.0f + aspect * aspect));
+			const GLfloat f2(splits[c] * splits[c] * t * t * (1.0f + aspect * aspect));
+			const GLfloat center(std::min(0.5f * (previous + splits[c]) + 0.5f * (f2 - n2) / (splits[c] - previous), splits[c]));
+			const GLfloat back(splits[c] - center);
+
+			//a؂グĕ_̌덷ő傫hȂ悤ɂ
+			const GLfloat radius(std::ceil(std::sqrt(back * back + f2) * 16.0f) / 16.0f);
+
+			//JƂɉêӂȂ悤ɁAS傫̃eNZ̊iqɂ낦
+			const GLfloat texel(2.0f * radius / static_cast<GLfloat>(resolution));
+			const Vector o(toLight * Vector{ 0.0f, 0.0f, -center, 1.0f });
+			for (int i = 0; i < 2; ++i) {
+				const GLfloat snapped(std::floor(o[i] / texel) * texel);
+				lo[i] = snapped - radius;
+				hi[i] = snapped + radius;
+			}
+
+			previous = splits[c];
+		}
+	}
+
+	//e𗎂Ƃ̂W߂iOpenGLĂ΂Ȃ̂łق̃XbhŎsłj
+	//f:f(shadow)̌`ŌĂяoAaddCasterŕ̂ǉ
+	template<typename F>
+	void record(F f) {
+		const auto t0(std::chrono::high_resolution_clock::now());
+		for (int c = 0; c < count; ++c) {
+			batches[c]->clear();
+			stats.casters[c] = 0;
+		}
+
+		f(*this);
+
+		//e𗎂Ƃ̂悤ɑOʂɍLĒ𓊉eϊs߂
+		//oCAXs[-1, 1]͈̔͂eNX`W[0, 1]Ɉڂ
+		static constexpr GLfloat biasMatrix[] = {
+			0.5f, 0.0f, 0.0f, 0.0f,
+			0.0f, 0.5f, 0.0f, 0.0f,
+			0.0f, 0.0f, 0.5f, 0.0f,
+			0.5f, 0.5f, 0.5f, 1.0f
+		};
+		const Matrix bias(biasMatrix);
+		for (int c = 0; c < count; ++c) {
+			projection[c] = Matrix::orthogonal(boundsMin[c], boundsMax[c]);
+			shadowMatrix[c] = bias * projection[c] * lightView * cameraInverse;
+		}
+		stats.cullTime = Profiler::elapsed(t0);
+	}
+
+	//e𗎂Ƃ̂ǉirecordɓn̒ŌĂԁj
+	//̍Wnŕ̂͂ދ͈̔͂ɂ邩A͈͂ɂΕɒǉ
+	//mesh:}`
+	//world:[hWnւ̕ϊs
+	//radius:}`͂ދ̔a
+	//߂l:ǂꂩ̕ɒǉtrue
+	bool addCaster(const MeshBuffer::Mesh& mesh, const Matrix& world, GLfloat radius = 1.0f) {
+		const Matrix modelview(lightView * world);
+
+		//̍Wnł̒SƔa
+		GLfloat s(0.0f);
+		for (int i = 0; i < 3; ++i) {
+			const GLfloat* const m(&modelview[i * 4]);
+			s = std::max(s, m[0] * m[0] + m[1] * m[1] + m[2] * m[2]);
+		}
+		const GLfloat r(radius * std::sqrt(s));
+		const GLfloat x(modelview[12]), y(modelview[13]), z(modelview[14]);
+
+		GLfloat normalMatrix[9];
+		bool added(false);
+		for (int c = 0; c < count; ++c) {
+			GLfloat* const lo(boundsMin[c]);
+			GLfloat* const hi(boundsMax[c]);
+
+			//͈͂̉ɂ͂ݏoĂ邩A͈͂艜ɂΉe𗎂ƂȂ
+			if (x + r < lo[0] || x - r > hi[0] || y + r < lo[1] || y - r > hi[1] || z + r < lo[2]) continue;
+
+			//͈͂ɂΑOʂL
+			hi[2] = std::max(hi[2], z + r);
+
+			if (!added) modelview.getNormalMatrix(normalMatrix);
+			batches[c]->add(mesh, modelview, normalMatrix);
+			++stats.casters[c];
+			added = true;
+		}
+		return added;
+	}
+
+	//ƂɃfvX`iIƃt[obt@͊ɖ߂j
+	//material:ގ̃jtH[obt@IuWFNgiIndirectBatch::drawɓnj
+	//context:݂̃ReLXg̔ԍ
+	void render(const Uniform<Material>& material, unsigned int context = 0) {
+		//t[obt@IuWFNg݂̃ReLXgō쐬
+		if (!framebuffer && !incomplete) {
+			framebuffer = GLFramebuffer::create();
+			glBindFramebuffer(GL_FRAMEBUFFER, framebuffer.get());
+			glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, texture.get(), 0, 0);
+			glDrawBuffer(GL_NONE);
+			glReadBuffer(GL_NONE);
+			if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+				std::cerr << "Error: Shadow map framebuffer is incomplete." << std::endl;
+				incomplete = true;
+			}
+			if (timer) for (int c = 0; c < count; ++c) queries[c] = GLQuery::create();
+		}
+		if (incomplete) {
+			glBindFramebuffer(GL_FRAMEBUFFER, 0);
+			return;
+		}
+
+		glBindFramebuffer(GL_FRAMEBUFFER, framebuffer.get());
+		glViewport(0, 0, resolution, resolution);
+		glUseProgram(program);
+
+		//e̎ȎՕh߂ɃfvX炷
+		glEnable(GL_POLYGON_OFFSET_FILL);
+		glPolygonOffset(2.0f, 4.0f);
+
+		for (int c = 0; c < count; ++c) {
+			//Õt[GPU̕`掞ԂoĂΎo
+			if (pending[c]) {
+				GLint available(GL_FALSE);
+				glGetQueryObjectiv(queries[c].get(), GL_QUERY_RESULT_AVAILABLE, &available);
+				if (available) {
+					GLuint64 elapsed(0);
+					glGetQueryObjectui64v(queries[c].get(), GL_QUERY_RESULT, &elapsed);
+					stats.gpuTime[c] = static_cast<double>(elapsed) * 1.0e-6;
+					pending[c] = false;
+				}
+			}
+
+			//̑wɕ`
+			const auto t0(std::chrono::high_resolution_clock::now());
+			const bool measure(timer && !pending[c]);
+			if (measure) glBeginQuery(GL_TIME_ELAPSED, queries[c].get());
+			glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, texture.get(), 0, c);
+			glClear(GL_DEPTH_BUFFER_BIT);
+			glUniformMatrix4fv(projectionLoc, 1, GL_FALSE, projection[c].data());
+			batches[c]->draw(GL_TRIANGLES, material, context);
+			if (measure) {
+				glEndQuery(GL_TIME_ELAPSED);
+				pending[c] = true;
+			}
+			stats.submitTime[c] = Profiler::elapsed(t0);
+		}
+
+		glDisable(GL_POLYGON_OFFSET_FILL);
+		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	}
+
+	//VhE}bveNX`jbgɌĕ`悷vOuniformϐݒ肷
+	//unit:eNX`jbg̔ԍ
+	//shadowMapLoc:sampler2DArrayShadowuniformϐ̏ꏊ
+	//shadowMatrixLoc:Ƃ̕ϊsimat4̔zjuniformϐ̏ꏊ
+	//cascadeFarLoc:Ƃ̉̋ifloat̔zjuniformϐ̏ꏊ
+	//cascadeCountLoc:̐uniformϐ̏ꏊiVhE}bvgȂ0ɂj
+	void bind(GLuint unit, GLint shadowMapLoc, GLint shadowMatrixLoc, GLint cascadeFarLoc, GLint cascadeCountLoc) const {
+		glActiveTexture(GL_TEXTURE0 + unit);
+		glBindTexture(GL_TEXTURE_2D_ARRAY, texture.get());
+		glActiveTexture(GL_TEXTURE0);
+		glUniform1i(shadowMapLoc, static_cast<GLint>(unit));
+		GLfloat matrices[MaxCascades * 16];
+		for (int c = 0; c < count; ++c) std::copy(shadowMatrix[c].data(), shadowMatrix[c].data() + 16, matrices + c * 16);
+		glUniformMatrix4fv(shadowMatrixLoc, count, GL_FALSE, matrices);
+		glUniform1fv(cascadeFarLoc, count, splits);
+		glUniform1i(cascadeCountLoc, incomplete ? 0 : count);
+	}
+
+	//̐
+	int getCount() const { return count; }
+
+	//̉̎_̋
+	GLfloat getSplit(int cascade) const { return splits[cascade]; }
+
+	//̌̒𓊉eϊs
+	const Matrix& getProjection(int cascade) const { return projection[cascade]; }
+
+	//̃r[ϊs
+	const Matrix& getLightView() const { return lightView; }
+
+	//vo
+	const Stats& getStats() const { return stats; }
+};
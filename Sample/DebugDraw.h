@@ -0,0 +1,386 @@
+#pragma once
+#include <vector>
+#include <chrono>
+#include <cmath>
+#include <algorithm>
+#include <GL/glew.h>
+
+//ϊs
+#include "Matrix.h"
+
+//DEBUG_DRAW0ɂƋL^`Ȃ̎ɂȂiw肵ȂNDEBUĜƂ0j
+#ifndef DEBUG_DRAW
+#ifdef NDEBUG
+#define DEBUG_DRAW 0
+#else
+#define DEBUG_DRAW 1
+#endif
+#endif
+
+#if DEBUG_DRAW
+//OpenGL̃IuWFNg̃nh
+#include "GLHandle.h"
+
+//VF[_[
+#include "Shader.h"
+
+//v
+#include "Profiler.h"
+
+//GPU̎gpʂ̋L^
+#include "GpuMemory.h"
+#endif
+
+//mFp̐Ɖʂɏd˂镶̕`
+//AAAAL^ƃt[̒_̗ɒǉA܂Ƃ߂ē]ĎނƂɈŕ`
+//L^̓XbhƂɕĂ̂ŁA[J[Xbh玩̃Xbh̔ԍnēɋL^ł
+//clearAuploadAdraw͋L^ĂXbhȂƂɕ`̃XbhŌĂяo
+class DebugDraw {
+public:
+	//FiRGBȀ̃oCgj
+	typedef GLuint Color;
+
+	//F
+	static constexpr Color color(GLfloat r, GLfloat g, GLfloat b, GLfloat a = 1.0f) {
+		return static_cast<Color>(r * 255.0f + 0.5f) | static_cast<Color>(g * 255.0f + 0.5f) << 8
+			| static_cast<Color>(b * 255.0f + 0.5f) << 16 | static_cast<Color>(a * 255.0f + 0.5f) << 24;
+	}
+
+	//v
+	struct Stats {
+		//Ōuploadœ]̐i[hWnƉʁjƎOp`̐
+		std::size_t lines, overlayLines, overlayTriangles;
+
+		//Ōuploadɂԁi~bj
+		double uploadTime;
+	};
+
+#if DEBUG_DRAW
+private:
+	//_
+	struct Vertex {
+		//ʒu
+		GLfloat position[3];
+
+		//F
+		Color color;
+	};
+
+	//{}`̎
+	enum Type { Lines, OverlayLines, OverlayTriangles, TypeCount };
+
+	//XbhƂ̋L^i{}`̎ނƂ̒_̗j
+	struct Stream {
+		std::vector<Vertex> vertices[TypeCount];
+	};
+	std::vector<Stream> streams;
+
+	//_obt@IuWFNgƊmۂ_
+	GLBuffer buffer;
+	std::size_t capacity;
+
+	//]_̗̎ނƂ̈ʒuƐ
+	GLint first[TypeCount];
+	GLsizei count[TypeCount];
+
+	//ReLXgƂ̒_zIuWFNg
+	mutable std::vector<GLVertexArray> vaos;
+
+	//VF[_[
+	const GLProgram program;
+	const GLint projectionLoc;
+
+	//v
+	Stats stats;
+
+	//̑傫ifj
+	static constexpr int GlyphWidth = 5, GlyphHeight = 7;
+
+	//Rs[֎~
+	DebugDraw(const DebugDraw&) = delete;
+	DebugDraw& operator=(const DebugDraw&) = delete;
+
+	//5~7f̕i󔒂~܂ŁA񂲂Ƃɉʂ̃rbg̉fj
+	static const unsigned char* glyph(char c) {
+		static const unsigned char font[][GlyphWidth] = {
+			{ 0x00,0x00,0x00,0x00,0x00 }, { 0x00,0x00,0x5F,0x00,0x00 }, { 0x00,0x07,0x00,0x07,0x00 }, { 0x14,0x7F,0x14,0x7F,0x14 },
+			{ 0x24,0x2A,0x7F,0x2A,0x12 }, { 0x23,0x13,0x08,0x64,0x62 }, { 0x36,0x49,0x55,0x22,0x50 }, { 0x00,0x05,0x03,0x00,0x00 },
+			{ 0x00,0x1C,0x22,0x41,0x00 }, { 0x00,0x41,0x22,0x1C,0x00 }, { 0x08,0x2A,0x1C,0x2A,0x08 }, { 0x08,0x08,0x3E,0x08,0x08 },
+			{ 0x00,0x50,0x30,0x00,0x00 }, { 0x08,0x08,0x08,0x08,0x08 }, { 0x00,0x60,0x60,0x00,0x00 }, { 0x20,0x10,0x08,0x04,0x02 },
+			{ 0x3E,0x51,0x49,0x45,0x3E }, { 0x00,0x42,0x7F,0x40,0x00 }, { 0x42,0x61,0x51,0x49,0x46 }, { 0x21,0x41,0x45,0x4B,0x31 },
+			{ 0x18,0x14,0x12,0x7F,0x10 }, { 0x27,0x45,0x45,0x45,0x39 }, { 0x3C,0x4A,0x49,0x49,0x30 }, { 0x01,0x71,0x09,0x05,0x03 },
+			{ 0x36,0x49,0x49,0x49,0x36 }, { 0x06,0x49,0x49,0x29,0x1E }, { 0x00,0x36,0x36,0x00,0x00 }, { 0x00,0x56,0x36,0x00,0x00 },
+			{ 0x08,0x14,0x22,0x41,0x00 }, { 0x14,0x14,0x14,0x14,0x14 }, { 0x00,0x41,0x22,0x14,0x08 }, { 0x02,0x01,0x51,0x09,0x06 },
+			{ 0x32,0x49,0x79,0x41,0x3E }, { 0x7E,0x11,0x11,0x11,0x7E }, { 0x7F,0x49,0x49,0x49,0x36 }, { 0x3E,0x41,0x41,0x41,0x22 },
+			{ 0x7F,0x41,0x41,0x22,0x1C }, { 0x7F,0x49,0x49,0x49,0x41 }, { 0x7F,0x09,0x09,0x09,0x01 }, { 0x3E,0x41,0x49,0x49,0x7A },
+			{ 0x7F,0x08,0x08,0x08,0x7F }, { 0x00,0x41,0x7F,0x41,0x00 }, { 0x20,0x40,0x41,0x3F,0x01 }, { 0x7F,0x08,0x14,0x22,0x41 },
+			{ 0x7F,0x40,0x40,0x40,0x40 }, { 0x7F,0x02,0x0C,0x02,0x7F }, { 0x7F,0x04,0x08,0x10,0x7F }, { 0x3E,0x41,0x41,0x41,0x3E },
+			{ 0x7F,0x09,0x09,0x09,0x06 }, { 0x3E,0x41,0x51,0x21,0x5E }, { 0x7F,0x09,0x19,0x29,0x46 }, { 0x46,0x49,0x49,0x49,0x31 },
+			{ 0x01,0x01,0x7F,0x01,0x01 }, { 0x3F,0x40,0x40,0x40,0x3F }, { 0x1F,0x20,0x40,0x20,0x1F }, { 0x3F,0x40,0x38,0x40,0x3F },
+			{ 0x63,0x14,0x08,0x14,0x63 }, { 0x07,0x08,0x70,0x08,0x07 }, { 0x61,0x51,0x49,0x45,0x43 }, { 0x00,0x7F,0x41,0x41,0x00 },
+			{ 0x02,0x04,0x08,0x10,0x20 }, { 0x00,0x41,0x41,0x7F,0x00 }, { 0x04,0x02,0x01,0x02,0x04 }, { 0x40,0x40,0x40,0x40,0x40 },
+			{ 0x00,0x01,0x02,0x04,0x00 }, { 0x20,0x54,0x54,0x54,0x78 }, { 0x7F,0x48,0x44,0x44,0x38 }, { 0x38,0x44,0x44,0x44,0x20 },
+			{ 0x38,0x44,0x44,0x48,0x7F }, { 0x38,0x54,0x54,0x54,0x18 }, { 0x08,0x7E,0x09,0x01,0x02 }, { 0x0C,0x52,0x52,0x52,0x3E },
+			{ 0x7F,0x08,0x04,0x04,0x78 }, { 0x00,0x44,0x7D,0x40,0x00 }, { 0x20,0x40,0x44,0x3D,0x00 }, { 0x7F,0x10,0x28,0x44,0x00 },
+			{ 0x00,0x41,0x7F,0x40,0x00 }, { 0x7C,0x04,0x18,0x04,0x78 }, { 0x7C,0x08,0x04,0x04,0x78 }, { 0x38,0x44,0x44,0x44,0x38 },
+			{ 0x7C,0x14,0x14,0x14,0x08 }, { 0x08,0x14,0x14,0x18,0x7C }, { 0x7C,0x08,0x04,0x04,0x08 }, { 0x48,0x54,0x54,0x54,0x20 },
+			{ 0x04,0x3F,0x44,0x40,0x20 }, { 0x3C,0x40,0x40,0x20,0x7C }, { 0x1C,0x20,0x40,0x20,0x1C }, { 0x3C,0x40,0x30,0x40,0x3C },
+			{ 0x44,0x28,0x10,0x28,0x44 }, { 0x0C,0x50,0x50,0x50,0x3C }, { 0x44,0x64,0x54,0x4C,0x44 }, { 0x00,0x08,0x36,0x41,0x00 },
+			{ 0x00,0x00,0x7F,0x00,0x00 }, { 0x00,0x41,0x36,0x08,0x00 }, { 0x08,0x04,0x08,0x10,0x08 }
+		};
+		return c >= ' ' && c <= '~' ? font[c - ' '] : font['?' - ' '];
+	}
+
+	//_ǉ
+	static void push(std::vector<Vertex>& v, GLfloat x, GLfloat y, GLfloat z, Color color) {
+		v.push_back(Vertex{ { x, y, z }, color });
+	}
+
+	//sŕϊ_߂
+	static void transform(const Matrix& m, GLfloat x, GLfloat y, GLfloat z, GLfloat* out) {
+		const GLfloat* const a(m.data());
+		const GLfloat w(a[3] * x + a[7] * y + a[11] * z + a[15]);
+		for (int k = 0; k < 3; ++k) out[k] = (a[k] * x + a[k + 4] * y + a[k + 8] * z + a[k + 12]) / w;
+	}
+
+	//8̊p12{̕ӂŌԁip̔ԍx1Ay2Az4̃rbgj
+	void corners(const GLfloat (*p)[3], Color color, unsigned int thread) {
+		for (int i = 0; i < 8; ++i) {
+			for (int bit = 1; bit < 8; bit <<= 1) {
+				if (i & bit) continue;
+				line(p[i], p[i | bit], color, thread);
+			}
+		}
+	}
+
+public:
+	//RXgN^
+	//threads:ɋL^Xbh̐iThreadPool::sizej
+	explicit DebugDraw(unsigned int threads = 1)
+		:streams(std::max(threads, 1u)), buffer(GLBuffer::create()), capacity(0)
+		, program(loadProgram("debug.vert", "debug.frag"))
+		, projectionLoc(glGetUniformLocation(program.get(), "projection"))
+		, stats()
+	{
+		std::fill(first, first + TypeCount, 0);
+		std::fill(count, count + TypeCount, 0);
+	}
+
+	//fXgN^
+	virtual ~DebugDraw() {
+		GpuMemory::instance().release(GpuMemory::Stream, capacity * sizeof(Vertex));
+	}
+
+	//L^̂it[̎n߂ɌĂяoAmۂ͎̈cj
+	void clear() {
+		for (Stream& s : streams) for (std::vector<Vertex>& v : s.vertices) v.clear();
+	}
+
+	//ǉ
+	//a, b:[_̃[hW
+	//color:F
+	//thread:L^Xbh̔ԍiThreadPool::parallelFor̔ԍAقɋL^ĂXbhȂ0j
+	void line(const GLfloat* a, const GLfloat* b, Color color, unsigned int thread = 0) {
+		std::vector<Vertex>& v(streams[thread].vertices[Lines]);
+		push(v, a[0], a[1], a[2], color);
+		push(v, b[0], b[1], b[2], color);
+	}
+
+	//Wɉǉ
+	//min, max:̍ŏƍő̊p̃[hW
+	void box(const GLfloat* min, const GLfloat* max, Color color, unsigned int thread = 0) {
+		GLfloat p[8][3];
+		for (int i = 0; i < 8; ++i) for (int k = 0; k < 3; ++k) p[i][k] = (i >> k & 1) ? max[k] : min[k];
+		corners(p, color, thread);
+	}
+
+	//ϊǉ
+	//model:2̗́ieW-11j[hWnɈڂϊs
+	void box(const Matrix& model, Color color, unsigned int thread = 0) {
+		GLfloat p[8][3];
+		for (int i = 0; i < 8; ++i) transform(model, (i & 1) ? 1.0f : -1.0f, (i & 2) ? 1.0f : -1.0f, (i & 4) ? 1.0f : -1.0f, p[i]);
+		corners(p, color, thread);
+	}
+
+	//Wɐ3{̉~Œǉ
+	//center:S̃[hW
+	//radius:a
+	void sphere(const GLfloat* center, GLfloat radius, Color color, unsigned int thread = 0) {
+		static constexpr int Segments = 24;
+		std::vector<Vertex>& v(streams[thread].vertices[Lines]);
+		for (int axis = 0; axis < 3; ++axis) {
+			const int u((axis + 1) % 3), w((axis + 2) % 3);
+			for (int i = 0; i < Segments; ++i) {
+				for (int j = i; j <= i + 1; ++j) {
+					const GLfloat a(6.283185f * static_cast<GLfloat>(j) / Segments);
+					GLfloat p[3] = { center[0], center[1], center[2] };
+					p[u] += radius * std::cos(a);
+					p[w] += radius * std::sin(a);
+					push(v, p[0], p[1], p[2], color);
+				}
+			}
+		}
+	}
+
+	//ǉ
+	//viewProjection:J̓eϊsƃr[ϊs̐ρi̋tϊŐKfoCXWn̗̂ڂj
+	void frustum(const Matrix& viewProjection, Color color, unsigned int thread = 0) {
+		box(viewProjection.inverse(), color, thread);
+	}
+
+	//ʂɐd˂
+	//x0, y0, x1, y1:r[|[g̍ォ̒[_̈ʒuifj
+	void overlayLine(GLfloat x0, GLfloat y0, GLfloat x1, GLfloat y1, Color color, unsigned int thread = 0) {
+		std::vector<Vertex>& v(streams[thread].vertices[OverlayLines]);
+		push(v, x0, y0, 0.0f, color);
+		push(v, x1, y1, 0.0f, color);
+	}
+
+	//ʂɓhԂ`d˂
+	//x, y:r[|[g̍ォ̍̊p̈ʒuifj
+	//width, height:傫ifj
+	void overlayRect(GLfloat x, GLfloat y, GLfloat width, GLfloat height, Color color, unsigned int thread = 0) {
+		std::vector<Vertex>& v(streams[thread].vertices[OverlayTriangles]);
+		push(v, x, y, 0.0f, color);
+		push(v, x, y + height, 0.0f, color);
+		push(v, x + width, y + height, 0.0f, color);
+		push(v, x, y, 0.0f, color);
+		push(v, x + width, y + height, 0.0f, color);
+		push(v, x + width, y, 0.0f, color);
+	}
+
+	//ʂɕd˂i5~7f̏̕cɑf܂Ƃ߂Ē`ɂAsłj
+	//x, y:r[|[g̍ォ̍ŏ̍̈̕ʒuifj
+	//text:ASCII̕
+	//scale:̉f̑傫ifj
+	//߂l:Ō̍s̕ifj
+	GLfloat text(GLfloat x, GLfloat y, const char* text, Color color, GLfloat scale = 2.0f, unsigned int thread = 0) {
+		GLfloat cx(x);
+		for (const char* c = text; *c != '\0'; ++c) {
+			if (*c == '\n') {
+				cx = x;
+				y += (GlyphHeight + 2) * scale;
+				continue;
+			}
+			const unsigned char* const g(glyph(*c));
+			for (int column = 0; column < GlyphWidth; ++column) {
+				for (int row = 0; row < GlyphHeight;) {
+					if ((g[column] >> row & 1) == 0) {
+						++row;
+						continue;
+					}
+					int end(row + 1);
+					while (end < GlyphHeight && (g[column] >> end & 1)) ++end;
+					overlayRect(cx + column * scale, y + row * scale, scale, (end - row) * scale, color, thread);
+					row = end;
+				}
+			}
+			cx += (GlyphWidth + 1) * scale;
+		}
+		return cx - x;
+	}
+
+	//L^̂𒸓_obt@IuWFNgɓ]i`̃XbhőSr[`OɈxĂяoj
+	void upload() {
+		const auto t0(std::chrono::high_resolution_clock::now());
+		std::size_t total(0);
+		for (int t = 0; t < TypeCount; ++t) {
+			first[t] = static_cast<GLint>(total);
+			for (const Stream& s : streams) total += s.vertices[t].size();
+			count[t] = static_cast<GLsizei>(total - first[t]);
+		}
+		stats.lines = count[Lines] / 2;
+		stats.overlayLines = count[OverlayLines] / 2;
+		stats.overlayTriangles = count[OverlayTriangles] / 3;
+		if (total == 0) {
+			stats.uploadTime = 0.0;
+			return;
+		}
+
+		//KvȂ傫AÕt[̕`҂Ȃ悤ɗ̈蒼ĂXbhƂ̗𑱂ē]
+		glBindBuffer(GL_ARRAY_BUFFER, buffer.get());
+		if (total > capacity) {
+			GpuMemory::instance().release(GpuMemory::Stream, capacity * sizeof(Vertex));
+			capacity = std::max(total, capacity * 2);
+			GpuMemory::instance().allocate(GpuMemory::Stream, capacity * sizeof(Vertex));
+		}
+		glBufferData(GL_ARRAY_BUFFER, capacity * sizeof(Vertex), NULL, GL_STREAM_DRAW);
+		std::size_t offset(0);
+		for (int t = 0; t < TypeCount; ++t) {
+			for (const Stream& s : streams) {
+				const std::vector<Vertex>& v(s.vertices[t]);
+				if (v.empty()) continue;
+				glBufferSubData(GL_ARRAY_BUFFER, offset * sizeof(Vertex), v.size() * sizeof(Vertex), v.data());
+				offset += v.size();
+			}
+		}
+		stats.uploadTime = Profiler::elapsed(t0);
+	}
+
+	//]̂`i[hWn̐̓fvXeXgāAʂɏd˂̂̓fvXeXgɔŕ`j
+	//viewProjection:eϊsƃr[ϊs̐
+	//viewport:r[|[gix, y, , j
+	//context:݂̃ReLXg̔ԍ
+	void draw(const Matrix& viewProjection, const GLint* viewport, unsigned int context = 0) const {
+		if (count[Lines] + count[OverlayLines] + count[OverlayTriangles] == 0 || !program) return;
+
+		//߂ĎgReLXgȂ璸_zIuWFNgiobt@IuWFNg̖O͕ςȂj
+		if (context >= vaos.size()) vaos.resize(context + 1);
+		if (vaos[context]) glBindVertexArray(vaos[context].get());
+		else {
+			vaos[context] = GLVertexArray::create();
+			glBindVertexArray(vaos[context].get());
+			glBindBuffer(GL_ARRAY_BUFFER, buffer.get());
+			glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), &static_cast<Vertex*>(0)->position);
+			glEnableVertexAttribArray(0);
+			glVertexAttribPointer(12, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(Vertex), &static_cast<Vertex*>(0)->color);
+			glEnableVertexAttribArray(12);
+		}
+
+		glUseProgram(program.get());
+		if (count[Lines] > 0) {
+			glUniformMatrix4fv(projectionLoc, 1, GL_FALSE, viewProjection.data());
+			glDrawArrays(GL_LINES, first[Lines], count[Lines]);
+		}
+		if (count[OverlayLines] + count[OverlayTriangles] > 0) {
+			//r[|[g̍_ɂyɂ
+			const Matrix overlay(Matrix::orthogonal(0.0f, static_cast<GLfloat>(viewport[2]), static_cast<GLfloat>(viewport[3]), 0.0f, -1.0f, 1.0f));
+			glUniformMatrix4fv(projectionLoc, 1, GL_FALSE, overlay.data());
+			glDisable(GL_DEPTH_TEST);
+			glEnable(GL_BLEND);
+			glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+			if (count[OverlayTriangles] > 0) glDrawArrays(GL_TRIANGLES, first[OverlayTriangles], count[OverlayTriangles]);
+			if (count[OverlayLines] > 0) glDrawArrays(GL_LINES, first[OverlayLines], count[OverlayLines]);
+			glDisable(GL_BLEND);
+			glEnable(GL_DEPTH_TEST);
+		}
+	}
+
+	//v
+	const Stats& getStats() const { return stats; }
+#else
+private:
+	//vi0j
+	Stats stats;
+
+public:
+	//RXgN^
+	explicit DebugDraw(unsigned int threads = 1) :stats() {}
+
+	//Ȃ
+	void clear() {}
+	void line(const GLfloat* a, const GLfloat* b, Color color, unsigned int thread = 0) {}
+	void box(const GLfloat* min, const GLfloat* max, Color color, unsigned int thread = 0) {}
+	void box(const Matrix& model, Color color, unsigned int thread = 0) {}
+	void sphere(const GLfloat* center, GLfloat radius, Color color, unsigned int thread = 0) {}
+	void frustum(const Matrix& viewProjection, Color color, unsigned int thread = 0) {}
+	void overlayLine(GLfloat x0, GLfloat y0, GLfloat x1, GLfloat y1, Color color, unsigned int thread = 0) {}
+	void overlayRect(GLfloat x, GLfloat y, GLfloat width, GLfloat height, Color color, unsigned int thread = 0) {}
+	GLfloat text(GLfloat x, GLfloat y, const char* text, Color color, GLfloat scale = 2.0f, unsigned int thread = 0) { return 0.0f; }
+	void upload() {}
+	void draw(const Matrix& viewProjection, const GLint* viewport, unsigned int context = 0) const {}
+
+	//v
+	const Stats& getStats() const { return stats; }
+#endif
+};
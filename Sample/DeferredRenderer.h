@@ -0,0 +1,341 @@
+#pragma once
+#include <chrono>
+#include <vector>
+#include <iostream>
+#include <algorithm>
+#include <GL/glew.h>
+
+//VF[_[
+#include "Shader.h"
+
+//ϊsƃxNg
+#include "Matrix.h"
+#include "vector.h"
+
+//OpenGL̃IuWFNg̏L
+#include "GLHandle.h"
+
+//GPU̎gpʂ̋L^
+#include "GpuMemory.h"
+
+//}`܂Ƃ߂Ċi[钸_obt@
+#include "MeshBuffer.h"
+
+//_
+#include "PointLights.h"
+
+//JXP[hVhE}bv
+#include "CascadedShadow.h"
+
+//̃v[u
+#include "LightProbes.h"
+
+//v
+#include "Profiler.h"
+
+//x`
+//WIgpXŖ@AގAfvXGobt@ɕ`ACeBOpXŉfƂɈxAet
+//sƊ͉ʑŜ𕢂Op`ŁA_͈͌͂͂͂ދiCg{[jŕ`
+//Gobt@̃eNX`̓r[̊ԂŋLAԑ傫r[|[gɍ킹đ傫
+//t[obt@IuWFNg̓ReLXg̊ԂŋLȂ̂ŃReLXgƂɍ
+class DeferredRenderer {
+public:
+	//v
+	struct Stats {
+		//WIgpX̔sɂԁi~bj
+		double geometryTime;
+
+		//CeBOpX̔sɂԁi~bj
+		double lightingTime;
+
+		//`Cg{[̐
+		GLsizei lights;
+	};
+
+	//Gobt@̔ԍ
+	enum Target {
+		//@ƋPW
+		Normal,
+
+		//gUˌW
+		Diffuse,
+
+		//ʔˌW
+		Specular,
+
+		//̔ˌW
+		Ambient,
+
+		//J[obt@̐
+		TargetCount
+	};
+
+	//Gobt@ŏ̃eNX`jbgi1Ԃ̓VhE}bvgj
+	static constexpr GLuint FirstUnit = 2;
+
+	//̃v[ueNX`jbgiGobt@̃fvX̎j
+	static constexpr GLuint ProbeUnit = FirstUnit + TargetCount + 1;
+
+private:
+	//Cg{[̐}`i[obt@
+	const MeshBuffer& meshes;
+
+	//Cg{[̐}`i_Pʋʏɂ鋅j
+	const MeshBuffer::Handle volume;
+
+	//WIgpXAsA_̃vOIuWFNg
+	const GLProgram geometry, directional, point;
+
+	//WIgpXuniformϐ̏ꏊ
+	const GLint geometryProjectionLoc;
+
+	//suniformϐ̏ꏊ
+	const GLint LposLoc, LambLoc, LdiffLoc, LspecLoc;
+	const GLint shadowMapLoc, shadowMatrixLoc, cascadeFarLoc, cascadeCountLoc;
+	const GLint directionalInverseLoc, directionalOriginLoc, directionalSizeLoc;
+	const GLint probeMapLoc, probeMatrixLoc, probeRotationLoc, probeSizeLoc;
+
+	//_uniformϐ̏ꏊ
+	const GLint pointProjectionLoc, pointInverseLoc, pointOriginLoc, pointSizeLoc;
+
+	//Gobt@̃J[obt@ƃfvXobt@
+	GLTexture targets[TargetCount];
+	GLTexture depth;
+
+	//Gobt@̑傫
+	GLsizei width, height;
+
+	//ReLXgƂ̃t[obt@IuWFNg
+	std::vector<GLFramebuffer> framebuffers;
+
+	//v
+	Stats stats;
+
+	//WIgpXn߂
+	std::chrono::high_resolution_clock::time_point geometryStart;
+
+	//Rs[֎~
+	DeferredRenderer(const DeferredRenderer&) = delete;
+	DeferredRenderer& operator=(const DeferredRenderer&) = delete;
+
+	//Gobt@1f̃oCg
+	static std::size_t bytesPerPixel() {
+		return 8 + 4 * (TargetCount - 1) + 4;
+	}
+
+	//Gobt@̃eNX`̃TvɃeNX`jbg蓖ĂigĂȂTv͏ꏊ-1Ȃ̂Ŗj
+	static void setSamplers(GLuint program) {
+		static const char* const names[TargetCount] = { "gNormal", "gDiffuse", "gSpecular", "gAmbient" };
+		glUseProgram(program);
+		for (int i = 0; i < TargetCount; ++i) {
+			glUniform1i(glGetUniformLocation(program, names[i]), FirstUnit + i);
+		}
+		glUniform1i(glGetUniformLocation(program, "gDepth"), FirstUnit + TargetCount);
+		glUniform1i(glGetUniformLocation(program, "probeMap"), ProbeUnit);
+	}
+
+	//Gobt@ȂƂw~h̑傫ɂ
+	void reserve(GLsizei w, GLsizei h) {
+		if (w <= width && h <= height) return;
+		GpuMemory::instance().release(GpuMemory::Texture, width * height * bytesPerPixel());
+		width = std::max(w, width);
+		height = std::max(h, height);
+		GpuMemory::instance().allocate(GpuMemory::Texture, width * height * bytesPerPixel());
+
+		//eNX`蒼iO͕ςȂ̂Ńt[obt@IuWFNg͂̂܂܎gj
+		for (int i = 0; i < TargetCount; ++i) {
+			glBindTexture(GL_TEXTURE_2D, targets[i].get());
+			if (i == Normal) glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, width, height, 0, GL_RGBA, GL_FLOAT, NULL);
+			else glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+		}
+		glBindTexture(GL_TEXTURE_2D, depth.get());
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT24, width, height, 0, GL_DEPTH_COMPONENT, GL_FLOAT, NULL);
+		glBindTexture(GL_TEXTURE_2D, 0);
+	}
+
+	//ReLXg̃t[obt@IuWFNgiȂ΍j
+	//߂l:gtrue
+	bool bindFramebuffer(unsigned int context) {
+		if (context >= framebuffers.size()) framebuffers.resize(context + 1);
+		if (framebuffers[context]) {
+			glBindFramebuffer(GL_FRAMEBUFFER, framebuffers[context].get());
+			return true;
+		}
+
+		framebuffers[context] = GLFramebuffer::create();
+		glBindFramebuffer(GL_FRAMEBUFFER, framebuffers[context].get());
+		GLenum buffers[TargetCount];
+		for (int i = 0; i < TargetCount; ++i) {
+			glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0 + i, GL_TEXTURE_2D, targets[i].get(), 0);
+			buffers[i] = GL_COLOR_ATTACHMENT0 + i;
+		}
+		glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, depth.get(), 0);
+		glDrawBuffers(TargetCount, buffers);
+		if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+			std::cerr << "Error: G-buffer framebuffer is incomplete." << std::endl;
+			glBindFramebuffer(GL_FRAMEBUFFER, 0);
+			return false;
+		}
+		return true;
+	}
+
+public:
+	//RXgN^
+	//meshes:Cg{[̐}`i[obt@
+	//volume:Cg{[ɎgimakeSphere(16, 8)x̑ej
+	DeferredRenderer(const MeshBuffer& meshes, MeshBuffer::Handle volume)
+		:meshes(meshes), volume(volume)
+		, geometry(loadProgram("batch.vert", "gbuffer.frag"))
+		, directional(loadProgram("deferred.vert", "deferred.frag"))
+		, point(loadProgram("light.vert", "light.frag"))
+		, geometryProjectionLoc(glGetUniformLocation(geometry.get(), "projection"))
+		, LposLoc(glGetUniformLocation(directional.get(), "Lpos"))
+		, LambLoc(glGetUniformLocation(directional.get(), "Lamb"))
+		, LdiffLoc(glGetUniformLocation(directional.get(), "Ldiff"))
+		, LspecLoc(glGetUniformLocation(directional.get(), "Lspec"))
+		, shadowMapLoc(glGetUniformLocation(directional.get(), "shadowMap"))
+		, shadowMatrixLoc(glGetUniformLocation(directional.get(), "shadowMatrix"))
+		, cascadeFarLoc(glGetUniformLocation(directional.get(), "cascadeFar"))
+		, cascadeCountLoc(glGetUniformLocation(directional.get(), "cascadeCount"))
+		, directionalInverseLoc(glGetUniformLocation(directional.get(), "inverseProjection"))
+		, directionalOriginLoc(glGetUniformLocation(directional.get(), "viewportOrigin"))
+		, directionalSizeLoc(glGetUniformLocation(directional.get(), "viewportSize"))
+		, probeMapLoc(glGetUniformLocation(directional.get(), "probeMap"))
+		, probeMatrixLoc(glGetUniformLocation(directional.get(), "probeMatrix"))
+		, probeRotationLoc(glGetUniformLocation(directional.get(), "probeRotation"))
+		, probeSizeLoc(glGetUniformLocation(directional.get(), "probeSize"))
+		, pointProjectionLoc(glGetUniformLocation(point.get(), "projection"))
+		, pointInverseLoc(glGetUniformLocation(point.get(), "inverseProjection"))
+		, pointOriginLoc(glGetUniformLocation(point.get(), "viewportOrigin"))
+		, pointSizeLoc(glGetUniformLocation(point.get(), "viewportSize"))
+		, depth(GLTexture::create()), width(0), height(0), stats()
+	{
+		//ގ0ԁA_1Ԃ̌|Cgǂ
+		glUniformBlockBinding(geometry.get(), glGetUniformBlockIndex(geometry.get(), "Material"), 0);
+		glUniformBlockBinding(point.get(), glGetUniformBlockIndex(point.get(), "PointLights"), 1);
+
+		//Gobt@̃eNX`
+		for (int i = 0; i < TargetCount; ++i) targets[i] = GLTexture::create();
+		for (int i = 0; i <= TargetCount; ++i) {
+			glBindTexture(GL_TEXTURE_2D, i < TargetCount ? targets[i].get() : depth.get());
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		}
+		glBindTexture(GL_TEXTURE_2D, 0);
+
+		//TvɃeNX`jbg蓖Ă
+		setSamplers(directional.get());
+		setSamplers(point.get());
+		glUniform1f(glGetUniformLocation(point.get(), "volumeScale"), 1.1f);
+		glUseProgram(0);
+	}
+
+	//fXgN^
+	virtual ~DeferredRenderer() {
+		GpuMemory::instance().release(GpuMemory::Texture, width * height * bytesPerPixel());
+	}
+
+	//WIgpXn߂îƂIndirectBatch::drawŐ}``AendGeometryĂԁj
+	//viewport:r[|[gix, y, , j
+	//projection:eϊs
+	//context:݂̃ReLXg̔ԍ
+	//߂l:Gobt@gȂfalse
+	bool beginGeometry(const GLint* viewport, const Matrix& projection, unsigned int context = 0) {
+		geometryStart = std::chrono::high_resolution_clock::now();
+		reserve(viewport[2], viewport[3]);
+		if (!bindFramebuffer(context)) return false;
+
+		//Gobt@̍Ƀr[|[g̑傫ŕ`
+		glViewport(0, 0, viewport[2], viewport[3]);
+		glDisable(GL_SCISSOR_TEST);
+		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+		glUseProgram(geometry.get());
+		glUniformMatrix4fv(geometryProjectionLoc, 1, GL_FALSE, projection.data());
+		return true;
+	}
+
+	//WIgpXIĩt[obt@ɖ߂j
+	void endGeometry() {
+		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+		stats.geometryTime = Profiler::elapsed(geometryStart);
+	}
+
+	//CeBOpX`ĩt[obt@̃r[|[gݒ肵ďĂĂԁj
+	//viewport:r[|[gix, y, , j
+	//projection:eϊs
+	//light:_Wn̕s̕iw = 0j
+	//amb, diff, spec:s̊AgUˌAʔˌ̋
+	//shadow:s̃VhE}bviNULLȂetȂj
+	//probes:̑Ɏg̃v[uiNULLȂambgj
+	//view:r[ϊsiv[uǂވʒu[hWnɖ߂̂Ɏgj
+	//lights:_i_WnɈڂē]Ă邱Ɓj
+	//context:݂̃ReLXg̔ԍ
+	void light(const GLint* viewport, const Matrix& projection, const Vector& light,
+		const GLfloat* amb, const GLfloat* diff, const GLfloat* spec,
+		const CascadedShadow* shadow, const LightProbes* probes, const Matrix& view,
+		const PointLights& lights, unsigned int context = 0)
+	{
+		const auto t0(std::chrono::high_resolution_clock::now());
+		const Matrix inverse(projection.inverse());
+		const GLfloat origin[] = { static_cast<GLfloat>(viewport[0]), static_cast<GLfloat>(viewport[1]) };
+		const GLfloat size[] = { static_cast<GLfloat>(viewport[2]), static_cast<GLfloat>(viewport[3]) };
+
+		//Gobt@
+		for (int i = 0; i < TargetCount; ++i) {
+			glActiveTexture(GL_TEXTURE0 + FirstUnit + i);
+			glBindTexture(GL_TEXTURE_2D, targets[i].get());
+		}
+		glActiveTexture(GL_TEXTURE0 + FirstUnit + TargetCount);
+		glBindTexture(GL_TEXTURE_2D, depth.get());
+		glActiveTexture(GL_TEXTURE0);
+
+		//ʑŜ𕢂Op`ŕsƊ`i_͎gȂ_zIuWFNg͌Ăj
+		glDisable(GL_DEPTH_TEST);
+		glDepthMask(GL_FALSE);
+		meshes.bind(context);
+		glUseProgram(directional.get());
+		glUniform4fv(LposLoc, 1, light.data());
+		glUniform3fv(LambLoc, 1, amb);
+		glUniform3fv(LdiffLoc, 1, diff);
+		glUniform3fv(LspecLoc, 1, spec);
+		if (shadow != NULL) shadow->bind(1, shadowMapLoc, shadowMatrixLoc, cascadeFarLoc, cascadeCountLoc);
+		else glUniform1i(cascadeCountLoc, 0);
+		if (probes != NULL) probes->bind(ProbeUnit, view, probeMapLoc, probeMatrixLoc, probeRotationLoc, probeSizeLoc);
+		else glUniform3f(probeSizeLoc, 0.0f, 0.0f, 0.0f);
+		glUniformMatrix4fv(directionalInverseLoc, 1, GL_FALSE, inverse.data());
+		glUniform2fv(directionalOriginLoc, 1, origin);
+		glUniform2fv(directionalSizeLoc, 1, size);
+		glDrawArrays(GL_TRIANGLES, 0, 3);
+
+		//_̃Cg{[̗ʂZŕ`
+		//_{[̒ɂĂ`悤ɕ\ʂ̂āAʂŐ؂Ȃ悤ɃfvXNv
+		stats.lights = lights.size();
+		if (lights.size() > 0 && meshes.valid(volume)) {
+			const MeshBuffer::Mesh& mesh(meshes.get(volume));
+			lights.select(1);
+			glEnable(GL_BLEND);
+			glBlendFunc(GL_ONE, GL_ONE);
+			glCullFace(GL_FRONT);
+			glEnable(GL_DEPTH_CLAMP);
+			glUseProgram(point.get());
+			glUniformMatrix4fv(pointProjectionLoc, 1, GL_FALSE, projection.data());
+			glUniformMatrix4fv(pointInverseLoc, 1, GL_FALSE, inverse.data());
+			glUniform2fv(pointOriginLoc, 1, origin);
+			glUniform2fv(pointSizeLoc, 1, size);
+			glDrawElementsInstancedBaseVertex(GL_TRIANGLES, mesh.indexcount, GL_UNSIGNED_INT,
+				static_cast<const GLuint*>(0) + mesh.firstIndex, lights.size(), mesh.baseVertex);
+			glDisable(GL_DEPTH_CLAMP);
+			glCullFace(GL_BACK);
+			glDisable(GL_BLEND);
+		}
+
+		glDepthMask(GL_TRUE);
+		glEnable(GL_DEPTH_TEST);
+		stats.lightingTime = Profiler::elapsed(t0);
+	}
+
+	//vo
+	const Stats& getStats() const { return stats; }
+};
@@ -0,0 +1,205 @@
+#pragma once
+#include <chrono>
+#include <iostream>
+#include <algorithm>
+#include <GL/glew.h>
+
+//OpenGL̃IuWFNg̏L
+#include "GLHandle.h"
+
+//GPU̎gpʂ̋L^
+#include "GpuMemory.h"
+
+//v
+#include "Profiler.h"
+
+//I𑜓x̕`
+//r[kr[|[gi_jŃItXN[̃J[obt@ƃfvXobt@ɕ`A
+//EBhẼr[|[gɊg債ȂNsĎʂideferred.vert, upscale.fragj
+//eNX`̓EBhẼr[|[g̑傫ŊmۂA{ςĂ蒼Ȃ
+//`ԂGPU̎Ԃ^C}[NGőAResolutionControllerɓn
+//t[obt@IuWFNgƒ_zIuWFNgƃNG̓ReLXg̊ԂŋLȂ̂ŁA
+//r[ƂɍĈ̃ReLXgŎgAŏɎgƂɂ̃ReLXgō
+class DynamicResolution {
+public:
+	//v
+	struct Stats {
+		//beginend܂łGPU̎ԁi~bAvłȂ0j
+		double gpuTime;
+
+		//g̔sɂԁi~bj
+		double upscaleTime;
+	};
+
+private:
+	//g債đNsvOIuWFNg
+	const GLuint program;
+
+	//guniformϐ̏ꏊ
+	const GLint regionLoc, originLoc, sizeLoc, sharpnessLoc;
+
+	//`̃J[obt@ƃfvXobt@
+	GLTexture color, depth;
+
+	//`̑傫
+	GLsizei width, height;
+
+	//`̃t[obt@IuWFNg
+	GLFramebuffer framebuffer;
+
+	//ʑŜ𕢂Op``ƂɌ̒_zIuWFNg
+	GLVertexArray vertexArray;
+
+	//t[obt@IuWFNggȂtrue
+	bool incomplete;
+
+	//GPU̎Ԃ𑪂NGƌʂ҂Ă邩ǂ
+	GLQuery query;
+	bool pending;
+
+	//GL_ARB_timer_querygtrue
+	const bool timer;
+
+	//Ns̋
+	GLfloat sharpness;
+
+	//v
+	Stats stats;
+
+	//Rs[֎~
+	DynamicResolution(const DynamicResolution&) = delete;
+	DynamicResolution& operator=(const DynamicResolution&) = delete;
+
+	//`1f̃oCg
+	static std::size_t bytesPerPixel() { return 4 + 4; }
+
+	//`ȂƂw~h̑傫ɂ
+	void reserve(GLsizei w, GLsizei h) {
+		if (w <= width && h <= height) return;
+		GpuMemory::instance().release(GpuMemory::Texture, width * height * bytesPerPixel());
+		width = std::max(w, width);
+		height = std::max(h, height);
+		glBindTexture(GL_TEXTURE_2D, color.get());
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+		glBindTexture(GL_TEXTURE_2D, depth.get());
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT24, width, height, 0, GL_DEPTH_COMPONENT, GL_FLOAT, NULL);
+		glBindTexture(GL_TEXTURE_2D, 0);
+		GpuMemory::instance().allocate(GpuMemory::Texture, width * height * bytesPerPixel());
+
+		//t[obt@IuWFNg
+		if (!framebuffer) {
+			framebuffer = GLFramebuffer::create();
+			glBindFramebuffer(GL_FRAMEBUFFER, framebuffer.get());
+			glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, color.get(), 0);
+			glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, depth.get(), 0);
+			if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+				std::cerr << "Error: Dynamic resolution framebuffer is incomplete." << std::endl;
+				incomplete = true;
+			}
+			glBindFramebuffer(GL_FRAMEBUFFER, 0);
+		}
+	}
+
+public:
+	//RXgN^
+	//program:g債đNsvOIuWFNgideferred.vert, upscale.fragj
+	//sharpness:Ns̋i0Ȃo`Ԃj
+	DynamicResolution(GLuint program, GLfloat sharpness = 0.2f)
+		:program(program)
+		, regionLoc(glGetUniformLocation(program, "region"))
+		, originLoc(glGetUniformLocation(program, "outputOrigin"))
+		, sizeLoc(glGetUniformLocation(program, "outputSize"))
+		, sharpnessLoc(glGetUniformLocation(program, "sharpness"))
+		, color(GLTexture::create()), depth(GLTexture::create()), width(0), height(0)
+		, incomplete(false), pending(false), timer(GLEW_ARB_timer_query != GL_FALSE)
+		, sharpness(sharpness), stats()
+	{
+		//k̈̊Oǂ܂Ȃ悤ɃVF[_[ōW߂̂ŁAo`Ԃœǂ
+		glBindTexture(GL_TEXTURE_2D, color.get());
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		glBindTexture(GL_TEXTURE_2D, depth.get());
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+		glBindTexture(GL_TEXTURE_2D, 0);
+
+		//`0Ԃ̃eNX`jbgɌ
+		glUseProgram(program);
+		glUniform1i(glGetUniformLocation(program, "source"), 0);
+		glUseProgram(0);
+	}
+
+	//fXgN^
+	virtual ~DynamicResolution() {
+		GpuMemory::instance().release(GpuMemory::Texture, width * height * bytesPerPixel());
+	}
+
+	//`ɕ`n߂iGPU̎Ԃ𑪂n߂ĕ`j
+	//̂ƂŃr[beginĂŏkr[|[gɕ`
+	//x`łGobt@̃pX̑OɌĂсAGobt@̃pX̂ƂbindĂŌ
+	//output:EBhẼr[|[gix, y, , A`͂̑傫Ŋmۂj
+	//߂l:`悪gȂfalseikɊ̃t[obt@ɕ`j
+	bool begin(const GLint* output) {
+		reserve(output[2], output[3]);
+		if (incomplete) return false;
+		if (timer && !query) query = GLQuery::create();
+
+		//Õt[GPU̎ԂoĂΎo
+		if (pending) {
+			GLint available(GL_FALSE);
+			glGetQueryObjectiv(query.get(), GL_QUERY_RESULT_AVAILABLE, &available);
+			if (available) {
+				GLuint64 elapsed(0);
+				glGetQueryObjectui64v(query.get(), GL_QUERY_RESULT, &elapsed);
+				stats.gpuTime = static_cast<double>(elapsed) * 1.0e-6;
+				pending = false;
+			}
+		}
+		if (timer && !pending) glBeginQuery(GL_TIME_ELAPSED, query.get());
+		bind();
+		return true;
+	}
+
+	//`ibegin̂Ƃłق̃t[obt@ɕ`ƂɌĂԁj
+	void bind() const {
+		glBindFramebuffer(GL_FRAMEBUFFER, framebuffer.get());
+	}
+
+	//`ɕ`IăEBhẼr[|[gɊg傷
+	//viewport:`kr[|[gi_j
+	//output:EBhẼr[|[g
+	void end(const GLint* viewport, const GLint* output) {
+		const auto t0(std::chrono::high_resolution_clock::now());
+		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+		glViewport(output[0], output[1], output[2], output[3]);
+		glDisable(GL_DEPTH_TEST);
+		glDepthMask(GL_FALSE);
+		if (!vertexArray) vertexArray = GLVertexArray::create();
+		glBindVertexArray(vertexArray.get());
+		glUseProgram(program);
+		glUniform4f(regionLoc, static_cast<GLfloat>(viewport[2]), static_cast<GLfloat>(viewport[3]),
+			1.0f / static_cast<GLfloat>(width), 1.0f / static_cast<GLfloat>(height));
+		glUniform2f(originLoc, static_cast<GLfloat>(output[0]), static_cast<GLfloat>(output[1]));
+		glUniform2f(sizeLoc, static_cast<GLfloat>(output[2]), static_cast<GLfloat>(output[3]));
+		glUniform1f(sharpnessLoc, viewport[2] < output[2] ? sharpness : 0.0f);
+		glBindTexture(GL_TEXTURE_2D, color.get());
+		glDrawArrays(GL_TRIANGLES, 0, 3);
+		glBindTexture(GL_TEXTURE_2D, 0);
+		glBindVertexArray(0);
+		glDepthMask(GL_TRUE);
+		glEnable(GL_DEPTH_TEST);
+		if (timer && !pending) {
+			glEndQuery(GL_TIME_ELAPSED);
+			pending = true;
+		}
+		stats.upscaleTime = Profiler::elapsed(t0);
+	}
+
+	//Ns̋ݒ肷
+	void setSharpness(GLfloat s) { sharpness = s; }
+
+	//vo
+	const Stats& getStats() const { return stats; }
+};
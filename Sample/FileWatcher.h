@@ -0,0 +1,221 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <set>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <cstring>
+#include <cerrno>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+//LinuxłinotifyŕύX̒ʒm󂯁Aق̊ł͍XVIɒׂ
+//inotifygȂƂfBNgĎłȂƂXV𒲂ׂ
+#if defined(__linux__)
+#define FILEWATCHER_INOTIFY
+#include <unistd.h>
+#include <poll.h>
+#include <sys/inotify.h>
+#endif
+
+//t@C̕ύXĎ
+//Ď͐p̃XbhōsAύXꂽt@C̃pXnăR[obN֐Ăяo
+//GfB^͕ۑɉx񂾂ꎞt@Cu肷̂ŁAύX܂ő҂Ă܂Ƃ߂Ēʒm
+class FileWatcher {
+	//Ďt@C
+	struct File {
+		//pX
+		std::string path;
+
+		//t@CfBNgƃt@C
+		std::string directory, name;
+
+		//ŏIXVƃTCYiXV𒲂ׂꍇA͕bPʂȂ̂ŃTCYׂj
+		time_t modified;
+		off_t size;
+
+		//XVIɒׂȂtrueiinotifyŊĎłȂj
+		bool polled;
+	};
+
+	//Ďt@C
+	std::vector<File> files;
+
+	//files̔r
+	std::mutex mutex;
+
+	//ύXꂽt@CnČĂяoiĎ̃XbhŌĂяoj
+	const std::function<void(const std::string&)> changed;
+
+	//Ď̃Xbh
+	std::thread thread;
+
+	//Ď𑱂Ȃtrue
+	std::atomic<bool> running;
+
+	//ύXƂ݂Ȃ܂ł̎
+	static constexpr int SettleTime = 100;
+
+#if defined(FILEWATCHER_INOTIFY)
+	//inotifỹt@CLqq
+	int fd;
+
+	//ĎĂfBNgƂ̊ĎLqq
+	std::vector<std::pair<int, std::string>> directories;
+#endif
+
+	//Rs[֎~
+	FileWatcher(const FileWatcher&) = delete;
+	FileWatcher& operator=(const FileWatcher&) = delete;
+
+	//t@C̍ŏIXVƃTCY𒲂ׂ
+	//߂l:t@Ctrue
+	static bool status(const std::string& path, time_t& modified, off_t& size) {
+		struct stat s;
+		if (stat(path.c_str(), &s) != 0) return false;
+		modified = s.st_mtime;
+		size = s.st_size;
+		return true;
+	}
+
+	//XV𒲂ׂt@ĈύXꂽ̂W߂
+	//pending:ύXꂽt@C̃pXǉ
+	//߂l:ύXꂽt@Ctrue
+	bool scan(std::set<std::string>& pending) {
+		bool found(false);
+		std::lock_guard<std::mutex> lock(mutex);
+		for (File& f : files) {
+			if (!f.polled) continue;
+			time_t t;
+			off_t n;
+			if (status(f.path, t, n) && (t != f.modified || n != f.size)) {
+				f.modified = t;
+				f.size = n;
+				pending.insert(f.path);
+				found = true;
+			}
+		}
+		return found;
+	}
+
+	//ύXꂽt@CW߂iύXȂtimeout~b܂ő҂j
+	//pending:ύXꂽt@C̃pXǉ
+	//߂l:ĎĂt@CύXĂtrue
+	bool collect(std::set<std::string>& pending, int timeout) {
+		bool found(false);
+#if defined(FILEWATCHER_INOTIFY)
+		pollfd p = { fd, POLLIN, 0 };
+		if (fd < 0) {
+			std::this_thread::sleep_for(std::chrono::milliseconds(timeout));
+		}
+		else if (poll(&p, 1, timeout) > 0) {
+			//CxǧɃt@C
+			alignas(inotify_event) char buffer[4096];
+			const ssize_t length(read(fd, buffer, sizeof buffer));
+			for (ssize_t offset = 0; offset < length;) {
+				const inotify_event* const event(reinterpret_cast<const inotify_event*>(buffer + offset));
+				offset += sizeof(inotify_event) + event->len;
+				if (event->len == 0) continue;
+
+				std::lock_guard<std::mutex> lock(mutex);
+				for (const auto& d : directories) {
+					if (d.first != event->wd) continue;
+					for (const File& f : files)
+						if (f.directory == d.second && f.name == event->name) {
+							pending.insert(f.path);
+							found = true;
+						}
+				}
+			}
+		}
+#else
+		std::this_thread::sleep_for(std::chrono::milliseconds(timeout));
+#endif
+		//inotifyŊĎłȂt@C͍XV𒲂ׂ
+		if (scan(pending)) found = true;
+		return found;
+	}
+
+	//Ď̃Xbh̏
+	void run() {
+		std::set<std::string> pending;
+		while (running.load(std::memory_order_acquire)) {
+			//SettleTime̊ԂɐVύXȂΒʒm
+			if (!collect(pending, pending.empty() ? 250 : SettleTime) && !pending.empty()) {
+				for (const std::string& path : pending) changed(path);
+				pending.clear();
+			}
+		}
+	}
+
+public:
+	//RXgN^
+	//f:f(path)̌`ŌĂяoiĎ̃XbhŌĂяoj
+	explicit FileWatcher(std::function<void(const std::string&)> f)
+		:changed(f), running(true)
+	{
+#if defined(FILEWATCHER_INOTIFY)
+		fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+		if (fd < 0) std::cerr << "Warning: inotify is not available (" << std::strerror(errno) << "). Polling modification times instead." << std::endl;
+#endif
+		thread = std::thread([this]() { run(); });
+	}
+
+	//fXgN^
+	virtual ~FileWatcher() {
+		stop();
+#if defined(FILEWATCHER_INOTIFY)
+		if (fd >= 0) close(fd);
+#endif
+	}
+
+	//Ď߂ăXbh̏I҂iR[obN֐͂ĂяoȂj
+	void stop() {
+		running.store(false, std::memory_order_release);
+		if (thread.joinable()) thread.join();
+	}
+
+	//t@CĎɉiłɊĎĂΉȂj
+	//path:t@C̃pX
+	void watch(const std::string& path) {
+		std::lock_guard<std::mutex> lock(mutex);
+		for (const File& f : files)
+			if (f.path == path) return;
+
+		const std::string::size_type slash(path.find_last_of("/\\"));
+		File f;
+		f.path = path;
+		f.directory = slash == std::string::npos ? "." : path.substr(0, slash);
+		f.name = slash == std::string::npos ? path : path.substr(slash + 1);
+		f.modified = 0;
+		f.size = 0;
+		f.polled = true;
+		status(path, f.modified, f.size);
+
+#if defined(FILEWATCHER_INOTIFY)
+		//t@CuĕۑGfB^̂ŃfBNgĎ
+		//ĎłȂ΍XV𒲂ׂ
+		if (fd >= 0) {
+			bool watched(false);
+			for (const auto& d : directories)
+				if (d.second == f.directory) watched = true;
+			if (!watched) {
+				const int wd(inotify_add_watch(fd, f.directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE));
+				if (wd < 0)
+					std::cerr << "Warning: Can't watch directory: " << f.directory << " (" << std::strerror(errno)
+						<< "). Polling modification times instead." << std::endl;
+				else {
+					directories.push_back(std::make_pair(wd, f.directory));
+					watched = true;
+				}
+			}
+			f.polled = !watched;
+		}
+#endif
+		files.push_back(f);
+	}
+};
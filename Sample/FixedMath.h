@@ -0,0 +1,352 @@
+#pragma once
+#include <GL/glew.h>
+
+//ϊs
+#include "Matrix.h"
+
+//傫RpCɌ߂xNgƍsAAtBϊAl
+//ׂẲZconstexprɂĂ̂ŐÓIȕ\̌vZɂg
+//AtBϊ͍Ō̍s(0, 0, 0, 1)ł邱Ƃ𗘗pĐςƖ@ϊšvZȂ
+//OpenGLɓnƂtoMatrixMatrixɕϊ
+
+//RpCɌvZł镽ij[g@j
+constexpr GLfloat constSqrt(GLfloat x) {
+	if (!(x > 0.0f)) return 0.0f;
+	if (!(x < 3.4e38f)) return x;
+
+	//[0.25, 4]Ɏ߂Ă狁߂
+	GLfloat s(1.0f);
+	while (x > 4.0f) { x *= 0.25f; s *= 2.0f; }
+	while (x < 0.25f) { x *= 4.0f; s *= 0.5f; }
+	GLfloat r((x + 1.0f) * 0.5f);
+	for (int i = 0; i < 5; ++i) r = (r + x / r) * 0.5f;
+	return r * s;
+}
+
+//RpCɌvZł鐳i[-/2, /2]ɈڂăeC[WJj
+constexpr GLfloat constSin(GLfloat a) {
+	const GLfloat pi(3.14159265f);
+	const long long k(static_cast<long long>(a * (0.5f / pi) + (a < 0.0f ? -0.5f : 0.5f)));
+	a -= static_cast<GLfloat>(k) * 2.0f * pi;
+	if (a > 0.5f * pi) a = pi - a;
+	else if (a < -0.5f * pi) a = -pi - a;
+	const GLfloat a2(a * a);
+	return a * (1.0f - a2 / 6.0f * (1.0f - a2 / 20.0f * (1.0f - a2 / 42.0f * (1.0f - a2 / 72.0f * (1.0f - a2 / 110.0f)))));
+}
+
+//RpCɌvZł]
+constexpr GLfloat constCos(GLfloat a) {
+	return constSin(a + 1.57079633f);
+}
+
+//ÑxNg
+template<int N>
+struct Vec {
+	//vf
+	GLfloat v[N];
+
+	//vfQƂ
+	constexpr GLfloat& operator[](int i) { return v[i]; }
+	constexpr GLfloat operator[](int i) const { return v[i]; }
+
+	//vf̔zԂ
+	constexpr const GLfloat* data() const { return v; }
+
+	constexpr Vec operator+(const Vec& a) const {
+		Vec t{};
+		for (int i = 0; i < N; ++i) t.v[i] = v[i] + a.v[i];
+		return t;
+	}
+
+	constexpr Vec operator-(const Vec& a) const {
+		Vec t{};
+		for (int i = 0; i < N; ++i) t.v[i] = v[i] - a.v[i];
+		return t;
+	}
+
+	constexpr Vec operator-() const {
+		Vec t{};
+		for (int i = 0; i < N; ++i) t.v[i] = -v[i];
+		return t;
+	}
+
+	constexpr Vec operator*(GLfloat s) const {
+		Vec t{};
+		for (int i = 0; i < N; ++i) t.v[i] = v[i] * s;
+		return t;
+	}
+};
+
+//
+template<int N>
+constexpr GLfloat dot(const Vec<N>& a, const Vec<N>& b) {
+	GLfloat s(0.0f);
+	for (int i = 0; i < N; ++i) s += a[i] * b[i];
+	return s;
+}
+
+//
+template<int N>
+constexpr GLfloat length(const Vec<N>& a) {
+	return constSqrt(dot(a, a));
+}
+
+//Ki0Ȃ炻̂܂ܕԂj
+template<int N>
+constexpr Vec<N> normalize(const Vec<N>& a) {
+	const GLfloat l(length(a));
+	return l > 0.0f ? a * (1.0f / l) : a;
+}
+
+//O
+constexpr Vec<3> cross(const Vec<3>& a, const Vec<3>& b) {
+	return Vec<3>{ a[1] * b[2] - a[2] * b[1], a[2] * b[0] - a[0] * b[2], a[0] * b[1] - a[1] * b[0] };
+}
+
+//RsC̍si񂲂ƂɊi[j
+template<int R, int C>
+struct Mat {
+	//vf
+	GLfloat m[R * C];
+
+	//rsc̗vfQƂ
+	constexpr GLfloat& operator()(int r, int c) { return m[c * R + r]; }
+	constexpr GLfloat operator()(int r, int c) const { return m[c * R + r]; }
+
+	//vf̔zԂ
+	constexpr const GLfloat* data() const { return m; }
+
+	//Pʍs
+	static constexpr Mat identity() {
+		Mat t{};
+		for (int i = 0; i < R && i < C; ++i) t(i, i) = 1.0f;
+		return t;
+	}
+
+	//s̐
+	template<int K>
+	constexpr Mat<R, K> operator*(const Mat<C, K>& b) const {
+		Mat<R, K> t{};
+		for (int k = 0; k < K; ++k) {
+			for (int r = 0; r < R; ++r) {
+				GLfloat s(0.0f);
+				for (int c = 0; c < C; ++c) s += (*this)(r, c) * b(c, k);
+				t(r, k) = s;
+			}
+		}
+		return t;
+	}
+
+	//sƃxNg̐
+	constexpr Vec<R> operator*(const Vec<C>& v) const {
+		Vec<R> t{};
+		for (int r = 0; r < R; ++r) {
+			GLfloat s(0.0f);
+			for (int c = 0; c < C; ++c) s += (*this)(r, c) * v[c];
+			t[r] = s;
+		}
+		return t;
+	}
+
+	//]us
+	constexpr Mat<C, R> transpose() const {
+		Mat<C, R> t{};
+		for (int c = 0; c < C; ++c) for (int r = 0; r < R; ++r) t(c, r) = (*this)(r, c);
+		return t;
+	}
+};
+
+//lix, y, zAwj
+struct Quat {
+	GLfloat x, y, z, w;
+
+	//]Ȃl
+	static constexpr Quat identity() { return Quat{ 0.0f, 0.0f, 0.0f, 1.0f }; }
+
+	//(x, y, z)a]l
+	static constexpr Quat rotate(GLfloat a, GLfloat x, GLfloat y, GLfloat z) {
+		const GLfloat d(constSqrt(x * x + y * y + z * z));
+		if (!(d > 0.0f)) return identity();
+		const GLfloat s(constSin(a * 0.5f) / d);
+		return Quat{ x * s, y * s, z * s, constCos(a * 0.5f) };
+	}
+
+	//ρiqɓKpĂ炱̉]Kpj
+	constexpr Quat operator*(const Quat& q) const {
+		return Quat{
+			w * q.x + x * q.w + y * q.z - z * q.y,
+			w * q.y - x * q.z + y * q.w + z * q.x,
+			w * q.z + x * q.y - y * q.x + z * q.w,
+			w * q.w - x * q.x - y * q.y - z * q.z
+		};
+	}
+
+	//iPʎlȂt]j
+	constexpr Quat conjugate() const { return Quat{ -x, -y, -z, w }; }
+
+	//K
+	constexpr Quat normalize() const {
+		const GLfloat l(constSqrt(x * x + y * y + z * z + w * w));
+		return l > 0.0f ? Quat{ x / l, y / l, z / l, w / l } : identity();
+	}
+
+	//xNg]iv + 2w(q~v) + 2q~(q~v)ōs炸ɋ߂j
+	constexpr Vec<3> rotate(const Vec<3>& v) const {
+		const Vec<3> q{ x, y, z };
+		const Vec<3> t(cross(q, v) * 2.0f);
+		return v + t * w + cross(q, t);
+	}
+
+	//`ԂĐKi߂ق̌ŕԂj
+	static constexpr Quat nlerp(const Quat& a, const Quat& b, GLfloat t) {
+		const GLfloat s(a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w < 0.0f ? -t : t);
+		const GLfloat u(1.0f - t);
+		return Quat{ a.x * u + b.x * s, a.y * u + b.y * s, a.z * u + b.z * s, a.w * u + b.w * s }.normalize();
+	}
+};
+
+//3s4̃AtBϊiŌ̍s(0, 0, 0, 1)Ȃ̂ŎȂj
+//m[0]`m[8]񂲂ƂɊi[3~3̐`ϊAm[9]`m[11]sړ
+struct Affine {
+	//vf
+	GLfloat m[12];
+
+	//Pϊ
+	static constexpr Affine identity() {
+		return Affine{ { 1.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f } };
+	}
+
+	//(x, y, z)sړ
+	static constexpr Affine translate(GLfloat x, GLfloat y, GLfloat z) {
+		return Affine{ { 1.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f, x, y, z } };
+	}
+
+	//(x, y, z){Ɋgk
+	static constexpr Affine scale(GLfloat x, GLfloat y, GLfloat z) {
+		return Affine{ { x, 0.0f, 0.0f, 0.0f, y, 0.0f, 0.0f, 0.0f, z, 0.0f, 0.0f, 0.0f } };
+	}
+
+	//l̉]
+	static constexpr Affine rotate(const Quat& q) {
+		const GLfloat xx(q.x * q.x), yy(q.y * q.y), zz(q.z * q.z);
+		const GLfloat xy(q.x * q.y), yz(q.y * q.z), zx(q.z * q.x);
+		const GLfloat wx(q.w * q.x), wy(q.w * q.y), wz(q.w * q.z);
+		return Affine{ {
+			1.0f - 2.0f * (yy + zz), 2.0f * (xy + wz), 2.0f * (zx - wy),
+			2.0f * (xy - wz), 1.0f - 2.0f * (zz + xx), 2.0f * (yz + wx),
+			2.0f * (zx + wy), 2.0f * (yz - wx), 1.0f - 2.0f * (xx + yy),
+			0.0f, 0.0f, 0.0f
+		} };
+	}
+
+	//(x, y, z)a]
+	static constexpr Affine rotate(GLfloat a, GLfloat x, GLfloat y, GLfloat z) {
+		return rotate(Quat::rotate(a, x, y, z));
+	}
+
+	//sړtA]qAgksxɑgݗĂitranslate(t) * rotate(q) * scale(s)Ɠj
+	static constexpr Affine trs(const Vec<3>& t, const Quat& q, const Vec<3>& s) {
+		Affine a(rotate(q));
+		for (int c = 0; c < 3; ++c) for (int r = 0; r < 3; ++r) a.m[c * 3 + r] *= s[c];
+		a.m[9] = t[0];
+		a.m[10] = t[1];
+		a.m[11] = t[2];
+		return a;
+	}
+
+	//ρiŌ̍sȂ̂ŏZ36j
+	constexpr Affine operator*(const Affine& b) const {
+		Affine t{};
+		for (int c = 0; c < 4; ++c) {
+			for (int r = 0; r < 3; ++r) {
+				t.m[c * 3 + r] = m[r] * b.m[c * 3] + m[3 + r] * b.m[c * 3 + 1] + m[6 + r] * b.m[c * 3 + 2];
+			}
+		}
+		t.m[9] += m[9];
+		t.m[10] += m[10];
+		t.m[11] += m[11];
+		return t;
+	}
+
+	//E畽sړ|i*this * translate(x, y, z)Z9ŋ߂j
+	constexpr Affine translated(GLfloat x, GLfloat y, GLfloat z) const {
+		Affine t(*this);
+		for (int r = 0; r < 3; ++r) t.m[9 + r] += m[r] * x + m[3 + r] * y + m[6 + r] * z;
+		return t;
+	}
+
+	//Egk|i*this * scale(x, y, z)Z9ŋ߂j
+	constexpr Affine scaled(GLfloat x, GLfloat y, GLfloat z) const {
+		Affine t(*this);
+		for (int r = 0; r < 3; ++r) {
+			t.m[r] *= x;
+			t.m[3 + r] *= y;
+			t.m[6 + r] *= z;
+		}
+		return t;
+	}
+
+	//_ϊ
+	constexpr Vec<3> transformPoint(const Vec<3>& p) const {
+		return Vec<3>{
+			m[0] * p[0] + m[3] * p[1] + m[6] * p[2] + m[9],
+			m[1] * p[0] + m[4] * p[1] + m[7] * p[2] + m[10],
+			m[2] * p[0] + m[5] * p[1] + m[8] * p[2] + m[11]
+		};
+	}
+
+	//xNgϊisړȂj
+	constexpr Vec<3> transformVector(const Vec<3>& v) const {
+		return Vec<3>{
+			m[0] * v[0] + m[3] * v[1] + m[6] * v[2],
+			m[1] * v[0] + m[4] * v[1] + m[7] * v[2],
+			m[2] * v[0] + m[5] * v[1] + m[8] * v[2]
+		};
+	}
+
+	//@xNg̕ϊsi3~3̗̕]qsAMatrix::getNormalMatrixƓj
+	constexpr Mat<3, 3> normalMatrix() const {
+		return Mat<3, 3>{ {
+			m[4] * m[8] - m[5] * m[7], m[5] * m[6] - m[3] * m[8], m[3] * m[7] - m[4] * m[6],
+			m[7] * m[2] - m[8] * m[1], m[8] * m[0] - m[6] * m[2], m[6] * m[1] - m[7] * m[0],
+			m[1] * m[5] - m[2] * m[4], m[2] * m[3] - m[0] * m[5], m[0] * m[4] - m[1] * m[3]
+		} };
+	}
+
+	//@xNg̕ϊszɋ߂
+	void getNormalMatrix(GLfloat* n) const {
+		const Mat<3, 3> t(normalMatrix());
+		for (int i = 0; i < 9; ++i) n[i] = t.m[i];
+	}
+
+	//tϊiłȂ΍PϊԂj
+	constexpr Affine inverse() const {
+		const Mat<3, 3> n(normalMatrix());
+		const GLfloat det(m[0] * n.m[0] + m[1] * n.m[1] + m[2] * n.m[2]);
+		if (det == 0.0f) return identity();
+
+		//`̋ts͗]qs̓]us񎮂Ŋ
+		Affine t{};
+		for (int c = 0; c < 3; ++c) for (int r = 0; r < 3; ++r) t.m[c * 3 + r] = n.m[r * 3 + c] / det;
+		for (int r = 0; r < 3; ++r) t.m[9 + r] = -(t.m[r] * m[9] + t.m[3 + r] * m[10] + t.m[6 + r] * m[11]);
+		return t;
+	}
+
+	//4s4̍sɂ
+	constexpr Mat<4, 4> toMat4() const {
+		return Mat<4, 4>{ {
+			m[0], m[1], m[2], 0.0f, m[3], m[4], m[5], 0.0f,
+			m[6], m[7], m[8], 0.0f, m[9], m[10], m[11], 1.0f
+		} };
+	}
+
+	//OpenGLɓnϊsɂ
+	Matrix toMatrix() const {
+		return Matrix(toMat4().data());
+	}
+
+	//ϊs̍Ō̍ŝĂăAtBϊɂ
+	static Affine fromMatrix(const Matrix& a) {
+		return Affine{ { a[0], a[1], a[2], a[4], a[5], a[6], a[8], a[9], a[10], a[12], a[13], a[14] } };
+	}
+};
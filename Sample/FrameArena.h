@@ -0,0 +1,239 @@
+#pragma once
+#include <vector>
+#include <new>
+#include <cstddef>
+#include <iostream>
+#include <atomic>
+
+//t[Ƃ̈ꎞIȃf[^mۂ`AP[^
+//XbhƂɗ̈iTuA[ij𕪂A擪l߂Ċmۂ邾Ōʂɂ͉Ȃ
+//̈frames̃t[pӂAbeginFrameőOgframesÕt[̗̈܂Ƃ߂ċɂ
+//̂GPU⃏[J[Õt[̃f[^QƂĂԂ㏑Ȃ
+//̈悪ȂȂƂ̓q[vmۂČxÃt[̗̈ɂƂɉ
+class FrameArena {
+public:
+	//v
+	struct Stats {
+		//݂̃t[ŊmۂoCgiSXbh̍vj
+		std::size_t used;
+
+		//̃t[ŊmۂoCg̍őliōʁj
+		std::size_t peak;
+
+		//̃Xbh̃t[ŊmۂoCg̍ől
+		std::size_t threadPeak;
+
+		//XbhƂ̗̈̃oCg
+		std::size_t capacity;
+
+		//̈ɓ肫炸q[vmۂ
+		unsigned int overflows;
+	};
+
+private:
+	//̈ɓ肫炸q[vmۂubN
+	struct Overflow {
+		//̃ubN
+		Overflow* next;
+	};
+
+	//XbhƂ̗̈iʂ̃XbhƓLbVCLɂ悤64oCgɂj
+	struct SubArena {
+		//̈̐擪
+		unsigned char* base;
+
+		//gpς݂̃oCg
+		std::size_t offset;
+
+		//q[vmۂubÑXg
+		Overflow* overflow;
+
+		//q[vmۂoCg
+		std::size_t overflowBytes;
+
+		//64oCgɂ邽߂̋lߕ
+		unsigned char padding[64 - sizeof(void*) * 2 - sizeof(std::size_t) * 2];
+	};
+
+	//XbhƂ̗̈̃oCg
+	const std::size_t capacity;
+
+	//Xbh̐
+	const unsigned int threads;
+
+	//obt@Ot[̐
+	const unsigned int frames;
+
+	//St[ESXbḧ̗̌ɂȂ郁
+	unsigned char* memory;
+
+	//t[ƃXbhƂ̗̈iframe * threads + thread ̈ʒuj
+	std::vector<SubArena> arenas;
+
+	//݂̃t[̔ԍ
+	unsigned int frame;
+
+	//̃t[ŊmۂoCg̍ől
+	std::size_t peak;
+
+	//̃Xbh̃t[ŊmۂoCg̍ől
+	std::size_t threadPeak;
+
+	//q[vmۂ񐔁i[J[Xbhj
+	std::atomic<unsigned int> overflows;
+
+	//t[̗̈̃oCgiSXbh̍vj
+	std::size_t frameUsed(unsigned int f) const {
+		std::size_t used(0);
+		for (unsigned int t = 0; t < threads; ++t) {
+			const SubArena& a(arenas[f * threads + t]);
+			used += a.offset + a.overflowBytes;
+		}
+		return used;
+	}
+
+	//TuA[iɂ
+	void reset(SubArena& a) {
+		for (Overflow* o = a.overflow; o != NULL;) {
+			Overflow* const next(o->next);
+			::operator delete(o);
+			o = next;
+		}
+		a.offset = 0;
+		a.overflow = NULL;
+		a.overflowBytes = 0;
+	}
+
+	//Rs[֎~
+	FrameArena(const FrameArena&) = delete;
+	FrameArena& operator=(const FrameArena&) = delete;
+
+public:
+	//RXgN^
+	//threads:gpXbh̐iThreadPool::size()j
+	//capacity:XbhƁEt[Ƃ̗̈̃oCg
+	//frames:obt@Ot[̐
+	FrameArena(unsigned int threads, std::size_t capacity = 1 << 20, unsigned int frames = 3)
+		:capacity((capacity + 63) & ~static_cast<std::size_t>(63))
+		, threads(threads > 0 ? threads : 1), frames(frames > 0 ? frames : 1)
+		, arenas(this->threads * this->frames), frame(0), peak(0), threadPeak(0), overflows(0)
+	{
+		memory = static_cast<unsigned char*>(::operator new(this->capacity * arenas.size()));
+		for (std::size_t i = 0; i < arenas.size(); ++i) {
+			arenas[i].base = memory + i * this->capacity;
+			arenas[i].offset = 0;
+			arenas[i].overflow = NULL;
+			arenas[i].overflowBytes = 0;
+		}
+	}
+
+	//fXgN^
+	virtual ~FrameArena() {
+		for (auto& a : arenas) reset(a);
+		::operator delete(memory);
+	}
+
+	//̃t[ɐi݁Ãt[̗̈ɂ
+	//̌ĂяǒframesÕt[Ŋmۂf[^gĂ͂Ȃ
+	void beginFrame() {
+		//It[̎gpʂōōʂXV
+		const std::size_t used(frameUsed(frame));
+		if (used > peak) peak = used;
+		for (unsigned int t = 0; t < threads; ++t) {
+			const SubArena& a(arenas[frame * threads + t]);
+			if (a.offset + a.overflowBytes > threadPeak) threadPeak = a.offset + a.overflowBytes;
+		}
+
+		frame = (frame + 1) % frames;
+		for (unsigned int t = 0; t < threads; ++t) reset(arenas[frame * threads + t]);
+	}
+
+	//mۂ
+	//bytes:oCg
+	//alignment:ẼoCgi2ׂ̂Aalignof(std::max_align_t)ȉj
+	//thread:mۂXbh̔ԍiThreadPoolparallelForɓnԍAĂяo0j
+	void* allocate(std::size_t bytes, std::size_t alignment = alignof(std::max_align_t), unsigned int thread = 0) {
+		SubArena& a(arenas[frame * threads + thread]);
+		const std::size_t start((a.offset + alignment - 1) & ~(alignment - 1));
+		if (start + bytes <= capacity) {
+			a.offset = start + bytes;
+			return a.base + start;
+		}
+
+		//̈悪Ȃ΃q[vmۂ
+		if (overflows++ == 0) {
+			std::cerr << "Warning: FrameArena overflow (" << bytes << " bytes on thread " << thread
+				<< ", capacity " << capacity << " bytes)." << std::endl;
+		}
+		const std::size_t header((sizeof(Overflow) + alignment - 1) & ~(alignment - 1));
+		Overflow* const o(static_cast<Overflow*>(::operator new(header + bytes)));
+		o->next = a.overflow;
+		a.overflow = o;
+		a.overflowBytes += bytes;
+		return reinterpret_cast<unsigned char*>(o) + header;
+	}
+
+	//zmۂivf͏Ȃj
+	//count:vf̐
+	//thread:mۂXbh̔ԍ
+	template<typename T>
+	T* allocate(std::size_t count, unsigned int thread = 0) {
+		return static_cast<T*>(allocate(count * sizeof(T), alignof(T), thread));
+	}
+
+	//Xbh̐
+	unsigned int getThreads() const { return threads; }
+
+	//vo
+	Stats getStats() const {
+		Stats stats;
+		stats.used = frameUsed(frame);
+		stats.peak = stats.used > peak ? stats.used : peak;
+		stats.threadPeak = threadPeak;
+		stats.capacity = capacity;
+		stats.overflows = overflows;
+		return stats;
+	}
+};
+
+//FrameArenamۂSTL̃AP[^
+//deallocate͉Ȃ̂ŁARei͂̃t[̂ɎgI
+template<typename T>
+class FrameAllocator {
+	//mې
+	FrameArena* arena;
+
+	//mۂXbh̔ԍ
+	unsigned int thread;
+
+	template<typename U> friend class FrameAllocator;
+
+public:
+	typedef T value_type;
+
+	//RXgN^
+	//arena:mې
+	//thread:mۂXbh̔ԍ
+	explicit FrameAllocator(FrameArena& arena, unsigned int thread = 0) :arena(&arena), thread(thread) {}
+
+	//ʂ̌^̃AP[^
+	template<typename U>
+	FrameAllocator(const FrameAllocator<U>& o) :arena(o.arena), thread(o.thread) {}
+
+	//mۂ
+	T* allocate(std::size_t n) {
+		return arena->allocate<T>(n, thread);
+	}
+
+	//̓t[̗̈ɂƂɂ܂Ƃ߂čs
+	void deallocate(T*, std::size_t) {}
+
+	template<typename U>
+	bool operator==(const FrameAllocator<U>& o) const { return arena == o.arena && thread == o.thread; }
+	template<typename U>
+	bool operator!=(const FrameAllocator<U>& o) const { return !(*this == o); }
+};
+
+//t[̊Ԃgz
+template<typename T>
+using FrameVector = std::vector<T, FrameAllocator<T>>;
@@ -0,0 +1,121 @@
+#pragma once
+#include <thread>
+#include <chrono>
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+
+//t[̊Jnƕ\̃^C~O߂
+//VSyncglfwSwapInterval(1)Ő҂
+//Latency͐g킸A\̎ƂɌ߂Ă̖ڕW̒xOɃt[n߂
+//͂ǂł\܂ł̎ԂڕW̒xɋ߂ÂieAO͋N肤j
+class FramePacer {
+public:
+	//
+	typedef std::chrono::steady_clock Clock;
+
+	//[h
+	enum Mode {
+		VSync,
+		Latency
+	};
+
+	//v
+	struct Stats {
+		//Ō̃t[̊Jn\܂ł̎ԁi~bj
+		double latency;
+
+		//\̎ɊԂɍȂt[̐
+		unsigned long long missed;
+	};
+
+private:
+	//[h
+	Mode mode;
+
+	//\̎
+	Clock::duration period;
+
+	//t[̊Jn\܂ł̖ڕW̎
+	Clock::duration target;
+
+	//̕\̎
+	Clock::time_point deadline;
+
+	//t[̊Jn
+	Clock::time_point start;
+
+	//v
+	Stats stats;
+
+	//~bԂɒ
+	static Clock::duration milliseconds(double ms) {
+		return std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double, std::milli>(ms));
+	}
+
+	//܂ő҂
+	//sleep͐xêōŌ1~b͋肵đ҂
+	static void waitUntil(Clock::time_point t) {
+		const Clock::time_point coarse(t - std::chrono::milliseconds(1));
+		if (Clock::now() < coarse) std::this_thread::sleep_until(coarse);
+		while (Clock::now() < t) std::this_thread::yield();
+	}
+
+public:
+	//RXgN^
+	FramePacer() :mode(VSync), period(milliseconds(1000.0 / 60.0)), target(period), stats() {
+	}
+
+	//҂
+	void setVSync() {
+		mode = VSync;
+		glfwSwapInterval(1);
+	}
+
+	//ڕW̒xɍ킹ăt[n߂
+	//periodMs:\̎i~bj
+	//latencyMs:t[̊Jn\܂ł̖ڕW̎ԁi~bj
+	void setLatency(double periodMs, double latencyMs) {
+		mode = Latency;
+		period = milliseconds(periodMs);
+		target = milliseconds(latencyMs < periodMs ? latencyMs : periodMs);
+		deadline = Clock::now() + period;
+		glfwSwapInterval(0);
+	}
+
+	//[h
+	Mode getMode() const { return mode; }
+
+	//t[n߂i͂ǂޑOɌĂԁj
+	void beginFrame() {
+		if (mode == Latency) waitUntil(deadline - target);
+		start = Clock::now();
+	}
+
+	//\̎܂ő҂ăJ[obt@ւ
+	//window:ւEBhE
+	template<typename W>
+	void present(const W& window) {
+		if (mode == Latency) waitUntil(deadline);
+		window.swapBuffers();
+
+		if (mode == Latency) {
+			//\Î҂Ēx𑪂
+			glFinish();
+			const Clock::time_point now(Clock::now());
+			stats.latency = std::chrono::duration<double, std::milli>(now - start).count();
+
+			//ԂɍȂ΂Ď̕\̎߂
+			deadline += period;
+			while (deadline - target < now) {
+				deadline += period;
+				++stats.missed;
+			}
+		}
+		else {
+			stats.latency = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+		}
+	}
+
+	//vo
+	const Stats& getStats() const { return stats; }
+};
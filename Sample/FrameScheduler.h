@@ -0,0 +1,164 @@
+#pragma once
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <functional>
+
+//bNgȂl̎󂯓n
+#include "TripleBuffer.h"
+
+//Œ̎ԍ݂ŃV~[Vi߂XPW[
+//V~[V͐p̃Xbhňbratei߁A񂲂ƂɒOƌ݂̏Ԃgvobt@ŌJ
+//`摤͌Jꂽ̏ԂݎŕԂĎĝŁAt[[gɂ炸ɂȂ
+//͂̓Xebv̊֐̒ŃCxg̃L[o
+//State:V~[V̏ԁiRs[ł^j
+template<typename State>
+class FrameScheduler {
+public:
+	//
+	typedef std::chrono::steady_clock Clock;
+
+	//V~[V̈Xebv
+	//state:XV
+	//dt:ԍ݁ibj
+	typedef std::function<void(State& state, double dt)> Step;
+
+	//v
+	struct Stats {
+		//i߂Xebv̐
+		unsigned long long ticks;
+
+		//x߂Ɏ̂ĂXebv̐
+		unsigned long long dropped;
+	};
+
+private:
+	//J
+	struct Snapshot {
+		//Oƌ݂̏
+		State previous, current;
+
+		//݂̏Ԃ̎iȌԂ͂̎ԍݑOj
+		Clock::time_point time;
+
+		//Xebv̔ԍ
+		unsigned long long tick;
+	};
+
+	//ԍ
+	const Clock::duration dt;
+
+	//xɎ߂Xebv̍ő吔
+	const unsigned int maxCatchUp;
+
+	//V~[ṼXbhĂ
+	State state;
+
+	//V~[V̈Xebv
+	Step step;
+
+	//`摤ɓn
+	TripleBuffer<Snapshot> snapshots;
+
+	//V~[ṼXbh
+	std::thread thread;
+
+	//Iv
+	std::atomic<bool> quit;
+
+	//i߂Xebv̐Ǝ̂ĂXebv̐
+	std::atomic<unsigned long long> ticks, dropped;
+
+	//V~[ṼXbh̏
+	void run() {
+		const double seconds(std::chrono::duration<double>(dt).count());
+		Clock::time_point next(Clock::now());
+		unsigned long long tick(0);
+		while (!quit.load(std::memory_order_relaxed)) {
+			//̃Xebv̎܂ő҂
+			std::this_thread::sleep_until(next);
+
+			//xꂷĂ߂̂߂
+			const Clock::time_point now(Clock::now());
+			const long long behind((now - next) / dt - static_cast<long long>(maxCatchUp));
+			if (behind > 0) {
+				next += dt * behind;
+				dropped.fetch_add(static_cast<unsigned long long>(behind), std::memory_order_relaxed);
+			}
+
+			//ɒǂ܂ŃXebvi߂
+			for (; next <= now; next += dt) {
+				Snapshot& snapshot(snapshots.write());
+				snapshot.previous = state;
+				step(state, seconds);
+				snapshot.current = state;
+				snapshot.time = next;
+				snapshot.tick = ++tick;
+				snapshots.publish();
+				ticks.fetch_add(1, std::memory_order_relaxed);
+			}
+		}
+	}
+
+	//Rs[֎~
+	FrameScheduler(const FrameScheduler&) = delete;
+	FrameScheduler& operator=(const FrameScheduler&) = delete;
+
+public:
+	//RXgN^
+	//rate:b̃Xebv̐
+	//initial:Ԃ̏l
+	//maxCatchUp:xɎ߂Xebv̍ő吔
+	FrameScheduler(double rate, const State& initial, unsigned int maxCatchUp = 5)
+		:dt(std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / rate)))
+		, maxCatchUp(maxCatchUp), state(initial)
+		, snapshots(Snapshot{ initial, initial, Clock::now(), 0 })
+		, quit(false), ticks(0), dropped(0)
+	{
+	}
+
+	//fXgN^
+	virtual ~FrameScheduler() {
+		stop();
+	}
+
+	//V~[ṼXbhJn
+	//f:V~[V̈Xebv
+	void start(const Step& f) {
+		if (thread.joinable()) return;
+		step = f;
+		quit = false;
+		thread = std::thread(&FrameScheduler::run, this);
+	}
+
+	//V~[ṼXbh~߂
+	void stop() {
+		quit = true;
+		if (thread.joinable()) thread.join();
+	}
+
+	//ݎ̏ԂԂċ߂i`摤̃XbhŎgj
+	//`͈XebvxĒOƌ݂̏Ԃ̊ԂԂ
+	//lerp:lerp(previous, current, alpha)ŕԂԂԂ֐
+	template<typename F>
+	State interpolate(F lerp) {
+		snapshots.update();
+		const Snapshot& snapshot(snapshots.read());
+		double alpha(std::chrono::duration<double>(Clock::now() - snapshot.time).count()
+			/ std::chrono::duration<double>(dt).count());
+		if (alpha < 0.0) alpha = 0.0;
+		if (alpha > 1.0) alpha = 1.0;
+		return lerp(snapshot.previous, snapshot.current, alpha);
+	}
+
+	//ԍ݁ibj
+	double getTimeStep() const { return std::chrono::duration<double>(dt).count(); }
+
+	//vo
+	Stats getStats() const {
+		Stats stats;
+		stats.ticks = ticks.load(std::memory_order_relaxed);
+		stats.dropped = dropped.load(std::memory_order_relaxed);
+		return stats;
+	}
+};
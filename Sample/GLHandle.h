@@ -0,0 +1,131 @@
+#pragma once
+#include <utility>
+#include <GL/glew.h>
+
+//OpenGL̃IuWFNgLnh
+//Rs[͂łA[uŏLڂ
+//Traitsɂ̓IuWFNǧ^TypeƁA̖Onull()A쐬create()A폜destroy()`
+template<typename Traits>
+class GLHandle {
+public:
+	//IuWFNǧ^
+	typedef typename Traits::Type Type;
+
+private:
+	//IuWFNg
+	Type name;
+
+public:
+	//̃nh
+	GLHandle() :name(Traits::null()) {}
+
+	//쐬ς݂̃IuWFNg̏L󂯎
+	//name:IuWFNg
+	explicit GLHandle(Type name) :name(name) {}
+
+	//fXgN^
+	~GLHandle() {
+		reset();
+	}
+
+	//[uRXgN^
+	GLHandle(GLHandle&& o) noexcept :name(o.release()) {}
+
+	//[u
+	GLHandle& operator=(GLHandle&& o) noexcept {
+		if (this != &o) reset(o.release());
+		return *this;
+	}
+
+	//Rs[֎~
+	GLHandle(const GLHandle&) = delete;
+	GLHandle& operator=(const GLHandle&) = delete;
+
+	//IuWFNg쐬
+	static GLHandle create() {
+		return GLHandle(Traits::create());
+	}
+
+	//IuWFNgo
+	Type get() const { return name; }
+
+	//LăIuWFNgԂ
+	Type release() {
+		const Type n(name);
+		name = Traits::null();
+		return n;
+	}
+
+	//LĂIuWFNg폜ĐVIuWFNg󂯎
+	//n:VLIuWFNg
+	void reset(Type n = Traits::null()) {
+		if (name != Traits::null()) Traits::destroy(name);
+		name = n;
+	}
+
+	//IuWFNgLĂtrue
+	explicit operator bool() const { return name != Traits::null(); }
+};
+
+//obt@IuWFNg
+struct GLBufferTraits {
+	typedef GLuint Type;
+	static GLuint null() { return 0; }
+	static GLuint create() { GLuint n; glGenBuffers(1, &n); return n; }
+	static void destroy(GLuint n) { glDeleteBuffers(1, &n); }
+};
+typedef GLHandle<GLBufferTraits> GLBuffer;
+
+//_zIuWFNg
+struct GLVertexArrayTraits {
+	typedef GLuint Type;
+	static GLuint null() { return 0; }
+	static GLuint create() { GLuint n; glGenVertexArrays(1, &n); return n; }
+	static void destroy(GLuint n) { glDeleteVertexArrays(1, &n); }
+};
+typedef GLHandle<GLVertexArrayTraits> GLVertexArray;
+
+//vOIuWFNg
+struct GLProgramTraits {
+	typedef GLuint Type;
+	static GLuint null() { return 0; }
+	static GLuint create() { return glCreateProgram(); }
+	static void destroy(GLuint n) { glDeleteProgram(n); }
+};
+typedef GLHandle<GLProgramTraits> GLProgram;
+
+//NGIuWFNg
+struct GLQueryTraits {
+	typedef GLuint Type;
+	static GLuint null() { return 0; }
+	static GLuint create() { GLuint n; glGenQueries(1, &n); return n; }
+	static void destroy(GLuint n) { glDeleteQueries(1, &n); }
+};
+typedef GLHandle<GLQueryTraits> GLQuery;
+
+//tFXi쐬Ƃ܂ł̃R}h̊҂IuWFNgɂȂj
+struct GLFenceTraits {
+	typedef GLsync Type;
+	static GLsync null() { return 0; }
+	static GLsync create() { return glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0); }
+	static void destroy(GLsync n) { glDeleteSync(n); }
+};
+typedef GLHandle<GLFenceTraits> GLFence;
+
+//eNX`IuWFNg
+struct GLTextureTraits {
+	typedef GLuint Type;
+	static GLuint null() { return 0; }
+	static GLuint create() { GLuint n; glGenTextures(1, &n); return n; }
+	static void destroy(GLuint n) { glDeleteTextures(1, &n); }
+};
+typedef GLHandle<GLTextureTraits> GLTexture;
+
+//t[obt@IuWFNg
+struct GLFramebufferTraits {
+	typedef GLuint Type;
+	static GLuint null() { return 0; }
+	static GLuint create() { GLuint n; glGenFramebuffers(1, &n); return n; }
+	static void destroy(GLuint n) { glDeleteFramebuffers(1, &n); }
+};
+typedef GLHandle<GLFramebufferTraits> GLFramebuffer;
@@ -0,0 +1,121 @@
+#pragma once
+#include <iostream>
+#include <cstddef>
+
+//GPU̎gpʂ̋L^
+//obt@IuWFNgȂǂmہE폜ƂɎނƂ̑傫L^A\Z𒴂x
+//OpenGLgȂ̂ŒP̂œm߂
+class GpuMemory {
+public:
+	//̎
+	enum Category {
+		Vertex,
+		Index,
+		Uniform,
+		Stream,
+		Texture,
+		Other,
+		CategoryCount
+	};
+
+	//ނƂ̎gp
+	struct Usage {
+		//݂̎gpʁioCgj
+		std::size_t current;
+
+		//ő̎gpʁioCgj
+		std::size_t peak;
+
+		//\ZioCgA0Ȃ疳j
+		std::size_t budget;
+
+		//݂̃t[ł̊mۂƍ폜̉
+		unsigned int allocations, releases;
+
+		//\Z𒴂xotrue
+		bool warned;
+	};
+
+private:
+	//ނƂ̎gp
+	Usage usage[CategoryCount];
+
+	//RXgN^
+	GpuMemory() :usage() {}
+
+public:
+	//B̃CX^Xo
+	static GpuMemory& instance() {
+		static GpuMemory memory;
+		return memory;
+	}
+
+	//ނ̖O
+	static const char* name(Category category) {
+		static const char* const names[CategoryCount] = { "vertex", "index", "uniform", "stream", "texture", "other" };
+		return names[category];
+	}
+
+	//mۂL^
+	//category:̎
+	//bytes:mۂoCg
+	void allocate(Category category, std::size_t bytes) {
+		Usage& u(usage[category]);
+		u.current += bytes;
+		if (u.current > u.peak) u.peak = u.current;
+		++u.allocations;
+		if (u.budget > 0 && u.current > u.budget && !u.warned) {
+			std::cerr << "Warning: GPU " << name(category) << " memory " << u.current
+				<< " bytes exceeds the budget of " << u.budget << " bytes." << std::endl;
+			u.warned = true;
+		}
+	}
+
+	//폜L^
+	//category:̎
+	//bytes:폜oCg
+	void release(Category category, std::size_t bytes) {
+		Usage& u(usage[category]);
+		u.current -= bytes < u.current ? bytes : u.current;
+		++u.releases;
+		if (u.budget == 0 || u.current <= u.budget) u.warned = false;
+	}
+
+	//\Zݒ肷
+	//category:̎
+	//bytes:\Z̃oCgi0Ȃ疳j
+	void setBudget(Category category, std::size_t bytes) {
+		usage[category].budget = bytes;
+		usage[category].warned = false;
+	}
+
+	//\Z𒴂Ătrue
+	bool isOverBudget(Category category) const {
+		return usage[category].budget > 0 && usage[category].current > usage[category].budget;
+	}
+
+	//ނƂ̎gpʂo
+	const Usage& getUsage(Category category) const { return usage[category]; }
+
+	//Ŝ̎gp
+	std::size_t getTotal() const {
+		std::size_t total(0);
+		for (const auto& u : usage) total += u.current;
+		return total;
+	}
+
+	//t[߂Ċmۂƍ폜̉񐔂0ɖ߂
+	void endFrame() {
+		for (auto& u : usage) u.allocations = u.releases = 0;
+	}
+
+	//gpʂo͂
+	void report(std::ostream& os) const {
+		for (int c = 0; c < CategoryCount; ++c) {
+			const Usage& u(usage[c]);
+			os << name(static_cast<Category>(c)) << ": " << u.current << " bytes (peak " << u.peak;
+			if (u.budget > 0) os << ", budget " << u.budget;
+			os << ")" << std::endl;
+		}
+	}
+};
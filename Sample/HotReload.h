@@ -0,0 +1,240 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+
+//VF[_[
+#include "Shader.h"
+
+//EBhE
+#include "Window.h"
+
+//t@C̊Ď
+#include "FileWatcher.h"
+
+//v
+#include "Profiler.h"
+
+//VF[_[f[^̃t@CĎĎsɓǂݒ
+//VF[_[͊Ď̃XbhŋLReLXggăRpCAupdateŃt[̋؂ɍւ
+//RpCɎsƂ͌ÂvÔ܂܎g
+//LReLXgȂupdateĂ񂾕`̃XbhŃRpC
+class HotReload {
+public:
+	//o^vOf[^̔ԍ
+	typedef unsigned int Handle;
+
+	//v
+	struct Stats {
+		//ւvOƃf[^̐
+		unsigned int reloads;
+
+		//RpCɎs
+		unsigned int failures;
+
+		//ŌɃRpCɂԁi~bj
+		double compileTime;
+	};
+
+private:
+	//vOIuWFNg
+	struct Program {
+		//VF[_[̃\[Xt@C
+		std::string vert, frag;
+
+		//gp̃vOIuWFNgi`̃XbhGj
+		GLuint current;
+
+		//Ď̃XbhŃRpCčւ҂ĂvOIuWFNg
+		std::atomic<GLuint> pending;
+
+		//`̃XbhŃRpCKvtrue
+		std::atomic<bool> dirty;
+
+		//vOIuWFNgւƂɌĂяoiuniformϐ̏ꏊȂǂߒj
+		std::function<void(GLuint)> bind;
+	};
+
+	//f[^̃t@C
+	struct Asset {
+		//t@C̃pX
+		std::string path;
+
+		//ǂݒKvtrue
+		std::atomic<bool> dirty;
+
+		//ǂݒi`̃XbhŃt[̋؂ɌĂяoj
+		std::function<void()> reload;
+	};
+
+	//o^vOIuWFNgƃf[^iĎ̃Xbhǂނ̂ŒǉmutexŎj
+	std::vector<std::unique_ptr<Program>> programs;
+	std::vector<std::unique_ptr<Asset>> assets;
+	std::mutex mutex;
+
+	//VF[_[RpC鋤LReLXgiȂNULLj
+	GLFWwindow* const loader;
+
+	//v
+	Stats stats;
+
+	//ŌɃRpCɂԁiĎ̃Xbhŏj
+	std::atomic<double> compileTime;
+
+	//RpCɎsiĎ̃Xbhŏj
+	std::atomic<unsigned int> failures;
+
+	//t@C̊ĎiR[obNق̃oĝōŌɍčŏɎ~߂j
+	FileWatcher watcher;
+
+	//Rs[֎~
+	HotReload(const HotReload&) = delete;
+	HotReload& operator=(const HotReload&) = delete;
+
+	//VF[_[ǂݍŃvOIuWFNg
+	//߂l:쐬vOIuWFNgAs0
+	GLuint compile(const Program& p) {
+		const auto t0(std::chrono::high_resolution_clock::now());
+		const GLuint program(loadProgram(p.vert.c_str(), p.frag.c_str()));
+		compileTime.store(Profiler::elapsed(t0), std::memory_order_relaxed);
+		if (program == 0) {
+			failures.fetch_add(1, std::memory_order_relaxed);
+			std::cerr << "Warning: Can't reload " << p.vert << ", " << p.frag << ". The previous program is kept." << std::endl;
+		}
+		return program;
+	}
+
+	//t@CύXꂽƂ̏iĎ̃XbhŌĂяoj
+	void changed(const std::string& path) {
+		std::lock_guard<std::mutex> lock(mutex);
+
+		for (const auto& a : assets)
+			if (a->path == path) a->dirty.store(true, std::memory_order_release);
+
+		for (const auto& p : programs) {
+			if (p->vert != path && p->frag != path) continue;
+
+			if (loader == NULL) {
+				p->dirty.store(true, std::memory_order_release);
+				continue;
+			}
+
+			//LReLXgŃRpCĂ犮҂Aق̃ReLXgŎg悤ɂ
+			glfwMakeContextCurrent(loader);
+			const GLuint program(compile(*p));
+			glFinish();
+			if (program != 0) {
+				//O̍ւ܂ςłȂ΂̂Ă
+				const GLuint previous(p->pending.exchange(program, std::memory_order_acq_rel));
+				if (previous != 0) glDeleteProgram(previous);
+			}
+			glfwMakeContextCurrent(NULL);
+		}
+	}
+
+public:
+	//RXgN^iCXbhŌĂяoj
+	//window:LEBhE
+	explicit HotReload(const Window& window)
+		:loader(window.createSharedContext()), stats(), compileTime(0.0), failures(0)
+		, watcher([this](const std::string& path) { changed(path); })
+	{
+		if (loader == NULL)
+			std::cerr << "Warning: Can't create a shared context. Shaders are reloaded on the drawing thread." << std::endl;
+	}
+
+	//fXgN^iCXbhŕ`̃ReLXgΏۂɂČĂяoj
+	virtual ~HotReload() {
+		//Ď̃XbhLReLXggȂȂĂn
+		watcher.stop();
+
+		for (const auto& p : programs) {
+			glDeleteProgram(p->current);
+			glDeleteProgram(p->pending.load());
+		}
+		if (loader != NULL) glfwDestroyWindow(loader);
+	}
+
+	//vOIuWFNgo^i`̃XbhŌĂяoj
+	//vert:o[ebNXVF[_[̃\[Xt@C
+	//frag:tOgVF[_[̃\[Xt@C
+	//bind:bind(program)̌`ŌĂяoA쐬ƂƍւƂuniformϐ̏ꏊȂǂߒ
+	//߂l:o^ԍAgetŃvOIuWFNgo
+	Handle addProgram(const char* vert, const char* frag, std::function<void(GLuint)> bind = std::function<void(GLuint)>()) {
+		std::unique_ptr<Program> p(new Program);
+		p->vert = vert;
+		p->frag = frag;
+		p->current = loadProgram(vert, frag);
+		p->pending.store(0);
+		p->dirty.store(false);
+		p->bind = bind;
+		if (p->current != 0 && p->bind) p->bind(p->current);
+
+		std::lock_guard<std::mutex> lock(mutex);
+		programs.push_back(std::move(p));
+		watcher.watch(vert);
+		watcher.watch(frag);
+		return static_cast<Handle>(programs.size() - 1);
+	}
+
+	//f[^̃t@Co^
+	//path:t@C̃pX
+	//reload:t@CύXꂽƂɕ`̃XbhŃt[̋؂ɌĂяo
+	void addAsset(const char* path, std::function<void()> reload) {
+		std::unique_ptr<Asset> a(new Asset);
+		a->path = path;
+		a->dirty.store(false);
+		a->reload = reload;
+
+		std::lock_guard<std::mutex> lock(mutex);
+		assets.push_back(std::move(a));
+		watcher.watch(path);
+	}
+
+	//gp̃vOIuWFNg
+	GLuint get(Handle handle) const { return programs[handle]->current; }
+
+	//ǂݒ̂ւi`̃XbhŃt[̋؂ɌĂяoj
+	//߂l:ւ
+	unsigned int update() {
+		unsigned int count(0);
+
+		for (const auto& p : programs) {
+			GLuint program(p->pending.exchange(0, std::memory_order_acq_rel));
+
+			//LReLXgȂ΂ŃRpC
+			if (p->dirty.exchange(false, std::memory_order_acq_rel)) {
+				if (program != 0) glDeleteProgram(program);
+				program = compile(*p);
+			}
+			if (program == 0) continue;
+
+			//gp̃vOIuWFNg͂̃t[̕`𔭍sIĂ̂ō폜Ă悢
+			glDeleteProgram(p->current);
+			p->current = program;
+			if (p->bind) p->bind(program);
+			++count;
+		}
+
+		for (const auto& a : assets) {
+			if (!a->dirty.exchange(false, std::memory_order_acq_rel)) continue;
+			a->reload();
+			++count;
+		}
+
+		stats.reloads += count;
+		stats.failures = failures.load(std::memory_order_relaxed);
+		stats.compileTime = compileTime.load(std::memory_order_relaxed);
+		return count;
+	}
+
+	//v
+	const Stats& getStats() const { return stats; }
+};
@@ -0,0 +1,379 @@
+#pragma once
+#include <vector>
+#include <chrono>
+#include <algorithm>
+#include <GL/glew.h>
+
+//܂Ƃ߂Ċi[}`
+#include "MeshBuffer.h"
+
+//ϊs
+#include "Matrix.h"
+
+//jtH[obt@IuWFNgƍގ
+#include "Uniform.h"
+#include "Material.h"
+
+//v
+#include "Profiler.h"
+
+//GPU̎gpʂ̋L^
+#include "GpuMemory.h"
+
+//glMultiDrawElementsIndirectɓn`R}h
+struct DrawElementsIndirectCommand {
+	//CfbNX̐
+	GLuint count;
+
+	//CX^X̐
+	GLuint instanceCount;
+
+	//ŏ̃CfbNẌʒu
+	GLuint firstIndex;
+
+	//CfbNXɉ钸_̈ʒu
+	GLint baseVertex;
+
+	//ŏ̃CX^Ẍʒu
+	GLuint baseInstance;
+};
+
+//MeshBufferɊi[}`̕`܂Ƃ߂ĈŔs
+//`悲Ƃ̕ϊs̓CX^Xœnibatch.vertj
+//GL_ARB_multi_draw_indirectȂΕ`悲ƂglDrawElementsBaseVertexĂ
+//setFrontToBackݒ肷Ɠގ̒O牜ɕׁAdrawDepthŃfvXɕ`
+class IndirectBatch {
+	//CX^XƂ̃f[^
+	struct Instance {
+		//fr[ϊs
+		GLfloat modelview[16];
+
+		//@xNg̕ϊs
+		GLfloat normalMatrix[9];
+
+		//sbLOœǂݏoԍi0͑IׂȂj
+		GLuint id;
+	};
+
+	//ǉꂽ`
+	struct Entry {
+		//ގ̔ԍ
+		unsigned int material;
+
+		//}`
+		MeshBuffer::Mesh mesh;
+
+		//CX^Xf[^̈ʒu
+		GLuint instance;
+
+		//_̉sifWň_zW̕𔽓]́j
+		GLfloat depth;
+	};
+
+	//`悷}`i[obt@
+	const MeshBuffer& meshes;
+
+	//ǉꂽ`
+	std::vector<Entry> entries;
+
+	//`R}h
+	std::vector<DrawElementsIndirectCommand> commands;
+
+	//CX^Xf[^iǉj
+	std::vector<Instance> instances;
+
+	//ގɕבւCX^Xf[^
+	std::vector<Instance> sorted;
+
+	//`R}h̃obt@IuWFNg
+	GLBuffer dib;
+
+	//CX^Xf[^̃obt@IuWFNg
+	GLBuffer instanceBuffer;
+
+	//mۂobt@IuWFNg̗vf
+	std::size_t commandCapacity, instanceCapacity;
+
+	//glMultiDrawElementsIndirectg
+	bool indirect;
+
+	//ގ̒O牜ɕׂ
+	bool frontToBack;
+
+	//`R}hĂtrueiclearaddfalseɖ߂j
+	bool built;
+
+	//sOpenGL̕`施߂̐
+	unsigned int calls;
+
+	//`施߂̔sɂԁi~bj
+	double submitTime;
+
+	//KvȂobt@IuWFNg傫ăf[^]
+	//target:obt@IuWFNǧ
+	//buffer:obt@IuWFNg
+	//capacity:mۂvf
+	//count:]vf
+	//size:vf̃TCY
+	//data:]f[^
+	static void upload(GLenum target, GLuint buffer, std::size_t& capacity, std::size_t count, std::size_t size, const void* data) {
+		glBindBuffer(target, buffer);
+		if (count > capacity) {
+			GpuMemory::instance().release(GpuMemory::Stream, capacity * size);
+			capacity = std::max(count, capacity * 2);
+			GpuMemory::instance().allocate(GpuMemory::Stream, capacity * size);
+		}
+
+		//Õt[̕`҂Ȃ悤ɗ̈蒼Ă]
+		glBufferData(target, capacity * size, NULL, GL_STREAM_DRAW);
+		glBufferSubData(target, 0, count * size, data);
+	}
+
+	//בւĕ`R}hƃCX^Xf[^AglMultiDrawElementsIndirectgȂ]
+	void build() {
+		if (built) return;
+		built = true;
+
+		//ގƂɂ܂Ƃ߂
+		//ގ͒ǉO牜ɕׂistd::stable_sort͈ꎞ̈mۂ̂ŎgȂj
+		if (frontToBack) {
+			std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+				return a.material < b.material || (a.material == b.material
+					&& (a.depth < b.depth || (a.depth == b.depth && a.instance < b.instance)));
+			});
+		}
+		else {
+			std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+				return a.material < b.material || (a.material == b.material && a.instance < b.instance);
+			});
+		}
+
+		//`R}hiCX^Xf[^L`͕т̂ňɂj
+		commands.resize(entries.size());
+		sorted.clear();
+		for (std::size_t i = 0; i < entries.size(); ++i) {
+			if (i == 0 || entries[i].instance != entries[i - 1].instance) sorted.push_back(instances[entries[i].instance]);
+			const MeshBuffer::Mesh& mesh(entries[i].mesh);
+			commands[i] = DrawElementsIndirectCommand{
+				static_cast<GLuint>(mesh.indexcount), 1, mesh.firstIndex, mesh.baseVertex, static_cast<GLuint>(sorted.size() - 1) };
+		}
+
+		if (indirect) {
+			//CX^Xf[^ƕ`R}h]
+			upload(GL_ARRAY_BUFFER, instanceBuffer.get(), instanceCapacity, sorted.size(), sizeof(Instance), sorted.data());
+			upload(GL_DRAW_INDIRECT_BUFFER, dib.get(), commandCapacity, commands.size(), sizeof(DrawElementsIndirectCommand), commands.data());
+		}
+	}
+
+	//CX^XLɂ
+	void enableInstanceAttributes() const {
+		glBindBuffer(GL_ARRAY_BUFFER, instanceBuffer.get());
+		for (GLuint c = 0; c < 4; ++c) {
+			glVertexAttribPointer(2 + c, 4, GL_FLOAT, GL_FALSE, sizeof(Instance), static_cast<Instance*>(0)->modelview + c * 4);
+			glVertexAttribDivisor(2 + c, 1);
+			glEnableVertexAttribArray(2 + c);
+		}
+		for (GLuint c = 0; c < 3; ++c) {
+			glVertexAttribPointer(6 + c, 3, GL_FLOAT, GL_FALSE, sizeof(Instance), static_cast<Instance*>(0)->normalMatrix + c * 3);
+			glVertexAttribDivisor(6 + c, 1);
+			glEnableVertexAttribArray(6 + c);
+		}
+		glVertexAttribIPointer(9, 1, GL_UNSIGNED_INT, sizeof(Instance), &static_cast<Instance*>(0)->id);
+		glVertexAttribDivisor(9, 1);
+		glEnableVertexAttribArray(9);
+	}
+
+	//CX^X𖳌ɂĒ萔̑lg悤ɂ
+	static void disableInstanceAttributes() {
+		for (GLuint i = 2; i < 10; ++i) glDisableVertexAttribArray(i);
+	}
+
+	//Rs[֎~
+	IndirectBatch(const IndirectBatch&) = delete;
+	IndirectBatch& operator=(const IndirectBatch&) = delete;
+
+public:
+	//RXgN^
+	//meshes:`悷}`i[obt@
+	IndirectBatch(const MeshBuffer& meshes)
+		:meshes(meshes), dib(GLBuffer::create()), instanceBuffer(GLBuffer::create())
+		, commandCapacity(0), instanceCapacity(0)
+		, indirect(GLEW_ARB_multi_draw_indirect != GL_FALSE), frontToBack(false), built(false)
+		, calls(0), submitTime(0.0)
+	{
+	}
+
+	//fXgN^
+	virtual ~IndirectBatch() {
+		GpuMemory::instance().release(GpuMemory::Stream,
+			commandCapacity * sizeof(DrawElementsIndirectCommand) + instanceCapacity * sizeof(Instance));
+	}
+
+	//ǉ`
+	void clear() {
+		entries.clear();
+		instances.clear();
+		built = false;
+	}
+
+	//`ǉ
+	//mesh:`悷}`
+	//modelview:fr[ϊs
+	//material:ގ̔ԍ
+	//id:sbLOœǂݏoԍi0ȂIׂȂj
+	void add(const MeshBuffer::Mesh& mesh, const Matrix& modelview, unsigned int material = 0, GLuint id = 0) {
+		GLfloat normalMatrix[9];
+		modelview.getNormalMatrix(normalMatrix);
+		add(mesh, modelview, normalMatrix, material, id);
+	}
+
+	//@ϊs߂Ă`ǉ
+	//mesh:`悷}`
+	//modelview:fr[ϊs
+	//normalMatrix:@ϊsi9vfj
+	//material:ގ̔ԍ
+	//id:sbLOœǂݏoԍi0ȂIׂȂj
+	void add(const MeshBuffer::Mesh& mesh, const Matrix& modelview, const GLfloat* normalMatrix, unsigned int material = 0, GLuint id = 0) {
+		if (mesh.indexcount == 0) return;
+		Instance instance;
+		std::copy(modelview.data(), modelview.data() + 16, instance.modelview);
+		std::copy(normalMatrix, normalMatrix + 9, instance.normalMatrix);
+		instance.id = id;
+		entries.push_back(Entry{ material, mesh, static_cast<GLuint>(instances.size()), -modelview.data()[14] });
+		instances.push_back(instance);
+		built = false;
+	}
+
+	//ϊŐ}`͈̔͂̕``ǉiMeshlets::cullŎc͈͂Ȃǁj
+	//CX^Xf[^͔͈͂̊ԂŋLAgl_PrimitiveID͔͈͂Ƃ0琔
+	//ranges:`悷͈
+	//count:͈͂̐
+	//modelview:fr[ϊs
+	//material:ގ̔ԍ
+	//id:sbLOœǂݏoԍi0ȂIׂȂj
+	void add(const MeshBuffer::Mesh* ranges, std::size_t count, const Matrix& modelview, unsigned int material = 0, GLuint id = 0) {
+		if (count == 0) return;
+		Instance instance;
+		std::copy(modelview.data(), modelview.data() + 16, instance.modelview);
+		modelview.getNormalMatrix(instance.normalMatrix);
+		instance.id = id;
+		for (std::size_t i = 0; i < count; ++i)
+			entries.push_back(Entry{ material, ranges[i], static_cast<GLuint>(instances.size()), -modelview.data()[14] });
+		instances.push_back(instance);
+		built = false;
+	}
+
+	//ǉ`𔭍s
+	//mode:{}`̎
+	//material:ގ̃jtH[obt@IuWFNgi|Cg0Ɍj
+	//context:݂̃ReLXg̔ԍiMeshBuffer::bindɓnj
+	//textures:ގ̔ԍňeNX`IuWFNgieNX`jbg0ɌANULLȂ猋Ȃj
+	void draw(GLenum mode, const Uniform<Material>& material, unsigned int context = 0, const GLuint* textures = NULL) {
+		const auto t0(std::chrono::high_resolution_clock::now());
+		calls = 0;
+		if (entries.empty()) {
+			commands.clear();
+			submitTime = 0.0;
+			return;
+		}
+
+		//fvXɕ`ĂȂΕ`R}h
+		build();
+
+		meshes.bind(context);
+		if (textures != NULL) glActiveTexture(GL_TEXTURE0);
+		if (indirect) {
+			glBindBuffer(GL_DRAW_INDIRECT_BUFFER, dib.get());
+			enableInstanceAttributes();
+
+			//ގƂɈŕ`悷
+			for (std::size_t first = 0; first < entries.size();) {
+				std::size_t last(first + 1);
+				while (last < entries.size() && entries[last].material == entries[first].material) ++last;
+				material.select(0, entries[first].material);
+				if (textures != NULL) glBindTexture(GL_TEXTURE_2D, textures[entries[first].material]);
+				glMultiDrawElementsIndirect(mode, GL_UNSIGNED_INT,
+					static_cast<const char*>(0) + first * sizeof(DrawElementsIndirectCommand),
+					static_cast<GLsizei>(last - first), 0);
+				++calls;
+				first = last;
+			}
+		}
+		else {
+			//`悲Ƃɑ̒萔lݒ肵ĕ`悷
+			disableInstanceAttributes();
+			unsigned int current(~0u);
+			for (std::size_t i = 0; i < commands.size(); ++i) {
+				if (entries[i].material != current) {
+					current = entries[i].material;
+					material.select(0, current);
+					if (textures != NULL) glBindTexture(GL_TEXTURE_2D, textures[current]);
+				}
+				const Instance& instance(sorted[commands[i].baseInstance]);
+				for (GLuint c = 0; c < 4; ++c) glVertexAttrib4fv(2 + c, instance.modelview + c * 4);
+				for (GLuint c = 0; c < 3; ++c) glVertexAttrib3fv(6 + c, instance.normalMatrix + c * 3);
+				glDrawElementsBaseVertex(mode, commands[i].count, GL_UNSIGNED_INT,
+					static_cast<const GLuint*>(0) + commands[i].firstIndex, commands[i].baseVertex);
+				++calls;
+			}
+		}
+
+		submitTime = Profiler::elapsed(t0);
+	}
+
+	//ǉ`̃fvX𒸓_ʒu̒_zIuWFNgŕ`
+	//ގ͐؂ւŔsifvXރVF[_[gpĂj
+	//̂ƂdrawĂԂƓтŕ`̂ŁAGL_EQUAL̃fvXeXgŌfɉAet
+	//sbLO̔ԍiinstanceIdjn̂ŁAԍރVF[_[g΃sbLOɂg
+	//mode:{}`̎
+	//context:݂̃ReLXg̔ԍiMeshBuffer::bindPositionsɓnj
+	void drawDepth(GLenum mode, unsigned int context = 0) {
+		if (entries.empty()) return;
+		build();
+
+		meshes.bindPositions(context);
+		if (indirect) {
+			glBindBuffer(GL_DRAW_INDIRECT_BUFFER, dib.get());
+			enableInstanceAttributes();
+			glMultiDrawElementsIndirect(mode, GL_UNSIGNED_INT, 0, static_cast<GLsizei>(commands.size()), 0);
+		}
+		else {
+			disableInstanceAttributes();
+			for (std::size_t i = 0; i < commands.size(); ++i) {
+				const Instance& instance(sorted[commands[i].baseInstance]);
+				for (GLuint c = 0; c < 4; ++c) glVertexAttrib4fv(2 + c, instance.modelview + c * 4);
+				glVertexAttribI1ui(9, instance.id);
+				glDrawElementsBaseVertex(mode, commands[i].count, GL_UNSIGNED_INT,
+					static_cast<const GLuint*>(0) + commands[i].firstIndex, commands[i].baseVertex);
+			}
+		}
+	}
+
+	//ގ̒O牜ɕׂ邩ǂݒ肷ifvXeXgŉBꂽf̉AetȂj
+	void setFrontToBack(bool enable) {
+		if (frontToBack != enable) built = false;
+		frontToBack = enable;
+	}
+
+	//ގ̒O牜ɕׂĂ邩ǂ
+	bool isFrontToBack() const { return frontToBack; }
+
+	//glMultiDrawElementsIndirectgǂݒ肷igȂΐݒ肵Ȃj
+	void setIndirect(bool enable) {
+		const bool value(enable && GLEW_ARB_multi_draw_indirect);
+		if (indirect != value) built = false;
+		indirect = value;
+	}
+
+	//glMultiDrawElementsIndirectgĂ邩ǂ
+	bool isIndirect() const { return indirect; }
+
+	//Odrawŕ`}`̐
+	std::size_t getDrawCount() const { return commands.size(); }
+
+	//OdrawŔsOpenGL̕`施߂̐
+	unsigned int getCallCount() const { return calls; }
+
+	//Odraw̔sɂԁi~bj
+	double getSubmitTime() const { return submitTime; }
+};
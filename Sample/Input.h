@@ -0,0 +1,246 @@
+#pragma once
+#include <vector>
+#include <fstream>
+#include <iostream>
+#include <GLFW/glfw3.h>
+
+//͂̃Cxg
+//GLFW̃R[obN֐ōAtăL[ɓ
+struct InputEvent {
+	//Cxg̎
+	enum Type {
+		//L[̑icode̓L[AactionGLFW_PRESSȂǁj
+		Key,
+
+		//}EX{^̑icode̓{^AactionGLFW_PRESSȂǁj
+		MouseButton,
+
+		//}EXJ[\̈ړix, y͐KfoCXWn̈ʒuj
+		Cursor,
+
+		//}EXzC[̑ix, y͉]ʁj
+		Scroll,
+
+		//EBhẼTCYύXix, y͕ƍj
+		Resize
+	};
+
+	//Cxg̎
+	Type type;
+
+	//L[{^
+	int code;
+
+	//EEJԂ
+	int action;
+
+	//ʒu
+	float x, y;
+
+	//Cxg̋Nibj
+	double time;
+};
+
+//͂̃Cxg𑀍iANVj̏Ԃɒu
+//L[}EX{^ANV̔ԍɌтĂA
+//V~[V̈XebvƂbeginTickĂ炻̃Xebv܂ł̃Cxgapply
+class InputActions {
+public:
+	//ANV̐̏
+	static constexpr unsigned int MaxActions = 32;
+
+private:
+	//L[{^ƃANV̌т
+	struct Binding {
+		//Cxg̎ށiKeyMouseButtonj
+		InputEvent::Type type;
+
+		//L[{^
+		int code;
+
+		//ANV̔ԍ
+		unsigned int action;
+	};
+
+	//т
+	std::vector<Binding> bindings;
+
+	//ANVɌтL[{^̂Ă鐔
+	unsigned int down[MaxActions];
+
+	//̃XebvŉꂽANVƗꂽANVirbg̏Wj
+	unsigned int pressed, released;
+
+	//}EXJ[\̐KfoCXWn̈ʒu
+	float cursor[2];
+
+	//̃Xebṽ}EXzC[̉]
+	float scroll[2];
+
+	//EBhẼTCY
+	float size[2];
+
+	//̃XebvŏCxg̐
+	unsigned int events;
+
+public:
+	//RXgN^
+	InputActions() :down(), pressed(0), released(0), cursor(), scroll(), size(), events(0) {}
+
+	//L[ANVɌт
+	void bindKey(int key, unsigned int action) {
+		bindings.push_back(Binding{ InputEvent::Key, key, action });
+	}
+
+	//}EX{^ANVɌт
+	void bindMouseButton(int button, unsigned int action) {
+		bindings.push_back(Binding{ InputEvent::MouseButton, button, action });
+	}
+
+	//Xebvn߂iꂽEꂽANVƉ]ʂ0ɖ߂j
+	void beginTick() {
+		pressed = released = 0;
+		scroll[0] = scroll[1] = 0.0f;
+		events = 0;
+	}
+
+	//CxgԂɔf
+	void apply(const InputEvent& event) {
+		++events;
+		switch (event.type) {
+		case InputEvent::Key:
+		case InputEvent::MouseButton:
+			//JԂ͏ԂςȂ
+			if (event.action == GLFW_REPEAT) break;
+			for (const auto& b : bindings) {
+				if (b.type != event.type || b.code != event.code || b.action >= MaxActions) continue;
+				const unsigned int bit(1u << b.action);
+				if (event.action == GLFW_PRESS) {
+					if (down[b.action]++ == 0) pressed |= bit;
+				}
+				else if (down[b.action] > 0) {
+					if (--down[b.action] == 0) released |= bit;
+				}
+			}
+			break;
+		case InputEvent::Cursor:
+			cursor[0] = event.x;
+			cursor[1] = event.y;
+			break;
+		case InputEvent::Scroll:
+			scroll[0] += event.x;
+			scroll[1] += event.y;
+			break;
+		case InputEvent::Resize:
+			size[0] = event.x;
+			size[1] = event.y;
+			break;
+		}
+	}
+
+	//ANVĂtrue
+	bool isDown(unsigned int action) const { return down[action] > 0; }
+
+	//̃XebvŃANVꂽtrue
+	bool wasPressed(unsigned int action) const { return (pressed >> action & 1) != 0; }
+
+	//̃XebvŃANVꂽtrue
+	bool wasReleased(unsigned int action) const { return (released >> action & 1) != 0; }
+
+	//}EXJ[\̐KfoCXWn̈ʒu
+	const float* getCursor() const { return cursor; }
+
+	//̃Xebṽ}EXzC[̉]
+	const float* getScroll() const { return scroll; }
+
+	//EBhẼTCY
+	const float* getSize() const { return size; }
+
+	//̃XebvŏCxg̐
+	unsigned int getEvents() const { return events; }
+};
+
+//͂̃Cxg̋L^ƍĐ
+//V~[ṼXebv̔ԍƈꏏɋL^̂ŁAĐƓXebvɓCxg͂
+class InputRecorder {
+	//L^Cxg
+	struct Record {
+		//Xebv̔ԍ
+		unsigned long long tick;
+
+		//Cxg
+		InputEvent event;
+	};
+
+	//L^Cxg
+	std::vector<Record> records;
+
+	//ɍĐCxg̈ʒu
+	std::size_t next;
+
+public:
+	//RXgN^
+	InputRecorder() :next(0) {}
+
+	//CxgL^
+	//tick:CxgXebv̔ԍ
+	void record(unsigned long long tick, const InputEvent& event) {
+		records.push_back(Record{ tick, event });
+	}
+
+	//Xebv܂ł̃CxgĐ
+	//tick:Xebv̔ԍ
+	//f:f(event)̌`ŌĂяo
+	template<typename F>
+	void replay(unsigned long long tick, F f) {
+		for (; next < records.size() && records[next].tick <= tick; ++next) f(records[next].event);
+	}
+
+	//ׂčĐIĂtrue
+	bool finished() const { return next >= records.size(); }
+
+	//L^Cxg̐
+	std::size_t size() const { return records.size(); }
+
+	//t@Cɕۑ
+	//name:t@C
+	//߂l:ۑłtrue
+	bool save(const char* name) const {
+		std::ofstream file(name, std::ios::binary);
+		if (file.fail()) {
+			std::cerr << "Error: Can't open input record file: " << name << std::endl;
+			return false;
+		}
+		file.write(reinterpret_cast<const char*>(records.data()), records.size() * sizeof(Record));
+		if (file.fail()) {
+			std::cerr << "Error: Can't write input record file: " << name << std::endl;
+			return false;
+		}
+		return true;
+	}
+
+	//t@Cǂݍ
+	//name:t@C
+	//߂l:ǂݍ߂true
+	bool load(const char* name) {
+		std::ifstream file(name, std::ios::binary);
+		if (file.fail()) {
+			std::cerr << "Error: Can't open input record file: " << name << std::endl;
+			return false;
+		}
+
+		//t@CTCYL^̐߂ēǂݍ
+		file.seekg(0L, std::ios::end);
+		const std::size_t count(static_cast<std::size_t>(file.tellg()) / sizeof(Record));
+		records.resize(count);
+		next = 0;
+		file.seekg(0L, std::ios::beg);
+		file.read(reinterpret_cast<char*>(records.data()), count * sizeof(Record));
+		if (file.fail()) {
+			std::cerr << "Error: Could not read input record file: " << name << std::endl;
+			records.clear();
+			return false;
+		}
+		return true;
+	}
+};
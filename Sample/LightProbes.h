@@ -0,0 +1,278 @@
+#pragma once
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include <fstream>
+#include <iostream>
+#include <algorithm>
+#include <GL/glew.h>
+
+//ϊsƃxNg
+#include "Matrix.h"
+#include "vector.h"
+
+//OpenGL̃IuWFNg̏L
+#include "GLHandle.h"
+
+//GPU̎gpʂ̋L^
+#include "GpuMemory.h"
+
+//̃v[ȕĂt
+#include "ProbeBaker.h"
+
+//iqɕׂ̃v[u
+//ProbeBakerŏĂt2܂ł̋ʒa֐̌Wۑēǂݍ݁A3eNX`ɒuĊɎg
+//RGB27̌W4vfSlicesɕAv[ůiqzSlicesׂeNX`ɒu
+//VF[_[ipoint.frag, deferred.fragj͊iq̒[̃v[uOǂ܂Ȃ悤ɍW߂ĕԂ
+//t@CHeader̂ƂɃv[uƂ̌W𔼐x_ŕׂ
+class LightProbes {
+public:
+	//ʒa֐̌W̐
+	static constexpr int Coefficients = ProbeBaker::Coefficients;
+
+	//̃v[ǔWueNZ̐
+	static constexpr int Slices = (Coefficients * 3 + 3) / 4;
+
+	//t@C̐擪
+	struct Header {
+		//ʎqi"SHPB"jƔ
+		char magic[4];
+		std::uint32_t version;
+
+		//ẽv[u̐
+		std::int32_t count[3];
+
+		//iq̗[̃v[ũ[hWn̈ʒu
+		float min[3], max[3];
+	};
+
+private:
+	//Wu3eNX`
+	GLTexture texture;
+
+	//ẽv[u̐iȂ0j
+	int count[3];
+
+	//iq̗[̃v[üʒu
+	GLfloat min[3], max[3];
+
+	//v[uƂ̌W
+	std::vector<GLfloat> coefficient;
+
+	//Rs[֎~
+	LightProbes(const LightProbes&) = delete;
+	LightProbes& operator=(const LightProbes&) = delete;
+
+	//eNX`̃oCg
+	std::size_t bytes() const {
+		return static_cast<std::size_t>(count[0]) * count[1] * count[2] * Slices * 4 * sizeof(GLushort);
+	}
+
+	//Px𔼐xɕϊił߂lɊۂ߂j
+	static std::uint16_t toHalf(float f) {
+		std::uint32_t x;
+		std::memcpy(&x, &f, 4);
+		const std::uint16_t sign(static_cast<std::uint16_t>(x >> 16 & 0x8000));
+		const int exponent(static_cast<int>(x >> 23 & 0xff) - 127 + 15);
+		std::uint32_t mantissa(x & 0x7fffff);
+		if (exponent >= 31) return static_cast<std::uint16_t>(sign | 0x7c00);
+		if (exponent <= 0) {
+			if (exponent < -10) return sign;
+			mantissa |= 0x800000;
+			const int shift(14 - exponent);
+			return static_cast<std::uint16_t>(sign | (mantissa + (1u << (shift - 1))) >> shift);
+		}
+		const std::uint32_t h((static_cast<std::uint32_t>(exponent) << 10 | mantissa >> 13) + (mantissa >> 12 & 1));
+		return static_cast<std::uint16_t>(sign | std::min(h, 0x7c00u));
+	}
+
+	//xPxɕϊ
+	static float toFloat(std::uint16_t h) {
+		const std::uint32_t sign(static_cast<std::uint32_t>(h & 0x8000) << 16);
+		const int exponent(h >> 10 & 0x1f);
+		const std::uint32_t mantissa(h & 0x3ff);
+		float f;
+		if (exponent == 0) {
+			f = std::ldexp(static_cast<float>(mantissa), -24);
+			return sign != 0 ? -f : f;
+		}
+		const std::uint32_t x(exponent == 31 ? sign | 0x7f800000 | mantissa << 13
+			: sign | static_cast<std::uint32_t>(exponent - 15 + 127) << 23 | mantissa << 13);
+		std::memcpy(&f, &x, 4);
+		return f;
+	}
+
+	//WeNX`ɓ]itextureAcountAcoefficientݒ肵ĂĂԁj
+	void upload() {
+		const int probes(count[0] * count[1] * count[2]);
+
+		//eNZ̕тɓւiv[ůiqzSlicesׂj
+		std::vector<GLfloat> texels(static_cast<std::size_t>(probes) * Slices * 4, 0.0f);
+		for (int p = 0; p < probes; ++p) {
+			const int z(p / (count[0] * count[1])), xy(p % (count[0] * count[1]));
+			for (int i = 0; i < Coefficients * 3; ++i) {
+				const std::size_t texel(static_cast<std::size_t>((i / 4 * count[2] + z) * count[0] * count[1] + xy));
+				texels[texel * 4 + i % 4] = coefficient[static_cast<std::size_t>(p) * Coefficients * 3 + i];
+			}
+		}
+		texture = GLTexture::create();
+		glBindTexture(GL_TEXTURE_3D, texture.get());
+		glTexImage3D(GL_TEXTURE_3D, 0, GL_RGBA16F, count[0], count[1], count[2] * Slices, 0, GL_RGBA, GL_FLOAT, texels.data());
+		glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+		glBindTexture(GL_TEXTURE_3D, 0);
+		GpuMemory::instance().allocate(GpuMemory::Texture, bytes());
+	}
+
+public:
+	//RXgN^
+	LightProbes() :count{ 0, 0, 0 }, min{}, max{} {}
+
+	//fXgN^
+	virtual ~LightProbes() {
+		if (texture) GpuMemory::instance().release(GpuMemory::Texture, bytes());
+	}
+
+	//ĂtWݒ肵ăeNX`ɓ]
+	//min, max:iq̗[̃v[ũ[hWn̈ʒu
+	//count:ẽv[u̐
+	//coefficient:ProbeBaker::bakeŋ߂W
+	void set(const GLfloat* min, const GLfloat* max, const int* count, const std::vector<GLfloat>& coefficient) {
+		if (texture) GpuMemory::instance().release(GpuMemory::Texture, bytes());
+		texture.reset();
+		std::copy(min, min + 3, this->min);
+		std::copy(max, max + 3, this->max);
+		std::copy(count, count + 3, this->count);
+		this->coefficient = coefficient;
+		upload();
+	}
+
+	//t@Cɕۑ
+	//name:t@C
+	//߂l:ۑłtrue
+	bool save(const char* name) const {
+		std::ofstream file(name, std::ios::binary);
+		if (file.fail()) {
+			std::cerr << "Error: Can't open light probe file: " << name << std::endl;
+			return false;
+		}
+		Header header = {};
+		std::memcpy(header.magic, "SHPB", 4);
+		header.version = 1;
+		for (int i = 0; i < 3; ++i) {
+			header.count[i] = count[i];
+			header.min[i] = min[i];
+			header.max[i] = max[i];
+		}
+		std::vector<std::uint16_t> half(coefficient.size());
+		std::transform(coefficient.begin(), coefficient.end(), half.begin(), toHalf);
+		file.write(reinterpret_cast<const char*>(&header), sizeof header);
+		file.write(reinterpret_cast<const char*>(half.data()), half.size() * sizeof(std::uint16_t));
+		if (file.fail()) {
+			std::cerr << "Error: Can't write light probe file: " << name << std::endl;
+			return false;
+		}
+		return true;
+	}
+
+	//t@CǂݍŃeNX`ɓ]
+	//name:t@C
+	//߂l:ǂݍ߂true
+	bool load(const char* name) {
+		std::ifstream file(name, std::ios::binary);
+		if (file.fail()) return false;
+		Header header;
+		file.read(reinterpret_cast<char*>(&header), sizeof header);
+		if (file.fail() || std::memcmp(header.magic, "SHPB", 4) != 0 || header.version != 1
+			|| header.count[0] <= 0 || header.count[1] <= 0 || header.count[2] <= 0) {
+			std::cerr << "Error: Not a light probe file: " << name << std::endl;
+			return false;
+		}
+		std::vector<std::uint16_t> half(static_cast<std::size_t>(header.count[0]) * header.count[1] * header.count[2] * Coefficients * 3);
+		file.read(reinterpret_cast<char*>(half.data()), half.size() * sizeof(std::uint16_t));
+		if (file.fail()) {
+			std::cerr << "Error: Could not read light probe file: " << name << std::endl;
+			return false;
+		}
+		std::vector<GLfloat> c(half.size());
+		std::transform(half.begin(), half.end(), c.begin(), toFloat);
+		const int n[] = { header.count[0], header.count[1], header.count[2] };
+		set(header.min, header.max, n, c);
+		return true;
+	}
+
+	//v[utrue
+	bool valid() const { return static_cast<bool>(texture); }
+
+	//eNX`uniformϐݒ肷iv[uȂΊg킹j
+	//v[ũTv͌^Ⴄ̂ōގ̃eNX`VhE}bvƕʂ̃jbgɂ
+	//unit:eNX`jbg
+	//view:r[ϊs
+	//mapLoc, matrixLoc, rotationLoc, sizeLoc:probeMap, probeMatrix, probeRotation, probeSizȅꏊ
+	void bind(GLuint unit, const Matrix& view, GLint mapLoc, GLint matrixLoc, GLint rotationLoc, GLint sizeLoc) const {
+		glActiveTexture(GL_TEXTURE0 + unit);
+		glBindTexture(GL_TEXTURE_3D, texture.get());
+		glActiveTexture(GL_TEXTURE0);
+		glUniform1i(mapLoc, static_cast<GLint>(unit));
+		if (!texture) {
+			glUniform3f(sizeLoc, 0.0f, 0.0f, 0.0f);
+			return;
+		}
+
+		//_Wniq̍Wni[̃v[u0count - 1jւ̕ϊƁA@[hWnɖ߂]
+		const Matrix inverse(view.inverse());
+		GLfloat scale[3];
+		for (int i = 0; i < 3; ++i) scale[i] = max[i] > min[i] ? static_cast<GLfloat>(count[i] - 1) / (max[i] - min[i]) : 0.0f;
+		const Matrix grid(Matrix::scale(scale[0], scale[1], scale[2]) * Matrix::translate(-min[0], -min[1], -min[2]) * inverse);
+		const GLfloat* const m(inverse.data());
+		const GLfloat rotation[] = { m[0], m[1], m[2], m[4], m[5], m[6], m[8], m[9], m[10] };
+		glUniformMatrix4fv(matrixLoc, 1, GL_FALSE, grid.data());
+		glUniformMatrix3fv(rotationLoc, 1, GL_FALSE, rotation);
+		glUniform3f(sizeLoc, static_cast<GLfloat>(count[0]), static_cast<GLfloat>(count[1]), static_cast<GLfloat>(count[2]));
+	}
+
+	//CPUŕˏƓx/΂߂iVF[_[Ɠԁj
+	//position:[hWn̈ʒu
+	//normal:[hWn̒Pʖ@xNg
+	//rgb:ʂ̏ݐ
+	void irradiance(const GLfloat* position, const GLfloat* normal, GLfloat* rgb) const {
+		std::fill(rgb, rgb + 3, 0.0f);
+		if (coefficient.empty()) return;
+
+		//iq̒̈ʒuƕԂ̏d
+		int base[3];
+		GLfloat fraction[3];
+		for (int i = 0; i < 3; ++i) {
+			const GLfloat g(max[i] > min[i] ? (position[i] - min[i]) * (count[i] - 1) / (max[i] - min[i]) : 0.0f);
+			const GLfloat c(std::min(std::max(g, 0.0f), static_cast<GLfloat>(count[i] - 1)));
+			base[i] = std::min(static_cast<int>(c), std::max(count[i] - 2, 0));
+			fraction[i] = count[i] > 1 ? c - base[i] : 0.0f;
+		}
+		GLfloat y[Coefficients];
+		ProbeBaker::basis(normal, y);
+		for (int corner = 0; corner < 8; ++corner) {
+			GLfloat w(1.0f);
+			int p[3];
+			for (int i = 0; i < 3; ++i) {
+				const int bit(corner >> i & 1);
+				p[i] = std::min(base[i] + bit, count[i] - 1);
+				w *= bit != 0 ? fraction[i] : 1.0f - fraction[i];
+			}
+			const GLfloat* const c(&coefficient[static_cast<std::size_t>(p[0] + count[0] * (p[1] + count[1] * p[2])) * Coefficients * 3]);
+			for (int k = 0; k < Coefficients; ++k) {
+				for (int i = 0; i < 3; ++i) rgb[i] += w * y[k] * c[k * 3 + i];
+			}
+		}
+		for (int i = 0; i < 3; ++i) rgb[i] = std::max(rgb[i], 0.0f);
+	}
+
+	//ẽv[u̐
+	const int* getCount() const { return count; }
+
+	//t@CɕۑƂ̃oCg
+	std::size_t fileSize() const { return sizeof(Header) + coefficient.size() * sizeof(std::uint16_t); }
+};
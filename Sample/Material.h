@@ -12,4 +12,6 @@ struct Material {
 	alignas(16) std::array<GLfloat, 3> specular;
 	//PnX
 	alignas(4) GLfloat shininess;
+	//eNX`̔ԍiTextureCache̔ԍA0ȂeNX`gȂj
+	alignas(4) GLint texture;
 };
\ No newline at end of file
@@ -0,0 +1,214 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <iostream>
+#include <GL/glew.h>
+
+//}`f[^
+#include "object.h"
+
+//obt@IuWFNg̈ꕔ̊蓖
+#include "BufferHeap.h"
+
+//nhŎQƂ鎑̃v[
+#include "ResourcePool.h"
+
+//̐}`܂Ƃ߂Ċi[钸_obt@
+//̒_zIuWFNgƒ_obt@ACfbNXobt@mۂĂA
+//}`Ƃɂ̈ꕔ蓖Ă
+//fvX`Ƃ̂߂ɒ_ʒul߂obt@ʒuɊ蓖Ă
+class MeshBuffer {
+public:
+	//蓖Ă}`
+	struct Mesh {
+		//ŏ̃CfbNẌʒu
+		GLuint firstIndex;
+
+		//CfbNX̐
+		GLsizei indexcount;
+
+		//CfbNXɉ钸_̈ʒu
+		GLint baseVertex;
+
+		//_̐
+		GLsizei vertexcount;
+	};
+
+private:
+	//i[}`̋L^
+	struct Slot {
+		//}`
+		Mesh mesh;
+
+		//_ƃCfbNX͈̔
+		BufferHeap::Handle vertex, index;
+
+		//_ʒu͈̔́i_͈̔͂ƓʒuɂȂj
+		BufferHeap::Handle position;
+	};
+
+public:
+	//i[}`̃nhil͖A菜ƌÂnh͖ɂȂj
+	typedef ResourcePool<Slot>::Handle Handle;
+
+private:
+
+	//_i[obt@
+	BufferHeap vertices;
+
+	//CfbNXi[obt@
+	BufferHeap indices;
+
+	//_ʒui[obt@iverticesƓɊ蓖ĂƉ̂ňʒuvj
+	BufferHeap positions;
+
+	//ReLXgƂ̒_zIuWFNg
+	//obt@IuWFNg͋LReLXg̊ԂŎg邪A_zIuWFNg͋LȂ
+	mutable std::vector<GLVertexArray> vaos;
+
+	//ReLXgƂ̒_ʒu̒_zIuWFNg
+	mutable std::vector<GLVertexArray> positionVaos;
+
+	//_ʒu̎
+	const GLint size;
+
+	//i[}`̋L^
+	ResourcePool<Slot> slots;
+
+	//Rs[֎~
+	MeshBuffer(const MeshBuffer&) = delete;
+	MeshBuffer& operator=(const MeshBuffer&) = delete;
+
+public:
+	//RXgN^
+	//vertexCapacity:i[ł钸_̐
+	//indexCapacity:i[łCfbNX̐
+	//size:_ʒu̎
+	MeshBuffer(GLsizei vertexCapacity, GLsizei indexCapacity, GLint size = 3)
+		:vertices(vertexCapacity, sizeof(Object::Vertex), GpuMemory::Vertex)
+		, indices(indexCapacity, sizeof(GLuint), GpuMemory::Index)
+		, positions(vertexCapacity, size * sizeof(GLfloat), GpuMemory::Vertex)
+		, size(size)
+	{
+		//ŏ̃ReLXg̒_zIuWFNg쐬
+		bind(0);
+	}
+
+	//fXgN^
+	virtual ~MeshBuffer() {}
+
+	//}`ǉ
+	//vertexcount:_̐
+	//vertex:_i[z
+	//indexcount:_̃CfbNX̗vf
+	//index:_̃CfbNXi[z
+	//߂l:i[}`̃nhi肫ȂΖȃnhj
+	Handle add(GLsizei vertexcount, const Object::Vertex* vertex, GLsizei indexcount, const GLuint* index) {
+		//_ʒuo
+		std::vector<GLfloat> position(vertexcount * size);
+		for (GLsizei i = 0; i < vertexcount; ++i)
+			std::copy(vertex[i].position, vertex[i].position + size, position.begin() + i * size);
+
+		Slot slot;
+		slot.vertex = vertices.allocate(vertexcount, 1, vertex);
+		slot.index = indices.allocate(indexcount, 1, index);
+		slot.position = slot.vertex != BufferAllocator::Invalid
+			? positions.allocate(vertexcount, 1, position.data()) : BufferAllocator::Invalid;
+		if (slot.vertex == BufferAllocator::Invalid || slot.index == BufferAllocator::Invalid || slot.position == BufferAllocator::Invalid) {
+			std::cerr << "Error: MeshBuffer is full." << std::endl;
+			if (slot.vertex != BufferAllocator::Invalid) vertices.free(slot.vertex);
+			if (slot.position != BufferAllocator::Invalid) positions.free(slot.position);
+			if (slot.index != BufferAllocator::Invalid) indices.free(slot.index);
+			return Handle();
+		}
+		slot.mesh.indexcount = indexcount;
+		slot.mesh.vertexcount = vertexcount;
+		update(slot);
+		return slots.create(slot);
+	}
+
+	//}`菜
+	//handle:addœnhiȃnhȂ牽Ȃj
+	void remove(Handle handle) {
+		const Slot* const slot(slots.get(handle));
+		if (slot == NULL) return;
+		vertices.free(slot->vertex);
+		positions.free(slot->position);
+		indices.free(slot->index);
+		slots.destroy(handle);
+	}
+
+	//󂫗̈l߂
+	//߂l:ړ͈͂̐
+	unsigned int defragment() {
+		const unsigned int moves(vertices.defragment() + indices.defragment());
+		positions.defragment();
+		slots.forEach([this](Handle, Slot& slot) { update(slot); });
+		return moves;
+	}
+
+	//nhi[}`wĂtrue
+	bool valid(Handle handle) const { return slots.valid(handle); }
+
+	//i[}`oinh͗LłȂ΂ȂȂj
+	const Mesh& get(Handle handle) const { return slots[handle].mesh; }
+
+	//_zIuWFNǧ
+	//context:݂̃ReLXg̔ԍi߂ĎgԍȂ璸_zIuWFNg쐬j
+	void bind(unsigned int context = 0) const {
+		if (context >= vaos.size()) vaos.resize(context + 1);
+		if (vaos[context]) {
+			glBindVertexArray(vaos[context].get());
+			return;
+		}
+
+		//_zIuWFNg쐬Č
+		vaos[context] = GLVertexArray::create();
+		glBindVertexArray(vaos[context].get());
+
+		//_obt@IuWFNgattributeϐɊ֘AÂ
+		glBindBuffer(GL_ARRAY_BUFFER, vertices.name());
+		glVertexAttribPointer(0, size, GL_FLOAT, GL_FALSE, sizeof(Object::Vertex), static_cast<Object::Vertex*>(0)->position);
+		glEnableVertexAttribArray(0);
+		glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Object::Vertex), static_cast<Object::Vertex*>(0)->normal);
+		glEnableVertexAttribArray(1);
+		glVertexAttribPointer(10, 2, GL_FLOAT, GL_FALSE, sizeof(Object::Vertex), static_cast<Object::Vertex*>(0)->texcoord);
+		glEnableVertexAttribArray(10);
+
+		//CfbNX̒_obt@IuWFNg
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indices.name());
+	}
+
+	//_ʒu̒_zIuWFNǧifvX`ƂɎgj
+	//context:݂̃ReLXg̔ԍi߂ĎgԍȂ璸_zIuWFNg쐬j
+	void bindPositions(unsigned int context = 0) const {
+		if (context >= positionVaos.size()) positionVaos.resize(context + 1);
+		if (positionVaos[context]) {
+			glBindVertexArray(positionVaos[context].get());
+			return;
+		}
+
+		//_zIuWFNg쐬Č
+		positionVaos[context] = GLVertexArray::create();
+		glBindVertexArray(positionVaos[context].get());
+
+		//_ʒũobt@IuWFNgattributeϐɊ֘AÂ
+		glBindBuffer(GL_ARRAY_BUFFER, positions.name());
+		glVertexAttribPointer(0, size, GL_FLOAT, GL_FALSE, 0, 0);
+		glEnableVertexAttribArray(0);
+
+		//CfbNX̒_obt@IuWFNg
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indices.name());
+	}
+
+	//_ƃCfbNX̊蓖Ă̓v
+	BufferAllocator::Stats getVertexStats() const { return vertices.getStats(); }
+	BufferAllocator::Stats getIndexStats() const { return indices.getStats(); }
+
+private:
+	//蓖Ă͈͂}`̈ʒu߂
+	void update(Slot& slot) const {
+		slot.mesh.firstIndex = static_cast<GLuint>(indices.offset(slot.index));
+		slot.mesh.baseVertex = static_cast<GLint>(vertices.offset(slot.vertex));
+	}
+};
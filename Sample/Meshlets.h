@@ -0,0 +1,337 @@
+#pragma once
+#include <vector>
+#include <chrono>
+#include <cmath>
+#include <algorithm>
+#include <GL/glew.h>
+
+//}`f[^
+#include "object.h"
+
+//܂Ƃ߂Ċi[}`
+#include "MeshBuffer.h"
+
+//ϊs
+#include "Matrix.h"
+
+//[J[Xbh
+#include "ThreadPool.h"
+
+//v
+#include "Profiler.h"
+
+//bVbgiOp`ׂ荇̂ǂő64_E124Op`̂܂Ƃ܂ɕ́j
+//܂Ƃ܂育ƂɋEƖ@̉~At[ƂɎ̊Oɂ̂ƗĂ̂CPUŎ̂Ă
+//CfbNX͂܂Ƃ܂̏ɕבւ̂ŁAMeshBufferɂgetIndices̃CfbNXi[
+class Meshlets {
+public:
+	//܂Ƃ܂̒_ƎOp`̐̏
+	static constexpr GLsizei MaxVertices = 64, MaxTriangles = 124;
+
+	//܂Ƃ܂
+	struct Meshlet {
+		//בւCfbNX̒̈ʒuƐ
+		GLuint firstIndex;
+		GLsizei count;
+
+		//E̒SƔaifWnj
+		GLfloat center[3], radius;
+
+		//@̉~̎ƁAƂȂp̐臒li1Ȃ痠̔Ȃj
+		GLfloat axis[3], cutoff;
+	};
+
+	//v
+	struct Stats {
+		//ׂ܂Ƃ܂̐ƁÅOƗŎ̂Ă
+		unsigned int tested, outside, backfacing;
+
+		//`Op`̐Ǝ̂ĂOp`̐
+		GLsizei triangles, rejected;
+
+		//JOɂԁi~bj
+		double cullTime;
+	};
+
+private:
+	//[J[Xbh
+	ThreadPool& pool;
+
+	//܂Ƃ܂
+	std::vector<Meshlet> meshlets;
+
+	//܂Ƃ܂̏ɕבւCfbNX
+	std::vector<GLuint> indices;
+
+	//JO𕪒Sd̐̏ƁA̎dŒׂ܂Ƃ܂̐̉
+	static constexpr unsigned int MaxJobs = 64, MinJobSize = 64;
+
+	//Rs[֎~
+	Meshlets(const Meshlets&) = delete;
+	Meshlets& operator=(const Meshlets&) = delete;
+
+	//Op`̏dS
+	static void centroid(const Object::Vertex* vertex, const GLuint* t, GLfloat* c) {
+		for (int k = 0; k < 3; ++k)
+			c[k] = (vertex[t[0]].position[k] + vertex[t[1]].position[k] + vertex[t[2]].position[k]) * (1.0f / 3.0f);
+	}
+
+	//܂Ƃ܂̋EƖ@̉~߂
+	void bound(Meshlet& m, const Object::Vertex* vertex) const {
+		const GLuint* const t(&indices[m.firstIndex]);
+
+		//E͒_͂ޒ̂̒Sł_܂ł̋ɂ
+		GLfloat lower[3], upper[3];
+		std::copy(vertex[t[0]].position, vertex[t[0]].position + 3, lower);
+		std::copy(lower, lower + 3, upper);
+		for (GLsizei i = 1; i < m.count; ++i) {
+			for (int k = 0; k < 3; ++k) {
+				lower[k] = std::min(lower[k], vertex[t[i]].position[k]);
+				upper[k] = std::max(upper[k], vertex[t[i]].position[k]);
+			}
+		}
+		for (int k = 0; k < 3; ++k) m.center[k] = (lower[k] + upper[k]) * 0.5f;
+		m.radius = 0.0f;
+		for (GLsizei i = 0; i < m.count; ++i) {
+			const GLfloat* const p(vertex[t[i]].position);
+			const GLfloat dx(p[0] - m.center[0]), dy(p[1] - m.center[1]), dz(p[2] - m.center[2]);
+			m.radius = std::max(m.radius, std::sqrt(dx * dx + dy * dy + dz * dz));
+		}
+
+		//Op`̖ʂ̖@𕽋ςĎɂiʐς0̎Op`͌Ȃ̂ŎgȂj
+		std::vector<GLfloat> normals;
+		normals.reserve(m.count);
+		GLfloat axis[3] = { 0.0f, 0.0f, 0.0f };
+		for (GLsizei i = 0; i < m.count; i += 3) {
+			const GLfloat* const p0(vertex[t[i]].position);
+			const GLfloat* const p1(vertex[t[i + 1]].position);
+			const GLfloat* const p2(vertex[t[i + 2]].position);
+			const GLfloat e1[3] = { p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2] };
+			const GLfloat e2[3] = { p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2] };
+			GLfloat n[3] = { e1[1] * e2[2] - e1[2] * e2[1], e1[2] * e2[0] - e1[0] * e2[2], e1[0] * e2[1] - e1[1] * e2[0] };
+			const GLfloat length(std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]));
+			if (length <= 1.0e-12f) continue;
+			for (int k = 0; k < 3; ++k) {
+				n[k] /= length;
+				axis[k] += n[k];
+				normals.push_back(n[k]);
+			}
+		}
+		const GLfloat length(std::sqrt(axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2]));
+		m.cutoff = 1.0f;
+		std::fill(m.axis, m.axis + 3, 0.0f);
+		if (normals.empty() || length <= 1.0e-6f) return;
+		for (int k = 0; k < 3; ++k) m.axis[k] = axis[k] / length;
+
+		//Ɩ@̂Ȃp̗]̍ŏl~̍L߂
+		//L肪90xɋ߂ƋE̔a̕肪قƂǐ藧Ȃ̂ŎgȂ
+		GLfloat minimum(1.0f);
+		for (std::size_t i = 0; i < normals.size(); i += 3)
+			minimum = std::min(minimum, m.axis[0] * normals[i] + m.axis[1] * normals[i + 1] + m.axis[2] * normals[i + 2]);
+		if (minimum > 0.1f) m.cutoff = std::sqrt(1.0f - minimum * minimum);
+	}
+
+public:
+	//RXgN^
+	//Op`IсA܂Ƃ܂̒_LOp`̂V_ȂSɋ߂̂܂ŉĂ
+	//pool:JO𕪒S郏[J[Xbh
+	//vertex:_
+	//vertexcount:_̐
+	//index:Op`̒_̃CfbNX
+	//indexcount:CfbNX̐
+	Meshlets(ThreadPool& pool, const Object::Vertex* vertex, GLsizei vertexcount, const GLuint* index, GLsizei indexcount)
+		:pool(pool)
+	{
+		const GLsizei triangles(indexcount / 3);
+		indices.reserve(triangles * 3);
+
+		//_ƂɂgOp`̈ꗗ
+		std::vector<GLuint> first(vertexcount + 1, 0), adjacency(triangles * 3);
+		for (GLsizei i = 0; i < triangles * 3; ++i) ++first[index[i] + 1];
+		for (GLsizei v = 0; v < vertexcount; ++v) first[v + 1] += first[v];
+		std::vector<GLuint> fill(first.begin(), first.end() - 1);
+		for (GLsizei i = 0; i < triangles * 3; ++i) adjacency[fill[index[i]]++] = static_cast<GLuint>(i / 3);
+
+		//Op`܂Ƃ܂ɓꂽtrueA_̂܂Ƃ܂̒ł̔ԍiĂȂ-1j
+		std::vector<bool> emitted(triangles, false);
+		std::vector<int> slot(vertexcount, -1);
+		std::vector<GLuint> members;
+		members.reserve(MaxVertices);
+
+		for (GLsizei seed = 0; seed < triangles; ) {
+			if (emitted[seed]) {
+				++seed;
+				continue;
+			}
+
+			Meshlet m;
+			m.firstIndex = static_cast<GLuint>(indices.size());
+			GLfloat sum[3] = { 0.0f, 0.0f, 0.0f };
+			for (GLsizei t = seed; t >= 0; ) {
+				//Op`܂Ƃ܂ɉ
+				const GLuint* const tri(index + t * 3);
+				for (int k = 0; k < 3; ++k) {
+					if (slot[tri[k]] >= 0) continue;
+					slot[tri[k]] = static_cast<int>(members.size());
+					members.push_back(tri[k]);
+					for (int j = 0; j < 3; ++j) sum[j] += vertex[tri[k]].position[j];
+				}
+				indices.insert(indices.end(), tri, tri + 3);
+				emitted[t] = true;
+				if (static_cast<GLsizei>(indices.size() - m.firstIndex) >= MaxTriangles * 3) break;
+
+				//ɉOp`IԁiV_Ȃ΂Ɍ߂j
+				const GLfloat center[3] = { sum[0] / members.size(), sum[1] / members.size(), sum[2] / members.size() };
+				GLsizei best(-1);
+				int bestNew(3);
+				GLfloat bestDistance(0.0f);
+				for (std::size_t v = 0; v < members.size() && bestNew > 0; ++v) {
+					for (GLuint a = first[members[v]]; a < first[members[v] + 1]; ++a) {
+						const GLuint c(adjacency[a]);
+						if (emitted[c]) continue;
+						const GLuint* const ct(index + c * 3);
+						const int added((slot[ct[0]] < 0 ? 1 : 0) + (slot[ct[1]] < 0 ? 1 : 0) + (slot[ct[2]] < 0 ? 1 : 0));
+						if (static_cast<GLsizei>(members.size()) + added > MaxVertices) continue;
+						GLfloat p[3];
+						centroid(vertex, ct, p);
+						const GLfloat distance((p[0] - center[0]) * (p[0] - center[0])
+							+ (p[1] - center[1]) * (p[1] - center[1]) + (p[2] - center[2]) * (p[2] - center[2]));
+						if (added < bestNew || (added == bestNew && distance < bestDistance)) {
+							best = static_cast<GLsizei>(c);
+							bestNew = added;
+							bestDistance = distance;
+						}
+						if (added == 0) break;
+					}
+				}
+				t = best;
+			}
+
+			//܂Ƃ܂Ē_̔ԍ߂
+			m.count = static_cast<GLsizei>(indices.size() - m.firstIndex);
+			bound(m, vertex);
+			meshlets.push_back(m);
+			for (const GLuint v : members) slot[v] = -1;
+			members.clear();
+		}
+	}
+
+	//̊Oɂ܂Ƃ܂ƗĂ܂Ƃ܂̂āAc܂Ƃ܂̕`͈͂
+	//CfbNXĂ܂Ƃ܂͈͈̔͂ɂ܂Ƃ߂
+	//d[J[Xbhɕ̂ŁA[J[Xbh̒ĂԂƂ̏ŏ
+	//mesh:getIndices̃CfbNXi[}`
+	//modelview:fr[ϊsigk͈lł̂Ƃj
+	//projection:eϊs
+	//ranges:`͈͂̊i[igetCount̗̈pӂj
+	//stats:v
+	//parallel:falseȂĂяoXbhŏ
+	//߂l:`͈͂̐
+	GLsizei cull(const MeshBuffer::Mesh& mesh, const Matrix& modelview, const Matrix& projection, MeshBuffer::Mesh* ranges, Stats& stats,
+		bool parallel = true) const {
+		const auto t0(std::chrono::high_resolution_clock::now());
+		const GLfloat* const m(modelview.data());
+		const GLfloat scale(std::sqrt(m[0] * m[0] + m[1] * m[1] + m[2] * m[2]));
+
+		//eϊs̍s王6ʂ߂i_WnA@͓ŐKj
+		const GLfloat* const p(projection.data());
+		GLfloat planes[6][4];
+		for (int i = 0; i < 3; ++i) {
+			for (int k = 0; k < 4; ++k) {
+				planes[i * 2][k] = p[k * 4 + 3] + p[k * 4 + i];
+				planes[i * 2 + 1][k] = p[k * 4 + 3] - p[k * 4 + i];
+			}
+		}
+		for (auto& plane : planes) {
+			const GLfloat length(std::sqrt(plane[0] * plane[0] + plane[1] * plane[1] + plane[2] * plane[2]));
+			for (GLfloat& e : plane) e /= length;
+		}
+
+		//dƂɂ܂Ƃ܂̈ʒu͈͂l߂ď݁AƂňꑱɂ
+		struct Result {
+			GLsizei ranges;
+			unsigned int outside, backfacing;
+			GLsizei rejected;
+		} results[MaxJobs];
+		const unsigned int count(static_cast<unsigned int>(meshlets.size()));
+		const unsigned int jobs(std::max(std::min(MaxJobs, (count + MinJobSize - 1) / MinJobSize), 1u));
+		const unsigned int size((count + jobs - 1) / jobs);
+		const auto test = [&](unsigned int job, unsigned int) {
+			Result r = { 0, 0, 0, 0 };
+			MeshBuffer::Mesh* const out(ranges + job * size);
+			const unsigned int end(std::min(count, (job + 1) * size));
+			for (unsigned int i = job * size; i < end; ++i) {
+				const Meshlet& ml(meshlets[i]);
+
+				//E̒S_WnɈڂ
+				const GLfloat* const c(ml.center);
+				const GLfloat x(m[0] * c[0] + m[4] * c[1] + m[8] * c[2] + m[12]);
+				const GLfloat y(m[1] * c[0] + m[5] * c[1] + m[9] * c[2] + m[13]);
+				const GLfloat z(m[2] * c[0] + m[6] * c[1] + m[10] * c[2] + m[14]);
+				const GLfloat radius(ml.radius * scale);
+
+				//ǂꂩ̕ʂ̊OɂΌȂ
+				bool outside(false);
+				for (const auto& plane : planes)
+					outside = outside || plane[0] * x + plane[1] * y + plane[2] * z + plane[3] < -radius;
+				if (outside) {
+					++r.outside;
+					r.rejected += ml.count / 3;
+					continue;
+				}
+
+				//_狫ÊǂĂ~̖̒@ׂĎƓȂ痠Ă
+				const GLfloat* const a(ml.axis);
+				const GLfloat ax(m[0] * a[0] + m[4] * a[1] + m[8] * a[2]);
+				const GLfloat ay(m[1] * a[0] + m[5] * a[1] + m[9] * a[2]);
+				const GLfloat az(m[2] * a[0] + m[6] * a[1] + m[10] * a[2]);
+				if ((x * ax + y * ay + z * az) / scale >= ml.cutoff * std::sqrt(x * x + y * y + z * z) + radius) {
+					++r.backfacing;
+					r.rejected += ml.count / 3;
+					continue;
+				}
+
+				//O͈̔͂ɑĂ΂Ȃ
+				const GLuint firstIndex(mesh.firstIndex + ml.firstIndex);
+				if (r.ranges > 0 && out[r.ranges - 1].firstIndex + out[r.ranges - 1].indexcount == firstIndex)
+					out[r.ranges - 1].indexcount += ml.count;
+				else
+					out[r.ranges++] = MeshBuffer::Mesh{ firstIndex, ml.count, mesh.baseVertex, mesh.vertexcount };
+			}
+			results[job] = r;
+		};
+		if (parallel && jobs > 1) pool.parallelFor(jobs, test);
+		else for (unsigned int job = 0; job < jobs; ++job) test(job, 0);
+
+		//dƂ͈̔͂Oɋl߁Ad̋ڂőĂ͈͂Ȃ
+		GLsizei total(0);
+		for (unsigned int job = 0; job < jobs; ++job) {
+			const Result& r(results[job]);
+			for (GLsizei k = 0; k < r.ranges; ++k) {
+				const MeshBuffer::Mesh& range(ranges[job * size + k]);
+				if (total > 0 && ranges[total - 1].firstIndex + ranges[total - 1].indexcount == range.firstIndex)
+					ranges[total - 1].indexcount += range.indexcount;
+				else
+					ranges[total++] = range;
+			}
+			stats.outside += r.outside;
+			stats.backfacing += r.backfacing;
+			stats.rejected += r.rejected;
+		}
+		stats.tested += count;
+		for (GLsizei k = 0; k < total; ++k) stats.triangles += ranges[k].indexcount / 3;
+		stats.cullTime += Profiler::elapsed(t0);
+		return total;
+	}
+
+	//܂Ƃ܂̐icullɓn`͈̗͂̈̑傫j
+	GLsizei getCount() const { return static_cast<GLsizei>(meshlets.size()); }
+
+	//܂Ƃ܂
+	const Meshlet& get(GLsizei i) const { return meshlets[i]; }
+
+	//܂Ƃ܂̏ɕבւCfbNX
+	const GLuint* getIndices() const { return indices.data(); }
+
+	//CfbNX̐
+	GLsizei getIndexCount() const { return static_cast<GLsizei>(indices.size()); }
+};
@@ -0,0 +1,334 @@
+#pragma once
+#include <vector>
+#include <chrono>
+#include <cmath>
+#include <algorithm>
+#include <limits>
+#include <GL/glew.h>
+
+//}`f[^
+#include "object.h"
+
+//ϊsƃxNg
+#include "Matrix.h"
+#include "vector.h"
+
+//SIMDZ
+#include "Simd.h"
+
+//[J[Xbh
+#include "ThreadPool.h"
+
+//v
+#include "Profiler.h"
+
+//CPUɂIN[WJO
+//̎Օ𑜓x̃fvXobt@Ƀ\tgEFAŕ`A
+//`悷镨̂̉ʏ͈̔͂艜ɂ邩ǂ𒲂ׂ
+//fvXobt@8~4f̃^CɕA^CƂ̍ő̐[xŔ肷
+class OcclusionCulling {
+public:
+	//v
+	struct Stats {
+		//ǉꂽՕ̐
+		unsigned int occluders;
+
+		//Օ̎Op`̐
+		unsigned int triangles;
+
+		//_̎Oɂ̂ŕ`ȂOp`̐
+		unsigned int rejected;
+
+		//肵̂̐
+		unsigned int tested;
+
+		//ՕĂ̂̐
+		unsigned int occluded;
+
+		//ʊÔ̐
+		unsigned int offscreen;
+
+		//Op`̐ݒɂԁi~bj
+		double setupTime;
+
+		//X^CYɂԁi~bj
+		double rasterTime;
+
+		//ɂԁi~bj
+		double testTime;
+	};
+
+	//^C̑傫
+	static constexpr int TileWidth = 8;
+	static constexpr int TileHeight = 4;
+
+private:
+	//ʏ̎Op`
+	struct Triangle {
+		//ӂ̊֐ a * x + b * y + ci0ȏj
+		float a[3], b[3], c[3];
+
+		//[x̕ zx * x + zy * y + z0
+		float zx, zy, z0;
+
+		//f͈̔
+		int xmin, xmax, ymin, ymax;
+	};
+
+	//fvXobt@̑傫
+	const int width, height;
+
+	//^C̐
+	const int tilesX, tilesY;
+
+	//fvXobt@i0OA1j
+	std::vector<float> depth;
+
+	//^CƂ̍ő̐[x
+	std::vector<float> tileMax;
+
+	//Օ̎Op`
+	std::vector<Triangle> triangles;
+
+	//X^CYɎgXbh
+	ThreadPool& pool;
+
+	//v
+	Stats stats;
+
+	//^C̍sX^CY
+	//ty:^C̍s
+	void rasterizeRow(int ty) {
+		const int y0(ty * TileHeight), y1(y0 + TileHeight);
+		const Float4 offset(0.5f, 1.5f, 2.5f, 3.5f);
+		const Float4 zero(0.0f);
+
+		//̍sɂOp``
+		for (const auto& t : triangles) {
+			if (t.ymax < y0 || t.ymin >= y1) continue;
+
+			const Float4 a0(t.a[0]), a1(t.a[1]), a2(t.a[2]);
+			const Float4 zx(t.zx);
+			const int ys(std::max(t.ymin, y0)), ye(std::min(t.ymax + 1, y1));
+			const int xs(t.xmin & ~3);
+
+			for (int y = ys; y < ye; ++y) {
+				const float py(static_cast<float>(y) + 0.5f);
+
+				//s̐擪ł̕ӂ̊֐Ɛ[x
+				const Float4 c0(t.b[0] * py + t.c[0]), c1(t.b[1] * py + t.c[1]), c2(t.b[2] * py + t.c[2]);
+				const Float4 zc(t.zy * py + t.z0);
+				float* const row(&depth[y * width]);
+
+				//4f
+				for (int x = xs; x <= t.xmax; x += 4) {
+					const Float4 px(Float4(static_cast<float>(x)) + offset);
+					const Float4 inside((a0 * px + c0 >= zero) & (a1 * px + c1 >= zero) & (a2 * px + c2 >= zero));
+					if (inside.mask() == 0) continue;
+
+					//Oɂf̐[x
+					const Float4 z(Float4::max(zx * px + zc, zero));
+					const Float4 d(Float4::loadu(row + x));
+					Float4::select(inside & (z < d), z, d).storeu(row + x);
+				}
+			}
+		}
+
+		//^CƂ̍ő̐[x߂
+		for (int tx = 0; tx < tilesX; ++tx) {
+			Float4 m(zero);
+			for (int y = y0; y < y1; ++y) {
+				const float* const p(&depth[y * width + tx * TileWidth]);
+				m = Float4::max(m, Float4::max(Float4::loadu(p), Float4::loadu(p + 4)));
+			}
+			float v[4];
+			m.storeu(v);
+			tileMax[ty * tilesX + tx] = std::max(std::max(v[0], v[1]), std::max(v[2], v[3]));
+		}
+	}
+
+	//Rs[֎~
+	OcclusionCulling(const OcclusionCulling&);
+	OcclusionCulling& operator=(const OcclusionCulling&);
+
+public:
+	//RXgN^
+	//pool:X^CYɎgXbh
+	//width:fvXobt@̕i8̔{j
+	//height:fvXobt@̍i4̔{j
+	OcclusionCulling(ThreadPool& pool, int width = 256, int height = 128)
+		:width(width), height(height), tilesX(width / TileWidth), tilesY(height / TileHeight)
+		, depth(width* height, 1.0f), tileMax(tilesX* tilesY, 1.0f), pool(pool)
+	{
+		clear();
+	}
+
+	//ՕĐVt[n߂
+	void clear() {
+		triangles.clear();
+		stats = Stats{};
+	}
+
+	//Օǉ
+	//Օ͕`悷}`̓Ɏ܂`łȂ΂ȂȂ
+	//mvp:eϊs~fr[ϊs
+	//vertex:_i[z
+	//indexcount:_̃CfbNX̗vf
+	//index:_̃CfbNXi[ziv肪\̎Op`j
+	void addOccluder(const Matrix& mvp, const Object::Vertex* vertex, GLsizei indexcount, const GLuint* index) {
+		const auto t0(std::chrono::high_resolution_clock::now());
+		const float sx(0.5f * static_cast<float>(width)), sy(0.5f * static_cast<float>(height));
+
+		for (GLsizei i = 0; i + 2 < indexcount; i += 3) {
+			++stats.triangles;
+
+			//_EBhEWɕϊ
+			float x[3], y[3], z[3];
+			bool clipped(false);
+			for (int k = 0; k < 3; ++k) {
+				const GLfloat* const p(vertex[index[i + k]].position);
+				const Vector c(mvp * Vector{ p[0], p[1], p[2], 1.0f });
+
+				//_̎O̖ʂɂOp`͕`Ȃi`ȂΎՕȂ̂ňSj
+				if (c[3] <= 1.0e-5f || c[2] < -c[3]) {
+					clipped = true;
+					break;
+				}
+				x[k] = (c[0] / c[3] + 1.0f) * sx;
+				y[k] = (c[1] / c[3] + 1.0f) * sy;
+				z[k] = c[2] / c[3] * 0.5f + 0.5f;
+			}
+
+			//̎Op``Ȃ
+			const float area((x[1] - x[0]) * (y[2] - y[0]) - (x[2] - x[0]) * (y[1] - y[0]));
+			if (clipped || area <= 0.0f) {
+				++stats.rejected;
+				continue;
+			}
+
+			Triangle t;
+			t.xmin = std::max(0, static_cast<int>(std::floor(std::min(x[0], std::min(x[1], x[2])))));
+			t.xmax = std::min(width - 1, static_cast<int>(std::ceil(std::max(x[0], std::max(x[1], x[2])))));
+			t.ymin = std::max(0, static_cast<int>(std::floor(std::min(y[0], std::min(y[1], y[2])))));
+			t.ymax = std::min(height - 1, static_cast<int>(std::ceil(std::max(y[0], std::max(y[1], y[2])))));
+			if (t.xmin > t.xmax || t.ymin > t.ymax) {
+				++stats.rejected;
+				continue;
+			}
+
+			//ӂ̊֐
+			for (int k = 0; k < 3; ++k) {
+				const int j((k + 1) % 3);
+				t.a[k] = y[k] - y[j];
+				t.b[k] = x[j] - x[k];
+				t.c[k] = (y[j] - y[k]) * x[k] - (x[j] - x[k]) * y[k];
+			}
+
+			//[x̕
+			t.zx = ((z[1] - z[0]) * (y[2] - y[0]) - (z[2] - z[0]) * (y[1] - y[0])) / area;
+			t.zy = ((z[2] - z[0]) * (x[1] - x[0]) - (z[1] - z[0]) * (x[2] - x[0])) / area;
+			t.z0 = z[0] - t.zx * x[0] - t.zy * y[0];
+
+			triangles.push_back(t);
+		}
+
+		++stats.occluders;
+		stats.setupTime += Profiler::elapsed(t0);
+	}
+
+	//ǉꂽՕfvXobt@ɃX^CY
+	void rasterize() {
+		const auto t0(std::chrono::high_resolution_clock::now());
+
+		std::fill(depth.begin(), depth.end(), 1.0f);
+
+		//^C̍sƂɕʂ̃Xbhŕ`
+		pool.parallelFor(static_cast<unsigned int>(tilesY), [this](unsigned int ty, unsigned int) {
+			rasterizeRow(static_cast<int>(ty));
+		});
+
+		stats.rasterTime += Profiler::elapsed(t0);
+	}
+
+	//邩ǂׂ
+	//modelview:fr[ϊs
+	//projection:eϊs
+	//radius:̔a
+	//cx,cy,cz:fWnł̋̒S
+	//߂l:\true
+	bool testSphere(const Matrix& modelview, const Matrix& projection, GLfloat radius,
+		GLfloat cx = 0.0f, GLfloat cy = 0.0f, GLfloat cz = 0.0f)
+	{
+		const auto t0(std::chrono::high_resolution_clock::now());
+		++stats.tested;
+
+		//_Wnł̒SƔa
+		const Vector c(modelview * Vector{ cx, cy, cz, 1.0f });
+		GLfloat s(0.0f);
+		for (int i = 0; i < 3; ++i) {
+			const GLfloat* const m(&modelview[i * 4]);
+			s = std::max(s, m[0] * m[0] + m[1] * m[1] + m[2] * m[2]);
+		}
+		const GLfloat r(radius * std::sqrt(s));
+
+		//͂ޔ̒_𓊉eĉʏ͈̔͂ƍłO̐[x߂
+		const float inf(std::numeric_limits<float>::max());
+		float xmin(inf), xmax(-inf), ymin(inf), ymax(-inf), zmin(inf);
+		for (int k = 0; k < 8; ++k) {
+			const Vector p(projection * Vector{
+				c[0] + ((k & 1) ? r : -r), c[1] + ((k & 2) ? r : -r), c[2] + ((k & 4) ? r : -r), 1.0f });
+
+			//_̎O̖ʂɂĂΌ邱Ƃɂ
+			if (p[3] <= 1.0e-5f || p[2] < -p[3]) {
+				stats.testTime += Profiler::elapsed(t0);
+				return true;
+			}
+			const float x(p[0] / p[3]), y(p[1] / p[3]), z(p[2] / p[3]);
+			xmin = std::min(xmin, x);
+			xmax = std::max(xmax, x);
+			ymin = std::min(ymin, y);
+			ymax = std::max(ymax, y);
+			zmin = std::min(zmin, z);
+		}
+
+		//ʊO
+		if (xmax < -1.0f || xmin > 1.0f || ymax < -1.0f || ymin > 1.0f || zmin > 1.0f) {
+			++stats.offscreen;
+			stats.testTime += Profiler::elapsed(t0);
+			return false;
+		}
+
+		//͈͂ɂ^C
+		const float sx(0.5f * static_cast<float>(width)), sy(0.5f * static_cast<float>(height));
+		const int tx0(std::max(0, static_cast<int>((xmin + 1.0f) * sx) / TileWidth));
+		const int tx1(std::min(tilesX - 1, static_cast<int>((xmax + 1.0f) * sx) / TileWidth));
+		const int ty0(std::max(0, static_cast<int>((ymin + 1.0f) * sy) / TileHeight));
+		const int ty1(std::min(tilesY - 1, static_cast<int>((ymax + 1.0f) * sy) / TileHeight));
+		const float d(zmin * 0.5f + 0.5f);
+
+		//ł̍łO艜ɂ^CΌ
+		bool visible(false);
+		for (int ty = ty0; ty <= ty1 && !visible; ++ty) {
+			for (int tx = tx0; tx <= tx1; ++tx) {
+				if (tileMax[ty * tilesX + tx] > d) {
+					visible = true;
+					break;
+				}
+			}
+		}
+
+		if (!visible) ++stats.occluded;
+		stats.testTime += Profiler::elapsed(t0);
+		return visible;
+	}
+
+	//vo
+	const Stats& getStats() const { return stats; }
+
+	//fvXobt@̑傫o
+	int getWidth() const { return width; }
+	int getHeight() const { return height; }
+
+	//fvXobt@o
+	const float* getDepth() const { return depth.data(); }
+};
@@ -0,0 +1,520 @@
+#pragma once
+#include <vector>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <algorithm>
+#include <GL/glew.h>
+
+//OpenGL̃IuWFNg̃nh
+#include "GLHandle.h"
+
+//VF[_[
+#include "Shader.h"
+
+//ϊs
+#include "Matrix.h"
+
+//4vfSIMDZ
+#include "Simd.h"
+
+//[J[Xbh
+#include "ThreadPool.h"
+
+//v
+#include "Profiler.h"
+
+//GPU̎gpʂ̋L^
+#include "GpuMemory.h"
+
+//p[eBN
+//Ԃ͐Ƃ̔ziSoAjɎAϕƎ񂾃p[eBN̋lߒƕo4SIMDŌvZă[J[XbhŕS
+//lߒ͓g̔z̊ԂōŝŁAdƂ̏ݐ悪dȂ炸ɏł
+//Ăp[eBN̈ʒuƎ̌o߂̊t[ƂɃobt@ɓ]AɌlp`̃CX^XƂĕ`
+//GPUŐϕƂisetGpuj̓gXtH[tB[hobNŏԂ̃obt@݂ɏACPUɂ͉ԂȂ
+class Particles {
+public:
+	//o
+	struct Emitter {
+		//oʒuƂ΂̑傫
+		GLfloat position[3], radius;
+
+		//Ƃ΂̑傫
+		GLfloat velocity[3], spread;
+
+		//bɕo鐔
+		GLfloat rate;
+
+		//ibAp[eBNƂ0.75{1{ɂ΂j
+		GLfloat life;
+	};
+
+	//v
+	struct Stats {
+		//Ăp[eBN̐iGPUŐϕƂ͗eʁj
+		std::size_t alive;
+
+		//ŌsimulateŕoƎ񂾐
+		std::size_t emitted, died;
+
+		//Ōsimulate̐ϕƋlߒ̎Ԃƕo̎ԁi~bj
+		double simulateTime, emitTime;
+
+		//Ōupdate̓]GPUł̐ϕ̔sɂԁi~bj
+		double uploadTime;
+	};
+
+private:
+	//xɌvZp[eBN̐
+	static constexpr unsigned int Lanes = 4;
+
+	//WuŌvZp[eBN̐iLanes̔{j
+	static constexpr unsigned int Grain = 4096;
+
+	//ô΂Ɏg̕\̑傫i2ׂ̂j
+	static constexpr unsigned int NoiseSize = 4096;
+
+	//p[eBN̏ԁiLanes̗]uA4Pʂł̂܂ܓǂݏj
+	struct State {
+		std::vector<GLfloat> px, py, pz;
+		std::vector<GLfloat> vx, vy, vz;
+		std::vector<GLfloat> age, life;
+	};
+
+	//[J[Xbh
+	ThreadPool& pool;
+
+	//p[eBN̐̏
+	const std::size_t capacity;
+
+	//ϕԂƋlߒ̏
+	State state[2];
+	unsigned int front;
+
+	//Ăp[eBN̐
+	std::size_t count;
+
+	//-11̈l̕\iLanesJԂj
+	std::vector<GLfloat> noise[4];
+
+	//̕\ʒu߂
+	std::uint32_t seed;
+
+	//o
+	Emitter emitter;
+
+	//oȂ[
+	GLfloat carry;
+
+	//d͉xiyjAx̌i1/bjA̍AŒ˕ԂƂ̔W
+	GLfloat gravity, drag, ground, bounce;
+
+	//WuƂ̐cilߒł͏ݐ̈ʒuj
+	std::vector<std::size_t> survivors;
+
+	//]CX^Xf[^iʒuƎ̌o߂̊j
+	std::vector<GLfloat> instances;
+
+	//`悷VF[_[uniformϐ̏ꏊ
+	const GLProgram program;
+	const GLint modelviewLoc, projectionLoc, sizeLoc, birthColorLoc, deathColorLoc;
+
+	//܂ꂽƂƎʂƂ̑傫ƐF
+	GLfloat extent[2], birthColor[4], deathColor[4];
+
+	//CX^Xf[^̃obt@IuWFNg
+	GLBuffer stream;
+
+	//ReLXgƂ̒_zIuWFNg
+	mutable std::vector<GLVertexArray> vaos;
+
+	//gXtH[tB[hobNŐϕVF[_[uniformϐ̏ꏊ
+	const GLProgram feedbackProgram;
+	enum { Origin, Radius, InitialVelocity, Spread, Lifetime, Gravity, Damping, Ground, Bounce, Dt, Seed, UniformCount };
+	GLint feedbackLoc[UniformCount];
+
+	//GPUŐϕԁiʒuƎ̌o߂̊AxƎj̃obt@IuWFNgƓǂݏo̔ԍ
+	GLBuffer feedback[2];
+	unsigned int feedbackFront;
+
+	//GPUŐϕȂtrue
+	bool gpu;
+
+	//v
+	Stats stats;
+
+	//Rs[֎~
+	Particles(const Particles&) = delete;
+	Particles& operator=(const Particles&) = delete;
+
+	//gXtH[tB[hobÑvOǂݍ
+	static GLuint loadFeedback() {
+		static const char* const varyings[] = { "outPosition", "outVelocity" };
+		return loadFeedbackProgram("feedback.vert", varyings, 2);
+	}
+
+	//d[J[Xbhɕ邩AĂяoXbhŏɏ
+	template<typename F>
+	void run(unsigned int jobs, F f, bool parallel) {
+		if (parallel && jobs > 1) pool.parallelFor(jobs, f);
+		else for (unsigned int job = 0; job < jobs; ++job) f(job, 0);
+	}
+
+	//CX^Xf[^
+	void writeInstance(std::size_t i, GLfloat x, GLfloat y, GLfloat z, GLfloat t) {
+		GLfloat* const p(&instances[i * 4]);
+		p[0] = x;
+		p[1] = y;
+		p[2] = z;
+		p[3] = t;
+	}
+
+	//̃ReLXg̒_zIuWFNg
+	void bind(unsigned int context) const {
+		if (context >= vaos.size()) vaos.resize(context + 1);
+		if (!vaos[context]) vaos[context] = GLVertexArray::create();
+		glBindVertexArray(vaos[context].get());
+	}
+
+	//GPUŐϕԂ蒼i܂܂ĂȂp[eBŇ͎o߂̊𕉂ɂĕo̊ŏɐ܂悤ɂj
+	void resetFeedback() {
+		std::vector<GLfloat> initial(capacity * 8, 0.0f);
+		for (std::size_t i = 0; i < capacity; ++i) {
+			GLfloat* const p(&initial[i * 8]);
+			std::copy(emitter.position, emitter.position + 3, p);
+			p[3] = -static_cast<GLfloat>(i) / std::max(emitter.rate * emitter.life, 1.0e-6f);
+			p[7] = emitter.life;
+		}
+		glBindBuffer(GL_ARRAY_BUFFER, feedback[0].get());
+		glBufferData(GL_ARRAY_BUFFER, capacity * 8 * sizeof(GLfloat), initial.data(), GL_DYNAMIC_COPY);
+		glBindBuffer(GL_ARRAY_BUFFER, feedback[1].get());
+		glBufferData(GL_ARRAY_BUFFER, capacity * 8 * sizeof(GLfloat), NULL, GL_DYNAMIC_COPY);
+		feedbackFront = 0;
+	}
+
+	//gXtH[tB[hobNŐϕ
+	void step(GLfloat dt) {
+		glUseProgram(feedbackProgram.get());
+		glUniform3fv(feedbackLoc[Origin], 1, emitter.position);
+		glUniform1f(feedbackLoc[Radius], emitter.radius);
+		glUniform3fv(feedbackLoc[InitialVelocity], 1, emitter.velocity);
+		glUniform1f(feedbackLoc[Spread], emitter.spread);
+		glUniform1f(feedbackLoc[Lifetime], emitter.life);
+		glUniform3f(feedbackLoc[Gravity], 0.0f, gravity, 0.0f);
+		glUniform1f(feedbackLoc[Damping], std::max(1.0f - drag * dt, 0.0f));
+		glUniform1f(feedbackLoc[Ground], ground);
+		glUniform1f(feedbackLoc[Bounce], bounce);
+		glUniform1f(feedbackLoc[Dt], dt);
+		seed = seed * 1664525u + 1013904223u;
+		glUniform1ui(feedbackLoc[Seed], seed);
+
+		//ǂݏȍԂ𒸓_ɂďޕ̃obt@ɏoiX^CY͂Ȃj
+		bind(0);
+		glBindBuffer(GL_ARRAY_BUFFER, feedback[feedbackFront].get());
+		glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 8 * sizeof(GLfloat), 0);
+		glVertexAttribDivisor(0, 0);
+		glEnableVertexAttribArray(0);
+		glVertexAttribPointer(11, 4, GL_FLOAT, GL_FALSE, 8 * sizeof(GLfloat), static_cast<const GLfloat*>(0) + 4);
+		glEnableVertexAttribArray(11);
+		glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, feedback[1 - feedbackFront].get());
+		glEnable(GL_RASTERIZER_DISCARD);
+		glBeginTransformFeedback(GL_POINTS);
+		glDrawArrays(GL_POINTS, 0, static_cast<GLsizei>(capacity));
+		glEndTransformFeedback();
+		glDisable(GL_RASTERIZER_DISCARD);
+		glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, 0);
+		glDisableVertexAttribArray(11);
+		feedbackFront = 1 - feedbackFront;
+	}
+
+public:
+	//RXgN^
+	//pool:ϕƋlߒ𕪒S郏[J[Xbh
+	//capacity:p[eBN̐̏
+	Particles(ThreadPool& pool, std::size_t capacity)
+		:pool(pool), capacity(capacity), front(0), count(0), seed(1), carry(0.0f)
+		, gravity(-9.8f), drag(0.1f), ground(-1.0f), bounce(0.5f)
+		, survivors((capacity + Grain - 1) / Grain + 1), instances((capacity + Lanes) * 4)
+		, program(loadProgram("particle.vert", "particle.frag"))
+		, modelviewLoc(glGetUniformLocation(program.get(), "modelview"))
+		, projectionLoc(glGetUniformLocation(program.get(), "projection"))
+		, sizeLoc(glGetUniformLocation(program.get(), "size"))
+		, birthColorLoc(glGetUniformLocation(program.get(), "birthColor"))
+		, deathColorLoc(glGetUniformLocation(program.get(), "deathColor"))
+		, stream(GLBuffer::create()), feedbackProgram(loadFeedback()), feedbackFront(0), gpu(false), stats()
+	{
+		//]܂߂Ď1ɂĂi]̌vZŔ񐳋KNaNȂj
+		for (State& s : state) {
+			for (std::vector<GLfloat>* v : { &s.px, &s.py, &s.pz, &s.vx, &s.vy, &s.vz, &s.age }) v->assign(capacity + Lanes, 0.0f);
+			s.life.assign(capacity + Lanes, 1.0f);
+		}
+
+		//ô΂Ɏg̕\
+		std::uint32_t x(2463534242u);
+		for (std::vector<GLfloat>& n : noise) {
+			n.resize(NoiseSize + Lanes);
+			for (unsigned int i = 0; i < NoiseSize; ++i) {
+				x ^= x << 13;
+				x ^= x >> 17;
+				x ^= x << 5;
+				n[i] = static_cast<GLfloat>(x >> 8) * (2.0f / 16777216.0f) - 1.0f;
+			}
+			std::copy(n.begin(), n.begin() + Lanes, n.begin() + NoiseSize);
+		}
+
+		const Emitter initial = { { 0.0f, 0.0f, 0.0f }, 0.1f, { 0.0f, 4.0f, 0.0f }, 1.0f, 1000.0f, 2.0f };
+		emitter = initial;
+		setAppearance(0.02f, 0.06f, 1.0f, 0.8f, 0.4f, 1.0f, 0.8f, 0.2f, 0.1f, 0.0f);
+
+		static const char* const names[] = {
+			"origin", "radius", "initialVelocity", "spread", "lifetime", "gravity", "damping", "ground", "bounce", "dt", "seed"
+		};
+		for (int i = 0; i < UniformCount; ++i) feedbackLoc[i] = glGetUniformLocation(feedbackProgram.get(), names[i]);
+
+		//CX^Xf[^̃obt@GPUŐϕԂ̃obt@mۂĂ
+		glBindBuffer(GL_ARRAY_BUFFER, stream.get());
+		glBufferData(GL_ARRAY_BUFFER, capacity * 4 * sizeof(GLfloat), NULL, GL_STREAM_DRAW);
+		GpuMemory::instance().allocate(GpuMemory::Stream, capacity * 4 * sizeof(GLfloat));
+		if (feedbackProgram) {
+			feedback[0] = GLBuffer::create();
+			feedback[1] = GLBuffer::create();
+			resetFeedback();
+			GpuMemory::instance().allocate(GpuMemory::Vertex, capacity * 16 * sizeof(GLfloat));
+		}
+	}
+
+	//fXgN^
+	virtual ~Particles() {
+		GpuMemory::instance().release(GpuMemory::Stream, capacity * 4 * sizeof(GLfloat));
+		if (feedbackProgram) GpuMemory::instance().release(GpuMemory::Vertex, capacity * 16 * sizeof(GLfloat));
+	}
+
+	//oݒ肷
+	void setEmitter(const Emitter& e) {
+		emitter = e;
+	}
+
+	//o
+	const Emitter& getEmitter() const { return emitter; }
+
+	//p[eBNɂ͂Əݒ肷
+	//gravity:d͉xiyj
+	//drag:x̌i1/bj
+	//ground:̍
+	//bounce:Œ˕ԂƂ̔W
+	void setForces(GLfloat gravity, GLfloat drag, GLfloat ground, GLfloat bounce) {
+		this->gravity = gravity;
+		this->drag = drag;
+		this->ground = ground;
+		this->bounce = bounce;
+	}
+
+	//ݒ肷
+	//birthSize, deathSize:܂ꂽƂƎʂƂ̎lp`̔̑傫
+	//r0, g0, b0, a0:܂ꂽƂ̐F
+	//r1, g1, b1, a1:ʂƂ̐F
+	void setAppearance(GLfloat birthSize, GLfloat deathSize, GLfloat r0, GLfloat g0, GLfloat b0, GLfloat a0,
+		GLfloat r1, GLfloat g1, GLfloat b1, GLfloat a1) {
+		extent[0] = birthSize;
+		extent[1] = deathSize;
+		const GLfloat c[] = { r0, g0, b0, a0, r1, g1, b1, a1 };
+		std::copy(c, c + 4, birthColor);
+		std::copy(c + 4, c + 8, deathColor);
+	}
+
+	//GPUŐϕ邩ǂݒ肷i؂ւƃp[eBNoj
+	//gXtH[tB[hobÑVF[_[gȂΐݒ肵Ȃ
+	void setGpu(bool enable) {
+		const bool value(enable && feedbackProgram);
+		if (value == gpu) return;
+		gpu = value;
+		count = 0;
+		carry = 0.0f;
+		if (gpu) resetFeedback();
+	}
+
+	//GPUŐϕĂ邩ǂ
+	bool isGpu() const { return gpu; }
+
+	//CPUŐϕĎ񂾃p[eBNl߁AVp[eBNoiOpenGL͌Ă΂Ȃj
+	//dt:ԍ݁ibj
+	//parallel:falseȂĂяoXbhŏ
+	void simulate(GLfloat dt, bool parallel = true) {
+		const auto t0(std::chrono::high_resolution_clock::now());
+		State& in(state[front]);
+		State& out(state[1 - front]);
+		std::vector<GLfloat> State::* const members[] = {
+			&State::px, &State::py, &State::pz, &State::vx, &State::vy, &State::vz, &State::age, &State::life
+		};
+
+		//ϕĐc𐔂
+		static const unsigned char bits[] = { 0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4 };
+		const Float4 step(dt), fall(gravity * dt), damping(std::max(1.0f - drag * dt, 0.0f));
+		const Float4 floor(ground), rebound(-bounce), zero(0.0f);
+		const unsigned int jobs(static_cast<unsigned int>((count + Grain - 1) / Grain));
+		run(jobs, [&](unsigned int job, unsigned int) {
+			const std::size_t begin(job * Grain), end(std::min(count, begin + Grain));
+			std::size_t alive(0);
+			for (std::size_t i = begin; i < end; i += Lanes) {
+				const Float4 vx(Float4::loadu(&in.vx[i]) * damping);
+				Float4 vy((Float4::loadu(&in.vy[i]) + fall) * damping);
+				const Float4 vz(Float4::loadu(&in.vz[i]) * damping);
+				const Float4 px(Float4::loadu(&in.px[i]) + vx * step);
+				Float4 py(Float4::loadu(&in.py[i]) + vy * step);
+				const Float4 pz(Float4::loadu(&in.pz[i]) + vz * step);
+				const Float4 age(Float4::loadu(&in.age[i]) + step);
+
+				//艺ɓĉɌĂΏ̏ɖ߂Ē˕Ԃ
+				const Float4 below((py < floor) & (vy < zero));
+				py = Float4::select(below, floor, py);
+				vy = Float4::select(below, vy * rebound, vy);
+
+				vx.storeu(&in.vx[i]);
+				vy.storeu(&in.vy[i]);
+				vz.storeu(&in.vz[i]);
+				px.storeu(&in.px[i]);
+				py.storeu(&in.py[i]);
+				pz.storeu(&in.pz[i]);
+				age.storeu(&in.age[i]);
+
+				int mask((age < Float4::loadu(&in.life[i])).mask());
+				if (end - i < Lanes) mask &= (1 << (end - i)) - 1;
+				alive += bits[mask];
+			}
+			survivors[job] = alive;
+		}, parallel);
+
+		//WuƂ̏ݐ߂
+		std::size_t alive(0);
+		for (unsigned int job = 0; job < jobs; ++job) {
+			const std::size_t n(survivors[job]);
+			survivors[job] = alive;
+			alive += n;
+		}
+
+		//Ăp[eBNg̔zɋl߁ACX^Xf[^
+		run(jobs, [&](unsigned int job, unsigned int) {
+			const std::size_t begin(job * Grain), end(std::min(count, begin + Grain));
+			std::size_t o(survivors[job]);
+			for (std::size_t i = begin; i < end; i += Lanes) {
+				const Float4 age(Float4::loadu(&in.age[i])), life(Float4::loadu(&in.life[i]));
+				int mask((age < life).mask());
+				if (end - i < Lanes) mask &= (1 << (end - i)) - 1;
+				if (mask == 0) continue;
+
+				//̌o߂̊
+				GLfloat t[Lanes];
+				(age / life).storeu(t);
+
+				if (mask == (1 << Lanes) - 1) {
+					//SĂ΂܂Ƃ߂Ĉڂ
+					for (const auto member : members) Float4::loadu(&(in.*member)[i]).storeu(&(out.*member)[o]);
+					for (unsigned int l = 0; l < Lanes; ++l) writeInstance(o + l, in.px[i + l], in.py[i + l], in.pz[i + l], t[l]);
+					o += Lanes;
+					continue;
+				}
+				for (unsigned int l = 0; l < Lanes; ++l) {
+					if ((mask >> l & 1) == 0) continue;
+					for (const auto member : members) (out.*member)[o] = (in.*member)[i + l];
+					writeInstance(o, in.px[i + l], in.py[i + l], in.pz[i + l], t[l]);
+					++o;
+				}
+			}
+		}, parallel);
+		stats.died = count - alive;
+		stats.simulateTime = Profiler::elapsed(t0);
+
+		//o̊ɍ킹ċl߂ƂɐVp[eBNi肫Ȃ͎̂Ăj
+		const auto t1(std::chrono::high_resolution_clock::now());
+		const GLfloat wanted(carry + emitter.rate * dt);
+		const std::size_t emit(std::min(capacity - alive, static_cast<std::size_t>(wanted)));
+		carry = wanted - std::floor(wanted);
+		seed = seed * 1664525u + 1013904223u;
+		const Float4 ox(emitter.position[0]), oy(emitter.position[1]), oz(emitter.position[2]), radius(emitter.radius);
+		const Float4 ux(emitter.velocity[0]), uy(emitter.velocity[1]), uz(emitter.velocity[2]), spread(emitter.spread);
+		const Float4 base(emitter.life * 0.875f), jitter(emitter.life * 0.125f);
+		run(static_cast<unsigned int>((emit + Grain - 1) / Grain), [&](unsigned int job, unsigned int) {
+			const std::size_t begin(alive + job * Grain), end(std::min(alive + emit, begin + Grain));
+			for (std::size_t i = begin; i < end; i += Lanes) {
+				//ʒuƑx̂΂͕\̗ꂽƂ납
+				const unsigned int k((seed + static_cast<std::uint32_t>(i)) & (NoiseSize - 1)), v((k + NoiseSize / 2 + 1) & (NoiseSize - 1));
+				const Float4 px(ox + Float4::loadu(&noise[0][k]) * radius);
+				const Float4 py(oy + Float4::loadu(&noise[1][k]) * radius);
+				const Float4 pz(oz + Float4::loadu(&noise[2][k]) * radius);
+				px.storeu(&out.px[i]);
+				py.storeu(&out.py[i]);
+				pz.storeu(&out.pz[i]);
+				(ux + Float4::loadu(&noise[0][v]) * spread).storeu(&out.vx[i]);
+				(uy + Float4::loadu(&noise[1][v]) * spread).storeu(&out.vy[i]);
+				(uz + Float4::loadu(&noise[2][v]) * spread).storeu(&out.vz[i]);
+				zero.storeu(&out.age[i]);
+				(base + Float4::loadu(&noise[3][k]) * jitter).storeu(&out.life[i]);
+				for (std::size_t l = i; l < std::min(end, i + Lanes); ++l) writeInstance(l, out.px[l], out.py[l], out.pz[l], 0.0f);
+			}
+		}, parallel);
+		stats.emitted = emit;
+		stats.emitTime = Profiler::elapsed(t1);
+
+		front = 1 - front;
+		count = stats.alive = alive + emit;
+	}
+
+	//p[eBNi߂ĕ`̏i`̃Xbhōŏ̃ReLXgΏۂɂČĂяoj
+	//CPUŐϕƂsimulatêƂŃCX^Xf[^]AGPUŐϕƂ̓gXtH[tB[hobN𔭍s
+	//dt:ԍ݁ibj
+	void update(GLfloat dt) {
+		if (!gpu) simulate(dt);
+		const auto t0(std::chrono::high_resolution_clock::now());
+		if (gpu) {
+			step(dt);
+			stats.alive = capacity;
+			stats.emitted = stats.died = 0;
+			stats.simulateTime = stats.emitTime = 0.0;
+		}
+		else {
+			//Õt[̕`҂Ȃ悤ɗ̈蒼Ă]
+			glBindBuffer(GL_ARRAY_BUFFER, stream.get());
+			glBufferData(GL_ARRAY_BUFFER, capacity * 4 * sizeof(GLfloat), NULL, GL_STREAM_DRAW);
+			glBufferSubData(GL_ARRAY_BUFFER, 0, count * 4 * sizeof(GLfloat), instances.data());
+		}
+		stats.uploadTime = Profiler::elapsed(t0);
+	}
+
+	//p[eBNZŕ`isȐ}`̂ƂŃfvX܂ɕ`j
+	//view:r[ϊsip[eBN̓[hWnŐϕj
+	//projection:eϊs
+	//context:݂̃ReLXg̔ԍ
+	void draw(const Matrix& view, const Matrix& projection, unsigned int context = 0) const {
+		const std::size_t n(gpu ? capacity : count);
+		if (n == 0 || !program) return;
+
+		bind(context);
+		glBindBuffer(GL_ARRAY_BUFFER, gpu ? feedback[feedbackFront].get() : stream.get());
+		glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, (gpu ? 8 : 4) * sizeof(GLfloat), 0);
+		glVertexAttribDivisor(0, 1);
+		glEnableVertexAttribArray(0);
+
+		glUseProgram(program.get());
+		glUniformMatrix4fv(modelviewLoc, 1, GL_FALSE, view.data());
+		glUniformMatrix4fv(projectionLoc, 1, GL_FALSE, projection.data());
+		glUniform2fv(sizeLoc, 1, extent);
+		glUniform4fv(birthColorLoc, 1, birthColor);
+		glUniform4fv(deathColorLoc, 1, deathColor);
+
+		glEnable(GL_BLEND);
+		glBlendFunc(GL_SRC_ALPHA, GL_ONE);
+		glDepthMask(GL_FALSE);
+		glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, static_cast<GLsizei>(n));
+		glDepthMask(GL_TRUE);
+		glDisable(GL_BLEND);
+	}
+
+	//Ăp[eBN̐iGPUŐϕƂ͗eʁj
+	std::size_t size() const { return gpu ? capacity : count; }
+
+	//p[eBN̐̏
+	std::size_t getCapacity() const { return capacity; }
+
+	//v
+	const Stats& getStats() const { return stats; }
+};
@@ -0,0 +1,368 @@
+#pragma once
+#include <chrono>
+#include <vector>
+#include <cmath>
+#include <iostream>
+#include <GL/glew.h>
+
+//VF[_[
+#include "Shader.h"
+
+//}`̒_
+#include "object.h"
+
+//ϊsƃxNg
+#include "Matrix.h"
+#include "vector.h"
+
+//OpenGL̃IuWFNg̏L
+#include "GLHandle.h"
+
+//`܂Ƃ߂Ĕs
+#include "IndirectBatch.h"
+
+//v
+#include "Profiler.h"
+
+//}EXJ[\̉̐}`I
+//J[\̎Size~Sizẻfɕ`̔ԍƎOp`̔ԍ𐮐̃J[obt@ɕ`ipick.vert, pick.fragjA
+//sNZobt@IuWFNgɔ񓯊ɓǂݏoătFXʉ߂̂o
+//ʂ1`2t[x邪AGPU`Î҂Ȃ̂ŕ`悪~܂Ȃ
+//GPUg킸ɂ̏őIԂƂRayŐ}`̎Op`ƌ𒲂ׂ
+//t[obt@IuWFNg̓ReLXg̊ԂŋLȂ̂ŃReLXgƂɍ
+class Picker {
+public:
+	//ǂݏö̈ӂ̉fiJ[\𒆐Sɂj
+	static constexpr GLsizei Size = 5;
+
+	//ǂݏo҂Ăv̐iꂾ̃t[xĂvȂj
+	static constexpr int Slots = 3;
+
+	//I񂾌
+	struct Result {
+		//`̔ԍiIndirectBatch::addɓnidAȂ0j
+		GLuint id;
+
+		//}`̒̎Op`̔ԍ
+		GLuint primitive;
+
+		//vĂ猋ʂo܂ł̃t[it[pollŎo0j
+		unsigned int frames;
+
+		//vĂ猋ʂo܂ł̎ԁi~bj
+		double latency;
+	};
+
+	//v
+	struct Stats {
+		//`Ɠǂݏo̔sɂԁi~bj
+		double requestTime;
+
+		//ǂݏoÎ҂Ăv̐
+		unsigned int pending;
+
+		//󂫂ȂČv̐
+		unsigned int dropped;
+	};
+
+	//CPUŐ}`̎Op`ƌ𒲂ׂ
+	class Ray {
+		//[hWn̎n_iOʏjƕiʂ܂ł̒j
+		GLfloat origin[3], direction[3];
+
+	public:
+		//RXgN^
+		//viewProjection:eϊs~r[ϊs
+		//x, y:r[|[g̐KfoCXWn̈ʒu
+		Ray(const Matrix& viewProjection, GLfloat x, GLfloat y) {
+			const Matrix inverse(viewProjection.inverse());
+			const Vector n(inverse * Vector{ x, y, -1.0f, 1.0f });
+			const Vector f(inverse * Vector{ x, y, 1.0f, 1.0f });
+			for (int i = 0; i < 3; ++i) {
+				origin[i] = n[i] / n[3];
+				direction[i] = f[i] / f[3] - origin[i];
+			}
+		}
+
+		//}`ƌ𒲂ׂ
+		//model:fϊs
+		//radius:fWň_𒆐Sɐ}`͂ދ̔aiɓȂΎOp`𒲂ׂȂj
+		//vertex, index, count:}`̒_AOp`̃CfbNXƂ̐
+		//t:܂łɌԋ߂_̌̈ʒuiOʂ0Aʂ1jA߂Ώ
+		//primitive:Op`̔ԍitƂɏj
+		//߂l:t߂Ōtrue
+		bool intersect(const Matrix& model, GLfloat radius,
+			const Object::Vertex* vertex, const GLuint* index, GLsizei count, GLfloat& t, GLuint& primitive) const {
+
+			//fWnɈڂiAtBϊȂ̂Ō̈ʒu͕ςȂj
+			const Matrix inverse(model.inverse());
+			const Vector o(inverse * Vector{ origin[0], origin[1], origin[2], 1.0f });
+			const Vector d(inverse * Vector{ direction[0], direction[1], direction[2], 0.0f });
+
+			//͂ދɓȂAĂt艓ΎOp`𒲂ׂȂ
+			const GLfloat a(d[0] * d[0] + d[1] * d[1] + d[2] * d[2]);
+			const GLfloat b(o[0] * d[0] + o[1] * d[1] + o[2] * d[2]);
+			const GLfloat c(o[0] * o[0] + o[1] * o[1] + o[2] * o[2] - radius * radius);
+			const GLfloat discriminant(b * b - a * c);
+			if (a <= 0.0f || discriminant < 0.0f) return false;
+			const GLfloat root(std::sqrt(discriminant));
+			if ((-b + root) / a < 0.0f || (-b - root) / a >= t) return false;
+
+			//Op`ƂɌ𒲂ׂiʂIԁj
+			bool hit(false);
+			for (GLsizei i = 0; i + 2 < count; i += 3) {
+				const GLfloat* const p0(vertex[index[i]].position);
+				const GLfloat* const p1(vertex[index[i + 1]].position);
+				const GLfloat* const p2(vertex[index[i + 2]].position);
+				const GLfloat e1[] = { p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2] };
+				const GLfloat e2[] = { p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2] };
+				const GLfloat p[] = { d[1] * e2[2] - d[2] * e2[1], d[2] * e2[0] - d[0] * e2[2], d[0] * e2[1] - d[1] * e2[0] };
+				const GLfloat det(e1[0] * p[0] + e1[1] * p[1] + e1[2] * p[2]);
+				if (std::fabs(det) < 1.0e-12f) continue;
+				const GLfloat inv(1.0f / det);
+				const GLfloat s[] = { o[0] - p0[0], o[1] - p0[1], o[2] - p0[2] };
+				const GLfloat u((s[0] * p[0] + s[1] * p[1] + s[2] * p[2]) * inv);
+				if (u < 0.0f || u > 1.0f) continue;
+				const GLfloat q[] = { s[1] * e1[2] - s[2] * e1[1], s[2] * e1[0] - s[0] * e1[2], s[0] * e1[1] - s[1] * e1[0] };
+				const GLfloat v((d[0] * q[0] + d[1] * q[1] + d[2] * q[2]) * inv);
+				if (v < 0.0f || u + v > 1.0f) continue;
+				const GLfloat u0((e2[0] * q[0] + e2[1] * q[1] + e2[2] * q[2]) * inv);
+				if (u0 < 0.0f || u0 >= t) continue;
+				t = u0;
+				primitive = static_cast<GLuint>(i / 3);
+				hit = true;
+			}
+			return hit;
+		}
+	};
+
+private:
+	//ԍ`vOIuWFNg
+	const GLProgram program;
+
+	//eϊsuniformϐ̏ꏊ
+	const GLint projectionLoc;
+
+	//ԍ`J[obt@iGL_RG32UIjƃfvXobt@
+	GLTexture color, depth;
+
+	//ReLXgƂ̃t[obt@IuWFNg
+	std::vector<GLFramebuffer> framebuffers;
+
+	//ǂݏo̗v
+	struct Slot {
+		//ǂݏõsNZobt@IuWFNg
+		GLBuffer buffer;
+
+		//ǂݏǒɒutFXi󂢂ĂNULLj
+		GLsync fence;
+
+		//vt[Ǝ
+		unsigned long long frame;
+		std::chrono::high_resolution_clock::time_point start;
+	};
+	Slot slots[Slots];
+
+	//Ɏgvi珇ɌÂj
+	int next;
+
+	//pollĂ񂾉
+	unsigned long long frame;
+
+	//ŌɎo
+	Result result;
+
+	//v
+	Stats stats;
+
+	//Rs[֎~
+	Picker(const Picker&) = delete;
+	Picker& operator=(const Picker&) = delete;
+
+	//ReLXg̃t[obt@IuWFNgiȂ΍j
+	//߂l:gtrue
+	bool bindFramebuffer(unsigned int context) {
+		if (context >= framebuffers.size()) framebuffers.resize(context + 1);
+		if (framebuffers[context]) {
+			glBindFramebuffer(GL_FRAMEBUFFER, framebuffers[context].get());
+			return true;
+		}
+
+		framebuffers[context] = GLFramebuffer::create();
+		glBindFramebuffer(GL_FRAMEBUFFER, framebuffers[context].get());
+		glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, color.get(), 0);
+		glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, depth.get(), 0);
+		glReadBuffer(GL_COLOR_ATTACHMENT0);
+		if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+			std::cerr << "Error: Picking framebuffer is incomplete." << std::endl;
+			glBindFramebuffer(GL_FRAMEBUFFER, 0);
+			return false;
+		}
+		return true;
+	}
+
+	//J[\̗̎̈ɔԍ`iIԍ`t[obt@IuWFNgĂj
+	//߂l:J[\r[|[g̊O`Ȃfalse
+	bool render(IndirectBatch& batch, const Matrix& projection, const GLint* viewport, GLfloat x, GLfloat y, unsigned int context) {
+		if (x < viewport[0] || y < viewport[1] || x >= viewport[0] + viewport[2] || y >= viewport[1] + viewport[3]) return false;
+		if (!bindFramebuffer(context)) return false;
+
+		//J[\̗̎̈悪t[obt@ŜɂȂ悤ɓeϊsg傷
+		const GLfloat cx(2.0f * (x - viewport[0]) / viewport[2] - 1.0f);
+		const GLfloat cy(2.0f * (y - viewport[1]) / viewport[3] - 1.0f);
+		const Matrix region(Matrix::scale(static_cast<GLfloat>(viewport[2]) / Size, static_cast<GLfloat>(viewport[3]) / Size, 1.0f)
+			* Matrix::translate(-cx, -cy, 0.0f));
+
+		glViewport(0, 0, Size, Size);
+		glDisable(GL_SCISSOR_TEST);
+		static const GLuint zero[] = { 0, 0, 0, 0 };
+		glClearBufferuiv(GL_COLOR, 0, zero);
+		glClear(GL_DEPTH_BUFFER_BIT);
+		glUseProgram(program.get());
+		glUniformMatrix4fv(projectionLoc, 1, GL_FALSE, (region * projection).data());
+		batch.drawDepth(GL_TRIANGLES, context);
+		return true;
+	}
+
+	//ǂݏoԍJ[\Ɉԋ߂}`I
+	//pixels:Size~Sizef̕`̔ԍƎOp`̔ԍ
+	//r:I񂾌ʂi[
+	static void choose(const GLuint* pixels, Result& r) {
+		r.id = r.primitive = 0;
+		int nearest(Size * Size);
+		for (int j = 0; j < Size; ++j) {
+			for (int i = 0; i < Size; ++i) {
+				const GLuint* const p(pixels + (j * Size + i) * 2);
+				const int d((i - Size / 2) * (i - Size / 2) + (j - Size / 2) * (j - Size / 2));
+				if (p[0] == 0 || d >= nearest) continue;
+				nearest = d;
+				r.id = p[0];
+				r.primitive = p[1];
+			}
+		}
+	}
+
+public:
+	//RXgN^
+	Picker()
+		:program(loadProgram("pick.vert", "pick.frag"))
+		, projectionLoc(glGetUniformLocation(program.get(), "projection"))
+		, color(GLTexture::create()), depth(GLTexture::create()), next(0), frame(0), result(), stats()
+	{
+		glBindTexture(GL_TEXTURE_2D, color.get());
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RG32UI, Size, Size, 0, GL_RG_INTEGER, GL_UNSIGNED_INT, NULL);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+		glBindTexture(GL_TEXTURE_2D, depth.get());
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT24, Size, Size, 0, GL_DEPTH_COMPONENT, GL_FLOAT, NULL);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+		glBindTexture(GL_TEXTURE_2D, 0);
+
+		//ǂݏõsNZobt@IuWFNg
+		for (Slot& slot : slots) {
+			slot.buffer = GLBuffer::create();
+			glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer.get());
+			glBufferData(GL_PIXEL_PACK_BUFFER, Size * Size * 2 * sizeof(GLuint), NULL, GL_STREAM_READ);
+			slot.fence = NULL;
+			slot.frame = 0;
+		}
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+	}
+
+	//fXgN^
+	virtual ~Picker() {
+		for (Slot& slot : slots) if (slot.fence != NULL) glDeleteSync(slot.fence);
+	}
+
+	//J[\̉̔ԍ`ăsNZobt@IuWFNgւ̓ǂݏo𔭍si҂Ȃj
+	//`W߂ƂŌĂԁAIƊ̃t[obt@ăr[|[g͕ςĂ
+	//batch:`W߂ob`idrawŕ`̂Ɠj
+	//projection:eϊs
+	//viewport:r[|[gix, y, , j
+	//x, y:J[\̃t[obt@̈ʒuifA_j
+	//context:݂̃ReLXg̔ԍ
+	//߂l:vłtrueiǂݏo҂v邩J[\r[|[g̊OȂfalsej
+	bool request(IndirectBatch& batch, const Matrix& projection, const GLint* viewport, GLfloat x, GLfloat y, unsigned int context = 0) {
+		const auto t0(std::chrono::high_resolution_clock::now());
+		Slot& slot(slots[next]);
+		if (slot.fence != NULL) {
+			++stats.dropped;
+			return false;
+		}
+		if (!render(batch, projection, viewport, x, y, context)) {
+			glBindFramebuffer(GL_FRAMEBUFFER, 0);
+			return false;
+		}
+
+		//sNZobt@IuWFNgɓǂݏoătFXu
+		//tFXGPUɓ͂悤ɑoĂipoll͑҂Ȃ̂őoȂ΂܂łIȂj
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer.get());
+		glReadPixels(0, 0, Size, Size, GL_RG_INTEGER, GL_UNSIGNED_INT, 0);
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+		slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+		glFlush();
+		slot.frame = frame;
+		slot.start = t0;
+		next = (next + 1) % Slots;
+		stats.requestTime = Profiler::elapsed(t0);
+		return true;
+	}
+
+	//ǂݏoIv̌ʂÂɎoit[ƂɈĂяoA҂Ȃj
+	//߂l:Vʂotrue
+	bool poll() {
+		bool found(false);
+		stats.pending = 0;
+		for (int k = 0; k < Slots; ++k) {
+			Slot& slot(slots[(next + k) % Slots]);
+			if (slot.fence == NULL) continue;
+
+			//tFXʉ߂ĂȂ΂VvIĂȂ
+			const GLenum status(glClientWaitSync(slot.fence, 0, 0));
+			if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) {
+				for (int i = k; i < Slots; ++i) if (slots[(next + i) % Slots].fence != NULL) ++stats.pending;
+				break;
+			}
+			glDeleteSync(slot.fence);
+			slot.fence = NULL;
+
+			glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer.get());
+			const GLuint* const pixels(static_cast<const GLuint*>(
+				glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, Size * Size * 2 * sizeof(GLuint), GL_MAP_READ_BIT)));
+			if (pixels != NULL) {
+				choose(pixels, result);
+				glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+			}
+			glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+			result.frames = static_cast<unsigned int>(frame - slot.frame);
+			result.latency = Profiler::elapsed(slot.start);
+			found = true;
+		}
+		++frame;
+		return found;
+	}
+
+	//J[\̉̔ԍ`ĂglReadPixelsœǂݏoiGPU`I܂ŕ`悪~܂j
+	//requestƓ
+	//߂l:I񂾌ʁiJ[\r[|[g̊OȂԍ0j
+	Result pickNow(IndirectBatch& batch, const Matrix& projection, const GLint* viewport, GLfloat x, GLfloat y, unsigned int context = 0) {
+		const auto t0(std::chrono::high_resolution_clock::now());
+		Result r = {};
+		if (render(batch, projection, viewport, x, y, context)) {
+			GLuint pixels[Size * Size * 2];
+			glReadPixels(0, 0, Size, Size, GL_RG_INTEGER, GL_UNSIGNED_INT, pixels);
+			choose(pixels, r);
+		}
+		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+		r.latency = Profiler::elapsed(t0);
+		return r;
+	}
+
+	//ŌɎo
+	const Result& getResult() const { return result; }
+
+	//v
+	const Stats& getStats() const { return stats; }
+};
@@ -0,0 +1,90 @@
+#pragma once
+#include <array>
+#include <vector>
+#include <GL/glew.h>
+
+//ϊsƃxNg
+#include "Matrix.h"
+#include "vector.h"
+
+//jtH[obt@IuWFNg
+#include "Uniform.h"
+
+//_̏W܂
+//[hWnŐݒ肵Ar[ƂɎ_WnɈڂăjtH[obt@IuWFNgɓ]
+//O`ipoint.fragjƒx`ilight.vert, light.fragj̗PointLightsubNƂēǂ
+class PointLights {
+public:
+	//_̍ő吔iVF[_[ƍ킹j
+	static constexpr unsigned int MaxLights = 256;
+
+	//_
+	struct Light {
+		//[hWn̈ʒu
+		GLfloat position[3];
+
+		//͂iŌ0ɂȂj
+		GLfloat radius;
+
+		//̐F
+		GLfloat color[3];
+	};
+
+	//jtH[ubNistd140j
+	struct Block {
+		//_Wn̈ʒuƌ͂
+		std::array<GLfloat, 4> position[MaxLights];
+
+		//̐F
+		std::array<GLfloat, 4> color[MaxLights];
+	};
+
+private:
+	//_
+	std::vector<Light> lights;
+
+	//]郆jtH[ubN
+	Block block;
+
+	//jtH[obt@IuWFNg
+	const Uniform<Block> uniform;
+
+public:
+	//RXgN^
+	PointLights() :block(), uniform(&block, 1) {
+		lights.reserve(MaxLights);
+	}
+
+	//_
+	void clear() { lights.clear(); }
+
+	//_ǉiMaxLights𒴂ǉȂj
+	//߂l:ǉłtrue
+	bool add(const Light& light) {
+		if (lights.size() >= MaxLights) return false;
+		lights.push_back(light);
+		return true;
+	}
+
+	//__WnɈڂē]
+	//view:r[ϊs
+	void upload(const Matrix& view) {
+		for (std::size_t i = 0; i < lights.size(); ++i) {
+			const Light& l(lights[i]);
+			const Vector p(view * Vector{ l.position[0], l.position[1], l.position[2], 1.0f });
+			block.position[i] = { p[0], p[1], p[2], l.radius };
+			block.color[i] = { l.color[0], l.color[1], l.color[2], 1.0f };
+		}
+		uniform.set(&block);
+	}
+
+	//jtH[obt@IuWFNg|CgɌ
+	//bp:|Cg
+	void select(GLuint bp) const { uniform.select(bp); }
+
+	//_̐
+	GLsizei size() const { return static_cast<GLsizei>(lights.size()); }
+
+	//_o
+	const Light& operator[](std::size_t i) const { return lights[i]; }
+};
@@ -0,0 +1,687 @@
+#pragma once
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <algorithm>
+#include <GL/glew.h>
+
+//}`̒_
+#include "object.h"
+
+//ϊsƃxNg
+#include "Matrix.h"
+#include "vector.h"
+
+//4vf̃xNgZ
+#include "Simd.h"
+
+//[J[Xbh
+#include "ThreadPool.h"
+
+//v
+#include "Profiler.h"
+
+//̃v[uCPUŏĂt
+//}`̎Op`[hWnɈڂBVHɂ܂Ƃ߁Aiqɕׂv[uoHǐՂŌ΂A
+//͂2܂ł̋ʒa֐ɎˉeĕˏƓx̌Wɂ
+//BVH̗tɂ4̎Op`vfƂɕׂĒuAFloat4ňxɌ𒲂ׂ
+//v[u^CƂăXbhƂɘA͈͂蓖āA͈̔͂s瑼̃Xbh̎c𓐂
+//ǂݍݎOɈxsAʂLightProbesŕۑĕ`Ɏg
+class ProbeBaker {
+public:
+	//ʒa֐̌W̐i2܂Łj
+	static constexpr int Coefficients = 9;
+
+	//tɂ܂Ƃ߂Op`̐iFloat4̗vfj
+	static constexpr int Lanes = 4;
+
+	//t\߂̎
+	static constexpr GLuint Leaf = 3;
+
+	//\ʐσq[XeBbNŕő̐[i[߂͔ɕj
+	static constexpr int MaxSahDepth = 32;
+
+	//Ăt̐ݒ
+	struct Settings {
+		//v[uƂ̌̐
+		unsigned int samples;
+
+		//}`Ŕ˂񐔁i0Ȃŏɓʂ̒ڌƋ󂾂j
+		unsigned int bounces;
+
+		//̕ˋPx
+		GLfloat sky[3];
+
+		//[hWn̕sɌƋ
+		GLfloat sun[3], sunColor[3];
+	};
+
+	//v
+	struct Stats {
+		//Op`BVH̐߂̐
+		unsigned int triangles, nodes;
+
+		//΂̐ie𒲂ׂ܂ށj
+		unsigned long long rays;
+
+		//̃Xbh^C𓐂񂾉
+		unsigned int steals;
+
+		//}`̒ɂĎ̃v[uv[u̐
+		unsigned int invalid;
+
+		//BVH鎞ԂƏĂt̎ԁi~bj
+		double buildTime, bakeTime;
+	};
+
+private:
+	//Op`i[hWnj
+	struct Triangle {
+		//ŏ̒_Ǝc̒_ւ̃xNg
+		GLfloat p0[3], e1[3], e2[3];
+
+		//_̖@̕ρiOj
+		GLfloat normal[3];
+
+		//˗
+		GLfloat albedo[3];
+	};
+
+	//Op`4̑givfƂɕׂj
+	struct Packet {
+		alignas(16) GLfloat p0[3][Lanes];
+		alignas(16) GLfloat e1[3][Lanes];
+		alignas(16) GLfloat e2[3][Lanes];
+
+		//̎Op`̔ԍ
+		GLuint triangle[Lanes];
+	};
+
+	//BVH̐
+	struct Node {
+		//߂͂ޔ̍ŏ̊p
+		GLfloat min[3];
+
+		//tȂOp`̑g̔ԍAłȂΓڂ̎q̔ԍiڂ̎q͂ɒuj
+		GLuint index;
+
+		//߂͂ޔ̍ő̊p
+		GLfloat max[3];
+
+		//tȂLeafAłȂΎqɕi0`2j
+		GLuint axis;
+	};
+
+	//ɉ
+	struct Box {
+		GLfloat min[3], max[3];
+
+		//̔
+		static Box empty() {
+			const GLfloat f(std::numeric_limits<GLfloat>::max());
+			return Box{ { f, f, f }, { -f, -f, -f } };
+		}
+
+		//_܂ނ悤ɍL
+		void grow(const GLfloat* p) {
+			for (int i = 0; i < 3; ++i) {
+				min[i] = std::min(min[i], p[i]);
+				max[i] = std::max(max[i], p[i]);
+			}
+		}
+
+		//܂ނ悤ɍL
+		void grow(const Box& b) {
+			grow(b.min);
+			grow(b.max);
+		}
+
+		//\ʐ
+		GLfloat area() const {
+			const GLfloat x(max[0] - min[0]), y(max[1] - min[1]), z(max[2] - min[2]);
+			return x < 0.0f ? 0.0f : 2.0f * (x * y + y * z + z * x);
+		}
+	};
+
+	//d𓐂ރ^C̊蓖
+	//XbhƂɎc̃^C͈̔[begin, end)64rbǧqϐɋl߂ĎA
+	//͑OÃXbh͎̎č딼͈̔͂Ɉڂ
+	class Tiles {
+		//XbhƂ͈̔́ĩׂXbh͈̔͂ƓLbVCɏȂ悤ɂj
+		struct Queue {
+			std::atomic<std::uint64_t> range;
+			char padding[64 - sizeof(std::atomic<std::uint64_t>)];
+		};
+		std::unique_ptr<Queue[]> queues;
+
+		//Xbh̐
+		const unsigned int threads;
+
+		//񂾉
+		std::atomic<unsigned int> steals;
+
+		//͈͂l߂
+		static std::uint64_t pack(std::uint32_t begin, std::uint32_t end) {
+			return static_cast<std::uint64_t>(end) << 32 | begin;
+		}
+
+	public:
+		//RXgN^
+		//threads:Xbh̐
+		//count:^C̐iXbh̔ԍɘA͈͂ɕj
+		Tiles(unsigned int threads, unsigned int count) :queues(new Queue[threads]), threads(threads), steals(0) {
+			for (unsigned int t = 0; t < threads; ++t) {
+				queues[t].range.store(pack(static_cast<std::uint32_t>(static_cast<std::uint64_t>(count) * t / threads),
+					static_cast<std::uint32_t>(static_cast<std::uint64_t>(count) * (t + 1) / threads)));
+			}
+		}
+
+		//ɏ^Co
+		//thread:Xbh̔ԍ
+		//tile:o^C̔ԍ
+		//߂l:ǂ̃Xbhɂ^CcĂȂfalse
+		bool next(unsigned int thread, unsigned int& tile) {
+			//͈̔͂̐擪
+			std::atomic<std::uint64_t>& own(queues[thread].range);
+			for (std::uint64_t r(own.load()); static_cast<std::uint32_t>(r) < static_cast<std::uint32_t>(r >> 32);) {
+				if (own.compare_exchange_weak(r, r + 1)) {
+					tile = static_cast<std::uint32_t>(r);
+					return true;
+				}
+			}
+
+			//̃Xbh̎č딼𓐂݁A̐擪Ďc͈̔͂ɂ
+			//͈̔͂͋Ȃ̂ő̃Xbh邱Ƃ͂Ȃ
+			for (unsigned int i = 1; i < threads; ++i) {
+				std::atomic<std::uint64_t>& victim(queues[(thread + i) % threads].range);
+				for (std::uint64_t r(victim.load());;) {
+					const std::uint32_t begin(static_cast<std::uint32_t>(r)), end(static_cast<std::uint32_t>(r >> 32));
+					if (begin >= end) break;
+					const std::uint32_t middle(begin + (end - begin) / 2);
+					if (victim.compare_exchange_weak(r, pack(begin, middle))) {
+						own.store(pack(middle + 1, end));
+						steals.fetch_add(1);
+						tile = middle;
+						return true;
+					}
+				}
+			}
+			return false;
+		}
+
+		//񂾉
+		unsigned int getSteals() const { return steals.load(); }
+	};
+
+	//xorshiftɂ闐iv[uƂɎ߂̂ŃXbh̐ɂ炸ʂɂȂj
+	class Random {
+		std::uint32_t state;
+
+	public:
+		//RXgN^
+		//seed:
+		explicit Random(std::uint32_t seed) :state(seed * 2654435761u + 1u) {}
+
+		//[0, 1)̈l
+		GLfloat next() {
+			state ^= state << 13;
+			state ^= state >> 17;
+			state ^= state << 5;
+			return static_cast<GLfloat>(state >> 8) * (1.0f / 16777216.0f);
+		}
+	};
+
+	//Op`
+	std::vector<Triangle> triangles;
+
+	//BVH̐߁i0ԂjƗt̎Op`̑g
+	std::vector<Node> nodes;
+	std::vector<Packet> packets;
+
+	//BVH蒼Kvtrue
+	bool dirty;
+
+	//v
+	Stats stats;
+
+	//begin`end̎Op`͂ސ߂iorderבւj
+	//depth:߂̐[i[Ȃ肷甼ɕtracẽX^bNɎ߂j
+	//߂l:߂̔ԍ
+	GLuint subdivide(const std::vector<Box>& boxes, const std::vector<Box>& centers, std::vector<GLuint>& order,
+		std::size_t begin, std::size_t end, int depth)
+	{
+		const GLuint node(static_cast<GLuint>(nodes.size()));
+		nodes.emplace_back();
+		Box box(Box::empty()), centroid(Box::empty());
+		for (std::size_t i = begin; i < end; ++i) {
+			box.grow(boxes[order[i]]);
+			centroid.grow(centers[order[i]].min);
+		}
+		std::copy(box.min, box.min + 3, nodes[node].min);
+		std::copy(box.max, box.max + 3, nodes[node].max);
+
+		//4ȉȂtɂĎOp`̑gi]vf͖ʐ0̎Op`Ŗ߂j
+		if (end - begin <= static_cast<std::size_t>(Lanes)) {
+			Packet packet{};
+			for (int l = 0; l < Lanes; ++l) {
+				const bool used(begin + l < end);
+				packet.triangle[l] = used ? order[begin + l] : 0;
+				if (!used) continue;
+				const Triangle& t(triangles[order[begin + l]]);
+				for (int i = 0; i < 3; ++i) {
+					packet.p0[i][l] = t.p0[i];
+					packet.e1[i][l] = t.e1[i];
+					packet.e2[i][l] = t.e2[i];
+				}
+			}
+			nodes[node].index = static_cast<GLuint>(packets.size());
+			nodes[node].axis = Leaf;
+			packets.push_back(packet);
+			return node;
+		}
+
+		//dS̍L肪ł傫rɕĕ\ʐσq[XeBbNŕʒuI
+		int axis(0);
+		for (int i = 1; i < 3; ++i) {
+			if (centroid.max[i] - centroid.min[i] > centroid.max[axis] - centroid.min[axis]) axis = i;
+		}
+		const GLfloat extent(centroid.max[axis] - centroid.min[axis]);
+		std::size_t middle(begin);
+		if (extent > 0.0f && depth < MaxSahDepth) {
+			static constexpr int Bins = 16;
+			Box bins[Bins];
+			std::size_t counts[Bins] = {};
+			std::fill(bins, bins + Bins, Box::empty());
+			const GLfloat scale(Bins * 0.999f / extent);
+			const auto bin = [&](GLuint t) { return static_cast<int>((centers[t].min[axis] - centroid.min[axis]) * scale); };
+			for (std::size_t i = begin; i < end; ++i) {
+				const int b(bin(order[i]));
+				bins[b].grow(boxes[order[i]]);
+				++counts[b];
+			}
+
+			//EݐςʐςƐ߂ĂAݐςȂpŏɂȂ鋫ET
+			GLfloat rightArea[Bins];
+			std::size_t rightCount[Bins];
+			Box right(Box::empty());
+			std::size_t n(0);
+			for (int b = Bins - 1; b > 0; --b) {
+				right.grow(bins[b]);
+				n += counts[b];
+				rightArea[b] = right.area();
+				rightCount[b] = n;
+			}
+			Box left(Box::empty());
+			std::size_t leftCount(0);
+			GLfloat best(std::numeric_limits<GLfloat>::max());
+			int split(0);
+			for (int b = 1; b < Bins; ++b) {
+				left.grow(bins[b - 1]);
+				leftCount += counts[b - 1];
+				if (leftCount == 0 || rightCount[b] == 0) continue;
+				const GLfloat cost(left.area() * leftCount + rightArea[b] * rightCount[b]);
+				if (cost < best) {
+					best = cost;
+					split = b;
+				}
+			}
+			if (split > 0) {
+				middle = std::partition(order.begin() + begin, order.begin() + end, [&](GLuint t) { return bin(t) < split; }) - order.begin();
+			}
+		}
+
+		//ȂΏdS̏Ŕɕ
+		if (middle == begin || middle == end) {
+			middle = begin + (end - begin) / 2;
+			std::nth_element(order.begin() + begin, order.begin() + middle, order.begin() + end,
+				[&](GLuint a, GLuint b) { return centers[a].min[axis] < centers[b].min[axis]; });
+		}
+		nodes[node].axis = static_cast<GLuint>(axis);
+		subdivide(boxes, centers, order, begin, middle, depth + 1);
+		const GLuint second(subdivide(boxes, centers, order, middle, end, depth + 1));
+		nodes[node].index = second;
+		return node;
+	}
+
+	//ƎOp`̌𒲂ׂ
+	//origin, direction:̎n_ƕ
+	//t:߂TA_܂ł̋ɏ
+	//any:trueȂǂꂩɓ_Ŗ߂ie𒲂ׂj
+	//߂l:Op`̔ԍiȂ-1j
+	int trace(const GLfloat* origin, const GLfloat* direction, GLfloat& t, bool any) const {
+		if (nodes.empty()) return -1;
+		const GLfloat inverse[] = { 1.0f / direction[0], 1.0f / direction[1], 1.0f / direction[2] };
+		const Float4 ox(origin[0]), oy(origin[1]), oz(origin[2]);
+		const Float4 dx(direction[0]), dy(direction[1]), dz(direction[2]);
+		const Float4 zero(0.0f), one(1.0f), epsilon(1.0e-20f), near(1.0e-4f);
+		int hit(-1);
+
+		//ƌ͈͂[0, t)ɂtrue
+		const auto overlap = [&](const Node& n) {
+			GLfloat enter(0.0f), leave(t);
+			for (int i = 0; i < 3; ++i) {
+				const GLfloat a((n.min[i] - origin[i]) * inverse[i]), b((n.max[i] - origin[i]) * inverse[i]);
+				enter = std::max(enter, std::min(a, b));
+				leave = std::min(leave, std::max(a, b));
+			}
+			return enter <= leave;
+		};
+
+		GLuint stack[MaxSahDepth + 64];
+		int top(0);
+		stack[top++] = 0;
+		while (top > 0) {
+			const Node& n(nodes[stack[--top]]);
+			if (!overlap(n)) continue;
+			if (n.axis != Leaf) {
+				//̐̌ɐiތȂڂ̎qɐςŐɒׂ
+				const GLuint first(static_cast<GLuint>(&n - nodes.data()) + 1);
+				if (direction[n.axis] > 0.0f) {
+					stack[top++] = n.index;
+					stack[top++] = first;
+				}
+				else {
+					stack[top++] = first;
+					stack[top++] = n.index;
+				}
+				continue;
+			}
+
+			//4̎Op`Moller-Trumbore̕@ł܂Ƃ߂Č𒲂ׂ
+			const Packet& p(packets[n.index]);
+			const Float4 e1x(Float4::load(p.e1[0])), e1y(Float4::load(p.e1[1])), e1z(Float4::load(p.e1[2]));
+			const Float4 e2x(Float4::load(p.e2[0])), e2y(Float4::load(p.e2[1])), e2z(Float4::load(p.e2[2]));
+			const Float4 px(dy * e2z - dz * e2y), py(dz * e2x - dx * e2z), pz(dx * e2y - dy * e2x);
+			const Float4 det(e1x * px + e1y * py + e1z * pz);
+			const Float4 inv(one / det);
+			const Float4 sx(ox - Float4::load(p.p0[0])), sy(oy - Float4::load(p.p0[1])), sz(oz - Float4::load(p.p0[2]));
+			const Float4 u((sx * px + sy * py + sz * pz) * inv);
+			const Float4 qx(sy * e1z - sz * e1y), qy(sz * e1x - sx * e1z), qz(sx * e1y - sy * e1x);
+			const Float4 v((dx * qx + dy * qy + dz * qz) * inv);
+			const Float4 d((e2x * qx + e2y * qy + e2z * qz) * inv);
+			const int mask(((det * det > epsilon) & (u >= zero) & (v >= zero) & (u + v <= one)
+				& (d > near) & (d < Float4(t))).mask());
+			if (mask == 0) continue;
+			if (any) {
+				int l(0);
+				while ((mask >> l & 1) == 0) ++l;
+				return static_cast<int>(p.triangle[l]);
+			}
+
+			//ōł߂̂I
+			alignas(16) GLfloat distance[Lanes];
+			d.store(distance);
+			for (int l = 0; l < Lanes; ++l) {
+				if ((mask >> l & 1) == 0 || distance[l] >= t) continue;
+				t = distance[l];
+				hit = static_cast<int>(p.triangle[l]);
+			}
+		}
+		return hit;
+	}
+
+	//̃v[uɓ͂߂ČWɂ
+	//position:v[üʒu
+	//settings:Ăt̐ݒ
+	//seed:̎
+	//coefficient:CoefficientsRGB̌W̏ݐ
+	//rays:΂̐ɉ
+	//߂l:ȏ̌ʂ̗ɓi}`̒ɂjȂfalse
+	bool bakeProbe(const GLfloat* position, const Settings& settings, std::uint32_t seed, GLfloat* coefficient, unsigned long long& rays) const {
+		Random random(seed);
+		std::fill(coefficient, coefficient + Coefficients * 3, 0.0f);
+		unsigned int inside(0);
+		for (unsigned int s = 0; s < settings.samples; ++s) {
+			//ʏɈlɕziwʂɕj
+			const GLfloat z(1.0f - 2.0f * (static_cast<GLfloat>(s) + random.next()) / static_cast<GLfloat>(settings.samples));
+			const GLfloat r(std::sqrt(std::max(0.0f, 1.0f - z * z)));
+			const GLfloat phi(6.2831853f * random.next());
+			const GLfloat direction[] = { r * std::cos(phi), r * std::sin(phi), z };
+
+			//oHǐՂē͂ˋPx߂
+			GLfloat radiance[3] = {}, throughput[] = { 1.0f, 1.0f, 1.0f };
+			GLfloat o[] = { position[0], position[1], position[2] };
+			GLfloat d[] = { direction[0], direction[1], direction[2] };
+			for (unsigned int bounce = 0;; ++bounce) {
+				GLfloat t(std::numeric_limits<GLfloat>::max());
+				const int hit(trace(o, d, t, false));
+				++rays;
+
+				//ɂȂ΋̌
+				if (hit < 0) {
+					for (int i = 0; i < 3; ++i) radiance[i] += throughput[i] * settings.sky[i];
+					break;
+				}
+
+				//ʂ̗ɓ}`̒Ȃ̂Ō͓͂Ȃ
+				const Triangle& tr(triangles[hit]);
+				const GLfloat* const n(tr.normal);
+				if (n[0] * d[0] + n[1] * d[1] + n[2] * d[2] > 0.0f) {
+					if (bounce == 0) ++inside;
+					break;
+				}
+
+				//_ʂ班Ĕ˗|
+				for (int i = 0; i < 3; ++i) {
+					o[i] += d[i] * t + n[i] * 1.0e-3f;
+					throughput[i] *= tr.albedo[i];
+				}
+
+				//s̒ڌie𒲂ׂj
+				const GLfloat ndl(n[0] * settings.sun[0] + n[1] * settings.sun[1] + n[2] * settings.sun[2]);
+				if (ndl > 0.0f) {
+					GLfloat shadow(std::numeric_limits<GLfloat>::max());
+					++rays;
+					if (trace(o, settings.sun, shadow, true) < 0) {
+						for (int i = 0; i < 3; ++i) radiance[i] += throughput[i] * settings.sunColor[i] * ndl;
+					}
+				}
+				if (bounce >= settings.bounces) break;
+
+				//]ɔႷ镪zŎ̕IԁigU˂̌WƊmxłj
+				const GLfloat a(6.2831853f * random.next()), b(random.next());
+				const GLfloat sr(std::sqrt(b)), sz(std::sqrt(1.0f - b));
+				const GLfloat tangent0[3] = { std::fabs(n[0]) > 0.9f ? 0.0f : 1.0f, std::fabs(n[0]) > 0.9f ? 1.0f : 0.0f, 0.0f };
+				GLfloat bx[] = { n[1] * tangent0[2] - n[2] * tangent0[1], n[2] * tangent0[0] - n[0] * tangent0[2], n[0] * tangent0[1] - n[1] * tangent0[0] };
+				const GLfloat bl(std::sqrt(bx[0] * bx[0] + bx[1] * bx[1] + bx[2] * bx[2]));
+				for (int i = 0; i < 3; ++i) bx[i] /= bl;
+				const GLfloat by[] = { n[1] * bx[2] - n[2] * bx[1], n[2] * bx[0] - n[0] * bx[2], n[0] * bx[1] - n[1] * bx[0] };
+				for (int i = 0; i < 3; ++i) d[i] = sr * (std::cos(a) * bx[i] + std::sin(a) * by[i]) + sz * n[i];
+			}
+
+			//ʒa֐Ɏˉe
+			GLfloat y[Coefficients];
+			basis(direction, y);
+			for (int c = 0; c < Coefficients; ++c) {
+				for (int i = 0; i < 3; ++i) coefficient[c * 3 + i] += radiance[i] * y[c];
+			}
+		}
+
+		//ʂ̖ʐςŏdݕtA]ŏݍŕˏƓx/΂̌Wɂ
+		static constexpr GLfloat band[Coefficients] = { 1.0f, 2.0f / 3.0f, 2.0f / 3.0f, 2.0f / 3.0f, 0.25f, 0.25f, 0.25f, 0.25f, 0.25f };
+		const GLfloat weight(12.566371f / static_cast<GLfloat>(settings.samples));
+		for (int c = 0; c < Coefficients; ++c) {
+			for (int i = 0; i < 3; ++i) coefficient[c * 3 + i] *= weight * band[c];
+		}
+		return inside * 2 < settings.samples;
+	}
+
+public:
+	//RXgN^
+	ProbeBaker() :dirty(false), stats() {}
+
+	//2܂ł̎̋ʒa֐̒l߂iVF[_[Ɠj
+	//d:PʃxNg
+	//y:Coefficients̒l̏ݐ
+	static void basis(const GLfloat* d, GLfloat* y) {
+		y[0] = 0.282095f;
+		y[1] = 0.488603f * d[1];
+		y[2] = 0.488603f * d[2];
+		y[3] = 0.488603f * d[0];
+		y[4] = 1.092548f * d[0] * d[1];
+		y[5] = 1.092548f * d[1] * d[2];
+		y[6] = 0.315392f * (3.0f * d[2] * d[2] - 1.0f);
+		y[7] = 1.092548f * d[0] * d[2];
+		y[8] = 0.546274f * (d[0] * d[0] - d[1] * d[1]);
+	}
+
+	//}`ǉ
+	//model:fϊs
+	//vertex, index, count:}`̒_AOp`̃CfbNXƂ̐
+	//albedo:˗iRGBj
+	void add(const Matrix& model, const Object::Vertex* vertex, const GLuint* index, GLsizei count, const GLfloat* albedo) {
+		GLfloat normalMatrix[9];
+		model.getNormalMatrix(normalMatrix);
+		triangles.reserve(triangles.size() + count / 3);
+		for (GLsizei i = 0; i + 2 < count; i += 3) {
+			GLfloat p[3][3], normal[3] = {};
+			for (int k = 0; k < 3; ++k) {
+				const Object::Vertex& v(vertex[index[i + k]]);
+				const Vector w(model * Vector{ v.position[0], v.position[1], v.position[2], 1.0f });
+				for (int j = 0; j < 3; ++j) {
+					p[k][j] = w[j];
+					normal[j] += normalMatrix[j] * v.normal[0] + normalMatrix[3 + j] * v.normal[1] + normalMatrix[6 + j] * v.normal[2];
+				}
+			}
+			const GLfloat length(std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]));
+			if (length == 0.0f) continue;
+			Triangle t;
+			for (int j = 0; j < 3; ++j) {
+				t.p0[j] = p[0][j];
+				t.e1[j] = p[1][j] - p[0][j];
+				t.e2[j] = p[2][j] - p[0][j];
+				t.normal[j] = normal[j] / length;
+				t.albedo[j] = albedo[j];
+			}
+			triangles.push_back(t);
+		}
+		dirty = true;
+	}
+
+	//ǉ}`
+	void clear() {
+		triangles.clear();
+		nodes.clear();
+		packets.clear();
+		dirty = false;
+	}
+
+	//BVHibakeKvȂĂԁj
+	void build() {
+		const auto t0(std::chrono::high_resolution_clock::now());
+		nodes.clear();
+		packets.clear();
+		if (!triangles.empty()) {
+			//Op`͂ޔƏdS
+			std::vector<Box> boxes(triangles.size()), centers(triangles.size());
+			for (std::size_t i = 0; i < triangles.size(); ++i) {
+				const Triangle& t(triangles[i]);
+				const GLfloat p1[] = { t.p0[0] + t.e1[0], t.p0[1] + t.e1[1], t.p0[2] + t.e1[2] };
+				const GLfloat p2[] = { t.p0[0] + t.e2[0], t.p0[1] + t.e2[1], t.p0[2] + t.e2[2] };
+				boxes[i] = Box::empty();
+				boxes[i].grow(t.p0);
+				boxes[i].grow(p1);
+				boxes[i].grow(p2);
+				for (int j = 0; j < 3; ++j) centers[i].min[j] = centers[i].max[j] = (boxes[i].min[j] + boxes[i].max[j]) * 0.5f;
+			}
+			std::vector<GLuint> order(triangles.size());
+			for (std::size_t i = 0; i < order.size(); ++i) order[i] = static_cast<GLuint>(i);
+			nodes.reserve(triangles.size() / 2 + 1);
+			packets.reserve(triangles.size() / 2 + 1);
+			subdivide(boxes, centers, order, 0, order.size(), 0);
+		}
+		dirty = false;
+		stats.triangles = static_cast<unsigned int>(triangles.size());
+		stats.nodes = static_cast<unsigned int>(nodes.size());
+		stats.buildTime = Profiler::elapsed(t0);
+	}
+
+	//iqɕׂv[uĂt
+	//pool:[J[Xbh
+	//min, max:iq̗[̃v[ũ[hWn̈ʒu
+	//count:ẽv[u̐ixAyAz̏ɕׂj
+	//settings:Ăt̐ݒ
+	//coefficient:v[uƂCoefficientsRGB̌WiˏƓx/΁ji[
+	void bake(ThreadPool& pool, const GLfloat* min, const GLfloat* max, const int* count,
+		const Settings& settings, std::vector<GLfloat>& coefficient)
+	{
+		if (dirty) build();
+		const auto t0(std::chrono::high_resolution_clock::now());
+		const unsigned int probes(static_cast<unsigned int>(count[0] * count[1] * count[2]));
+		coefficient.assign(static_cast<std::size_t>(probes) * Coefficients * 3, 0.0f);
+		std::vector<char> valid(probes, 0);
+
+		//v[üʒu
+		const auto position = [&](unsigned int probe, GLfloat* p) {
+			const int c[] = { static_cast<int>(probe) % count[0], static_cast<int>(probe) / count[0] % count[1], static_cast<int>(probe) / (count[0] * count[1]) };
+			for (int i = 0; i < 3; ++i) {
+				p[i] = count[i] > 1 ? min[i] + (max[i] - min[i]) * static_cast<GLfloat>(c[i]) / static_cast<GLfloat>(count[i] - 1) : min[i];
+			}
+		};
+
+		//XbhƂɃ^CoďAs瑼̃Xbh瓐
+		Tiles tiles(pool.size(), probes);
+		std::atomic<unsigned long long> rays(0);
+		pool.parallelFor(pool.size(), [&](unsigned int, unsigned int thread) {
+			unsigned long long traced(0);
+			for (unsigned int probe; tiles.next(thread, probe);) {
+				GLfloat p[3];
+				position(probe, p);
+				valid[probe] = bakeProbe(p, settings, probe, &coefficient[static_cast<std::size_t>(probe) * Coefficients * 3], traced) ? 1 : 0;
+			}
+			rays.fetch_add(traced);
+		});
+
+		//}`̒ɂv[uׂ̗͗Lȃv[u̕ςŖ߂i߂̂̉Ɏgj
+		stats.invalid = 0;
+		for (bool changed(true); changed;) {
+			changed = false;
+			for (unsigned int probe = 0; probe < probes; ++probe) {
+				if (valid[probe] != 0) continue;
+				const int c[] = { static_cast<int>(probe) % count[0], static_cast<int>(probe) / count[0] % count[1], static_cast<int>(probe) / (count[0] * count[1]) };
+				GLfloat sum[Coefficients * 3] = {};
+				int n(0);
+				for (int axis = 0; axis < 3; ++axis) {
+					for (int step = -1; step <= 1; step += 2) {
+						int d[] = { c[0], c[1], c[2] };
+						d[axis] += step;
+						if (d[axis] < 0 || d[axis] >= count[axis]) continue;
+						const std::size_t neighbor(static_cast<std::size_t>(d[0] + count[0] * (d[1] + count[1] * d[2])));
+						if (valid[neighbor] != 1) continue;
+						for (int i = 0; i < Coefficients * 3; ++i) sum[i] += coefficient[neighbor * Coefficients * 3 + i];
+						++n;
+					}
+				}
+				if (n == 0) continue;
+				for (int i = 0; i < Coefficients * 3; ++i) coefficient[static_cast<std::size_t>(probe) * Coefficients * 3 + i] = sum[i] / n;
+				valid[probe] = 2;
+				++stats.invalid;
+				changed = true;
+			}
+			for (char& v : valid) if (v == 2) v = 1;
+		}
+
+		stats.rays = rays.load();
+		stats.steals = tiles.getSteals();
+		stats.bakeTime = Profiler::elapsed(t0);
+	}
+
+	//Ɛ}`̌𒲂ׂ
+	//origin, direction:̎n_ƕ
+	//t:߂TA_܂ł̋ɏ
+	//߂l:Op`̔ԍiȂ-1j
+	int intersect(const GLfloat* origin, const GLfloat* direction, GLfloat& t) {
+		if (dirty) build();
+		return trace(origin, direction, t, false);
+	}
+
+	//Op`̐
+	std::size_t size() const { return triangles.size(); }
+
+	//vo
+	const Stats& getStats() const { return stats; }
+};
@@ -0,0 +1,129 @@
+#pragma once
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+
+//t[Ƃ̌vl̏Wv
+//JE^͋Nɓo^ĂAt[add/setŒlendFrameŒ߂
+//interval t[Ƃɕςƍőo͂
+class Profiler {
+	//JE^
+	struct Counter {
+		//O
+		std::string name;
+
+		//݂̃t[̒l
+		double value;
+
+		//Õt[̒liendFrameŒ߂lj
+		double last;
+
+		//Wṽt[̍v
+		double sum;
+
+		//Wṽt[̍ő
+		double max;
+	};
+
+	//o^ꂽJE^
+	std::vector<Counter> counters;
+
+	//Wṽt[
+	unsigned int frames;
+
+	//o͂Ԋũt[i0Ȃo͂Ȃj
+	unsigned int interval;
+
+	//o͐
+	std::ostream& out;
+
+public:
+	//RXgN^
+	//interval:o͂Ԋũt[
+	//out:o͐
+	Profiler(unsigned int interval = 300, std::ostream& out = std::cerr)
+		:frames(0), interval(interval), out(out) {}
+
+	//JE^o^Ă̔ԍԂiO΂̔ԍԂj
+	//name:JE^̖O
+	unsigned int counter(const char* name) {
+		for (std::size_t i = 0; i < counters.size(); ++i) {
+			if (counters[i].name == name) return static_cast<unsigned int>(i);
+		}
+		counters.push_back(Counter{ name, 0.0, 0.0, 0.0, 0.0 });
+		return static_cast<unsigned int>(counters.size() - 1);
+	}
+
+	//݂̃t[̒lɉ
+	void add(unsigned int id, double v) { counters[id].value += v; }
+
+	//݂̃t[̒lݒ肷
+	void set(unsigned int id, double v) { counters[id].value = v; }
+
+	//݂̃t[̒lo
+	double get(unsigned int id) const { return counters[id].value; }
+
+	//Õt[̒loit[̓rŕ\ƂɎgj
+	double last(unsigned int id) const { return counters[id].last; }
+
+	//߂̏WvԂ̕ςo
+	double average(unsigned int id) const { return frames > 0 ? counters[id].sum / frames : 0.0; }
+
+	//t[߂
+	void endFrame() {
+		for (auto& c : counters) {
+			c.sum += c.value;
+			c.max = std::max(c.max, c.value);
+			c.last = c.value;
+			c.value = 0.0;
+		}
+		if (++frames == interval) {
+			report(out);
+			reset();
+		}
+	}
+
+	//Wv蒼
+	void reset() {
+		for (auto& c : counters) c.sum = c.max = 0.0;
+		frames = 0;
+	}
+
+	//Wṽt[̕ςƍőo͂
+	void report(std::ostream& os) const {
+		if (frames == 0) return;
+		os << "--- " << frames << " frames ---" << std::endl;
+		for (const auto& c : counters) {
+			os << std::setw(32) << std::left << c.name << std::right
+				<< " avg " << std::setw(10) << std::fixed << std::setprecision(3) << c.sum / frames
+				<< " max " << std::setw(10) << c.max << std::endl;
+		}
+		os.unsetf(std::ios::floatfield);
+	}
+
+	//XR[v̌oߎԂ~bŃJE^ɉ
+	class Timer {
+		//JE^
+		Profiler& profiler;
+		const unsigned int id;
+
+		//Jn
+		const std::chrono::high_resolution_clock::time_point t0;
+
+	public:
+		//RXgN^
+		Timer(Profiler& profiler, unsigned int id)
+			:profiler(profiler), id(id), t0(std::chrono::high_resolution_clock::now()) {}
+
+		//fXgN^
+		~Timer() { profiler.add(id, elapsed(t0)); }
+	};
+
+	//t0̌oߎԂ~bŋ߂
+	static double elapsed(std::chrono::high_resolution_clock::time_point t0) {
+		return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - t0).count();
+	}
+};
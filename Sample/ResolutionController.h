@@ -0,0 +1,175 @@
+#pragma once
+#include <cmath>
+#include <algorithm>
+
+//I𑜓x̔{߂鐧
+//vt[̎ԂƖڕW̎Ԃ̍PIDŕ`悷ʐς𑝌A̕c̔{ɂ
+//{step݂̍Ɋۂ߁A݂𒴂ēƂςiqXeVXjAςƂcooldowñt[lq
+//ڕW̎Ԃ̋߂̕sтł͐䂹Aグ{ŖڕW𒴂ȂグȂ̂ŁA{݂ɗhȂ
+//OpenGLgȂ̂ŁAԂ^ĐU镑m߂
+class ResolutionController {
+public:
+	//̐ݒ
+	struct Settings {
+		//t[̎Ԃ̗\Zi~bj
+		double budget;
+
+		//\ẐڕWɂ銄i]Tcj
+		double headroom;
+
+		//{̉Ə
+		float minScale, maxScale;
+
+		//{̍
+		float step;
+
+		//AϕÃQC
+		double kp, ki, kd;
+
+		//{グƂɃQCɊ|Wî͑Aグ̂͂j
+		double raise;
+
+		//ڕWƂ̍̊菬ΐ䂵Ȃ
+		double deadband;
+
+		//vԂ𕽊銄i1Ȃ畽Ȃj
+		double smoothing;
+
+		//{ςƂŐ~߂t[iςʂvɌ܂ő҂j
+		unsigned int cooldown;
+	};
+
+	//v
+	struct Stats {
+		//݂̔{
+		float scale;
+
+		//t[̎ԁi~bj
+		double frameTime;
+
+		//ڕWƂ̍i\Zɑ΂銄AȂ]Tj
+		double error;
+
+		//updateĂ񂾉
+		unsigned long long frames;
+
+		//\Z𒴂t[̐
+		unsigned long long misses;
+
+		//{ς
+		unsigned long long changes;
+	};
+
+	//̐ݒ
+	//budget:t[̎Ԃ̗\Zi~bj
+	static Settings defaults(double budget) {
+		return Settings{ budget, 0.9, 0.5f, 1.0f, 0.05f, 0.6, 0.1, 0.2, 0.25, 0.05, 0.5, 4 };
+	}
+
+private:
+	//ݒ
+	Settings settings;
+
+	//`悷ʐς̊i{2Aۂ߂Oj
+	double area;
+
+	//덷̐ϕƑǑ덷
+	double integral, previous;
+
+	//{ςĂlqt[̎c
+	unsigned int hold;
+
+	//v
+	Stats stats;
+
+	//{݂Ɋۂ߂Ĕ͈͂Ɏ߂
+	float quantize(double scale) const {
+		const double s(settings.step > 0.0f ? std::floor(scale / settings.step + 0.5) * settings.step : scale);
+		return static_cast<float>(std::min(std::max(s, static_cast<double>(settings.minScale)), static_cast<double>(settings.maxScale)));
+	}
+
+public:
+	//RXgN^
+	//settings:̐ݒ
+	explicit ResolutionController(const Settings& settings) :settings(settings) {
+		reset();
+	}
+
+	//{ɖ߂ēv
+	void reset() {
+		area = static_cast<double>(settings.maxScale) * settings.maxScale;
+		integral = previous = 0.0;
+		hold = 0;
+		stats = Stats{ settings.maxScale, 0.0, 0.0, 0, 0, 0 };
+	}
+
+	//t[̎Ԃ^Ĕ{XV
+	//cpuTime:CPŨt[̎ԁi~bj
+	//gpuTime:GPU̕`̎ԁi~bAvłȂ0j
+	//߂l:̃t[Ɏg{
+	float update(double cpuTime, double gpuTime) {
+		//\Z𒴂ǂ͒xŐAɂ͉𑜓xŕςGPU̎ԂgiȂCPU̎ԁj
+		++stats.frames;
+		if (std::max(cpuTime, gpuTime) > settings.budget) ++stats.misses;
+		const double time(gpuTime > 0.0 ? gpuTime : cpuTime);
+		stats.frameTime = stats.frames == 1 ? time : stats.frameTime + (time - stats.frameTime) * settings.smoothing;
+
+		//{ς͑O̔{̌vcĂ̂ő҂
+		if (hold > 0) {
+			--hold;
+			return stats.scale;
+		}
+
+		//ڕWƂ̍\Zɑ΂銄ŋ߁Asт̒Ȃ牽Ȃ
+		const double target(settings.budget * settings.headroom);
+		const double error((target - stats.frameTime) / settings.budget);
+		stats.error = error;
+		if (std::fabs(error) < settings.deadband) {
+			previous = error;
+			return stats.scale;
+		}
+
+		//PIDŖʐς𑝌iグƂ̓QCj
+		//ʐς͈͂̒[ɒtēɌ덷Ƃ͐ϕȂ
+		const double gain(error > 0.0 ? settings.raise : 1.0);
+		const double minArea(static_cast<double>(settings.minScale) * settings.minScale);
+		const double maxArea(static_cast<double>(settings.maxScale) * settings.maxScale);
+		const bool saturated((area >= maxArea && error > 0.0) || (area <= minArea && error < 0.0));
+		if (!saturated) integral = std::min(std::max(integral + error, -1.0), 1.0);
+		const double output(gain * (settings.kp * error + settings.ki * integral + settings.kd * (error - previous)));
+		previous = error;
+		area = std::min(std::max(area * std::max(1.0 + output, 0.25), minArea), maxArea);
+
+		//݂𒴂ēƂ{ς
+		const double scale(std::sqrt(area));
+		if (std::fabs(scale - stats.scale) >= settings.step * 0.999f || (scale <= settings.minScale && stats.scale > settings.minScale)
+			|| (scale >= settings.maxScale && stats.scale < settings.maxScale))
+		{
+			//グƂ͎ԂʐςɔႷƂďグ{łڕWɎ܂ƂグA
+			//܂ȂΖʐς̔{ɖ߂ďグJԂȂ悤ɂ
+			const float next(quantize(scale));
+			if (next > stats.scale && stats.frameTime * next * next > target * stats.scale * stats.scale) {
+				area = static_cast<double>(stats.scale) * stats.scale;
+			}
+			else if (next != stats.scale) {
+				stats.scale = next;
+				++stats.changes;
+				hold = settings.cooldown;
+			}
+		}
+		return stats.scale;
+	}
+
+	//݂̔{
+	float getScale() const { return stats.scale; }
+
+	//ݒ
+	const Settings& getSettings() const { return settings; }
+
+	//\Zς
+	//budget:t[̎Ԃ̗\Zi~bj
+	void setBudget(double budget) { settings.budget = budget; }
+
+	//vo
+	const Stats& getStats() const { return stats; }
+};
@@ -0,0 +1,115 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <utility>
+#include <cstddef>
+
+//nhŎQƂ鎑̃v[
+//vfstd::vectorɋl߂Ċi[A폜ʒu͎̍쐬Ŏg
+//폜Ɛオiނ̂ŁAÂnh͖ɂȂ
+//reserve͈̔͂Ȃ쐬ƍ폜Ńq[v̊mۂ͋NȂ
+template<typename T>
+class ResourcePool {
+public:
+	//nhil͖j
+	struct Handle {
+		//vf̈ʒu
+		std::uint32_t index;
+
+		//쐬Ƃ̐iȂ琶Ăvfj
+		std::uint32_t generation;
+
+		Handle() :index(0), generation(0) {}
+		Handle(std::uint32_t index, std::uint32_t generation) :index(index), generation(generation) {}
+
+		bool operator==(const Handle& h) const { return index == h.index && generation == h.generation; }
+		bool operator!=(const Handle& h) const { return !(*this == h); }
+	};
+
+private:
+	//vf
+	std::vector<T> items;
+
+	//vfƂ̐iȂgpAȂ󂫁j
+	std::vector<std::uint32_t> generations;
+
+	//󂢂Ăʒu
+	std::vector<std::uint32_t> freeList;
+
+	//gp̗vf̐
+	std::size_t count;
+
+public:
+	//RXgN^
+	//capacity:炩ߊmۂĂvf̐
+	explicit ResourcePool(std::size_t capacity = 0) :count(0) {
+		reserve(capacity);
+	}
+
+	//vf̐̕mۂĂ
+	void reserve(std::size_t capacity) {
+		items.reserve(capacity);
+		generations.reserve(capacity);
+		freeList.reserve(capacity);
+	}
+
+	//vf쐬
+	//args:vf̃RXgN^̈
+	template<typename... Args>
+	Handle create(Args&&... args) {
+		std::uint32_t index;
+		if (freeList.empty()) {
+			index = static_cast<std::uint32_t>(items.size());
+			items.emplace_back(std::forward<Args>(args)...);
+			generations.push_back(0);
+		}
+		else {
+			index = freeList.back();
+			freeList.pop_back();
+			items[index] = T(std::forward<Args>(args)...);
+		}
+		++count;
+		return Handle(index, ++generations[index]);
+	}
+
+	//vf폜iȃnhȂ牽Ȃj
+	void destroy(Handle handle) {
+		if (!valid(handle)) return;
+
+		//lĎ
+		items[handle.index] = T();
+		++generations[handle.index];
+		freeList.push_back(handle.index);
+		--count;
+	}
+
+	//nhĂvfwĂtrue
+	bool valid(Handle handle) const {
+		return handle.index < generations.size() && generations[handle.index] == handle.generation
+			&& (handle.generation & 1) != 0;
+	}
+
+	//vfoiȃnhȂNULLj
+	T* get(Handle handle) {
+		return valid(handle) ? &items[handle.index] : NULL;
+	}
+	const T* get(Handle handle) const {
+		return valid(handle) ? &items[handle.index] : NULL;
+	}
+
+	//vfoinh͗LłȂ΂ȂȂj
+	T& operator[](Handle handle) { return items[handle.index]; }
+	const T& operator[](Handle handle) const { return items[handle.index]; }
+
+	//gp̗vfɂď
+	//f:f(handle, item)̌`ŌĂяo
+	template<typename F>
+	void forEach(F f) {
+		for (std::uint32_t i = 0; i < items.size(); ++i) {
+			if (generations[i] & 1) f(Handle(i, generations[i]), items[i]);
+		}
+	}
+
+	//gp̗vf̐
+	std::size_t size() const { return count; }
+};
@@ -0,0 +1,318 @@
+#pragma once
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <atomic>
+#include <chrono>
+#include <GL/glew.h>
+
+//ϊs
+#include "Matrix.h"
+
+//[J[Xbh
+#include "ThreadPool.h"
+
+//v
+#include "Profiler.h"
+
+//ϊ̊Kw
+//ߓ_̃[Jϊsƃ[hϊsA@ϊs[D̏ɕׂziSoAjɊi[
+//؂͔z̘A͈͂ɂȂAe͕KqOɂ
+//[Jϊsςߓ_Ƃ̕؂updateŌvZ
+//傫ȕ؂̓[J[XbhŕS
+class SceneGraph {
+public:
+	//ߓ_̃nhiǉĂςȂj
+	typedef std::uint32_t Node;
+
+	//êȂߓ_̐e
+	static constexpr Node None = 0xffffffffu;
+
+	//v
+	struct Stats {
+		//ߓ_̐
+		unsigned int nodes;
+
+		//ŌupdateŌvZߓ_̐
+		unsigned int updated;
+
+		//ŌupdateŕS؂̐
+		unsigned int tasks;
+
+		//Ōupdateɂԁi~bj
+		double updateTime;
+	};
+
+private:
+	//@ϊs
+	struct NormalMatrix {
+		GLfloat m[9];
+	};
+
+	//ߓ_̏
+	enum Flag : std::uint8_t {
+		//[Jϊs񂪕ς
+		Dirty = 1,
+
+		//qDirty̐ߓ_
+		DirtyDescendant = 2
+	};
+
+	//[J[S镔؂͈̔
+	struct Task {
+		std::uint32_t begin, end;
+	};
+
+	//牺͔z̈ʒui[D̏jŎQƂ
+	//[Jϊs
+	std::vector<Matrix> local;
+
+	//[hϊs
+	std::vector<Matrix> world;
+
+	//@ϊs
+	std::vector<NormalMatrix> normal;
+
+	//ëʒuieȂNonej
+	std::vector<std::uint32_t> parent;
+
+	//܂ޕ؂̐ߓ_̐
+	std::vector<std::uint32_t> size;
+
+	//ߓ_̏
+	std::vector<std::uint8_t> flags;
+
+	//[hϊsvZupdate̔ԍ
+	std::vector<std::uint32_t> stamp;
+
+	//ʒuɂߓ_̃nh
+	std::vector<Node> ids;
+
+	//nhʒu\
+	std::vector<std::uint32_t> positions;
+
+	//[J[Xbh
+	ThreadPool& pool;
+
+	//[J[ɕɐɌvZ傫ȕ؂̍̈ʒu
+	std::vector<std::uint32_t> serial;
+
+	//[J[S镔؂͈̔
+	std::vector<Task> tasks;
+
+	//ߓ_ǉĂ番S蒼ĂȂtrue
+	bool structureChanged;
+
+	//update̔ԍ
+	std::uint32_t frame;
+
+	//v
+	Stats stats;
+
+	//cDirtyDescendantt
+	//i:ߓ_̈ʒu
+	void markAncestors(std::uint32_t i) {
+		for (std::uint32_t p = parent[i]; p != None && !(flags[p] & DirtyDescendant); p = parent[p]) {
+			flags[p] |= DirtyDescendant;
+		}
+	}
+
+	//ߓ_̃[hϊsƖ@ϊsvZ
+	void compute(std::uint32_t i) {
+		const std::uint32_t p(parent[i]);
+		world[i] = p == None ? local[i] : world[p] * local[i];
+		world[i].getNormalMatrix(normal[i].m);
+		stamp[i] = frame;
+		flags[i] = 0;
+	}
+
+	//͈͂̐ߓ_KvȂ̂vZ
+	//begin, end:͈́i؂ׂ́j
+	//߂l:vZߓ_̐
+	unsigned int updateRange(std::uint32_t begin, std::uint32_t end) {
+		unsigned int updated(0);
+		for (std::uint32_t i = begin; i < end;) {
+			const std::uint32_t p(parent[i]);
+			if ((flags[i] & Dirty) || (p != None && stamp[p] == frame)) {
+				//eςĂΌvZ
+				compute(i);
+				++updated;
+				++i;
+			}
+			else if (flags[i] & DirtyDescendant) {
+				//qɕς̂΍~Ă
+				flags[i] = 0;
+				++i;
+			}
+			else {
+				//ςĂȂ؂͔΂
+				i += size[i];
+			}
+		}
+		return updated;
+	}
+
+	//[J[̕S蒼
+	void partition() {
+		serial.clear();
+		tasks.clear();
+
+		//[J[̐ߓ_̖̐ڈ
+		const std::uint32_t count(static_cast<std::uint32_t>(parent.size()));
+		const std::uint32_t grain(std::max<std::uint32_t>(1024, count / (pool.size() * 4)));
+
+		for (std::uint32_t i = 0; i < count;) {
+			if (size[i] <= grain) {
+				//ȕ؂ׂ͈͗̔͂ƂȂĈ̕Sɂ
+				if (!tasks.empty() && tasks.back().end == i && tasks.back().end - tasks.back().begin + size[i] <= grain) {
+					tasks.back().end += size[i];
+				}
+				else {
+					tasks.push_back(Task{ i, i + size[i] });
+				}
+				i += size[i];
+			}
+			else {
+				//傫ȕ؂̍͐ɌvZĎq̕؂𕪒S
+				serial.push_back(i);
+				++i;
+			}
+		}
+		structureChanged = false;
+	}
+
+	//Rs[֎~
+	SceneGraph(const SceneGraph&) = delete;
+	SceneGraph& operator=(const SceneGraph&) = delete;
+
+public:
+	//RXgN^
+	//pool:؂̌vZ𕪒S郏[J[Xbh
+	explicit SceneGraph(ThreadPool& pool)
+		:pool(pool), structureChanged(false), frame(0), stats() {
+	}
+
+	//fXgN^
+	virtual ~SceneGraph() {}
+
+	//ߓ_̐̕mۂĂ
+	void reserve(std::size_t count) {
+		local.reserve(count);
+		world.reserve(count);
+		normal.reserve(count);
+		parent.reserve(count);
+		size.reserve(count);
+		flags.reserve(count);
+		stamp.reserve(count);
+		ids.reserve(count);
+		positions.reserve(count);
+	}
+
+	//ߓ_ǉ
+	//e̕؂̍Ōɑ}̂ŁA[D̏ɒǉΔz̖ɒǉ邾ōς
+	//parentNode:e̐ߓ_iNoneȂ獪j
+	//m:[Jϊs
+	//߂l:ǉߓ_
+	Node addNode(Node parentNode, const Matrix& m) {
+		const std::uint32_t p(parentNode == None ? static_cast<std::uint32_t>(None) : positions[parentNode]);
+		const std::uint32_t i(p == None ? static_cast<std::uint32_t>(parent.size()) : p + size[p]);
+		const Node node(static_cast<Node>(positions.size()));
+
+		//}ʒu̐ߓ_炷iɒǉƂ͂炳Ȃj
+		const bool append(i == parent.size());
+		if (!append) {
+			for (auto& q : parent) {
+				if (q != None && q >= i) ++q;
+			}
+		}
+		local.insert(local.begin() + i, m);
+		world.insert(world.begin() + i, m);
+		normal.insert(normal.begin() + i, NormalMatrix());
+		parent.insert(parent.begin() + i, p);
+		size.insert(size.begin() + i, 1);
+		flags.insert(flags.begin() + i, Dirty);
+		stamp.insert(stamp.begin() + i, 0);
+		ids.insert(ids.begin() + i, node);
+		positions.push_back(i);
+		if (!append) {
+			for (std::uint32_t j = i + 1; j < ids.size(); ++j) positions[ids[j]] = j;
+		}
+
+		//c̕؂傫
+		for (std::uint32_t q = p; q != None; q = parent[q]) ++size[q];
+		markAncestors(i);
+		structureChanged = true;
+		return node;
+	}
+
+	//[Jϊsݒ肷
+	//node:ߓ_
+	//m:[Jϊs
+	void setLocal(Node node, const Matrix& m) {
+		const std::uint32_t i(positions[node]);
+		local[i] = m;
+		if (!(flags[i] & Dirty)) {
+			flags[i] |= Dirty;
+			markAncestors(i);
+		}
+	}
+
+	//e̐ߓ_iȂNonej
+	Node getParent(Node node) const {
+		const std::uint32_t p(parent[positions[node]]);
+		return p == None ? p : ids[p];
+	}
+
+	//[Jϊs
+	const Matrix& getLocal(Node node) const { return local[positions[node]]; }
+
+	//[hϊsiupdatěŗLj
+	const Matrix& getWorld(Node node) const { return world[positions[node]]; }
+
+	//@ϊsiupdatěŗLj
+	const GLfloat* getNormalMatrix(Node node) const { return normal[positions[node]].m; }
+
+	//ςߓ_Ƃ̕؂̃[hϊsƖ@ϊsvZ
+	void update() {
+		const auto t0(std::chrono::high_resolution_clock::now());
+		if (structureChanged) partition();
+		++frame;
+
+		//傫ȕ؂̍[D̏ɌvZ
+		unsigned int updated(0);
+		for (const std::uint32_t i : serial) {
+			const std::uint32_t p(parent[i]);
+			if ((flags[i] & Dirty) || (p != None && stamp[p] == frame)) {
+				compute(i);
+				++updated;
+			}
+			else {
+				flags[i] &= ~DirtyDescendant;
+			}
+		}
+
+		//c̕؂𕪒SČvZ
+		if (tasks.size() == 1) {
+			updated += updateRange(tasks[0].begin, tasks[0].end);
+		}
+		else if (!tasks.empty()) {
+			std::atomic<unsigned int> count(0);
+			pool.parallelFor(static_cast<unsigned int>(tasks.size()), [&](unsigned int t, unsigned int) {
+				const unsigned int n(updateRange(tasks[t].begin, tasks[t].end));
+				if (n > 0) count.fetch_add(n, std::memory_order_relaxed);
+			});
+			updated += count.load();
+		}
+
+		stats.nodes = static_cast<unsigned int>(parent.size());
+		stats.updated = updated;
+		stats.tasks = static_cast<unsigned int>(tasks.size());
+		stats.updateTime = Profiler::elapsed(t0);
+	}
+
+	//ߓ_̐
+	std::size_t getSize() const { return parent.size(); }
+
+	//vo
+	const Stats& getStats() const { return stats; }
+};
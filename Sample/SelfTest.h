@@ -0,0 +1,366 @@
+#pragma once
+#include <iostream>
+#include <cstring>
+#include <cstdint>
+#include <vector>
+#include <algorithm>
+
+//͈͂̊蓖
+#include "BufferAllocator.h"
+
+//I𑜓x̔{̐
+#include "ResolutionController.h"
+
+//OpenGLgȂ̎Ȑff
+//N --test [O] w肷ƃEBhEOɎsAs0ȊOŏI
+class SelfTest {
+	//m߂ʂ𐔂
+	class Checks {
+		//ʂ̏o͐
+		std::ostream& out;
+
+		//m߂Ǝs̐
+		unsigned int count, failures;
+
+	public:
+		//RXgN^
+		//out:ʂ̏o͐
+		explicit Checks(std::ostream& out) :out(out), count(0), failures(0) {}
+
+		//m߂
+		//condition:藧ׂ
+		//what:m߂eisƂɏo͂j
+		//߂l:condition
+		bool operator()(bool condition, const char* what) {
+			++count;
+			if (!condition) {
+				++failures;
+				out << "Error: " << what << std::endl;
+			}
+			return condition;
+		}
+
+		//ʂo͂
+		//߂l:sȂtrue
+		bool report() const {
+			out << count - failures << " / " << count << " checks passed" << std::endl;
+			return failures == 0;
+		}
+	};
+
+	//ff̊֐
+	typedef bool (*Function)(std::ostream& out);
+
+	//o^ꂽff
+	struct Entry {
+		//O
+		const char* name;
+
+		//ff̊֐
+		Function function;
+	};
+
+	//蓖Ă͈͂dȂ炸AEɂ낢AŜɎ܂Ătrue
+	//ranges:ʒuƑ傫ƋȆg
+	static bool disjoint(std::vector<std::size_t> ranges, std::size_t capacity) {
+		std::vector<std::pair<std::size_t, std::size_t>> sorted;
+		for (std::size_t i = 0; i + 2 < ranges.size(); i += 3) {
+			if (ranges[i] % ranges[i + 2] != 0) return false;
+			sorted.emplace_back(ranges[i], ranges[i + 1]);
+		}
+		std::sort(sorted.begin(), sorted.end());
+		for (std::size_t i = 0; i < sorted.size(); ++i) {
+			if (sorted[i].first + sorted[i].second > capacity) return false;
+			if (i > 0 && sorted[i - 1].first + sorted[i - 1].second > sorted[i].first) return false;
+		}
+		return true;
+	}
+
+	//͈͂̊蓖Ă̋EAƌAeʂ̕sAlߒm߂
+	static bool allocator(std::ostream& out) {
+		Checks check(out);
+
+		//Eɂ낦Ċ蓖āA傫͍ŏPʂɐ؂グ
+		{
+			BufferAllocator a(4096, 4);
+			static const std::size_t sizes[] = { 3, 100, 17, 256, 1 }, alignments[] = { 1, 16, 64, 256, 8 };
+			std::vector<std::size_t> ranges;
+			for (int i = 0; i < 5; ++i) {
+				const BufferAllocator::Handle h(a.allocate(sizes[i], alignments[i]));
+				if (!check(h != BufferAllocator::Invalid, "allocator: aligned allocation failed")) continue;
+				check(a.size(h) >= sizes[i] && a.size(h) % 4 == 0, "allocator: size is not rounded up to the granularity");
+				ranges.insert(ranges.end(), { a.offset(h), a.size(h), std::max<std::size_t>(alignments[i], 4) });
+			}
+			check(disjoint(ranges, 4096), "allocator: aligned ranges overlap or are misaligned");
+		}
+
+		//蓖Ăƌ̗]肪󂫗̈ƂĎcAƑŐ󂫗̈ƂȂ
+		{
+			BufferAllocator a(1024);
+			const BufferAllocator::Handle h0(a.allocate(100)), h1(a.allocate(200)), h2(a.allocate(300));
+			check(a.offset(h0) == 0 && a.offset(h1) == 100 && a.offset(h2) == 300, "allocator: ranges are not split from the front");
+			BufferAllocator::Stats stats(a.getStats());
+			check(stats.used == 600 && stats.allocations == 3, "allocator: used size is wrong after splitting");
+			check(stats.freeBlocks == 1 && stats.largestFree == 424, "allocator: tail is not kept as one free block");
+			a.free(h0);
+			a.free(h2);
+			stats = a.getStats();
+			check(stats.freeBlocks == 2 && stats.largestFree == 724, "allocator: freed range is not merged with the following free block");
+			a.free(h1);
+			stats = a.getStats();
+			check(stats.freeBlocks == 1 && stats.largestFree == 1024 && stats.used == 0, "allocator: freed ranges are not merged into one block");
+			a.free(h1);
+			check(a.getStats().allocations == 0, "allocator: double free changed the statistics");
+		}
+
+		//eʂ𒴂銄蓖Ă͎sAƍĂъ蓖Ă
+		{
+			BufferAllocator a(1000);
+			check(a.allocate(1001) == BufferAllocator::Invalid, "allocator: allocation larger than the capacity succeeded");
+			const BufferAllocator::Handle h(a.allocate(1000));
+			check(h != BufferAllocator::Invalid, "allocator: allocation of the whole capacity failed");
+			check(a.allocate(1) == BufferAllocator::Invalid, "allocator: allocation succeeded in a full allocator");
+			a.free(h);
+			check(a.allocate(1000) != BufferAllocator::Invalid, "allocator: allocation failed after freeing");
+
+			//󂫂̍v͑ĂfЉĂΑ傫Ȋ蓖Ă͎s
+			BufferAllocator b(400);
+			BufferAllocator::Handle hs[4];
+			for (auto& x : hs) x = b.allocate(100);
+			b.free(hs[0]);
+			b.free(hs[2]);
+			check(b.allocate(200) == BufferAllocator::Invalid, "allocator: allocation succeeded across fragmented free blocks");
+			check(b.allocate(100) != BufferAllocator::Invalid, "allocator: allocation failed in a free block of exactly the requested size");
+		}
+
+		//lߒƐĂ͈͂̒gƋEۂA󂫗̈悪ɂ܂Ƃ܂
+		{
+			static constexpr std::size_t capacity(1 << 16);
+			BufferAllocator a(capacity, 4);
+			std::vector<unsigned char> memory(capacity, 0);
+			std::vector<BufferAllocator::Handle> handles;
+			std::vector<std::size_t> alignments;
+			std::uint32_t seed(12345);
+			for (int i = 0; i < 200; ++i) {
+				seed = seed * 1664525u + 1013904223u;
+				const std::size_t size(1 + (seed >> 8) % 300), alignment(std::size_t(4) << ((seed >> 20) % 5));
+				const BufferAllocator::Handle h(a.allocate(size, alignment));
+				if (h == BufferAllocator::Invalid) break;
+				std::fill(memory.begin() + a.offset(h), memory.begin() + a.offset(h) + a.size(h), static_cast<unsigned char>(h * 7 + 1));
+				handles.push_back(h);
+				alignments.push_back(alignment);
+			}
+			check(handles.size() == 200, "allocator: allocations for compaction failed");
+
+			//ČJ
+			std::vector<BufferAllocator::Handle> live;
+			std::vector<std::size_t> liveAlignments;
+			for (std::size_t i = 0; i < handles.size(); ++i) {
+				if (i % 2 == 0) a.free(handles[i]);
+				else {
+					live.push_back(handles[i]);
+					liveAlignments.push_back(alignments[i]);
+				}
+			}
+			const std::size_t used(a.getUsed());
+			check(a.getStats().freeBlocks > 1, "allocator: freeing every other range left no holes");
+
+			//ړ͑O珇Ɉʒȕ֌
+			bool forward(true);
+			std::size_t last(0);
+			a.defragment([&](std::size_t from, std::size_t to, std::size_t size) {
+				if (to > from || to < last) forward = false;
+				last = to + size;
+				std::memmove(&memory[to], &memory[from], size);
+			});
+			check(forward, "allocator: compaction moved a range backwards or out of order");
+
+			//͈̖͎͂gpʂƋĚԂ̍v𒴂Ǎ͈̋󂫗̈ɂȂ
+			std::vector<std::size_t> ranges;
+			std::size_t end(0), gaps(0);
+			bool intact(true);
+			for (std::size_t i = 0; i < live.size(); ++i) {
+				const BufferAllocator::Handle h(live[i]);
+				ranges.insert(ranges.end(), { a.offset(h), a.size(h), liveAlignments[i] });
+				end = std::max(end, a.offset(h) + a.size(h));
+				gaps += liveAlignments[i] - 4;
+				for (std::size_t j = a.offset(h); j < a.offset(h) + a.size(h); ++j) {
+					if (memory[j] != static_cast<unsigned char>(h * 7 + 1)) intact = false;
+				}
+			}
+			check(intact, "allocator: compaction did not keep the contents of live ranges");
+			check(disjoint(ranges, capacity), "allocator: compacted ranges overlap or are misaligned");
+			const BufferAllocator::Stats stats(a.getStats());
+			check(stats.used == used && stats.allocations == live.size(), "allocator: compaction changed the used size");
+			check(end <= used + gaps && stats.largestFree == capacity - end, "allocator: compaction left the free space fragmented");
+
+			//lߒƂƊ蓖Ăł
+			for (const BufferAllocator::Handle h : live) a.free(h);
+			check(a.getStats().freeBlocks == 1 && a.getStats().largestFree == capacity, "allocator: free blocks are not merged after compaction");
+		}
+
+		//蓖ĂƉ𗐐ŌJԂĂ͈͂͏dȂ炸Agpʂ
+		{
+			static constexpr std::size_t capacity(1 << 20);
+			BufferAllocator a(capacity, 16);
+			std::vector<BufferAllocator::Handle> handles;
+			std::uint32_t seed(1);
+			bool consistent(true);
+			for (int i = 0; i < 20000; ++i) {
+				seed = seed * 1664525u + 1013904223u;
+				if (!handles.empty() && (seed >> 28) < 7) {
+					const std::size_t k((seed >> 4) % handles.size());
+					a.free(handles[k]);
+					handles[k] = handles.back();
+					handles.pop_back();
+				}
+				else {
+					const BufferAllocator::Handle h(a.allocate(1 + (seed >> 12) % 4096, std::size_t(16) << ((seed >> 8) % 3)));
+					if (h != BufferAllocator::Invalid) handles.push_back(h);
+				}
+				if (i % 1000 == 0) {
+					std::vector<std::size_t> ranges;
+					std::size_t sum(0);
+					for (const BufferAllocator::Handle h : handles) {
+						ranges.insert(ranges.end(), { a.offset(h), a.size(h), 16 });
+						sum += a.size(h);
+					}
+					if (!disjoint(ranges, capacity) || sum != a.getUsed()) consistent = false;
+				}
+			}
+			check(consistent, "allocator: random allocations overlap or the used size is wrong");
+		}
+
+		return check.report();
+	}
+
+	//GPU̎ԂœI𑜓x̐𓮂
+	struct Trace {
+		//\Z𒴂t[̐ƁAׂグĂԂɒt[̐
+		unsigned long long misses, spikeMisses;
+
+		//ׂグĂŌɗ\Z𒴂܂ł̃t[
+		int settle;
+
+		//ׂグĂԂɗ\ZɎ܂Ă{グ̌ς
+		int reversals;
+
+		//{ς
+		unsigned long long changes;
+
+		//ׂグĂԂ̍Ō̔{ƁAI̔{
+		float spikeScale, finalScale;
+	};
+
+	//GPU̎ԂŒ̕ƕ`ʐςɔႷ镔̘aɂĐ𓮂
+	//v2t[xē͂A}5%̗h炬
+	//load:ʐςɔႷ镔i~bA{1̂Ƃj
+	//spikeLoad:spikeBeginspikeEnd܂ł̖ʐςɔႷ镔
+	//fixed:trueȂ{1ɌŒ肷irpj
+	//cpuOnly:trueȂGPU̎Ԃ0ɂCPU̎ԂƂēni^C}[NGgȂꍇj
+	static Trace simulate(double load, double spikeLoad, bool fixed, bool cpuOnly) {
+		static constexpr double budget(1000.0 / 60.0);
+		static constexpr int frames(2400), spikeBegin(900), spikeEnd(1500), latency(2);
+		ResolutionController controller(ResolutionController::defaults(budget));
+		std::vector<double> measured(latency, 0.0);
+		std::uint32_t seed(1);
+		Trace trace{ 0, 0, 0, 0, 0, 1.0f, 1.0f };
+		float previous(controller.getScale());
+		int direction(0);
+		for (int f = 0; f < frames; ++f) {
+			const bool spike(f >= spikeBegin && f < spikeEnd);
+			const double scale(fixed ? 1.0 : controller.getScale());
+			seed = seed * 1664525u + 1013904223u;
+			const double noise(1.0 + 0.1 * (static_cast<double>(seed >> 8) / 16777216.0 - 0.5));
+			const double gpu((2.0 + (spike ? spikeLoad : load) * scale * scale) * noise);
+			if (gpu > budget && spike) {
+				++trace.spikeMisses;
+				trace.settle = f - spikeBegin;
+			}
+			measured.push_back(gpu);
+			const double late(measured[measured.size() - 1 - latency]);
+			if (cpuOnly) controller.update(std::max(late, 4.0), 0.0);
+			else controller.update(4.0, late);
+
+			//\ZɎ܂ƂŔ{グJԂĂȂ
+			const float next(controller.getScale());
+			if (next != previous) {
+				const int d(next > previous ? 1 : -1);
+				if (spike && f > spikeBegin + trace.settle && direction != 0 && d != direction) ++trace.reversals;
+				direction = d;
+				previous = next;
+			}
+			if (spike) trace.spikeScale = next;
+		}
+		trace.misses = controller.getStats().misses;
+		trace.changes = fixed ? 0 : controller.getStats().changes;
+		trace.finalScale = controller.getScale();
+		return trace;
+	}
+
+	//I𑜓x̐킪ׂ̑ɒǏ]A܂ƂŔ{hȂƂm߂
+	static bool resolution(std::ostream& out) {
+		Checks check(out);
+
+		//{Œ肷ƕׂグĂԂׂ͂ė\Z𒴂
+		const Trace fixed(simulate(11.0, 22.0, true, false));
+		check(fixed.spikeMisses == 600, "resolution: the synthetic load does not exceed the budget at full resolution");
+
+		//͐\t[ŗ\ZɎ߁Ǎ͔{グȂ
+		const Trace pid(simulate(11.0, 22.0, false, false));
+		out << "misses " << pid.misses << " (fixed " << fixed.misses << "), settle " << pid.settle << " frames, "
+			<< pid.changes << " changes, scale " << pid.spikeScale << " during the spike" << std::endl;
+		check(pid.misses <= 16, "resolution: too many frames over budget");
+		check(pid.settle <= 30, "resolution: the controller took too long to settle");
+		check(pid.reversals == 0, "resolution: the scale oscillated after settling");
+		check(pid.changes <= 10, "resolution: the scale changed too often");
+		check(pid.spikeScale < 1.0f && pid.spikeScale >= 0.5f, "resolution: the scale was not lowered under load");
+		check(pid.finalScale == 1.0f, "resolution: the scale did not return to full resolution after the load dropped");
+
+		//yׂΔ{ςȂ
+		const Trace light(simulate(8.0, 8.0, false, false));
+		check(light.changes == 0 && light.misses == 0 && light.finalScale == 1.0f, "resolution: the scale changed under a constant light load");
+
+		//{Ă܂Ȃׂł͉Ŏ~܂
+		const Trace heavy(simulate(80.0, 80.0, false, false));
+		check(heavy.finalScale == 0.5f && heavy.reversals == 0, "resolution: the scale is not clamped at the minimum under an excessive load");
+
+		//GPU̎ԂȂCPU̎ԂŐ䂷
+		const Trace cpu(simulate(11.0, 22.0, false, true));
+		check(cpu.misses <= 16 && cpu.reversals == 0 && cpu.finalScale == 1.0f, "resolution: the controller does not work from the CPU time alone");
+
+		return check.report();
+	}
+
+	//o^ꂽffo
+	static const Entry* entries(std::size_t& count) {
+		static const Entry table[] = {
+			{ "allocator", allocator },
+			{ "resolution", resolution },
+		};
+		count = sizeof table / sizeof table[0];
+		return table;
+	}
+
+public:
+	//ffs
+	//name:ff̖OiNULLȂ炷ׂāj
+	//out:ʂ̏o͐
+	//߂l:Yff肷ׂĐtrue
+	static bool run(const char* name, std::ostream& out) {
+		std::size_t count;
+		const Entry* const table(entries(count));
+		bool found(false), passed(true);
+		for (std::size_t i = 0; i < count; ++i) {
+			if (name != NULL && std::strcmp(name, table[i].name) != 0) continue;
+			out << "=== " << table[i].name << " ===" << std::endl;
+			if (!table[i].function(out)) passed = false;
+			found = true;
+		}
+		if (!found) {
+			std::cerr << "Error: Unknown test: " << name << std::endl;
+			for (std::size_t i = 0; i < count; ++i) std::cerr << "  " << table[i].name << std::endl;
+		}
+		return found && passed;
+	}
+};
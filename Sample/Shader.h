@@ -0,0 +1,192 @@
+#pragma once
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <GL/glew.h>
+
+//VF[_[IuWFNg̃RpCʂ\
+//shader:VF[_[IuWFNg
+//str:RpCG[ꏊ
+GLboolean printShaderInfoLog(GLuint shader, const char* str) {
+	//RpCʂ擾
+	GLint status;
+	//VF[_IuWFNg̏o
+	glGetShaderiv(shader, GL_COMPILE_STATUS, &status);
+	if (status == GL_FALSE)std::cerr << "Compile Error in " << str << std::endl;
+
+	//VF[_[RpC̃O̒擾
+	GLsizei bufSize;
+	glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &bufSize);
+
+	if (bufSize > 1) {
+		//VF[_[RpC̃Oe擾
+		std::vector<GLchar> infoLog(bufSize);
+		GLsizei length;
+		glGetShaderInfoLog(shader, bufSize, &length, &infoLog[0]);
+		std::cerr << &infoLog[0] << std::endl;
+	}
+	return static_cast<GLboolean>(status);
+}
+
+//vOIuWFNg̃Nʂ\
+//program:vOIuWFNg
+GLboolean printProgramInfoLog(GLuint program) {
+	//Nʂ擾
+	GLint status;
+	glGetProgramiv(program, GL_LINK_STATUS, &status);
+	if (status == GL_FALSE)std::cerr << "LinkError." << std::endl;
+
+	//VF[_[ÑO̒擾
+	GLsizei bufSize;
+	glGetProgramiv(program, GL_INFO_LOG_LENGTH, &bufSize);
+
+	if (bufSize > 1) {
+		//VF[_[ÑO̓e擾
+		std::vector<GLchar> infoLog(bufSize);
+		GLsizei length;
+		glGetProgramInfoLog(program, bufSize, &length, &infoLog[0]);
+		std::cerr << &infoLog[0] << std::endl;
+	}
+	return static_cast<GLboolean>(status);
+}
+
+
+//vOIuWFNg쐬
+//vsrc:o[ebNXVF[_[̃\[XvO̕
+//fsrc:tOgVF[_[̃\[XvO̕
+//varyings:gXtH[tB[hobNŏooutϐ̖OiNULLȂ珑oȂj
+//varyingCount:varyings̐
+GLuint createProgram(const char* vsrc, const char* fsrc, const char* const* varyings = NULL, GLsizei varyingCount = 0) {
+	//̃IuWFNg쐬
+	const GLuint program(glCreateProgram());
+
+	//ǂ炩̃VF[_[̃RpCɎs΃NȂ
+	//iЕłNłĂ܂̂ŁAǂݒ̂ƂɌÂvOcȂȂj
+	bool compiled(true);
+
+	if (vsrc != NULL) {
+		//o[ebNXVF[_[̃VF[_[IuWFNg쐬
+		const GLuint vobj(glCreateShader(GL_VERTEX_SHADER));
+		//VF[_IuWFNgɑ΂ă\[XvOǂݍ
+		glShaderSource(vobj, 1, &vsrc, NULL);
+		//VF[_IuWFNgɓǂݍ܂ꂽ\[Xt@CRpC
+		glCompileShader(vobj);
+
+		//Ă΃o[ebNXVF[_[̃VF[_[IuWFNgvOIuWFNgɑgݍ
+		if (printShaderInfoLog(vobj, "vertex shader"))
+			//vOIuWFNgɃVF[_IuWFNggݍ
+			glAttachShader(program, vobj);
+		else
+			compiled = false;
+		//폜}[N
+		glDeleteShader(vobj);
+	}
+
+	if (fsrc != NULL) {
+		//tOgVF[_[̃VF[_[IuWFNg쐬
+		const GLuint fobj(glCreateShader(GL_FRAGMENT_SHADER));
+		glShaderSource(fobj, 1, &fsrc, NULL);
+		glCompileShader(fobj);
+
+		//Ă΃tOgVF[_[̃VF[_[IuWFNgvOIuWFNgɑgݍ
+		if(printShaderInfoLog(fobj,"fragment shader"))
+			glAttachShader(program, fobj);
+		else
+			compiled = false;
+		glDeleteShader(fobj);
+	}
+
+	//vOIuWFNgN
+	//Attributeϐ̏ꏊw肵Ă(inϐoutϐ)
+	glBindAttribLocation(program, 0, "position");
+	glBindAttribLocation(program, 1, "normal");
+	//CX^XƂ̕ϊsimat42`5ԁAmat36`8Ԃgj
+	glBindAttribLocation(program, 2, "instanceModelview");
+	glBindAttribLocation(program, 6, "instanceNormalMatrix");
+	//sbLO̔ԍi9ԁj
+	glBindAttribLocation(program, 9, "instanceId");
+	//eNX`Wi10ԁj
+	glBindAttribLocation(program, 10, "texcoord");
+	//p[eBN̑xi11ԁj
+	glBindAttribLocation(program, 11, "velocity");
+	//mFp̐̐Fi12ԁj
+	glBindAttribLocation(program, 12, "color");
+	glBindFragDataLocation(program,0,"fragment");
+	//gXtH[tB[hobNŏoϐ͂ЂƂ̃obt@ɑďo
+	if (varyings != NULL) glTransformFeedbackVaryings(program, varyingCount, varyings, GL_INTERLEAVED_ATTRIBS);
+	//programɎw肵vOIuWFNgNĂ
+	if (compiled) glLinkProgram(program);
+
+	//Ă΍쐬vOIuWFNgԂ
+	if(compiled && printProgramInfoLog(program))
+		return program;
+
+	//vOIuWFNg쐬łȂ0Ԃ
+	glDeleteProgram(program);
+	return 0;
+}
+
+
+//VF[_[̃\[Xt@Cǂݍ񂾃Ԃ
+//name:VF[_[̃\[Xt@C
+//buffer:ǂݍ񂾃\[Xt@C̃eLXg
+bool readShaderSource(const char* name, std::vector<GLchar>& buffer) {
+	//t@CNULL
+	if (name == NULL)return false;
+
+	//\[Xt@CJ
+	std::ifstream file(name, std::ios::binary);
+	if (file.fail()) {
+		//JȂ
+		std::cerr << "Error: Can't open source file: " << name << std::endl;
+		return false;
+	}
+
+	//t@C̖Ɉړ݈ʒu(=t@CTCY)𓾂
+	file.seekg(0L, std::ios::end);
+	GLsizei length = static_cast<GLsizei>(file.tellg());
+
+	//t@CTCỸm
+	buffer.resize(length + 1);
+
+	//t@C擪疖܂œǂݍ
+	file.seekg(0L,std::ios::beg);
+	file.read(buffer.data(), length);
+	buffer[length] = '\0';
+	
+	if (file.fail()) {
+		//܂ǂݍ߂Ȃ
+		std::cerr << "Error: Could not read souce file:" << name << std::endl;
+		file.close();
+		return false;
+	}
+
+	//ǂݍݐ
+	file.close();
+	return true;
+}
+
+//VF[_[̃\[Xt@CǂݍŃvOIuWFNg쐬
+//vert:o[ebNXVF[_[̃\[Xt@C
+//frag:tOgVF[_[̃\[Xt@C
+GLuint loadProgram(const char* vert, const char* frag) {
+	//VF[_[̃\[Xt@Cǂݍ
+	//肭ǂݍ܂ĂvstatfstattrueɂȂ
+	std::vector<GLchar> vsrc;
+	const bool vstat(readShaderSource(vert, vsrc));
+	std::vector<GLchar>fsrc;
+	const bool fstat(readShaderSource(frag, fsrc));
+	
+	//vOIuWFNg쐬
+	//擪ւ̃|C^œn
+	return vstat && fstat ? createProgram(vsrc.data(), fsrc.data()) : 0;
+}
+
+//o[ebNXVF[_[̃gXtH[tB[hobÑvOIuWFNg쐬
+//vert:o[ebNXVF[_[̃\[Xt@C
+//varyings:ooutϐ̖O
+//varyingCount:varyings̐
+GLuint loadFeedbackProgram(const char* vert, const char* const* varyings, GLsizei varyingCount) {
+	std::vector<GLchar> vsrc;
+	return readShaderSource(vert, vsrc) ? createProgram(vsrc.data(), NULL, varyings, varyingCount) : 0;
+}
@@ -1,13 +1,12 @@
 #pragma once
-#include <memory>
 
 //}`f[^
 #include "object.h"
 
 //}`̕`
 class Shape {
-	//}`f[^
-	std::shared_ptr<const Object> object;
+	//}`f[^iRs[͂ł[ułj
+	Object object;
 
 
 protected:
@@ -22,7 +21,7 @@ public:
 		//indexcount:_̃CfbNX̗vf
 		//index:_̃CfbNXi[z
 		Shape(GLint size, GLsizei vertexcount, const Object::Vertex* vertex,GLsizei indexcount=0,const GLuint *index=NULL)
-		:object(new Object(size, vertexcount, vertex,indexcount,index))
+		:object(size, vertexcount, vertex,indexcount,index)
 		, vertexcount(vertexcount) {
 
 	}
@@ -30,7 +29,7 @@ public:
 	//`
 		void draw()const {
 			//_zIuWFNg
-			object->bind();
+			object.bind();
 
 			//`s
 			execute();
@@ -0,0 +1,156 @@
+#pragma once
+#include <cmath>
+#include <algorithm>
+#include <cstring>
+
+//SSE2gƂ͑gݍ݊֐g
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SIMD_SSE2 1
+#include <emmintrin.h>
+#endif
+
+//4vf̒Px_xNg
+struct Float4 {
+#ifdef SIMD_SSE2
+	//WX^̒l
+	__m128 v;
+
+	//RXgN^
+	Float4() {}
+	Float4(__m128 v) :v(v) {}
+
+	//Svfsɂ
+	explicit Float4(float s) :v(_mm_set1_ps(s)) {}
+
+	//vfʂɎw肷
+	Float4(float x, float y, float z, float w) :v(_mm_setr_ps(x, y, z, w)) {}
+
+	//16oCgEɂǂݍ
+	static Float4 load(const float* p) { return _mm_load_ps(p); }
+
+	//EɂĂȂǂݍ
+	static Float4 loadu(const float* p) { return _mm_loadu_ps(p); }
+
+	//16oCgEɂɏ
+	void store(float* p) const { _mm_store_ps(p, v); }
+
+	//EɂĂȂɏ
+	void storeu(float* p) const { _mm_storeu_ps(p, v); }
+
+	//4oCg̕ȂiRGBA8̉fȂǁjǂݍ
+	static Float4 loadBytes(const unsigned char* p) {
+		int b;
+		std::memcpy(&b, p, 4);
+		const __m128i zero(_mm_setzero_si128());
+		return _mm_cvtepi32_ps(_mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(b), zero), zero));
+	}
+
+	//ł߂Ɋۂ߁A0255Ɏ߂4oCgɏ
+	void storeBytes(unsigned char* p) const {
+		const __m128i i(_mm_cvtps_epi32(v));
+		const int b(_mm_cvtsi128_si32(_mm_packus_epi16(_mm_packs_epi32(i, i), i)));
+		std::memcpy(p, &b, 4);
+	}
+
+	Float4 operator+(const Float4& a) const { return _mm_add_ps(v, a.v); }
+	Float4 operator-(const Float4& a) const { return _mm_sub_ps(v, a.v); }
+	Float4 operator*(const Float4& a) const { return _mm_mul_ps(v, a.v); }
+	Float4 operator/(const Float4& a) const { return _mm_div_ps(v, a.v); }
+
+	//rʂ̃}XNԂ
+	Float4 operator<(const Float4& a) const { return _mm_cmplt_ps(v, a.v); }
+	Float4 operator<=(const Float4& a) const { return _mm_cmple_ps(v, a.v); }
+	Float4 operator>(const Float4& a) const { return _mm_cmpgt_ps(v, a.v); }
+	Float4 operator>=(const Float4& a) const { return _mm_cmpge_ps(v, a.v); }
+
+	//}XN̘_Z
+	Float4 operator&(const Float4& a) const { return _mm_and_ps(v, a.v); }
+	Float4 operator|(const Float4& a) const { return _mm_or_ps(v, a.v); }
+
+	//vfƂ̍ŏlƍől
+	static Float4 min(const Float4& a, const Float4& b) { return _mm_min_ps(a.v, b.v); }
+	static Float4 max(const Float4& a, const Float4& b) { return _mm_max_ps(a.v, b.v); }
+
+	//
+	static Float4 sqrt(const Float4& a) { return _mm_sqrt_ps(a.v); }
+
+	//maskĂvfaAȊObI
+	static Float4 select(const Float4& mask, const Float4& a, const Float4& b) {
+		return _mm_or_ps(_mm_and_ps(mask.v, a.v), _mm_andnot_ps(mask.v, b.v));
+	}
+
+	//}XN̊evf̕rbg𐮐ɂ܂Ƃ߂
+	int mask() const { return _mm_movemask_ps(v); }
+#else
+	//evf̒l
+	float v[4];
+
+	//RXgN^
+	Float4() {}
+
+	//Svfsɂ
+	explicit Float4(float s) :v{ s, s, s, s } {}
+
+	//vfʂɎw肷
+	Float4(float x, float y, float z, float w) :v{ x, y, z, w } {}
+
+	//ǂݍ
+	static Float4 load(const float* p) { return Float4(p[0], p[1], p[2], p[3]); }
+	static Float4 loadu(const float* p) { return load(p); }
+
+	//ɏ
+	void store(float* p) const { std::copy(v, v + 4, p); }
+	void storeu(float* p) const { store(p); }
+
+	//4oCg̕ȂiRGBA8̉fȂǁjǂݍ
+	static Float4 loadBytes(const unsigned char* p) { return Float4(p[0], p[1], p[2], p[3]); }
+
+	//ł߂Ɋۂ߁A0255Ɏ߂4oCgɏ
+	void storeBytes(unsigned char* p) const {
+		for (int i = 0; i < 4; ++i) p[i] = static_cast<unsigned char>(std::min(std::max(v[i] + 0.5f, 0.0f), 255.0f));
+	}
+
+	Float4 operator+(const Float4& a) const { return Float4(v[0] + a.v[0], v[1] + a.v[1], v[2] + a.v[2], v[3] + a.v[3]); }
+	Float4 operator-(const Float4& a) const { return Float4(v[0] - a.v[0], v[1] - a.v[1], v[2] - a.v[2], v[3] - a.v[3]); }
+	Float4 operator*(const Float4& a) const { return Float4(v[0] * a.v[0], v[1] * a.v[1], v[2] * a.v[2], v[3] * a.v[3]); }
+	Float4 operator/(const Float4& a) const { return Float4(v[0] / a.v[0], v[1] / a.v[1], v[2] / a.v[2], v[3] / a.v[3]); }
+
+	//rʂ̃}XNԂi^̗vf-1.0AU̗vf0.0j
+	Float4 operator<(const Float4& a) const { return compare(a, [](float x, float y) { return x < y; }); }
+	Float4 operator<=(const Float4& a) const { return compare(a, [](float x, float y) { return x <= y; }); }
+	Float4 operator>(const Float4& a) const { return compare(a, [](float x, float y) { return x > y; }); }
+	Float4 operator>=(const Float4& a) const { return compare(a, [](float x, float y) { return x >= y; }); }
+
+	//}XN̘_Z
+	Float4 operator&(const Float4& a) const { return compare(a, [](float x, float y) { return x < 0.0f && y < 0.0f; }); }
+	Float4 operator|(const Float4& a) const { return compare(a, [](float x, float y) { return x < 0.0f || y < 0.0f; }); }
+
+	//vfƂ̍ŏlƍől
+	static Float4 min(const Float4& a, const Float4& b) { return Float4(std::min(a.v[0], b.v[0]), std::min(a.v[1], b.v[1]), std::min(a.v[2], b.v[2]), std::min(a.v[3], b.v[3])); }
+	static Float4 max(const Float4& a, const Float4& b) { return Float4(std::max(a.v[0], b.v[0]), std::max(a.v[1], b.v[1]), std::max(a.v[2], b.v[2]), std::max(a.v[3], b.v[3])); }
+
+	//
+	static Float4 sqrt(const Float4& a) { return Float4(std::sqrt(a.v[0]), std::sqrt(a.v[1]), std::sqrt(a.v[2]), std::sqrt(a.v[3])); }
+
+	//maskĂvfaAȊObI
+	static Float4 select(const Float4& mask, const Float4& a, const Float4& b) {
+		Float4 t;
+		for (int i = 0; i < 4; ++i) t.v[i] = mask.v[i] < 0.0f ? a.v[i] : b.v[i];
+		return t;
+	}
+
+	//}XN̊evf𐮐̃rbgɂ܂Ƃ߂
+	int mask() const {
+		return (v[0] < 0.0f ? 1 : 0) | (v[1] < 0.0f ? 2 : 0) | (v[2] < 0.0f ? 4 : 0) | (v[3] < 0.0f ? 8 : 0);
+	}
+
+private:
+	//vfƂɔră}XN
+	template<typename F>
+	Float4 compare(const Float4& a, F f) const {
+		Float4 t;
+		for (int i = 0; i < 4; ++i) t.v[i] = f(v[i], a.v[i]) ? -1.0f : 0.0f;
+		return t;
+	}
+#endif
+};
@@ -0,0 +1,51 @@
+#pragma once
+#include <cmath>
+#include <vector>
+#include <GL/glew.h>
+
+//}`f[^
+#include "object.h"
+
+//̒_ƃCfbNX
+//slices:ox̕
+//stacks:ܓx̕
+//vertex:_̊i[
+//index:_̃CfbNX̊i[
+void makeSphere(int slices, int stacks, std::vector<Object::Vertex>& vertex, std::vector<GLuint>& index) {
+	//_
+	for (int j = 0; j <= stacks; ++j) {
+		const float t(static_cast<float> (j) / static_cast<float>(stacks));
+		const float y(cos(3.141593f * t)), r(sin(3.141593f * t));
+		for (int i = 0; i <= slices; ++i) {
+			const float s(static_cast<float>(i) / static_cast<float>(slices));
+			const float z(r * cos(6.283185f * s)), x(r * sin(6.283185f * s));
+			//_
+			const Object::Vertex v = { x,y,z,x,y,z,s,t };
+			//_ǉ
+			vertex.emplace_back(v);
+		}
+		
+	}
+
+	//CfbNX
+	for (int j = 0; j < stacks; ++j) {
+		const int k((slices + 1) * j);
+		for (int i = 0; i < slices; ++i) {
+			//_̃CfbNX
+			const GLuint k0(k + i);
+			const GLuint k1(k0 + 1);
+			const GLuint k2(k1 + slices);
+			const GLuint k3(k2 + 1);
+
+			//̎Op`
+			index.emplace_back(k0);
+			index.emplace_back(k2);
+			index.emplace_back(k3);
+
+			//E̎Op`
+			index.emplace_back(k0);
+			index.emplace_back(k3);
+			index.emplace_back(k1);
+		}
+	}
+}
@@ -0,0 +1,65 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+
+//̃XbhǉAʂ̈̃XbhoOobt@
+//bNg킸AǉƎoŃq[v̊mۂNȂ
+//Capacity:i[łvf̐i2ׂ̂j
+template<typename T, std::size_t Capacity>
+class SpscRing {
+	static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two.");
+
+	//vf
+	T items[Capacity];
+
+	//Ɏoʒuioi߂j
+	std::atomic<std::size_t> head;
+
+	//ǉ鑤ƎoLbVCȂ悤ɗ
+	char padding[64];
+
+	//ɒǉʒuiǉ鑤i߂j
+	std::atomic<std::size_t> tail;
+
+	//tŒǉłȂ񐔁iǉ鑤j
+	std::atomic<unsigned long long> dropped;
+
+	//Rs[֎~
+	SpscRing(const SpscRing&) = delete;
+	SpscRing& operator=(const SpscRing&) = delete;
+
+public:
+	//RXgN^
+	SpscRing() :head(0), tail(0), dropped(0) {}
+
+	//vfǉiǉ鑤̃XbhŎgj
+	//߂l:tŒǉłȂfalse
+	bool push(const T& item) {
+		const std::size_t t(tail.load(std::memory_order_relaxed));
+		if (t - head.load(std::memory_order_acquire) >= Capacity) {
+			dropped.fetch_add(1, std::memory_order_relaxed);
+			return false;
+		}
+		items[t & (Capacity - 1)] = item;
+		tail.store(t + 1, std::memory_order_release);
+		return true;
+	}
+
+	//vfoiõXbhŎgj
+	//߂l:ŎoȂfalse
+	bool pop(T& item) {
+		const std::size_t h(head.load(std::memory_order_relaxed));
+		if (h == tail.load(std::memory_order_acquire)) return false;
+		item = items[h & (Capacity - 1)];
+		head.store(h + 1, std::memory_order_release);
+		return true;
+	}
+
+	//i[Ăvf̖̐ڈ
+	std::size_t size() const {
+		return tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire);
+	}
+
+	//tŒǉłȂ
+	unsigned long long getDropped() const { return dropped.load(std::memory_order_relaxed); }
+};
@@ -0,0 +1,304 @@
+#pragma once
+#include <vector>
+#include <memory>
+#include <chrono>
+#include <cmath>
+#include <algorithm>
+#include <iostream>
+#include <GL/glew.h>
+
+//eNX`̉摜
+#include "TextureImage.h"
+
+//OpenGL̃IuWFNg̃nh
+#include "GLHandle.h"
+
+//GPU̎gpʂ̋L^
+#include "GpuMemory.h"
+
+//ϊs
+#include "Matrix.h"
+
+//v
+#include "Profiler.h"
+
+//eNX`̒u
+//摜͑SxCPUɎAGPUɂ͉ʏ̑傫ɕKvȃxex܂łu
+//GPUɒuʂ\Z𒴂Ƃ͒gĂȂ̂eAׂƂ̓]̓t[Ƃ̏ŕ
+//OpenGL 3.2ł̓x̃łȂ̂ŁAuxςƂ͓ÕeNX`蒼
+class TextureCache {
+public:
+	//eNX`̔ԍiގtextureɓA0̓eNX`Ȃj
+	typedef unsigned int Handle;
+
+	//v
+	struct Stats {
+		//eNX`̐
+		unsigned int textures;
+
+		//GPUɒuĂoCg
+		std::size_t resident;
+
+		//vǂɒuꍇ̃oCg
+		std::size_t wanted;
+
+		//\ZioCgA0Ȃ疳j
+		std::size_t budget;
+
+		//Ōupdateœ]oCg
+		std::size_t uploaded;
+
+		//ŌupdateőeeNX`̐
+		unsigned int evicted;
+
+		//ǂݍ݂ɂԂ̍vi~bjƓǂݍ񂾃oCg̍v
+		double loadTime;
+		std::size_t loaded;
+
+		//Ōupdateɂԁi~bj
+		double updateTime;
+	};
+
+private:
+	//eNX`
+	struct Entry {
+		//摜
+		TextureImage image;
+
+		//eNX`IuWFNg
+		GLTexture texture;
+
+		//GPUɒuĂłׂx
+		int resident;
+
+		//GPUɒułׂxiTailSizefȉ̍ŏ̃xj
+		int tail;
+
+		//̃t[ŗvꂽłׂxivȂ΃x̐j
+		int wanted;
+
+		//updateŌ߂GPUɒułׂx
+		int target;
+
+		//Ōɗvꂽt[
+		unsigned int lastUse;
+	};
+
+	//eNX`iԍ͓Y+1j
+	std::vector<std::unique_ptr<Entry>> entries;
+
+	//GPUɒu\Zƃt[Ƃ̓]̏ioCgj
+	std::size_t budget, uploadLimit;
+
+	//t[̔ԍ
+	unsigned int frame;
+
+	//v
+	Stats stats;
+
+	//updateōׂeNX`it[mۂȂ悤Ɏg񂷁j
+	std::vector<Entry*> refine;
+
+	//GPUɒu傫ifj
+	static constexpr GLsizei TailSize = 64;
+
+	//vȂȂĂׂxcĂt[
+	static constexpr unsigned int KeepFrames = 120;
+
+	//Rs[֎~
+	TextureCache(const TextureCache&) = delete;
+	TextureCache& operator=(const TextureCache&) = delete;
+
+	//GPUɒuxςilevelłex܂ł0Ԃ]j
+	void reside(Entry& e, int level) {
+		const std::size_t before(e.image.getBytes(e.resident)), after(e.image.getBytes(level));
+		glBindTexture(GL_TEXTURE_2D, e.texture.get());
+		for (int l = level; l < e.image.getLevelCount(); ++l) e.image.upload(l, l - level);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 0);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, e.image.getLevelCount() - 1 - level);
+
+		//GPU̎gpʂL^
+		GpuMemory::instance().release(GpuMemory::Texture, before);
+		GpuMemory::instance().allocate(GpuMemory::Texture, after);
+		stats.resident += after - before;
+		e.resident = level;
+	}
+
+public:
+	//RXgN^
+	//budget:GPUɒu\ZioCgA0Ȃ疳j
+	//uploadLimit:t[Ƃɍׂx]oCg̏
+	explicit TextureCache(std::size_t budget = 64 << 20, std::size_t uploadLimit = 8 << 20)
+		:budget(budget), uploadLimit(uploadLimit), frame(0), stats()
+	{
+		stats.budget = budget;
+	}
+
+	//fXgN^
+	virtual ~TextureCache() {
+		GpuMemory::instance().release(GpuMemory::Texture, stats.resident);
+	}
+
+	//摜o^iŏ͑exGPUɒuj
+	//image:摜i~bv}bv͍Ăj
+	//߂l:eNX`̔ԍÅňȂ`Ȃ0
+	Handle add(TextureImage&& image) {
+		if (!image.isSupported()) {
+			std::cerr << "Error: Texture format 0x" << std::hex << image.getInternalFormat() << std::dec
+				<< " is not supported by this GPU." << std::endl;
+			return 0;
+		}
+
+		std::unique_ptr<Entry> e(new Entry);
+		e->image = std::move(image);
+		e->texture = GLTexture::create();
+		e->resident = e->image.getLevelCount();
+		e->tail = 0;
+		while (e->tail < e->image.getLevelCount() - 1
+			&& std::max(e->image.getLevel(e->tail).width, e->image.getLevel(e->tail).height) > TailSize) ++e->tail;
+		e->wanted = e->image.getLevelCount();
+		e->target = e->tail;
+		e->lastUse = frame - KeepFrames;
+
+		//JԂē\Agł͈ٕtB^
+		glBindTexture(GL_TEXTURE_2D, e->texture.get());
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+		if (GLEW_EXT_texture_filter_anisotropic) glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAX_ANISOTROPY_EXT, 8.0f);
+		reside(*e, e->tail);
+
+		entries.push_back(std::move(e));
+		refine.reserve(entries.size());
+		++stats.textures;
+		return static_cast<Handle>(entries.size());
+	}
+
+	//KTXDDS̃t@Cǂݍœo^
+	//񈳏k̉摜Ń~bv}bviȂ΃[J[Xbhō
+	//path:t@C̃pX
+	//pool:[J[Xbh
+	//߂l:eNX`̔ԍAǂݍ߂Ȃ0
+	Handle load(const char* path, ThreadPool& pool) {
+		const auto t0(std::chrono::high_resolution_clock::now());
+		TextureImage image;
+		if (!image.load(path)) return 0;
+		image.generateMipmaps(pool);
+		const std::size_t bytes(image.getBytes());
+		const Handle handle(add(std::move(image)));
+		stats.loadTime += Profiler::elapsed(t0);
+		stats.loaded += bytes;
+		return handle;
+	}
+
+	//eNX`IuWFNgo
+	//handle:eNX`̔ԍ
+	//߂l:eNX`IuWFNgAԍ0Ȃ0
+	GLuint get(Handle handle) const {
+		return handle > 0 ? entries[handle - 1]->texture.get() : 0;
+	}
+
+	//̃t[ŕKvȍׂvit[ɉxvłׂ̂gj
+	//handle:eNX`̔ԍ
+	//pixels:eNX`Ŝʏŕ傫ifj
+	void request(Handle handle, GLfloat pixels) {
+		if (handle == 0) return;
+		Entry& e(*entries[handle - 1]);
+		const TextureImage::Level& top(e.image.getLevel(0));
+		const GLfloat texels(static_cast<GLfloat>(std::max(top.width, top.height)));
+		const int level(pixels >= texels ? 0 : pixels > 0.0f
+			? static_cast<int>(std::floor(std::log2(texels / pixels))) : e.image.getLevelCount() - 1);
+		e.wanted = std::min(e.wanted, std::min(level, e.image.getLevelCount() - 1));
+		e.lastUse = frame;
+	}
+
+	//ň͂񂾐}`ʏŕ傫߂ił߂_̋Ōςj
+	//modelview:}`̃fr[ϊs
+	//projection:eϊs
+	//radius:_Wnł̋̔a
+	//height:r[|[g̍ifj
+	//߂l:̒aʏŕf
+	static GLfloat screenSize(const Matrix& modelview, const Matrix& projection, GLfloat radius, GLfloat height) {
+		const GLfloat* const m(modelview.data());
+		const GLfloat distance(std::sqrt(m[12] * m[12] + m[13] * m[13] + m[14] * m[14]) - radius);
+		return radius * projection.data()[5] * height / std::max(distance, 1.0e-3f * radius);
+	}
+
+	//vɍ킹GPUɒuxςi`̃XbhŃt[̋؂ɌĂяoj
+	//eNX`jbg0̌ς
+	void update() {
+		const auto t0(std::chrono::high_resolution_clock::now());
+		stats.uploaded = 0;
+		stats.evicted = 0;
+		glActiveTexture(GL_TEXTURE0);
+
+		//̃t[ŗvĂΗvǂ̃xɂiKv΍ׂx̂ĂjA
+		//vȂ΂΂炭͍̃xcAKeepFrameŝvȂΑexɂ
+		std::size_t total(0);
+		for (const auto& e : entries) {
+			const int level(e->lastUse == frame ? e->wanted : frame - e->lastUse < KeepFrames ? e->resident : e->tail);
+			e->target = std::min(level, e->tail);
+			total += e->image.getBytes(e->target);
+		}
+		stats.wanted = total;
+
+		//\Z𒴂ĂΈie
+		//̃t[̗vׂ́AgĂȂ́Aׂx傫̂̏ɑI
+		const auto before = [](const Entry* a, const Entry* b) {
+			const bool excessA(a->target < a->wanted), excessB(b->target < b->wanted);
+			if (excessA != excessB) return excessA;
+			if (a->lastUse != b->lastUse) return a->lastUse < b->lastUse;
+			return a->image.getLevel(a->target).size > b->image.getLevel(b->target).size;
+		};
+		while (budget > 0 && total > budget) {
+			Entry* victim(NULL);
+			for (const auto& e : entries)
+				if (e->target < e->tail && (victim == NULL || before(e.get(), victim))) victim = e.get();
+			if (victim == NULL) break;
+			total -= victim->image.getLevel(victim->target).size;
+			++victim->target;
+		}
+
+		//ê͐ɍ蒼ă󂯂
+		refine.clear();
+		for (const auto& e : entries) {
+			if (e->target > e->resident) {
+				reside(*e, e->target);
+				++stats.evicted;
+			}
+			else if (e->target < e->resident) refine.push_back(e.get());
+		}
+
+		//ׂ̂͑Ȃx̂Aex珇ɓ]̏Ɏ܂Ƃ܂ōׂ
+		//ił𒴂Ƃ́Ãt[ł܂]ĂȂΈiׂ
+		std::sort(refine.begin(), refine.end(), [](const Entry* a, const Entry* b) {
+			return a->resident - a->target > b->resident - b->target;
+		});
+		for (Entry* e : refine) {
+			int fit(e->resident);
+			for (int level = e->resident - 1; level >= e->target; --level) {
+				if (stats.uploaded + e->image.getBytes(level) > uploadLimit) break;
+				fit = level;
+			}
+			if (fit == e->resident && stats.uploaded == 0) fit = e->resident - 1;
+			if (fit == e->resident) continue;
+			stats.uploaded += e->image.getBytes(fit);
+			reside(*e, fit);
+		}
+
+		//̃t[̗v󂯕t
+		for (const auto& e : entries) e->wanted = e->image.getLevelCount();
+		++frame;
+		stats.updateTime = Profiler::elapsed(t0);
+	}
+
+	//\Zݒ肷
+	//bytes:GPUɒu\Zi0Ȃ疳j
+	void setBudget(std::size_t bytes) {
+		budget = stats.budget = bytes;
+	}
+
+	//v
+	const Stats& getStats() const { return stats; }
+};
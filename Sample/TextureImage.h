@@ -0,0 +1,388 @@
+#pragma once
+#include <vector>
+#include <fstream>
+#include <iostream>
+#include <cstring>
+#include <cstdint>
+#include <algorithm>
+#include <GL/glew.h>
+
+//SIMD̉Z
+#include "Simd.h"
+
+//[J[Xbh
+#include "ThreadPool.h"
+
+//eNX`̉摜i~bv}bv̑Sx̃f[^CPŨɎj
+//KTXio[W1jDDS̃t@Cǂݍ݁ABC1`BC7ETC2̈kf[^͓WJɂ̂܂ܓ]
+//񈳏kRGBA8̉摜Ń~bv}bviȂgenerateMipmapsCPUŏkč
+class TextureImage {
+public:
+	//~bv}bṽx
+	struct Level {
+		//ƍ
+		GLsizei width, height;
+
+		//data̒̈ʒuƃoCg
+		std::size_t offset, size;
+	};
+
+private:
+	//tH[}bg
+	GLenum internalFormat;
+
+	//񈳏k̂Ƃ̉f̃tH[}bgƌ^ik`Ȃ0j
+	GLenum format, type;
+
+	//~bv}bṽxi0Ԃłׂj
+	std::vector<Level> levels;
+
+	//Sx̃f[^
+	std::vector<unsigned char> data;
+
+	//k`4x4f̃ubÑoCg
+	//߂l:ubÑoCgA񈳏kΉĂȂ`Ȃ0
+	static std::size_t blockBytes(GLenum internalFormat) {
+		switch (internalFormat) {
+		case GL_COMPRESSED_RGB_S3TC_DXT1_EXT:
+		case GL_COMPRESSED_RGBA_S3TC_DXT1_EXT:
+		case GL_COMPRESSED_SRGB_S3TC_DXT1_EXT:
+		case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT:
+		case GL_COMPRESSED_RED_RGTC1:
+		case GL_COMPRESSED_SIGNED_RED_RGTC1:
+		case GL_COMPRESSED_RGB8_ETC2:
+		case GL_COMPRESSED_SRGB8_ETC2:
+		case GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2:
+		case GL_COMPRESSED_SRGB8_PUNCHTHROUGH_ALPHA1_ETC2:
+		case GL_COMPRESSED_R11_EAC:
+		case GL_COMPRESSED_SIGNED_R11_EAC:
+			return 8;
+		case GL_COMPRESSED_RGBA_S3TC_DXT3_EXT:
+		case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT:
+		case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT3_EXT:
+		case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT:
+		case GL_COMPRESSED_RG_RGTC2:
+		case GL_COMPRESSED_SIGNED_RG_RGTC2:
+		case GL_COMPRESSED_RGBA_BPTC_UNORM:
+		case GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM:
+		case GL_COMPRESSED_RGB_BPTC_SIGNED_FLOAT:
+		case GL_COMPRESSED_RGB_BPTC_UNSIGNED_FLOAT:
+		case GL_COMPRESSED_RGBA8_ETC2_EAC:
+		case GL_COMPRESSED_SRGB8_ALPHA8_ETC2_EAC:
+		case GL_COMPRESSED_RG11_EAC:
+		case GL_COMPRESSED_SIGNED_RG11_EAC:
+			return 16;
+		default:
+			return 0;
+		}
+	}
+
+	//DDS̊gwb_DXGI_FORMATtH[}bgɂ
+	//߂l:tH[}bgAΉĂȂ0
+	static GLenum dxgiFormat(std::uint32_t dxgi) {
+		switch (dxgi) {
+		case 28: return GL_RGBA8;
+		case 29: return GL_SRGB8_ALPHA8;
+		case 71: return GL_COMPRESSED_RGBA_S3TC_DXT1_EXT;
+		case 72: return GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT;
+		case 74: return GL_COMPRESSED_RGBA_S3TC_DXT3_EXT;
+		case 75: return GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT3_EXT;
+		case 77: return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+		case 78: return GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT;
+		case 80: return GL_COMPRESSED_RED_RGTC1;
+		case 81: return GL_COMPRESSED_SIGNED_RED_RGTC1;
+		case 83: return GL_COMPRESSED_RG_RGTC2;
+		case 84: return GL_COMPRESSED_SIGNED_RG_RGTC2;
+		case 95: return GL_COMPRESSED_RGB_BPTC_UNSIGNED_FLOAT;
+		case 96: return GL_COMPRESSED_RGB_BPTC_SIGNED_FLOAT;
+		case 98: return GL_COMPRESSED_RGBA_BPTC_UNORM;
+		case 99: return GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM;
+		default: return 0;
+		}
+	}
+
+	//gGfBA32rbgǂݏo
+	static std::uint32_t read32(const unsigned char* p) {
+		return static_cast<std::uint32_t>(p[0]) | static_cast<std::uint32_t>(p[1]) << 8
+			| static_cast<std::uint32_t>(p[2]) << 16 | static_cast<std::uint32_t>(p[3]) << 24;
+	}
+
+	//tH[}bgݒ肷
+	//߂l:k`񈳏kRGBA8Ȃtrue
+	bool setFormat(GLenum f) {
+		internalFormat = f;
+		if (blockBytes(f) > 0) {
+			format = type = 0;
+			return true;
+		}
+		format = GL_RGBA;
+		type = GL_UNSIGNED_BYTE;
+		return f == GL_RGBA8 || f == GL_SRGB8_ALPHA8;
+	}
+
+	//ƍƃx烌xׂăf[^̗̈mۂi0Ԃ̃f[^͎cj
+	void layout(GLsizei width, GLsizei height, int count) {
+		const std::size_t block(blockBytes(internalFormat));
+		levels.resize(count);
+		std::size_t offset(0);
+		for (Level& level : levels) {
+			level.width = width;
+			level.height = height;
+			level.offset = offset;
+			level.size = block > 0
+				? static_cast<std::size_t>((width + 3) / 4) * static_cast<std::size_t>((height + 3) / 4) * block
+				: static_cast<std::size_t>(width) * static_cast<std::size_t>(height) * 4;
+			offset += level.size;
+			width = std::max(width / 2, 1);
+			height = std::max(height / 2, 1);
+		}
+		data.resize(offset);
+	}
+
+public:
+	//RXgN^
+	TextureImage() :internalFormat(0), format(0), type(0) {}
+
+	//񈳏kRGBA8̉摜i~bv}bvgenerateMipmapsōj
+	//width, height:摜̕ƍ
+	//rgba:f̃f[^iNULLȂ0Ŗ߂j
+	void create(GLsizei width, GLsizei height, const unsigned char* rgba = NULL) {
+		setFormat(GL_RGBA8);
+		levels.clear();
+		data.clear();
+		layout(width, height, 1);
+		if (rgba != NULL) std::copy(rgba, rgba + data.size(), data.begin());
+	}
+
+	//KTXio[W1j̃f[^ǂݍ
+	//p, size:t@C̓eƃoCg
+	//߂l:ǂݍ߂true
+	bool loadKtx(const unsigned char* p, std::size_t size) {
+		static const unsigned char identifier[12] = { 0xAB, 'K', 'T', 'X', ' ', '1', '1', 0xBB, '\r', '\n', 0x1A, '\n' };
+		if (size < 64 || std::memcmp(p, identifier, sizeof identifier) != 0) return false;
+		if (read32(p + 12) != 0x04030201) {
+			std::cerr << "Error: Big-endian KTX files are not supported." << std::endl;
+			return false;
+		}
+
+		//2DeNX`izL[u}bvA3DeNX`͈Ȃj
+		const std::uint32_t glType(read32(p + 16)), glFormat(read32(p + 24)), glInternalFormat(read32(p + 28));
+		const GLsizei width(static_cast<GLsizei>(read32(p + 36))), height(static_cast<GLsizei>(read32(p + 40)));
+		if (width <= 0 || height <= 0 || read32(p + 44) > 0 || read32(p + 48) > 0 || read32(p + 52) != 1) {
+			std::cerr << "Error: Only 2D KTX textures with one face are supported." << std::endl;
+			return false;
+		}
+
+		//񈳏kȂRGBA8rbg
+		if (glType != 0 && (glType != GL_UNSIGNED_BYTE || glFormat != GL_RGBA)) {
+			std::cerr << "Error: Unsupported KTX pixel format: 0x" << std::hex << glFormat << std::dec << std::endl;
+			return false;
+		}
+		if (!setFormat(glType == 0 ? glInternalFormat : glInternalFormat == GL_RGBA ? GL_RGBA8 : glInternalFormat)) {
+			std::cerr << "Error: Unsupported KTX internal format: 0x" << std::hex << glInternalFormat << std::dec << std::endl;
+			return false;
+		}
+
+		//xƂɃoCgOɕtA4oCgE܂ŋlߕ
+		layout(width, height, std::max(static_cast<int>(read32(p + 56)), 1));
+		std::size_t offset(64 + read32(p + 60));
+		for (const Level& level : levels) {
+			if (offset + 4 > size || read32(p + offset) < level.size || offset + 4 + level.size > size) {
+				std::cerr << "Error: The KTX file is truncated." << std::endl;
+				return false;
+			}
+			std::memcpy(&data[level.offset], p + offset + 4, level.size);
+			offset += 4 + ((read32(p + offset) + 3) & ~3u);
+		}
+		return true;
+	}
+
+	//DDS̃f[^ǂݍ
+	//p, size:t@C̓eƃoCg
+	//߂l:ǂݍ߂true
+	bool loadDds(const unsigned char* p, std::size_t size) {
+		if (size < 128 || std::memcmp(p, "DDS ", 4) != 0) return false;
+
+		//L[u}bv3DeNX`͈Ȃ
+		if ((read32(p + 112) & 0x200200) != 0) {
+			std::cerr << "Error: Only 2D DDS textures are supported." << std::endl;
+			return false;
+		}
+
+		//f̃tH[}bgiFourCCADX10̊gwb_DXGI_FORMATj
+		std::size_t offset(128);
+		GLenum f(0);
+		const unsigned char* const fourCC(p + 84);
+		const std::uint32_t flags(read32(p + 80));
+		if ((flags & 0x4) != 0) {
+			if (std::memcmp(fourCC, "DXT1", 4) == 0) f = GL_COMPRESSED_RGBA_S3TC_DXT1_EXT;
+			else if (std::memcmp(fourCC, "DXT3", 4) == 0) f = GL_COMPRESSED_RGBA_S3TC_DXT3_EXT;
+			else if (std::memcmp(fourCC, "DXT5", 4) == 0) f = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+			else if (std::memcmp(fourCC, "ATI1", 4) == 0 || std::memcmp(fourCC, "BC4U", 4) == 0) f = GL_COMPRESSED_RED_RGTC1;
+			else if (std::memcmp(fourCC, "ATI2", 4) == 0 || std::memcmp(fourCC, "BC5U", 4) == 0) f = GL_COMPRESSED_RG_RGTC2;
+			else if (std::memcmp(fourCC, "DX10", 4) == 0) {
+				if (size < 148 || read32(p + 132) != 3 || read32(p + 140) > 1) {
+					std::cerr << "Error: Only 2D DDS textures are supported." << std::endl;
+					return false;
+				}
+				f = dxgiFormat(read32(p + 128));
+				offset = 148;
+			}
+		}
+		else if ((flags & 0x40) != 0 && read32(p + 88) == 32
+			&& read32(p + 92) == 0xff && read32(p + 96) == 0xff00 && read32(p + 100) == 0xff0000) {
+			f = GL_RGBA8;
+		}
+		if (f == 0 || !setFormat(f)) {
+			std::cerr << "Error: Unsupported DDS pixel format." << std::endl;
+			return false;
+		}
+
+		//xׂ͍ɌԂȂł
+		const GLsizei width(static_cast<GLsizei>(read32(p + 16))), height(static_cast<GLsizei>(read32(p + 12)));
+		if (width <= 0 || height <= 0) {
+			std::cerr << "Error: Invalid DDS image size." << std::endl;
+			return false;
+		}
+		layout(width, height, (read32(p + 8) & 0x20000) != 0 ? std::max(static_cast<int>(read32(p + 28)), 1) : 1);
+		if (offset + data.size() > size) {
+			std::cerr << "Error: The DDS file is truncated." << std::endl;
+			return false;
+		}
+		std::memcpy(data.data(), p + offset, data.size());
+		return true;
+	}
+
+	//KTXDDS̃f[^ǂݍ
+	//p, size:t@C̓eƃoCg
+	//߂l:ǂݍ߂true
+	bool load(const unsigned char* p, std::size_t size) {
+		if (size >= 4 && std::memcmp(p, "DDS ", 4) == 0) return loadDds(p, size);
+		if (size >= 4 && std::memcmp(p + 1, "KTX", 3) == 0) return loadKtx(p, size);
+		std::cerr << "Error: Unknown texture file format." << std::endl;
+		return false;
+	}
+
+	//KTXDDS̃t@Cǂݍ
+	//path:t@C̃pX
+	//߂l:ǂݍ߂true
+	bool load(const char* path) {
+		std::ifstream file(path, std::ios::binary | std::ios::ate);
+		if (!file) {
+			std::cerr << "Error: Can't open texture file: " << path << std::endl;
+			return false;
+		}
+		std::vector<unsigned char> buffer(static_cast<std::size_t>(file.tellg()));
+		file.seekg(0);
+		file.read(reinterpret_cast<char*>(buffer.data()), buffer.size());
+		if (file.fail() || !load(buffer.data(), buffer.size())) {
+			std::cerr << "Error: Can't load texture file: " << path << std::endl;
+			return false;
+		}
+		return true;
+	}
+
+	//񈳏k̉摜̃~bv}bv1x1܂ōiłɓiȏ゠ΉȂj
+	//Õx2x2f𕽋ςAs܂Ƃ߂ă[J[Xbhɕ
+	//pool:[J[Xbh
+	//parallel:falseȂĂяoXbhō
+	void generateMipmaps(ThreadPool& pool, bool parallel = true) {
+		if (isCompressed() || levels.size() != 1) return;
+
+		int count(1);
+		for (GLsizei w = levels[0].width, h = levels[0].height; w > 1 || h > 1; w = std::max(w / 2, 1), h = std::max(h / 2, 1)) ++count;
+		layout(levels[0].width, levels[0].height, count);
+
+		for (int l = 1; l < count; ++l) {
+			const Level& src(levels[l - 1]);
+			const Level& dst(levels[l]);
+			const unsigned char* const s(&data[src.offset]);
+			unsigned char* const d(&data[dst.offset]);
+
+			//̎dł悻16Kf
+			const GLsizei rows(std::max(16384 / dst.width, 1));
+			const unsigned int jobs(static_cast<unsigned int>((dst.height + rows - 1) / rows));
+			const auto filter = [&](unsigned int job, unsigned int) {
+				const Float4 quarter(0.25f);
+				const GLsizei end(std::min(static_cast<GLsizei>(job + 1) * rows, dst.height));
+				for (GLsizei y = static_cast<GLsizei>(job) * rows; y < end; ++y) {
+					//̑傫ł͒[̉fJԂ
+					const unsigned char* const r0(s + static_cast<std::size_t>(std::min(y * 2, src.height - 1)) * src.width * 4);
+					const unsigned char* const r1(s + static_cast<std::size_t>(std::min(y * 2 + 1, src.height - 1)) * src.width * 4);
+					unsigned char* const out(d + static_cast<std::size_t>(y) * dst.width * 4);
+					for (GLsizei x = 0; x < dst.width; ++x) {
+						const GLsizei x0(std::min(x * 2, src.width - 1) * 4), x1(std::min(x * 2 + 1, src.width - 1) * 4);
+						((Float4::loadBytes(r0 + x0) + Float4::loadBytes(r0 + x1)
+							+ Float4::loadBytes(r1 + x0) + Float4::loadBytes(r1 + x1)) * quarter).storeBytes(out + x * 4);
+					}
+				}
+			};
+			if (parallel && jobs > 1) pool.parallelFor(jobs, filter);
+			else for (unsigned int job = 0; job < jobs; ++job) filter(job, 0);
+		}
+	}
+
+	//̊OpenGLň`Ȃtrue
+	bool isSupported() const {
+		switch (internalFormat) {
+		case GL_COMPRESSED_RGB_S3TC_DXT1_EXT:
+		case GL_COMPRESSED_RGBA_S3TC_DXT1_EXT:
+		case GL_COMPRESSED_SRGB_S3TC_DXT1_EXT:
+		case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT:
+		case GL_COMPRESSED_RGBA_S3TC_DXT3_EXT:
+		case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT:
+		case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT3_EXT:
+		case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT:
+			return GLEW_EXT_texture_compression_s3tc != GL_FALSE;
+		case GL_COMPRESSED_RGBA_BPTC_UNORM:
+		case GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM:
+		case GL_COMPRESSED_RGB_BPTC_SIGNED_FLOAT:
+		case GL_COMPRESSED_RGB_BPTC_UNSIGNED_FLOAT:
+			return GLEW_ARB_texture_compression_bptc != GL_FALSE;
+		case GL_COMPRESSED_RGB8_ETC2:
+		case GL_COMPRESSED_SRGB8_ETC2:
+		case GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2:
+		case GL_COMPRESSED_SRGB8_PUNCHTHROUGH_ALPHA1_ETC2:
+		case GL_COMPRESSED_RGBA8_ETC2_EAC:
+		case GL_COMPRESSED_SRGB8_ALPHA8_ETC2_EAC:
+		case GL_COMPRESSED_R11_EAC:
+		case GL_COMPRESSED_SIGNED_R11_EAC:
+		case GL_COMPRESSED_RG11_EAC:
+		case GL_COMPRESSED_SIGNED_RG11_EAC:
+			return GLEW_ARB_ES3_compatibility != GL_FALSE;
+		default:
+			return !levels.empty();
+		}
+	}
+
+	//xĂeNX`̎w肵xɓ]
+	//level:摜̃x
+	//target:]̃eNX`̃x
+	void upload(int level, GLint target) const {
+		const Level& l(levels[level]);
+		if (isCompressed())
+			glCompressedTexImage2D(GL_TEXTURE_2D, target, internalFormat, l.width, l.height, 0, static_cast<GLsizei>(l.size), &data[l.offset]);
+		else
+			glTexImage2D(GL_TEXTURE_2D, target, internalFormat, l.width, l.height, 0, format, type, &data[l.offset]);
+	}
+
+	//k`Ȃtrue
+	bool isCompressed() const { return format == 0; }
+
+	//tH[}bg
+	GLenum getInternalFormat() const { return internalFormat; }
+
+	//x̐
+	int getLevelCount() const { return static_cast<int>(levels.size()); }
+
+	//x
+	const Level& getLevel(int level) const { return levels[level]; }
+
+	//x̉f̃f[^
+	const unsigned char* getData(int level) const { return &data[levels[level].offset]; }
+
+	//w肵xłex܂ł̃oCg
+	std::size_t getBytes(int level = 0) const {
+		return level < getLevelCount() ? data.size() - levels[level].offset : 0;
+	}
+};
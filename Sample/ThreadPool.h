@@ -0,0 +1,151 @@
+#pragma once
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <algorithm>
+
+//[J[Xbh̃v[
+//parallelForœnꂽĂяõXbhƃ[J[XbhŕSĎs
+//̎󂯓nɃq[vgȂ̂Ŗt[ĂяoĂmۂNȂ
+class ThreadPool {
+	//[J[Xbh
+	std::vector<std::thread> workers;
+
+	//Wu̎󂯓nɎgr
+	std::mutex mutex;
+
+	//WůJnƏI̒ʒm
+	std::condition_variable start, finish;
+
+	//̃XbhparallelFor𒼗񉻂
+	std::mutex dispatch;
+
+	//s̃Wu
+	void (*job)(void* context, unsigned int index, unsigned int thread);
+
+	//Wuɓnf[^
+	void* context;
+
+	//Wu̗vf
+	unsigned int count;
+
+	//ɏvf̔ԍ
+	std::atomic<unsigned int> next;
+
+	//Wũ[J[̐
+	unsigned int active;
+
+	//Wu̐i[J[VWuɋCÂ߂Ɏgj
+	unsigned long long generation;
+
+	//Iv
+	bool quit;
+
+	//̃Xbh̔ԍi[J[łȂ0j
+	static unsigned int& currentThread() {
+		thread_local unsigned int thread(0);
+		return thread;
+	}
+
+	//̃XbhWuȂtrue
+	static bool& inJob() {
+		thread_local bool busy(false);
+		return busy;
+	}
+
+	//Wu̗vfo菈
+	//thread:Xbh̔ԍiĂяo0j
+	void run(unsigned int thread) {
+		inJob() = true;
+		for (unsigned int i; (i = next.fetch_add(1)) < count;) job(context, i, thread);
+		inJob() = false;
+	}
+
+	//[J[Xbh̏
+	//thread:Xbh̔ԍ
+	void work(unsigned int thread) {
+		currentThread() = thread;
+		unsigned long long seen(0);
+		std::unique_lock<std::mutex> lock(mutex);
+		for (;;) {
+			//VWuIv҂
+			start.wait(lock, [&] { return quit || generation != seen; });
+			if (quit) return;
+			seen = generation;
+
+			//bNOăWu
+			lock.unlock();
+			run(thread);
+			lock.lock();
+
+			//ŌɏI[J[Ăяoɒʒm
+			if (--active == 0) finish.notify_one();
+		}
+	}
+
+	//Rs[֎~
+	ThreadPool(const ThreadPool&);
+	ThreadPool& operator=(const ThreadPool&);
+
+public:
+	//RXgN^
+	//threads:Ăяo܂ރXbh̐i0Ȃn[hEFÃXbhj
+	explicit ThreadPool(unsigned int threads = 0)
+		:job(NULL), context(NULL), count(0), next(0), active(0), generation(0), quit(false)
+	{
+		if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+		for (unsigned int i = 1; i < threads; ++i) workers.emplace_back(&ThreadPool::work, this, i);
+	}
+
+	//fXgN^
+	virtual ~ThreadPool() {
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			quit = true;
+		}
+		start.notify_all();
+		for (auto& worker : workers) worker.join();
+	}
+
+	//Ăяo܂ރXbh̐
+	unsigned int size() const { return static_cast<unsigned int>(workers.size()) + 1; }
+
+	//0count-1܂ł̔ԍɂfɌĂяoASI܂ő҂
+	//count:vf
+	//f:f(index, thread)̌`ŌĂяoAthread0size()-1܂ł̃Xbh̔ԍ
+	//f̒ĂparallelFor͓qɂAĂяoXbhł̏ŏ
+	template<typename F>
+	void parallelFor(unsigned int count, const F& f) {
+		if (count == 0) return;
+
+		//[J[ȂvfAWu̒Ă΂ꂽ炻̏ŏ
+		if (workers.empty() || count == 1 || inJob()) {
+			const unsigned int thread(currentThread());
+			for (unsigned int i = 0; i < count; ++i) f(i, thread);
+			return;
+		}
+
+		std::lock_guard<std::mutex> guard(dispatch);
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			job = [](void* context, unsigned int index, unsigned int thread) {
+				(*static_cast<const F*>(context))(index, thread);
+			};
+			context = const_cast<F*>(&f);
+			this->count = count;
+			next.store(0);
+			active = static_cast<unsigned int>(workers.size());
+			++generation;
+		}
+		start.notify_all();
+
+		//Ăяoɉ
+		run(0);
+
+		//[J[SÎ҂
+		std::unique_lock<std::mutex> lock(mutex);
+		finish.wait(lock, [&] { return active == 0; });
+	}
+};
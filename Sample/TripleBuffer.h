@@ -0,0 +1,60 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+
+//̃Xbh݁Aʂ̈̃XbhŐV̒lǂݏogvobt@
+//O̗̈ݗpA󂯓npAǂݏopɎgA󂯓np̗̈sɌ
+//bNgȂ̂ŏݑǂݏo҂Ȃ
+template<typename T>
+class TripleBuffer {
+	//󂯓np̗̈̔ԍɕti܂Ă܂ǂݏoĂȂj
+	static constexpr std::uint8_t Fresh = 4;
+
+	//O̗̈
+	T buffer[3];
+
+	//ݗp̗̈̔ԍiݑgj
+	std::uint8_t back;
+
+	//󂯓np̗̈̔ԍFresh
+	std::atomic<std::uint8_t> middle;
+
+	//ǂݏop̗̈̔ԍiǂݏogj
+	std::uint8_t front;
+
+	//Rs[֎~
+	TripleBuffer(const TripleBuffer&) = delete;
+	TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+public:
+	//RXgN^
+	//initial:O̗̈̏l
+	explicit TripleBuffer(const T& initial = T())
+		:buffer{ initial, initial, initial }, back(0), middle(1), front(2) {
+	}
+
+	//ݗp̗̈iݑ̃XbhŎgj
+	T& write() { return buffer[back]; }
+
+	//ݗp̗̈ǂݏoɓniݑ̃XbhŎgj
+	void publish() {
+		back = middle.exchange(static_cast<std::uint8_t>(back | Fresh), std::memory_order_acq_rel) & 3;
+	}
+
+	//lœǂݏoɓniݑ̃XbhŎgj
+	void publish(const T& value) {
+		buffer[back] = value;
+		publish();
+	}
+
+	//ŐV̒l󂯎iǂݏõXbhŎgj
+	//߂l:OɎ󂯎ĂVl܂Ătrue
+	bool update() {
+		if (!(middle.load(std::memory_order_relaxed) & Fresh)) return false;
+		front = middle.exchange(front, std::memory_order_acq_rel) & 3;
+		return true;
+	}
+
+	//󂯎liǂݏõXbhŎgj
+	const T& read() const { return buffer[front]; }
+};
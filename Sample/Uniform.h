@@ -1,61 +1,82 @@
 #pragma once
-#include <memory>
+#include <utility>
 #include <GL/glew.h>
 
+//jtH[ubN̒uꏊ
+#include "UniformHeap.h"
+
 //jtH[obt@IuWFNg
+//uniformubNUniformHeap̃y[W狫Eɂ낦Ċ蓖Ă͈͂ɒu
 template<typename T>
 class Uniform {
 	struct UniformBuffer {
-		//jtH[obt@IuWFNg
-		GLuint ubo;
+		//蓖Ă͈
+		UniformHeap::Range range;
 
 		//jtH[ubÑTCY
 		GLsizeiptr blocksize;
 
+		//mۂuniformubN̐
+		unsigned int count;
+
 		//RXgN^
 		//data:uniformubNɊi[f[^
 		//countFmۂuniformubN̐
-		UniformBuffer(const T* data,unsigned int count) {
+		UniformBuffer(const T* data,unsigned int count) :count(count) {
 			//jtH[ubÑTCY߂
-			GLint alignment;
-			glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+			UniformHeap& heap(UniformHeap::instance());
+			const GLsizeiptr alignment(heap.getAlignment());
 			blocksize = (((sizeof(T) - 1) / alignment) + 1) * alignment;
-			//jtH[obt@IuWFNg쐬
-			glGenBuffers(1, &ubo);
-			glBindBuffer(GL_UNIFORM_BUFFER, ubo);
-			glBufferData(GL_UNIFORM_BUFFER, count*blocksize, NULL, GL_STATIC_DRAW);
-			for (unsigned int i = 0; i < count; ++i) {
-				glBufferSubData(GL_UNIFORM_BUFFER, i * blocksize, sizeof(T), data + i);
+			//y[W͈͂蓖Ăi蓖ĂȂΉuȂj
+			range = heap.allocate(count * blocksize);
+			for (unsigned int i = 0; range.page != NULL && data != NULL && i < count; ++i) {
+				range.page->upload(range.handle, data + i, sizeof(T), i * blocksize);
 			}
 		}
 
 		//fXgN^
+		//͈͂iy[W̎gpʂBufferHeapL^j
 		~UniformBuffer() {
-			//jtH[obt@IuWFNg폜
-			glDeleteBuffers(1, &ubo);
+			UniformHeap::instance().free(range);
+		}
+
+		//[uRXgN^i[u͔͈͂ȂȂj
+		UniformBuffer(UniformBuffer&& o) noexcept
+			:range(o.range), blocksize(o.blocksize), count(o.count) {
+			o.range.page = NULL;
+			o.count = 0;
 		}
 
+		//Rs[ƃ[u͋֎~
+		UniformBuffer(const UniformBuffer&) = delete;
+		UniformBuffer& operator=(const UniformBuffer&) = delete;
+		UniformBuffer& operator=(UniformBuffer&&) = delete;
 	};
 
-	const std::shared_ptr<const UniformBuffer> buffer;
+	//jtH[obt@iUniformƂɈLj
+	UniformBuffer buffer;
 
 public:
 	//RXgN^
 	//dataFuniformubNɊi[f[^
 	//countFmۂuniformubN̐
-	Uniform(const T* data = NULL,unsigned int count=1) :buffer(new UniformBuffer(data,count)){
+	Uniform(const T* data = NULL,unsigned int count=1) :buffer(data,count){
 	}
 
 	//fXgN^
 	virtual ~Uniform(){}
 
+	//[uŏLڂiRs[͋֎~j
+	Uniform(Uniform&& o) noexcept :buffer(std::move(o.buffer)) {}
+	Uniform(const Uniform&) = delete;
+	Uniform& operator=(const Uniform&) = delete;
+
 	//jtH[obt@IuWFNgɃf[^i[
 	//dataFuniformubNɊi[f[^
 	void set(const T* data,unsigned int start=0,unsigned int count=1) const {
-		glBindBuffer(GL_UNIFORM_BUFFER, buffer->ubo);
-		for (unsigned int i = 0; i < count; ++i) {
+		for (unsigned int i = 0; buffer.range.page != NULL && i < count; ++i) {
 			//f[^]
-			glBufferSubData(GL_UNIFORM_BUFFER, (start+i,*buffer->blocksize, sizeof(T), data+i));
+			buffer.range.page->upload(buffer.range.handle, data + i, sizeof(T), (start + i) * buffer.blocksize);
 		}
 
 	}
@@ -64,7 +85,11 @@ public:
 	//bpF|Cg
 	//iFuniformubN̈ʒu
 	void select(GLuint bp,unsigned int i=0) const {
+		//͈͂蓖ĂȂƂ͌Ȃ
+		if (buffer.range.page == NULL) return;
+
 		//ގɐݒ肷郆jtH[obt@IuWFNgw肷
-		glBindBufferRange(GL_UNIFORM_BUFFER, bp, buffer->ubo,i*buffer->blocksize,sizeof(T));
+		glBindBufferRange(GL_UNIFORM_BUFFER, bp, buffer.range.page->name(),
+			buffer.range.page->byteOffset(buffer.range.handle) + i * buffer.blocksize, sizeof(T));
 	}
 };
\ No newline at end of file
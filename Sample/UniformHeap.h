@@ -0,0 +1,92 @@
+#pragma once
+#include <memory>
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <GL/glew.h>
+
+//傫ȃobt@IuWFNg̈ꕔ̊蓖
+#include "BufferHeap.h"
+
+//jtH[ubN̒uꏊ
+//jtH[obt@IuWFNgʂɍɁA傫ȃobt@IuWFNgiy[Wj
+//GL_UNIFORM_BUFFER_OFFSET_ALIGNMENTɂ낦͈͂蓖āAglBindBufferRangeŌ
+//y[WȂΒǉAɂȂy[W͍폜iIɂׂ͂ĂUniformƂƂɏj
+class UniformHeap {
+public:
+	//蓖Ă͈
+	struct Range {
+		//͈͂蓖Ăy[Wi蓖ĂĂȂNULLj
+		BufferHeap* page;
+
+		//y[W͈̒̔
+		BufferHeap::Handle handle;
+	};
+
+private:
+	//̃y[W̃oCg
+	static constexpr std::size_t PageSize = 64 << 10;
+
+	//y[W
+	std::vector<std::unique_ptr<BufferHeap>> pages;
+
+	//͈͂̈ʒűEioCgA0Ȃ疢擾j
+	GLint alignment;
+
+	//RXgN^
+	UniformHeap() :alignment(0) {}
+
+	//Rs[֎~
+	UniformHeap(const UniformHeap&) = delete;
+	UniformHeap& operator=(const UniformHeap&) = delete;
+
+public:
+	//B̃CX^Xo
+	static UniformHeap& instance() {
+		static UniformHeap heap;
+		return heap;
+	}
+
+	//͈͂̈ʒűEiOpenGL̃ReLXgɌĂԁj
+	GLsizeiptr getAlignment() {
+		if (alignment == 0) {
+			glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+			if (alignment <= 0) alignment = 256;
+		}
+		return alignment;
+	}
+
+	//͈͂蓖Ă
+	//bytes:oCg
+	//߂l:蓖Ắ͈i蓖ĂȂpageNULLj
+	Range allocate(std::size_t bytes) {
+		const std::size_t a(static_cast<std::size_t>(getAlignment()));
+		for (const auto& page : pages) {
+			const BufferHeap::Handle handle(page->allocate(bytes, a));
+			if (handle != BufferAllocator::Invalid) return Range{ page.get(), handle };
+		}
+
+		//ǂ̃y[WɂȂ΃y[WǉiEɂ낦錄Ԃ̕傫j
+		pages.emplace_back(new BufferHeap(std::max(PageSize, bytes + a), 1, GpuMemory::Uniform, GL_DYNAMIC_DRAW));
+		const BufferHeap::Handle handle(pages.back()->allocate(bytes, a));
+		if (handle == BufferAllocator::Invalid) {
+			std::cerr << "Error: UniformHeap is full." << std::endl;
+			pages.pop_back();
+			return Range{ NULL, BufferAllocator::Invalid };
+		}
+		return Range{ pages.back().get(), handle };
+	}
+
+	//͈͂iy[WɂȂ΍폜j
+	//range:allocateœ͈
+	void free(const Range& range) {
+		if (range.page == NULL) return;
+		range.page->free(range.handle);
+		if (range.page->getStats().allocations > 0) return;
+		pages.erase(std::find_if(pages.begin(), pages.end(),
+			[&](const std::unique_ptr<BufferHeap>& page) { return page.get() == range.page; }));
+	}
+
+	//y[W̐
+	std::size_t size() const { return pages.size(); }
+};
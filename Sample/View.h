@@ -0,0 +1,162 @@
+#pragma once
+#include <chrono>
+#include <algorithm>
+#include <GL/glew.h>
+
+//ϊs
+#include "Matrix.h"
+
+//`܂Ƃ߂Ĕs
+#include "IndirectBatch.h"
+
+//CPUɂIN[WJO
+#include "OcclusionCulling.h"
+
+//v
+#include "Profiler.h"
+
+//̃Jŕ`ʂ̗̈
+//`͓iKɕ
+//record:JOĕ`ob`ɏW߂iOpenGLĂ΂Ȃ̂Ńr[Ƃɕʂ̃XbhŎsłj
+//submit:ReLXgΏۂɂĂr[|[gݒ肵ăob`𔭍si`̃XbhŏɎsj
+class View {
+public:
+	//t[obt@ɑ΂r[|[g̊i0AEオ1j
+	struct Rect {
+		GLfloat x, y, width, height;
+	};
+
+private:
+	//`EBhẼReLXg̔ԍ
+	const unsigned int context;
+
+	//r[|[g̊
+	Rect rect;
+
+	//r[|[gifj
+	GLint viewport[4];
+
+	//EBhE̒̃r[|[gifAI𑜓xŏkȂviewportƓj
+	GLint output[4];
+
+	//r[ϊsƓeϊs
+	Matrix view, projection;
+
+	//̃r[̕`
+	IndirectBatch batch;
+
+	//̃r[̃IN[WJO
+	OcclusionCulling occlusion;
+
+	//recordɂԁi~bj
+	double recordTime;
+
+	//Rs[֎~
+	View(const View&) = delete;
+	View& operator=(const View&) = delete;
+
+public:
+	//RXgN^
+	//meshes:`悷}`i[obt@
+	//pool:IN[WJOɎgXbh
+	//context:`EBhẼReLXg̔ԍiMeshBuffer::bindɓnj
+	//rect:t[obt@ɑ΂r[|[g̊
+	View(const MeshBuffer& meshes, ThreadPool& pool, unsigned int context, const Rect& rect)
+		:context(context), rect(rect), viewport(), output(), view(Matrix::identity()), projection(Matrix::identity())
+		, batch(meshes), occlusion(pool), recordTime(0.0)
+	{
+	}
+
+	//fXgN^
+	virtual ~View() {}
+
+	//t[obt@̃TCYr[|[g߂
+	//framebufferSize:t[obt@̕ƍ
+	//scale:I𑜓x̔{i0ȂkɃEBhEɒڕ`AȂ`̍ɏkĕ`j
+	void setFramebufferSize(const GLsizei* framebufferSize, GLfloat scale = 0.0f) {
+		output[0] = static_cast<GLint>(rect.x * framebufferSize[0]);
+		output[1] = static_cast<GLint>(rect.y * framebufferSize[1]);
+		output[2] = static_cast<GLint>(rect.width * framebufferSize[0]);
+		output[3] = static_cast<GLint>(rect.height * framebufferSize[1]);
+		if (scale > 0.0f) {
+			viewport[0] = viewport[1] = 0;
+			viewport[2] = std::max(static_cast<GLint>(output[2] * scale + 0.5f), 1);
+			viewport[3] = std::max(static_cast<GLint>(output[3] * scale + 0.5f), 1);
+		}
+		else {
+			std::copy(output, output + 4, viewport);
+		}
+	}
+
+	//r[|[g̏c
+	GLfloat getAspect() const {
+		return viewport[3] > 0 ? static_cast<GLfloat>(viewport[2]) / static_cast<GLfloat>(viewport[3]) : 1.0f;
+	}
+
+	//Jݒ肷
+	//v:r[ϊs
+	//p:eϊs
+	void setCamera(const Matrix& v, const Matrix& p) {
+		view = v;
+		projection = p;
+	}
+
+	//JOĕ`W߂iOpenGLĂ΂Ȃj
+	//f:f(view)̌`ŌĂяoAgetOcclusiongetBatchŕ`W߂
+	template<typename F>
+	void record(F f) {
+		const auto t0(std::chrono::high_resolution_clock::now());
+		occlusion.clear();
+		batch.clear();
+		f(*this);
+		recordTime = Profiler::elapsed(t0);
+	}
+
+	//r[|[gݒ肵ďĩr[̃ReLXgΏۂɂȂĂ邱Ɓj
+	void begin() const {
+		glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+		glScissor(viewport[0], viewport[1], viewport[2], viewport[3]);
+		glEnable(GL_SCISSOR_TEST);
+		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+	}
+
+	//W߂`𔭍sibegin̂Ƃuniformϐݒ肵ĂĂԁj
+	//mode:{}`̎
+	//material:ގ̃jtH[obt@IuWFNg
+	//textures:ގ̔ԍňeNX`IuWFNgiNULLȂ猋Ȃj
+	void submit(GLenum mode, const Uniform<Material>& material, const GLuint* textures = NULL) {
+		batch.draw(mode, material, context, textures);
+		end();
+	}
+
+	//r[̕`IiVU[eXg𖳌ɂj
+	void end() const {
+		glDisable(GL_SCISSOR_TEST);
+	}
+
+	//`EBhẼReLXg̔ԍ
+	unsigned int getContext() const { return context; }
+
+	//r[|[gix, y, , j
+	const GLint* getViewport() const { return viewport; }
+
+	//EBhE̒̃r[|[gix, y, , j
+	const GLint* getOutputViewport() const { return output; }
+
+	//r[ϊs
+	const Matrix& getView() const { return view; }
+
+	//eϊs
+	const Matrix& getProjection() const { return projection; }
+
+	//̃r[̕`
+	IndirectBatch& getBatch() { return batch; }
+	const IndirectBatch& getBatch() const { return batch; }
+
+	//̃r[̃IN[WJO
+	OcclusionCulling& getOcclusion() { return occlusion; }
+	const OcclusionCulling& getOcclusion() const { return occlusion; }
+
+	//recordɂԁi~bj
+	double getRecordTime() const { return recordTime; }
+};
@@ -3,28 +3,40 @@
 #include<GL/glew.h>
 #include<GLFW/glfw3.h>
 
+//͂̃Cxg
+#include "Input.h"
+#include "SpscRing.h"
+
 //EBhE֘Ȁ
 class Window {
+public:
+	//͂̃Cxg̃L[i`摤̃XbhŒǉAV~[ṼXbhŎoj
+	typedef SpscRing<InputEvent, 1024> EventQueue;
+
+private:
 	//EBhẼnh
 	GLFWwindow* const window;
 
 	//EBhẼTCY
 	GLfloat size[2];
 
-	//[hWnɑ΂foCXWn̊g嗦
-	GLfloat scale;
+	//t[obt@̃TCY
+	GLsizei framebufferSize[2];
 
-	//}`̐KfoCXWnł̈ʒu
-	GLfloat location[2];
+	//͂̃Cxg
+	EventQueue events;
 
-	//L[{[h̏
-	int keyStatus;
+	//CxgɎtăL[ɓ
+	void push(InputEvent::Type type, int code, int action, float x, float y) {
+		const InputEvent event = { type, code, action, x, y, glfwGetTime() };
+		events.push(event);
+	}
 
 public:
 	//RXgN^
-	Window(int width = 640, int height = 480, const char* title = "Hello") :
-		window(glfwCreateWindow(width, height, title, NULL, NULL)) 
-		,scale(100.0f),location{0.0f,0.0f},keyStatus(GLFW_RELEASE)
+	//share:OpenGL̎LEBhEiNULLȂ狤LȂj
+	Window(int width = 640, int height = 480, const char* title = "Hello", const Window* share = NULL) :
+		window(glfwCreateWindow(width, height, title, NULL, share != NULL ? share->window : NULL)) 
 	{
 
 		if (window == NULL)
@@ -47,7 +59,8 @@ public:
 
 		//̃^C~O҂
 		//J[obt@̓ւ̃^C~Ow肷
-		glfwSwapInterval(1);
+		//ڈȍ~̃EBhE͍ŏ̃EBhE̓ւő҂̂ő҂Ȃ
+		glfwSwapInterval(share != NULL ? 0 : 1);
 
 		//EBhETCYύXɌĂяo̓o^
 		glfwSetWindowSizeCallback(window, resize);
@@ -58,6 +71,12 @@ public:
 		//L[{[h̑쎞ɌĂяo̓o^
 		glfwSetKeyCallback(window, keyboard);
 
+		//}EX{^̑쎞ɌĂяo̓o^
+		glfwSetMouseButtonCallback(window, mouse);
+
+		//}EXJ[\̈ړɌĂяo̓o^
+		glfwSetCursorPosCallback(window, cursor);
+
 		//̃CX^Xthis|C^L^Ă
 		glfwSetWindowUserPointer(window, this);
 
@@ -73,27 +92,31 @@ public:
 	//`惋[v̌p
 	explicit operator bool() {
 		//Cxgo
+		//L[}EX̑̓R[obN֐ŃCxg̃L[ɓ
 		glfwPollEvents();
-		
-		//L[{[h̏Ԃ𒲂ׂ
-		if (glfwGetKey(window, GLFW_KEY_LEFT) != GLFW_RELEASE) location[0] -= 2.0f / size[0];
-		else if (glfwGetKey(window, GLFW_KEY_RIGHT) != GLFW_RELEASE) location[0] += 2.0f / size[0];
-		if (glfwGetKey(window, GLFW_KEY_DOWN) != GLFW_RELEASE) location[1] -= 2.0f / size[1];
-		else if (glfwGetKey(window, GLFW_KEY_UP) != GLFW_RELEASE) location[1] += 2.0f / size[1];
-
-		//}EX̍{^̏Ԃ𒲂ׂ
-		if (glfwGetMouseButton(window, GLFW_MOUSE_BUTTON_1 != GLFW_RELEASE)) {
-			//{^Ă}EXJ[\̈ʒu擾
-			double x, y;
-			glfwGetCursorPos(window, &x, &y);
-
-			//}EXJ[\̐KfoCXWnł̈ʒu߂Ahieght͔]
-			location[0] = static_cast<GLfloat>(x) * 2.0f / size[0] - 1.0f;
-			location[1] = 1.0f - static_cast<GLfloat>(y) * 2.0f / size[1];
-
-			//EBhEKvȂtrueԂ
-		}
-		return !glfwWindowShouldClose(window)&&!glfwGetKey(window,GLFW_KEY_ESCAPE);
+
+		//EBhEKvȂtrueԂ
+		return !glfwWindowShouldClose(window);
+	}
+
+	//̃EBhẼReLXgΏۂɂ
+	void makeCurrent() const {
+		glfwMakeContextCurrent(window);
+	}
+
+	//̃EBhEƎL錩ȂReLXgiق̃XbhŃVF[_[RpĈɎgj
+	//Ώۂ̃ReLXg͕ςȂACXbhŌĂяoĕsvɂȂglfwDestroyWindowŔj
+	//߂l:쐬ReLXg̃EBhEA쐬łȂNULL
+	GLFWwindow* createSharedContext() const {
+		glfwWindowHint(GLFW_VISIBLE, GL_FALSE);
+		GLFWwindow* const context(glfwCreateWindow(1, 1, "", NULL, window));
+		glfwWindowHint(GLFW_VISIBLE, GL_TRUE);
+		return context;
+	}
+
+	//EBhEKvtrue
+	bool shouldClose() const {
+		return glfwWindowShouldClose(window) != 0;
 	}
 
 	//_uobt@O
@@ -105,20 +128,24 @@ public:
 	//EBhẼTCYύX̏
 	static void resize(GLFWwindow* const window, int width, int height) {
 		//t[obt@̃TCY𒲂ׂ
+		//r[|[g͕`悷ƂɃr[Ƃɐݒ肷
 		int fbWidth, fbHeight;
 		glfwGetFramebufferSize(window, &fbWidth, &fbHeight);
 
-		//t[obt@Ŝr[|[gɐݒ肷
-		glViewport(0, 0, fbWidth, fbHeight);
-
 		//̃CX^Xthis|C^𓾂
 		Window* const
 			instance(static_cast<Window*>(glfwGetWindowUserPointer(window)));
 		if (instance != NULL) {
-			
+			//t[obt@̃TCYۑ
+			instance->framebufferSize[0] = fbWidth;
+			instance->framebufferSize[1] = fbHeight;
+
 			//JEBhẼTCYۑ
 			instance->size[0] = static_cast<GLfloat>(width);
 			instance->size[1] = static_cast<GLfloat>(height);
+
+			//V~[Vɂm点
+			instance->push(InputEvent::Resize, 0, 0, instance->size[0], instance->size[1]);
 		}
 	}
 
@@ -128,8 +155,8 @@ public:
 		Window* const instance(static_cast<Window*>(glfwGetWindowUserPointer(window)));
 
 		if (instance != NULL) {
-			//[hWnɑ΂foCXWn̊g嗦XV
-			instance->scale += static_cast<GLfloat>(y);
+			//]ʂCxgɂ
+			instance->push(InputEvent::Scroll, 0, 0, static_cast<float>(x), static_cast<float>(y));
 		}
 	}
 
@@ -139,8 +166,35 @@ public:
 		Window* const instance(static_cast<Window*>(glfwGetWindowUserPointer(window)));
 
 		if (instance != NULL) {
-			//L[̏Ԃۑ
-			instance->keyStatus = action;
+			//L[̑Cxgɂ
+			instance->push(InputEvent::Key, key, action, 0.0f, 0.0f);
+		}
+
+		//ESCL[ŃEBhE
+		if (key == GLFW_KEY_ESCAPE && action == GLFW_PRESS) glfwSetWindowShouldClose(window, GL_TRUE);
+	}
+
+	//}EX{^쎞̏
+	static void mouse(GLFWwindow* window, int button, int action, int mods) {
+		//̃CX^Xthis|C^𓾂
+		Window* const instance(static_cast<Window*>(glfwGetWindowUserPointer(window)));
+
+		if (instance != NULL) {
+			//{^̑Cxgɂ
+			instance->push(InputEvent::MouseButton, button, action, 0.0f, 0.0f);
+		}
+	}
+
+	//}EXJ[\ړ̏
+	static void cursor(GLFWwindow* window, double x, double y) {
+		//̃CX^Xthis|C^𓾂
+		Window* const instance(static_cast<Window*>(glfwGetWindowUserPointer(window)));
+
+		if (instance != NULL) {
+			//}EXJ[\̐KfoCXWnł̈ʒu߂Aheight͔]
+			instance->push(InputEvent::Cursor, 0, 0,
+				static_cast<GLfloat>(x) * 2.0f / instance->size[0] - 1.0f,
+				1.0f - static_cast<GLfloat>(y) * 2.0f / instance->size[1]);
 		}
 	}
 
@@ -148,9 +202,10 @@ public:
 	//EBhẼTCYo
 	const GLfloat* getSize() const { return size; }
 
-	//[hWnɑ΂foCXWn̊g嗦o
-	GLfloat getScale() const { return scale; }
+	//t[obt@̃TCYo
+	const GLsizei* getFramebufferSize() const { return framebufferSize; }
 
-	const GLfloat* getLocation() const { return location; }
+	//͂̃Cxg̃L[o
+	EventQueue& getEvents() { return events; }
 
 };
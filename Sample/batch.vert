@@ -0,0 +1,18 @@
+#version 150 core
+uniform mat4 projection;
+in vec4 position;
+in vec3 normal;
+in vec2 texcoord;
+in mat4 instanceModelview;
+in mat3 instanceNormalMatrix;
+out vec4 P;
+out vec3 N;
+out vec2 T;
+invariant gl_Position;
+void main()
+{
+	P=instanceModelview*position;
+	N=normalize(instanceNormalMatrix*normal);
+	T=texcoord;
+	gl_Position = projection*P;
+}
\ No newline at end of file
@@ -0,0 +1,7 @@
+#version 150 core
+in vec4 C;
+out vec4 fragment;
+void main()
+{
+	fragment=C;
+}
\ No newline at end of file
@@ -0,0 +1,10 @@
+#version 150 core
+uniform mat4 projection;
+in vec4 position;
+in vec4 color;
+out vec4 C;
+void main()
+{
+	C=color;
+	gl_Position=projection*position;
+}
\ No newline at end of file
@@ -0,0 +1,82 @@
+#version 150 core
+uniform vec4 Lpos;
+uniform vec3 Lamb;
+uniform vec3 Ldiff;
+uniform vec3 Lspec;
+const int MaxCascades=4;
+uniform sampler2DArrayShadow shadowMap;
+uniform mat4 shadowMatrix[MaxCascades];
+uniform float cascadeFar[MaxCascades];
+uniform int cascadeCount;
+uniform sampler2D gNormal;
+uniform sampler2D gDiffuse;
+uniform sampler2D gSpecular;
+uniform sampler2D gAmbient;
+uniform sampler2D gDepth;
+uniform mat4 inverseProjection;
+uniform vec2 viewportOrigin;
+uniform vec2 viewportSize;
+out vec4 fragment;
+uniform sampler3D probeMap;
+uniform mat4 probeMatrix;
+uniform mat3 probeRotation;
+uniform vec3 probeSize;
+vec3 ambient(vec3 P,vec3 N,vec3 Lamb)
+{
+	if(probeSize.x==0.0)return Lamb;
+	vec3 g=clamp((probeMatrix*vec4(P,1.0)).xyz,vec3(0.0),probeSize-1.0);
+	vec3 n=normalize(probeRotation*N);
+	vec2 t=(g.xy+0.5)/probeSize.xy;
+	float depth=probeSize.z*7.0;
+	vec4 c0=texture(probeMap,vec3(t,(g.z+0.5)/depth));
+	vec4 c1=texture(probeMap,vec3(t,(probeSize.z+g.z+0.5)/depth));
+	vec4 c2=texture(probeMap,vec3(t,(probeSize.z*2.0+g.z+0.5)/depth));
+	vec4 c3=texture(probeMap,vec3(t,(probeSize.z*3.0+g.z+0.5)/depth));
+	vec4 c4=texture(probeMap,vec3(t,(probeSize.z*4.0+g.z+0.5)/depth));
+	vec4 c5=texture(probeMap,vec3(t,(probeSize.z*5.0+g.z+0.5)/depth));
+	vec4 c6=texture(probeMap,vec3(t,(probeSize.z*6.0+g.z+0.5)/depth));
+	vec3 E=0.282095*c0.xyz
+		+0.488603*(n.y*vec3(c0.w,c1.xy)+n.z*vec3(c1.zw,c2.x)+n.x*c2.yzw)
+		+1.092548*(n.x*n.y*c3.xyz+n.y*n.z*vec3(c3.w,c4.xy)+n.x*n.z*c5.yzw)
+		+0.315392*(3.0*n.z*n.z-1.0)*vec3(c4.zw,c5.x)
+		+0.546274*(n.x*n.x-n.y*n.y)*c6.xyz;
+	return max(E,vec3(0.0));
+}
+float shadow(vec4 P)
+{
+	float d=-P.z;
+	if(cascadeCount==0||d>cascadeFar[cascadeCount-1])return 1.0;
+	int c=0;
+	while(c<cascadeCount-1&&d>cascadeFar[c])++c;
+	vec4 S=shadowMatrix[c]*P;
+	vec3 s=S.xyz/S.w;
+	vec2 texel=1.0/vec2(textureSize(shadowMap,0).xy);
+	float lit=0.0;
+	for(int y=-1;y<=1;++y){
+		for(int x=-1;x<=1;++x){
+			lit+=texture(shadowMap,vec4(s.xy+vec2(x,y)*texel,float(c),min(s.z,1.0)));
+		}
+	}
+	return lit/9.0;
+}
+void main()
+{
+	vec2 f=gl_FragCoord.xy-viewportOrigin;
+	ivec2 t=ivec2(f);
+	float z=texelFetch(gDepth,t,0).r;
+	if(z>=1.0)discard;
+	vec4 q=inverseProjection*vec4(f/viewportSize*2.0-1.0,z*2.0-1.0,1.0);
+	vec4 P=vec4(q.xyz/q.w,1.0);
+	vec4 n=texelFetch(gNormal,t,0);
+	vec3 N=n.xyz;
+	vec3 Kdiff=texelFetch(gDiffuse,t,0).rgb;
+	vec3 Kspec=texelFetch(gSpecular,t,0).rgb;
+	vec3 Kamb=texelFetch(gAmbient,t,0).rgb;
+	vec3 V=-normalize(P.xyz);
+	vec3 L=normalize((Lpos*P.w-P*Lpos.w).xyz);
+	vec3 H=normalize(L+V);
+	float Is=shadow(P);
+	vec3 Idiff=Is*max(dot(N,L),0.0)*Kdiff*Ldiff+Kamb*ambient(P.xyz,N,Lamb);
+	vec3 Ispec=Is*pow(max(dot(N,H),0.0),n.w)*Kspec*Lspec;
+	fragment=vec4(Idiff+Ispec,1.0);
+}
\ No newline at end of file
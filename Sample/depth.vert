@@ -0,0 +1,10 @@
+#version 150 core
+uniform mat4 projection;
+in vec4 position;
+in mat4 instanceModelview;
+invariant gl_Position;
+void main()
+{
+	vec4 P=instanceModelview*position;
+	gl_Position = projection*P;
+}
\ No newline at end of file
@@ -0,0 +1,48 @@
+#version 150 core
+uniform vec3 origin;
+uniform float radius;
+uniform vec3 initialVelocity;
+uniform float spread;
+uniform float lifetime;
+uniform vec3 gravity;
+uniform float damping;
+uniform float ground;
+uniform float bounce;
+uniform float dt;
+uniform uint seed;
+in vec4 position;
+in vec4 velocity;
+out vec4 outPosition;
+out vec4 outVelocity;
+float random(inout uint s)
+{
+	s=s*1664525u+1013904223u;
+	return float(s>>8u)*(2.0/16777216.0)-1.0;
+}
+void main()
+{
+	vec3 p=position.xyz;
+	vec3 v=velocity.xyz;
+	float life=velocity.w;
+	float t=position.w+dt/life;
+	if(t>=1.0||(position.w<0.0&&t>=0.0))
+	{
+		uint s=uint(gl_VertexID)*747796405u+seed;
+		p=origin+vec3(random(s),random(s),random(s))*radius;
+		v=initialVelocity+vec3(random(s),random(s),random(s))*spread;
+		life=lifetime*(0.875+0.125*random(s));
+		t=0.0;
+	}
+	else if(t>=0.0)
+	{
+		v=(v+gravity*dt)*damping;
+		p+=v*dt;
+		if(p.y<ground&&v.y<0.0)
+		{
+			p.y=ground;
+			v.y=-v.y*bounce;
+		}
+	}
+	outPosition=vec4(p,t);
+	outVelocity=vec4(v,life);
+}
\ No newline at end of file
@@ -0,0 +1,21 @@
+#version 150 core
+layout (std140) uniform Material{
+	vec3 Kamb;
+	vec3 Kdiff;
+	vec3 Kspec;
+	float Kshi;
+	int Ktex;
+};
+in vec4 P;
+in vec3 N;
+in vec2 T;
+uniform sampler2D diffuseMap;
+out vec4 fragment[4];
+void main()
+{
+	vec3 albedo=Ktex!=0?texture(diffuseMap,T).rgb:vec3(1.0);
+	fragment[0]=vec4(normalize(N),Kshi);
+	fragment[1]=vec4(albedo*Kdiff,1.0);
+	fragment[2]=vec4(Kspec,1.0);
+	fragment[3]=vec4(albedo*Kamb,1.0);
+}
\ No newline at end of file
@@ -0,0 +1,36 @@
+#version 150 core
+const int MaxPointLights=256;
+layout (std140) uniform PointLights{
+	vec4 pointPosition[MaxPointLights];
+	vec4 pointColor[MaxPointLights];
+};
+uniform sampler2D gNormal;
+uniform sampler2D gDiffuse;
+uniform sampler2D gSpecular;
+uniform sampler2D gDepth;
+uniform mat4 inverseProjection;
+uniform vec2 viewportOrigin;
+uniform vec2 viewportSize;
+flat in int light;
+out vec4 fragment;
+void main()
+{
+	vec2 f=gl_FragCoord.xy-viewportOrigin;
+	ivec2 t=ivec2(f);
+	float z=texelFetch(gDepth,t,0).r;
+	if(z>=1.0)discard;
+	vec4 q=inverseProjection*vec4(f/viewportSize*2.0-1.0,z*2.0-1.0,1.0);
+	vec3 P=q.xyz/q.w;
+	vec3 D=pointPosition[light].xyz-P;
+	float d=length(D);
+	float a=clamp(1.0-d/pointPosition[light].w,0.0,1.0);
+	if(a<=0.0)discard;
+	vec4 n=texelFetch(gNormal,t,0);
+	vec3 N=n.xyz;
+	vec3 L=D/d;
+	vec3 V=-normalize(P);
+	vec3 H=normalize(L+V);
+	vec3 Idiff=max(dot(N,L),0.0)*texelFetch(gDiffuse,t,0).rgb;
+	vec3 Ispec=pow(max(dot(N,H),0.0),n.w)*texelFetch(gSpecular,t,0).rgb;
+	fragment=vec4(a*a*(Idiff+Ispec)*pointColor[light].rgb,1.0);
+}
\ No newline at end of file
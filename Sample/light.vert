@@ -0,0 +1,16 @@
+#version 150 core
+const int MaxPointLights=256;
+layout (std140) uniform PointLights{
+	vec4 pointPosition[MaxPointLights];
+	vec4 pointColor[MaxPointLights];
+};
+uniform mat4 projection;
+uniform float volumeScale;
+in vec4 position;
+flat out int light;
+void main()
+{
+	light=gl_InstanceID;
+	vec4 l=pointPosition[gl_InstanceID];
+	gl_Position=projection*vec4(l.xyz+position.xyz*l.w*volumeScale,1.0);
+}
\ No newline at end of file
@@ -1,258 +1,213 @@
 #include <cstdlib>
+#include <cstring>
+#include <cstdio>
 #include <iostream>
 #include <fstream>
 #include <vector>
 #include <memory>
+#include <new>
+#include <atomic>
+#include <cstdint>
+#include <algorithm>
+#include <string>
 #include <GL/glew.h>
 #include <GLFW/glfw3.h>
 #include <cmath>
 #include "Window.h"
 #include "Matrix.h"
+#include "FixedMath.h"
 #include "vector.h"
 #include "Shape.h"
 #include "ShapeIndex.h"
 #include "SolidShapeIndex.h"
 #include "SolidShape.h"
+#include "Sphere.h"
 #include "Uniform.h"
 #include "Material.h"
-
-//VF[_[IuWFNg̃RpCʂ\
-//shader:VF[_[IuWFNg
-//str:RpCG[ꏊ
-GLboolean printShaderInfoLog(GLuint shader, const char* str) {
-	//RpCʂ擾
-	GLint status;
-	//VF[_IuWFNg̏o
-	glGetShaderiv(shader, GL_COMPILE_STATUS, &status);
-	if (status == GL_FALSE)std::cerr << "Compile Error in " << str << std::endl;
-
-	//VF[_[RpC̃O̒擾
-	GLsizei bufSize;
-	glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &bufSize);
-
-	if (bufSize > 1) {
-		//VF[_[RpC̃Oe擾
-		std::vector<GLchar> infoLog(bufSize);
-		GLsizei length;
-		glGetShaderInfoLog(shader, bufSize, &length, &infoLog[0]);
-		std::cerr << &infoLog[0] << std::endl;
-	}
-	return static_cast<GLboolean>(status);
+#include "Shader.h"
+#include "ThreadPool.h"
+#include "Profiler.h"
+#include "OcclusionCulling.h"
+#include "MeshBuffer.h"
+#include "IndirectBatch.h"
+#include "GpuMemory.h"
+#include "FrameArena.h"
+#include "SceneGraph.h"
+#include "FrameScheduler.h"
+#include "FramePacer.h"
+#include "Input.h"
+#include "View.h"
+#include "CascadedShadow.h"
+#include "PointLights.h"
+#include "DeferredRenderer.h"
+
+//VF[_[̓ǂݒ
+#include "HotReload.h"
+
+//J[\̉̐}`I
+#include "Picker.h"
+
+//L[t[Aj[V
+#include "Animation.h"
+
+//eNX`
+#include "TextureCache.h"
+
+//bVbg̃JO
+#include "Meshlets.h"
+
+//p[eBN
+#include "Particles.h"
+
+//mFp̐ƕ
+#include "DebugDraw.h"
+
+//̃v[ȕĂtƊ
+#include "LightProbes.h"
+
+//t[̎Ԃɍ킹I𑜓x
+#include "ResolutionController.h"
+#include "DynamicResolution.h"
+#include "AllocationCounter.h"
+#include "Benchmark.h"
+#include "SelfTest.h"
+
+//q[v̊mۂ̉񐔂𐔂邽߂operator newoperator deleteu
+//zƋEw肷`uAׂĂ̊mۂmallocōsĐAfreeŉ
+//ĂяoɓWJmallocoperator deletȇgݍ킹Čx̂œWJȂ
+#if defined(_MSC_VER)
+#define REPLACED_ALLOCATION __declspec(noinline)
+#else
+#define REPLACED_ALLOCATION __attribute__((noinline))
+#endif
+REPLACED_ALLOCATION void* operator new(std::size_t size) {
+	AllocationCounter::add();
+	if (void* const p = std::malloc(size > 0 ? size : 1)) return p;
+	throw std::bad_alloc();
 }
-
-//vOIuWFNg̃Nʂ\
-//program:vOIuWFNg
-GLboolean printProgramInfoLog(GLuint program) {
-	//Nʂ擾
-	GLint status;
-	glGetProgramiv(program, GL_LINK_STATUS, &status);
-	if (status == GL_FALSE)std::cerr << "LinkError." << std::endl;
-
-	//VF[_[ÑO̒擾
-	GLsizei bufSize;
-	glGetProgramiv(program, GL_INFO_LOG_LENGTH, &bufSize);
-
-	if (bufSize > 1) {
-		//VF[_[ÑO̓e擾
-		std::vector<GLchar> infoLog(bufSize);
-		GLsizei length;
-		glGetProgramInfoLog(program, bufSize, &length, &infoLog[0]);
-		std::cerr << &infoLog[0] << std::endl;
-	}
-	return static_cast<GLboolean>(status);
+REPLACED_ALLOCATION void* operator new[](std::size_t size) {
+	return operator new(size);
 }
-
-
-//vOIuWFNg쐬
-//vsrc:o[ebNXVF[_[̃\[XvO̕
-//fsrc:tOgVF[_[̃\[XvO̕
-GLuint createProgram(const char* vsrc, const char* fsrc) {
-	//̃IuWFNg쐬
-	const GLuint program(glCreateProgram());
-
-	if (vsrc != NULL) {
-		//o[ebNXVF[_[̃VF[_[IuWFNg쐬
-		const GLuint vobj(glCreateShader(GL_VERTEX_SHADER));
-		//VF[_IuWFNgɑ΂ă\[XvOǂݍ
-		glShaderSource(vobj, 1, &vsrc, NULL);
-		//VF[_IuWFNgɓǂݍ܂ꂽ\[Xt@CRpC
-		glCompileShader(vobj);
-
-		//Ă΃o[ebNXVF[_[̃VF[_[IuWFNgvOIuWFNgɑgݍ
-		if (printShaderInfoLog(vobj, "vertex shader"))
-			//vOIuWFNgɃVF[_IuWFNggݍ
-			glAttachShader(program, vobj);
-		//폜}[N
-		glDeleteShader(vobj);
-	}
-
-	if (fsrc != NULL) {
-		//tOgVF[_[̃VF[_[IuWFNg쐬
-		const GLuint fobj(glCreateShader(GL_FRAGMENT_SHADER));
-		glShaderSource(fobj, 1, &fsrc, NULL);
-		glCompileShader(fobj);
-
-		//Ă΃tOgVF[_[̃VF[_[IuWFNgvOIuWFNgɑgݍ
-		if(printShaderInfoLog(fobj,"fragment shader"))
-			glAttachShader(program, fobj);
-		glDeleteShader(fobj);
-	}
-
-	//vOIuWFNgN
-	//Attributeϐ̏ꏊw肵Ă(inϐoutϐ)
-	glBindAttribLocation(program, 0, "position");
-	glBindAttribLocation(program, 1, "normal");
-	glBindFragDataLocation(program,0,"fragment");
-	//programɎw肵vOIuWFNgNĂ
-	glLinkProgram(program);
-
-	//Ă΍쐬vOIuWFNgԂ
-	if(printProgramInfoLog(program))
-		return program;
-
-	//vOIuWFNg쐬łȂ0Ԃ
-	glDeleteProgram(program);
-	return 0;
+REPLACED_ALLOCATION void operator delete(void* p) noexcept {
+	std::free(p);
 }
-
-
-//VF[_[̃\[Xt@Cǂݍ񂾃Ԃ
-//name:VF[_[̃\[Xt@C
-//buffer:ǂݍ񂾃\[Xt@C̃eLXg
-bool readShaderSource(const char* name, std::vector<GLchar>& buffer) {
-	//t@CNULL
-	if (name == NULL)return false;
-
-	//\[Xt@CJ
-	std::ifstream file(name, std::ios::binary);
-	if (file.fail()) {
-		//JȂ
-		std::cerr << "Error: Can't open source file: " << name << std::endl;
-		return false;
-	}
-
-	//t@C̖Ɉړ݈ʒu(=t@CTCY)𓾂
-	file.seekg(0L, std::ios::end);
-	GLsizei length = static_cast<GLsizei>(file.tellg());
-
-	//t@CTCỸm
-	buffer.resize(length + 1);
-
-	//t@C擪疖܂œǂݍ
-	file.seekg(0L,std::ios::beg);
-	file.read(buffer.data(), length);
-	buffer[length] = '\0';
-	
-	if (file.fail()) {
-		//܂ǂݍ߂Ȃ
-		std::cerr << "Error: Could not read souce file:" << name << std::endl;
-		file.close();
-		return false;
-	}
-
-	//ǂݍݐ
-	file.close();
-	return true;
+REPLACED_ALLOCATION void operator delete[](void* p) noexcept {
+	std::free(p);
 }
-
-//VF[_[̃\[Xt@CǂݍŃvOIuWFNg쐬
-//vert:o[ebNXVF[_[̃\[Xt@C
-//frag:tOgVF[_[̃\[Xt@C
-GLuint loadProgram(const char* vert, const char* frag) {
-	//VF[_[̃\[Xt@Cǂݍ
-	//肭ǂݍ܂ĂvstatfstattrueɂȂ
-	std::vector<GLchar> vsrc;
-	const bool vstat(readShaderSource(vert, vsrc));
-	std::vector<GLchar>fsrc;
-	const bool fstat(readShaderSource(frag, fsrc));
-	
-	//vOIuWFNg쐬
-	//擪ւ̃|C^œn
-	return vstat && fstat ? createProgram(vsrc.data(), fsrc.data()) : 0;
+REPLACED_ALLOCATION void operator delete(void* p, std::size_t) noexcept {
+	std::free(p);
+}
+REPLACED_ALLOCATION void operator delete[](void* p, std::size_t) noexcept {
+	std::free(p);
+}
+#ifdef __cpp_aligned_new
+//Ew肷`͋E̕]ɊmۂA낦ʒu̒OmallocԂʒuu
+REPLACED_ALLOCATION void* operator new(std::size_t size, std::align_val_t alignment) {
+	const std::size_t a(std::max(static_cast<std::size_t>(alignment), sizeof(void*)));
+	void* const p(operator new(size + a));
+	void** const q(reinterpret_cast<void**>((reinterpret_cast<std::uintptr_t>(p) + a) & ~static_cast<std::uintptr_t>(a - 1)));
+	q[-1] = p;
+	return q;
+}
+REPLACED_ALLOCATION void* operator new[](std::size_t size, std::align_val_t alignment) {
+	return operator new(size, alignment);
+}
+REPLACED_ALLOCATION void operator delete(void* p, std::align_val_t) noexcept {
+	if (p != NULL) std::free(static_cast<void**>(p)[-1]);
+}
+REPLACED_ALLOCATION void operator delete[](void* p, std::align_val_t alignment) noexcept {
+	operator delete(p, alignment);
 }
+REPLACED_ALLOCATION void operator delete(void* p, std::size_t, std::align_val_t alignment) noexcept {
+	operator delete(p, alignment);
+}
+REPLACED_ALLOCATION void operator delete[](void* p, std::size_t, std::align_val_t alignment) noexcept {
+	operator delete(p, alignment);
+}
+#endif
 
 //Z`̒_̈ʒu
 constexpr Object::Vertex rectangleVertex[] = {
-	{-0.5f,-0.5f},
-	{ 0.5f,-0.5f},
-	{ 0.5f, 0.5f},
-	{-0.5f, 0.5f}
+	{ -0.5f, -0.5f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f },
+	{ 0.5f, -0.5f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f },
+	{ 0.5f, 0.5f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f },
+	{ -0.5f, 0.5f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f }
 };
 
 constexpr Object::Vertex octahedronVertex[] =
 {
- { 0.0f, 1.0f, 0.0f },
- { -1.0f, 0.0f, 0.0f },
- { 0.0f, -1.0f, 0.0f },
- { 1.0f, 0.0f, 0.0f },
- { 0.0f, 1.0f, 0.0f },
- { 0.0f, 0.0f, 1.0f },
- { 0.0f, -1.0f, 0.0f },
- { 0.0f, 0.0f, -1.0f },
- { -1.0f, 0.0f, 0.0f },
- { 0.0f, 0.0f, 1.0f },
- { 1.0f, 0.0f, 0.0f },
- { 0.0f, 0.0f, -1.0f }
+ { 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f },
+ { -1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f },
+ { 0.0f, -1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f },
+ { 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f },
+ { 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f },
+ { 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f },
+ { 0.0f, -1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f },
+ { 0.0f, 0.0f, -1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f },
+ { -1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f },
+ { 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f },
+ { 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f },
+ { 0.0f, 0.0f, -1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f }
 };
 
 //Zʑ̂̒_̈ʒuƐF
 constexpr Object::Vertex cubeVertex[] =
 {
- { -1.0f, -1.0f, -1.0f, 0.0f, 0.0f, 0.0f },
- { -1.0f, -1.0f, 1.0f, 0.0f, 0.0f, 0.8f },
- { -1.0f, 1.0f, 1.0f, 0.0f, 0.8f, 0.0f },
- { -1.0f, 1.0f, -1.0f, 0.0f, 0.8f, 0.8f },
- { 1.0f, 1.0f, -1.0f, 0.8f, 0.0f, 0.0f },
- { 1.0f, -1.0f, -1.0f, 0.8f, 0.0f, 0.8f },
- { 1.0f, -1.0f, 1.0f, 0.8f, 0.8f, 0.0f },
- { 1.0f, 1.0f, 1.0f, 0.8f, 0.8f, 0.8f }
+ { -1.0f, -1.0f, -1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f },
+ { -1.0f, -1.0f, 1.0f, 0.0f, 0.0f, 0.8f, 0.0f, 0.0f },
+ { -1.0f, 1.0f, 1.0f, 0.0f, 0.8f, 0.0f, 0.0f, 0.0f },
+ { -1.0f, 1.0f, -1.0f, 0.0f, 0.8f, 0.8f, 0.0f, 0.0f },
+ { 1.0f, 1.0f, -1.0f, 0.8f, 0.0f, 0.0f, 0.0f, 0.0f },
+ { 1.0f, -1.0f, -1.0f, 0.8f, 0.0f, 0.8f, 0.0f, 0.0f },
+ { 1.0f, -1.0f, 1.0f, 0.8f, 0.8f, 0.0f, 0.0f, 0.0f },
+ { 1.0f, 1.0f, 1.0f, 0.8f, 0.8f, 0.8f, 0.0f, 0.0f }
 };
 
-// ʂƂɐFςZʑ̂̒_
+// ʂƂɐFςZʑ̂̒_ieNX`W͖ʂƂ0`1j
 constexpr Object::Vertex solidCubeVertex[] =
 {
 	// 
-	{ -1.0f, -1.0f, -1.0f, -1.0f, 0.0f, 0.0f },
-	{ -1.0f, -1.0f, 1.0f, -1.0f, 0.0f, 0.0f },
-	{ -1.0f, 1.0f, 1.0f, -1.0f, 0.0f, 0.0f },
-	{ -1.0f, -1.0f, -1.0f, -1.0f, 0.0f, 0.0f },
-	{ -1.0f, 1.0f, 1.0f, -1.0f, 0.0f, 0.0f },
-	{ -1.0f, 1.0f, -1.0f, -1.0f, 0.0f, 0.0f },
+	{ -1.0f, -1.0f, -1.0f, -1.0f, 0.0f, 0.0f, 0.0f, 0.0f },
+	{ -1.0f, -1.0f, 1.0f, -1.0f, 0.0f, 0.0f, 1.0f, 0.0f },
+	{ -1.0f, 1.0f, 1.0f, -1.0f, 0.0f, 0.0f, 1.0f, 1.0f },
+	{ -1.0f, -1.0f, -1.0f, -1.0f, 0.0f, 0.0f, 0.0f, 0.0f },
+	{ -1.0f, 1.0f, 1.0f, -1.0f, 0.0f, 0.0f, 1.0f, 1.0f },
+	{ -1.0f, 1.0f, -1.0f, -1.0f, 0.0f, 0.0f, 0.0f, 1.0f },
 	// 
-	{ 1.0f, -1.0f, -1.0f, 0.0f, 0.0f, -1.0f },
-	{ -1.0f, -1.0f, -1.0f, 0.0f, 0.0f, -1.0f },
-	{ -1.0f, 1.0f, -1.0f, 0.0f, 0.0f, -1.0f },
-	{ 1.0f, -1.0f, -1.0f, 0.0f, 0.0f, -1.0f },
-	{ -1.0f, 1.0f, -1.0f, 0.0f, 0.0f, -1.0f },
-	{ 1.0f, 1.0f, -1.0f, 0.0f, 0.0f, -1.0f },
+	{ 1.0f, -1.0f, -1.0f, 0.0f, 0.0f, -1.0f, 0.0f, 0.0f },
+	{ -1.0f, -1.0f, -1.0f, 0.0f, 0.0f, -1.0f, 1.0f, 0.0f },
+	{ -1.0f, 1.0f, -1.0f, 0.0f, 0.0f, -1.0f, 1.0f, 1.0f },
+	{ 1.0f, -1.0f, -1.0f, 0.0f, 0.0f, -1.0f, 0.0f, 0.0f },
+	{ -1.0f, 1.0f, -1.0f, 0.0f, 0.0f, -1.0f, 1.0f, 1.0f },
+	{ 1.0f, 1.0f, -1.0f, 0.0f, 0.0f, -1.0f, 0.0f, 1.0f },
 	// 
-	{ -1.0f, -1.0f, -1.0f, 0.0f, -1.0f, 0.0f },
-	{ 1.0f, -1.0f, -1.0f, 0.0f, -1.0f, 0.0f },
-	{ 1.0f, -1.0f, 1.0f, 0.0f, -1.0f, 0.0f },
-	{ -1.0f, -1.0f, -1.0f, 0.0f, -1.0f, 0.0f },
-	{ 1.0f, -1.0f, 1.0f, 0.0f, -1.0f, 0.0f },
-	{ -1.0f, -1.0f, 1.0f, 0.0f, -1.0f, 0.0f },
+	{ -1.0f, -1.0f, -1.0f, 0.0f, -1.0f, 0.0f, 0.0f, 0.0f },
+	{ 1.0f, -1.0f, -1.0f, 0.0f, -1.0f, 0.0f, 1.0f, 0.0f },
+	{ 1.0f, -1.0f, 1.0f, 0.0f, -1.0f, 0.0f, 1.0f, 1.0f },
+	{ -1.0f, -1.0f, -1.0f, 0.0f, -1.0f, 0.0f, 0.0f, 0.0f },
+	{ 1.0f, -1.0f, 1.0f, 0.0f, -1.0f, 0.0f, 1.0f, 1.0f },
+	{ -1.0f, -1.0f, 1.0f, 0.0f, -1.0f, 0.0f, 0.0f, 1.0f },
 	// E
-	{ 1.0f, -1.0f, 1.0f, 1.0f, 0.0f, 0.0f },
-	{ 1.0f, -1.0f, -1.0f, 1.0f, 0.0f, 0.0f },
-	{ 1.0f, 1.0f, -1.0f, 1.0f, 0.0f, 0.0f },
-	{ 1.0f, -1.0f, 1.0f, 1.0f, 0.0f, 0.0f },
-	{ 1.0f, 1.0f, -1.0f, 1.0f, 0.0f, 0.0f },
-	{ 1.0f, 1.0f, 1.0f, 1.0f, 0.0f, 0.0f },
+	{ 1.0f, -1.0f, 1.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f },
+	{ 1.0f, -1.0f, -1.0f, 1.0f, 0.0f, 0.0f, 1.0f, 0.0f },
+	{ 1.0f, 1.0f, -1.0f, 1.0f, 0.0f, 0.0f, 1.0f, 1.0f },
+	{ 1.0f, -1.0f, 1.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f },
+	{ 1.0f, 1.0f, -1.0f, 1.0f, 0.0f, 0.0f, 1.0f, 1.0f },
+	{ 1.0f, 1.0f, 1.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f },
 	// 
-	{ -1.0f, 1.0f, -1.0f, 0.0f, 1.0f, 0.0f },
-	{ -1.0f, 1.0f, 1.0f, 0.0f, 1.0f, 0.0f },
-	{ 1.0f, 1.0f, 1.0f, 0.0f, 1.0f, 0.0f },
-	{ -1.0f, 1.0f, -1.0f, 0.0f, 1.0f, 0.0f },
-	{ 1.0f, 1.0f, 1.0f, 0.0f, 1.0f, 0.0f },
-	{ 1.0f, 1.0f, -1.0f, 0.0f, 1.0f, 0.0f },
+	{ -1.0f, 1.0f, -1.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f },
+	{ -1.0f, 1.0f, 1.0f, 0.0f, 1.0f, 0.0f, 1.0f, 0.0f },
+	{ 1.0f, 1.0f, 1.0f, 0.0f, 1.0f, 0.0f, 1.0f, 1.0f },
+	{ -1.0f, 1.0f, -1.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f },
+	{ 1.0f, 1.0f, 1.0f, 0.0f, 1.0f, 0.0f, 1.0f, 1.0f },
+	{ 1.0f, 1.0f, -1.0f, 0.0f, 1.0f, 0.0f, 0.0f, 1.0f },
 	// O
-	{ -1.0f, -1.0f, 1.0f, 0.0f, 0.0f, 1.0f },
-	{ 1.0f, -1.0f, 1.0f, 0.0f, 0.0f, 1.0f },
-	{ 1.0f, 1.0f, 1.0f, 0.0f, 0.0f, 1.0f },
-	{ -1.0f, -1.0f, 1.0f, 0.0f, 0.0f, 1.0f },
-	{ 1.0f, 1.0f, 1.0f, 0.0f, 0.0f, 1.0f },
-	{ -1.0f, 1.0f, 1.0f, 0.0f, 0.0f, 1.0f }
+	{ -1.0f, -1.0f, 1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f },
+	{ 1.0f, -1.0f, 1.0f, 0.0f, 0.0f, 1.0f, 1.0f, 0.0f },
+	{ 1.0f, 1.0f, 1.0f, 0.0f, 0.0f, 1.0f, 1.0f, 1.0f },
+	{ -1.0f, -1.0f, 1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f },
+	{ 1.0f, 1.0f, 1.0f, 0.0f, 0.0f, 1.0f, 1.0f, 1.0f },
+	{ -1.0f, 1.0f, 1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 1.0f }
 };
 
 //Zʑ̗̂Ő̗[_̃CfbNX
@@ -284,7 +239,166 @@ constexpr GLuint solidCubeIndex[] =
 };
 
 
-int main() {
+//V~[V̏
+struct Simulation {
+	//}`̐KfoCXWnł̈ʒu
+	GLfloat location[2];
+
+	//}`̉]p
+	GLfloat angle;
+
+	//[hWnɑ΂foCXWn̊g嗦
+	GLfloat scale;
+
+	//x`gȂtrue
+	bool deferred;
+
+	//O`ŃfvXɕ`Ȃtrue
+	bool prepass;
+
+	//}EXJ[\̐KfoCXWnł̈ʒu
+	GLfloat cursor[2];
+
+	//J[\̉̐}`GPȖCPUőIԂȂtrue
+	bool cpuPick;
+
+	//p[eBNgXtH[tB[hobNGPUŐϕȂtrue
+	bool gpuParticles;
+
+	//mFp̐ƕ`Ȃtrue
+	bool debugDraw;
+
+	//t[̎Ԃɍ킹ĕ`𑜓xςȂtrue
+	bool dynamicResolution;
+};
+
+//͂̃ANV
+enum Action {
+	MoveLeft,
+	MoveRight,
+	MoveDown,
+	MoveUp,
+	Drag,
+	ToggleRenderer,
+	TogglePrepass,
+	TogglePick,
+	ToggleParticles,
+	ToggleDebugDraw,
+	ToggleResolution
+};
+
+//V~[VXebvi߂
+//state:V~[V̏
+//input:͂̃ANV̏
+//dt:ԍ݁ibj
+void simulate(Simulation& state, const InputActions& input, double dt) {
+	//L[Ő}`ړ鑬if/bj
+	const GLfloat speed(60.0f);
+
+	//Xebvňړf
+	const GLfloat pixels(speed * static_cast<GLfloat>(dt));
+
+	//}`ړ
+	const float* const size(input.getSize());
+	if (size[0] > 0.0f && size[1] > 0.0f) {
+		if (input.isDown(MoveLeft)) state.location[0] -= pixels * 2.0f / size[0];
+		else if (input.isDown(MoveRight)) state.location[0] += pixels * 2.0f / size[0];
+		if (input.isDown(MoveDown)) state.location[1] -= pixels * 2.0f / size[1];
+		else if (input.isDown(MoveUp)) state.location[1] += pixels * 2.0f / size[1];
+	}
+
+	//hbOĂԂ̓}EXJ[\̈ʒuɈړ
+	if (input.isDown(Drag)) {
+		state.location[0] = input.getCursor()[0];
+		state.location[1] = input.getCursor()[1];
+	}
+
+	//}EXzC[Ŋg嗦ς
+	state.scale += input.getScroll()[1];
+
+	//}`1WA/bŉ
+	state.angle += static_cast<GLfloat>(dt);
+
+	//O`ƒx`؂ւ
+	if (input.wasPressed(ToggleRenderer)) state.deferred = !state.deferred;
+
+	//fvX̐s`؂ւ
+	if (input.wasPressed(TogglePrepass)) state.prepass = !state.prepass;
+
+	//sbLOɎgJ[\̈ʒuL^
+	state.cursor[0] = input.getCursor()[0];
+	state.cursor[1] = input.getCursor()[1];
+
+	//GPUCPŨsbLO؂ւ
+	if (input.wasPressed(TogglePick)) state.cpuPick = !state.cpuPick;
+
+	//p[eBNϕ̂CPUGPUŐ؂ւ
+	if (input.wasPressed(ToggleParticles)) state.gpuParticles = !state.gpuParticles;
+
+	//mFp̐ƕ̕\؂ւ
+	if (input.wasPressed(ToggleDebugDraw)) state.debugDraw = !state.debugDraw;
+
+	//I𑜓x؂ւ
+	if (input.wasPressed(ToggleResolution)) state.dynamicResolution = !state.dynamicResolution;
+}
+
+//V~[V̏ԂԂ
+//a, b:Oƌ݂̏
+//t:Ԃ̊
+Simulation interpolateSimulation(const Simulation& a, const Simulation& b, double t) {
+	const GLfloat u(static_cast<GLfloat>(t));
+	Simulation s;
+	s.location[0] = a.location[0] + (b.location[0] - a.location[0]) * u;
+	s.location[1] = a.location[1] + (b.location[1] - a.location[1]) * u;
+	s.angle = a.angle + (b.angle - a.angle) * u;
+	s.scale = a.scale + (b.scale - a.scale) * u;
+	s.deferred = b.deferred;
+	s.prepass = b.prepass;
+	s.cursor[0] = b.cursor[0];
+	s.cursor[1] = b.cursor[1];
+	s.cpuPick = b.cpuPick;
+	s.gpuParticles = b.gpuParticles;
+	s.debugDraw = b.debugDraw;
+	s.dynamicResolution = b.dynamicResolution;
+	return s;
+}
+
+//R}hCɎw肵IvVtrue
+//name:IvV̖O
+bool hasOption(int argc, char* argv[], const char* name) {
+	for (int i = 1; i < argc; ++i) if (std::strcmp(argv[i], name) == 0) return true;
+	return false;
+}
+
+//R}hCɎw肵IvV̎̈o
+//name:IvV̖O
+//߂l:IvVȂ̈ȂNULL
+const char* optionValue(int argc, char* argv[], const char* name) {
+	for (int i = 1; i < argc - 1; ++i) if (std::strcmp(argv[i], name) == 0) return argv[i + 1];
+	return NULL;
+}
+
+//ReLXgƂOpenGL̏ԂiReLXgΏۂɂȂĂ邱Ɓj
+void initState() {
+	//wiFw肷
+	glClearColor(1.0f, 1.0f, 1.0f, 0.0f);
+
+	//obNtF[XJOLɂ
+	glFrontFace(GL_CCW);
+	glCullFace(GL_BACK);
+	glEnable(GL_CULL_FACE);
+
+	//fvXobt@Lɂ
+	glClearDepth(1.0);
+	glDepthFunc(GL_LESS);
+	glEnable(GL_DEPTH_TEST);
+}
+
+int main(int argc, char* argv[]) {
+
+	//--test [O]w肳ĂOpenGLgȂffďIiEBhE͍Ȃj
+	if (argc > 1 && std::strcmp(argv[1], "--test") == 0)
+		return SelfTest::run(argc > 2 ? argv[2] : NULL, std::cout) ? 0 : 1;
 
 	//GLFW
 	if(glfwInit() == GL_FALSE) {
@@ -306,173 +420,814 @@ int main() {
 	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
 
 
+	//--benchw肳Ă΃EBhE\Ȃ
+	const bool bench(argc > 1 && std::strcmp(argv[1], "--bench") == 0);
+	if (bench) glfwWindowHint(GLFW_VISIBLE, GL_FALSE);
+
 	//EBhE쐬
 	Window window;
-
-	//wiFw肷
-	glClearColor(1.0f, 1.0f, 1.0f, 0.0f);
-
-	//obNtF[XJOLɂ
-	glFrontFace(GL_CCW);
-	glCullFace(GL_BACK);
-	glEnable(GL_CULL_FACE);
-
-	//fvXobt@Lɂ
-	glClearDepth(1.0);
-	glDepthFunc(GL_LESS);
-	glEnable(GL_DEPTH_TEST);
+	initState();
 
 
-	//vOIuWFNg쐬create
-	const GLuint program(loadProgram("point.vert", "point.frag"));
+	//--benchw肳Ăΐ\vďI
+	if (bench)
+		return Benchmark::run(argc > 2 ? argv[2] : NULL, std::cout) ? 0 : 1;
 
-	//uniformϐ̏ꏊ擾
-	const GLint modelviewLoc(glGetUniformLocation(program, "modelview"));
-	const GLint projectionLoc(glGetUniformLocation(program, "projection"));
-	const GLint normalMatrixLoc(glGetUniformLocation(program, "normalMatrix"));
-	const GLint LposLoc(glGetUniformLocation(program, "Lpos"));
-	const GLint LambLoc(glGetUniformLocation(program, "Lamb"));
-	const GLint LdiffLoc(glGetUniformLocation(program, "Ldiff"));
-	const GLint LspecLoc(glGetUniformLocation(program, "Lspec"));
+	//--latency [~b]w肳Ăΐ҂ɖڕW̒xɍ킹ăt[n߂
+	FramePacer pacer;
+	if (argc > 1 && std::strcmp(argv[1], "--latency") == 0) {
+		const GLFWvidmode* const mode(glfwGetVideoMode(glfwGetPrimaryMonitor()));
+		const double period(1000.0 / (mode != NULL && mode->refreshRate > 0 ? mode->refreshRate : 60));
+		pacer.setLatency(period, argc > 2 ? std::atof(argv[2]) : period * 0.5);
+	}
 
-	//uniform block̏ꏊ擾
-	const GLint materialLoc(glGetUniformBlockIndex(program, "Material"));
+	//I𑜓x̔{߂鐧i--frame-budget [~b]ŗ\Zw肷AȂ΃j^[̈̍XV̎ԁj
+	const char* const budgetOption(optionValue(argc, argv, "--frame-budget"));
+	const GLFWvidmode* const videoMode(glfwGetVideoMode(glfwGetPrimaryMonitor()));
+	const double frameBudget(budgetOption != NULL && std::atof(budgetOption) > 0.0 ? std::atof(budgetOption)
+		: 1000.0 / (videoMode != NULL && videoMode->refreshRate > 0 ? videoMode->refreshRate : 60));
+	ResolutionController resolution(ResolutionController::defaults(frameBudget));
 
-	//uniform block̏ꏊ0Ԃ̌|CgɌт
-	glUniformBlockBinding(program, materialLoc, 0);
+	//VF[_[̃t@CĎĎsɓǂݒ
+	HotReload reload(window);
 
-	//̕
-	const int slices(512), stacks(256);
+	//uniformϐ̏ꏊivOIuWFNgǂݒ狁ߒj
+	GLint projectionLoc(-1), LposLoc(-1), LambLoc(-1), LdiffLoc(-1), LspecLoc(-1), pointLightCountLoc(-1);
+	GLint shadowMapLoc(-1), shadowMatrixLoc(-1), cascadeFarLoc(-1), cascadeCountLoc(-1);
+	GLint probeMapLoc(-1), probeMatrixLoc(-1), probeRotationLoc(-1), probeSizeLoc(-1);
 
-	//_
+	//vOIuWFNg쐬create
+	//ϊs̓CX^Xœn
+	const HotReload::Handle program(reload.addProgram("batch.vert", "point.frag", [&](GLuint program) {
+		//uniformϐ̏ꏊ擾
+		projectionLoc = glGetUniformLocation(program, "projection");
+		LposLoc = glGetUniformLocation(program, "Lpos");
+		LambLoc = glGetUniformLocation(program, "Lamb");
+		LdiffLoc = glGetUniformLocation(program, "Ldiff");
+		LspecLoc = glGetUniformLocation(program, "Lspec");
+
+		//uniform block̏ꏊ擾
+		const GLint materialLoc(glGetUniformBlockIndex(program, "Material"));
+
+		//uniform block̏ꏊ0Ԃ̌|CgɌт
+		glUniformBlockBinding(program, materialLoc, 0);
+
+		//_uniform block1Ԃ̌|CgɌт
+		glUniformBlockBinding(program, glGetUniformBlockIndex(program, "PointLights"), 1);
+		pointLightCountLoc = glGetUniformLocation(program, "pointLightCount");
+
+		//VhE}bvuniformϐ̏ꏊ擾
+		shadowMapLoc = glGetUniformLocation(program, "shadowMap");
+		shadowMatrixLoc = glGetUniformLocation(program, "shadowMatrix");
+		cascadeFarLoc = glGetUniformLocation(program, "cascadeFar");
+		cascadeCountLoc = glGetUniformLocation(program, "cascadeCount");
+
+		//̃v[uuniformϐ̏ꏊ擾
+		probeMapLoc = glGetUniformLocation(program, "probeMap");
+		probeMatrixLoc = glGetUniformLocation(program, "probeMatrix");
+		probeRotationLoc = glGetUniformLocation(program, "probeRotation");
+		probeSizeLoc = glGetUniformLocation(program, "probeSize");
+	}));
+
+	//VhE}bvɃfvX`vOIuWFNg
+	const GLuint shadowProgram(loadProgram("shadow.vert", "shadow.frag"));
+
+	//O`̑OɃfvX`vOIuWFNgitOgVF[_[̓VhE}bvƋpj
+	//batch.vertƓgl_Position߂invariantɂAGL_EQUAL̃fvXeXgňv
+	GLint depthProjectionLoc(-1);
+	const HotReload::Handle depthProgram(reload.addProgram("depth.vert", "shadow.frag", [&](GLuint program) {
+		depthProjectionLoc = glGetUniformLocation(program, "projection");
+	}));
+
+	//[J[Xbh
+	ThreadPool pool;
+
+	//̒_ƃCfbNX
 	std::vector<Object::Vertex> solidSphereVertex;
-	for (int j = 0; j <= stacks; ++j) {
-		const float t(static_cast<float> (j) / static_cast<float>(stacks));
-		const float y(cos(3.141593f * t)), r(sin(3.141593f * t));
-		for (int i = 0; i <= slices; ++i) {
-			const float s(static_cast<float>(i) / static_cast<float>(slices));
-			const float z(r * cos(6.283185f * s)), x(r * sin(6.283185f * s));
-			//_
-			const Object::Vertex v = { x,y,z,x,y,z };
-			//_ǉ
-			solidSphereVertex.emplace_back(v);
-		}
-		
-	}
-
-	//CfbNX
 	std::vector<GLuint> solidSphereIndex;
-	for (int j = 0; j < stacks; ++j) {
-		const int k((slices + 1) * j);
-		for (int i = 0; i < slices; ++i) {
-			//_̃CfbNX
-			const GLuint k0(k + i);
-			const GLuint k1(k0 + 1);
-			const GLuint k2(k1 + slices);
-			const GLuint k3(k2 + 1);
-
-			//̎Op`
-			solidSphereIndex.emplace_back(k0);
-			solidSphereIndex.emplace_back(k2);
-			solidSphereIndex.emplace_back(k3);
-
-			//E̎Op`
-			solidSphereIndex.emplace_back(k0);
-			solidSphereIndex.emplace_back(k3);
-			solidSphereIndex.emplace_back(k1);
-		}
-	}
-
-	//}`f[^쐬
-	std::unique_ptr<const Shape> shape(new SolidShapeIndex(3,static_cast<GLsizei>(solidSphereVertex.size()), solidSphereVertex.data(), static_cast<GLsizei>(solidSphereIndex.size()), solidSphereIndex.data()));
-
+	makeSphere(512, 256, solidSphereVertex, solidSphereIndex);
+
+	//bVbgɕiobt@ɂ͕בւCfbNXi[j
+	const Meshlets sphereMeshlets(pool, solidSphereVertex.data(), static_cast<GLsizei>(solidSphereVertex.size()),
+		solidSphereIndex.data(), static_cast<GLsizei>(solidSphereIndex.size()));
+
+	//ՕɎgei_ʏɂ̂Ō̋̓Ɏ܂j
+	//_̃Cg{[ɂg
+	std::vector<Object::Vertex> occluderVertex;
+	std::vector<GLuint> occluderIndex;
+	makeSphere(16, 8, occluderVertex, occluderIndex);
+
+	//}`f[^܂Ƃ߂Ċi[obt@ɒǉie󂯂鏰ɂ͘Zʑ̂gj
+	static constexpr GLsizei solidCubeVertexCount(sizeof solidCubeVertex / sizeof solidCubeVertex[0]);
+	static constexpr GLsizei solidCubeIndexCount(sizeof solidCubeIndex / sizeof solidCubeIndex[0]);
+	MeshBuffer meshes(static_cast<GLsizei>(solidSphereVertex.size() + occluderVertex.size()) + solidCubeVertexCount,
+		static_cast<GLsizei>(solidSphereIndex.size() + occluderIndex.size()) + solidCubeIndexCount);
+	const MeshBuffer::Handle sphere(meshes.add(static_cast<GLsizei>(solidSphereVertex.size()), solidSphereVertex.data(), sphereMeshlets.getIndexCount(), sphereMeshlets.getIndices()));
+	const MeshBuffer::Handle cube(meshes.add(solidCubeVertexCount, solidCubeVertex, solidCubeIndexCount, solidCubeIndex));
+	const MeshBuffer::Handle lightVolume(meshes.add(static_cast<GLsizei>(occluderVertex.size()), occluderVertex.data(), static_cast<GLsizei>(occluderIndex.size()), occluderIndex.data()));
+
+	//x`iO`Ǝsɐ؂ւj
+	DeferredRenderer deferred(meshes, lightVolume);
+
+	//_i--lights []Őw肷j
+	PointLights pointLights;
+	const char* const lightsOption(optionValue(argc, argv, "--lights"));
+	const int pointLightCount(std::min(lightsOption != NULL ? std::atoi(lightsOption) : 16, static_cast<int>(PointLights::MaxLights)));
 
 	//f[^
+	//ŏ͉̌e𗎂ƂsȂ̂ŁAʒȗɌɌiw = 0j^
 	static constexpr int Lcount(1);
-	static constexpr Vector Lpos[] = { 0.0f,0.0f,5.0f,1.0f };
+	static constexpr Vector Lpos[] = { 1.0f,3.0f,2.0f,0.0f };
 	static constexpr GLfloat Lamb[] = { 0.2f,0.1f,0.1f};
 	static constexpr GLfloat Ldiff[] = { 1.0f,0.5f,0.5f};
 	static constexpr GLfloat Lspec[] = { 1.0f,0.5f,0.5f};
 
+	//eNX`i--texture [KTXDDS̃t@C]ŏ̃eNX`w肷AȂΎs͗lj
+	//GPUɂ͏ʏŕ傫ɕKvȃxu
+	TextureCache textures;
+	const char* const textureOption(optionValue(argc, argv, "--texture"));
+	TextureCache::Handle groundTexture(textureOption != NULL ? textures.load(textureOption, pool) : 0);
+	if (groundTexture == 0) {
+		static constexpr GLsizei checkerSize(1024), checkerCell(64);
+		std::vector<unsigned char> checker(checkerSize * checkerSize * 4);
+		for (GLsizei y = 0; y < checkerSize; ++y) {
+			for (GLsizei x = 0; x < checkerSize; ++x) {
+				const unsigned char c((x / checkerCell + y / checkerCell) % 2 != 0 ? 255 : 160);
+				unsigned char* const p(&checker[(y * checkerSize + x) * 4]);
+				p[0] = p[1] = p[2] = c;
+				p[3] = 255;
+			}
+		}
+		TextureImage image;
+		image.create(checkerSize, checkerSize, checker.data());
+		image.generateMipmaps(pool);
+		groundTexture = textures.add(std::move(image));
+	}
+
 	//Ff[^
-	static constexpr Material color[]{
-		//Kamb,Kdiff,Kspec,Kshȉ
-		{0.6f, 0.6f, 0.2f, 1.0f, 0.0f, 1.0f, 0.3f, 0.3f, 0.3f, 30.0f },
-		{ 0.1f, 0.1f, 0.5f, 0.2f, 0.0f, 1.0f, 0.4f, 0.4f, 0.4f, 60.0f }
+	Material color[]{
+		//Kamb,Kdiff,Kspec,Kshi,eNX`̏
+		{0.6f, 0.6f, 0.2f, 1.0f, 0.0f, 1.0f, 0.3f, 0.3f, 0.3f, 30.0f, 0 },
+		{ 0.1f, 0.1f, 0.5f, 0.2f, 0.0f, 1.0f, 0.4f, 0.4f, 0.4f, 60.0f, 0 },
+		{ 0.4f, 0.4f, 0.4f, 0.8f, 0.8f, 0.8f, 0.1f, 0.1f, 0.1f, 10.0f, 0 },
+		//J[\̉̐}`
+		{ 0.6f, 0.3f, 0.0f, 1.0f, 0.6f, 0.1f, 0.5f, 0.5f, 0.5f, 30.0f, 0 }
 	};
+	static constexpr unsigned int pickedMaterial(3);
+
+	//̍ގɂ̓eNX`\
+	static constexpr unsigned int groundMaterial(2);
+	color[groundMaterial].texture = static_cast<GLint>(groundTexture);
+
+	const Uniform<Material> material(color,4);
+
+	//ގ̔ԍňeNX`IuWFNg
+	GLuint materialTextures[4];
+	for (int m = 0; m < 4; ++m) materialTextures[m] = textures.get(color[m].texture);
+
+	//t[Ƃ̈ꎞIȃf[^̊mې
+	FrameArena arena(pool.size(), 256 << 10);
+
+	//}`̎鏬ȋ̃Aj[Vi--tracks []Őw肷j
+	//8bňO0.25bƂ̃L[ŕ\AԂōČłL[͎菜
+	Animation animation(pool);
+	const char* const tracksOption(optionValue(argc, argv, "--tracks"));
+	const int trackCount(std::max(tracksOption != NULL ? std::atoi(tracksOption) : 32, 0));
+	for (int i = 0; i < trackCount; ++i) {
+		static constexpr int keyCount(33);
+		Animation::Key keys[keyCount];
+		const GLfloat phase(6.283185f * static_cast<GLfloat>(i) / static_cast<GLfloat>(trackCount));
+		const GLfloat radius(3.5f + 0.5f * static_cast<GLfloat>(i % 3));
+		for (int k = 0; k < keyCount; ++k) {
+			const GLfloat t(0.25f * static_cast<GLfloat>(k));
+			const GLfloat a(phase + 6.283185f * t / 8.0f);
+			const GLfloat size(0.15f + 0.05f * std::sin(3.0f * a));
+			keys[k] = Animation::Key{ t,
+				Vec<3>{ radius * std::cos(a), 0.5f * std::sin(2.0f * a + phase), radius * std::sin(a) },
+				Quat::rotate(4.0f * a, 0.3f, 1.0f, 0.0f),
+				Vec<3>{ size, size, size } };
+		}
+		animation.addTrack(keys, keyCount, 1.0e-3f);
+	}
+	std::vector<Matrix> animated(trackCount);
+
+	//}`畬グp[eBNi--particles []ŏw肷j
+	//o̊͏Ŋ̂ɂāAς܂ŐĂ悤ɂ
+	const char* const particleOption(optionValue(argc, argv, "--particles"));
+	Particles particles(pool, particleOption != NULL ? std::strtoul(particleOption, NULL, 10) : 100000);
+	Particles::Emitter fountain(particles.getEmitter());
+	fountain.life = 2.5f;
+	fountain.spread = 1.5f;
+	fountain.rate = static_cast<GLfloat>(particles.getCapacity()) / fountain.life;
+	particles.setForces(-9.8f, 0.1f, -1.9f, 0.5f);
+	GLfloat particleTime(0.0f);
+
+	//mFp̐ƕi[J[XbhL^j
+	DebugDraw debug(pool.size());
+
+	//ϊ̊Kwi2ڂ̐}`1ڂ̐}`炸炷j
+	//r[ϊ̓r[ƂɈႤ̂ŊKwɂ͊܂߂Ȃ
+	SceneGraph scene(pool);
+	const SceneGraph::Node objectNode(scene.addNode(SceneGraph::None, Matrix::identity()));
+	const SceneGraph::Node object1Node(scene.addNode(objectNode, Matrix::translate(0.0f, 0.0f, 3.0f)));
+	const SceneGraph::Node objects[] = { objectNode, object1Node };
+
+	//e󂯂鏰i}`̉ɔZʑ̂uAϊ̓RpCɋ߂j
+	static constexpr Affine groundLocal(Affine::translate(0.0f, -2.0f, 0.0f).scaled(6.0f, 0.1f, 6.0f));
+	const SceneGraph::Node groundNode(scene.addNode(SceneGraph::None, groundLocal.toMatrix()));
+
+	//Zʑ̂͂ދ̔aiS璸_܂ł̋j
+	static constexpr GLfloat cubeRadius(length(Vec<3>{ 1.0f, 1.0f, 1.0f }));
+
+	//͂ދ̔ai[hWnj
+	static constexpr GLfloat groundRadius(length(Vec<3>{ 6.0f, 0.1f, 6.0f }));
+
+	//J̑Oʂƌ
+	static constexpr GLfloat zNear(1.0f), zFar(10.0f);
+
+	//̑Ɏg̃v[ui--probes [t@C]ŏĂtʂǂݍ݁AȂΏĂtĕۑj
+	//}`͍ŏ̔zû܂ܓȂ̂ƂďĂt
+	LightProbes probes;
+	const char* const probesOption(optionValue(argc, argv, "--probes"));
+	if (probesOption == NULL || !probes.load(probesOption)) {
+		ProbeBaker baker;
+		baker.add(Matrix::identity(), solidSphereVertex.data(), solidSphereIndex.data(), static_cast<GLsizei>(solidSphereIndex.size()), color[0].diffuse.data());
+		baker.add(Matrix::translate(0.0f, 0.0f, 3.0f), solidSphereVertex.data(), solidSphereIndex.data(), static_cast<GLsizei>(solidSphereIndex.size()), color[1].diffuse.data());
+		baker.add(groundLocal.toMatrix(), solidCubeVertex, solidCubeIndex, solidCubeIndexCount, color[groundMaterial].diffuse.data());
+
+		//͕̌s̊Aڌ͕s̊gUˌɂ
+		const GLfloat sun(std::sqrt(Lpos[0][0] * Lpos[0][0] + Lpos[0][1] * Lpos[0][1] + Lpos[0][2] * Lpos[0][2]));
+		const ProbeBaker::Settings settings = { 256, 2, { Lamb[0], Lamb[1], Lamb[2] },
+			{ Lpos[0][0] / sun, Lpos[0][1] / sun, Lpos[0][2] / sun }, { Ldiff[0], Ldiff[1], Ldiff[2] } };
+
+		//̏𕢂iqɃv[uׂ
+		static constexpr GLfloat probeMin[] = { -6.0f, -1.5f, -6.0f }, probeMax[] = { 6.0f, 2.5f, 6.0f };
+		static constexpr int probeCount[] = { 8, 4, 8 };
+		std::vector<GLfloat> coefficient;
+		baker.bake(pool, probeMin, probeMax, probeCount, settings, coefficient);
+		probes.set(probeMin, probeMax, probeCount, coefficient);
+		if (probesOption != NULL) probes.save(probesOption);
+	}
 
-	const Uniform<Material> material(color,2);
+	//--window2w肳ĂΎLڂ̃EBhEJ
+	//_zIuWFNg͋LȂ̂ŃReLXg̔ԍ1ɂ
+	std::unique_ptr<Window> window2;
+	if (hasOption(argc, argv, "--window2")) {
+		window2.reset(new Window(640, 480, "View 2", &window));
+		initState();
+		window.makeCurrent();
+	}
 
-	//^C}[0ɃZbg
-	glfwSetTime(0.0);
+	//r[i--splitw肳Ă΍ŏ̃EBhEEɕj
+	std::vector<std::unique_ptr<View>> views;
+	if (hasOption(argc, argv, "--split")) {
+		views.emplace_back(new View(meshes, pool, 0, View::Rect{ 0.0f, 0.0f, 0.5f, 1.0f }));
+		views.emplace_back(new View(meshes, pool, 0, View::Rect{ 0.5f, 0.0f, 0.5f, 1.0f }));
+	}
+	else {
+		views.emplace_back(new View(meshes, pool, 0, View::Rect{ 0.0f, 0.0f, 1.0f, 1.0f }));
+	}
+	if (window2) views.emplace_back(new View(meshes, pool, 1, View::Rect{ 0.0f, 0.0f, 1.0f, 1.0f }));
+	const unsigned int viewCount(static_cast<unsigned int>(views.size()));
+
+	//`ReLXg؂ւ
+	//_̃jtH[obt@Gobt@Ȃǂ̓ReLXg̊ԂŋLĂ̂ŁA
+	//ÕReLXgŃtFX𔭍sătbVÃReLXgGPȖł҂Ă珑
+	unsigned int currentContext(0);
+	const auto makeCurrent([&](unsigned int context) {
+		if (context == currentContext) return;
+		GLFence fence(GLFence::create());
+		glFlush();
+		if (context == 0) window.makeCurrent(); else window2->makeCurrent();
+		glWaitSync(fence.get(), 0, GL_TIMEOUT_IGNORED);
+		currentContext = context;
+	});
+
+	//J[\̉̐}`Iԁiŏ̃r[őIԁj
+	//sbLO̔ԍ͐}`i + 1AȋfirstTrackId + iAgroundIdŁA0͉Ȃ
+	Picker picker;
+	static constexpr GLuint firstTrackId(3);
+	const GLuint groundId(firstTrackId + static_cast<GLuint>(trackCount));
+	GLuint picked(0);
+
+	//r[Ƃ̃JXP[hVhE}bvi̓r[̃J̎䂩狁߂j
+	std::vector<std::unique_ptr<CascadedShadow>> shadows;
+	for (unsigned int v = 0; v < viewCount; ++v) shadows.emplace_back(new CascadedShadow(meshes, shadowProgram));
+
+	//r[Ƃ̓I𑜓x̕`ig債đNsvOIuWFNg͋pj
+	const GLuint upscaleProgram(loadProgram("deferred.vert", "upscale.frag"));
+	std::vector<std::unique_ptr<DynamicResolution>> targets;
+	for (unsigned int v = 0; v < viewCount; ++v) targets.emplace_back(new DynamicResolution(upscaleProgram));
+
+	//v
+	Profiler profiler;
+	const unsigned int occludedCounter(profiler.counter("occlusion.occluded"));
+	const unsigned int occluderSetupCounter(profiler.counter("occlusion.setup (ms)"));
+	const unsigned int occluderRasterCounter(profiler.counter("occlusion.raster (ms)"));
+	const unsigned int occlusionTestCounter(profiler.counter("occlusion.test (ms)"));
+	const unsigned int submitCounter(profiler.counter("batch.submit (ms)"));
+	const unsigned int drawCallCounter(profiler.counter("batch.calls"));
+	const unsigned int allocationCounter(profiler.counter("frame.allocations"));
+	const unsigned int arenaPeakCounter(profiler.counter("arena.peak (KB)"));
+	const unsigned int viewCounter(profiler.counter("view.count"));
+	const unsigned int recordCounter(profiler.counter("view.record (ms)"));
+
+	//bVbg̃JO
+	const unsigned int meshletRejectedCounter(profiler.counter("meshlet.rejected"));
+	const unsigned int meshletCullCounter(profiler.counter("meshlet.cull (ms)"));
+	std::vector<Meshlets::Stats> meshletStats(viewCount);
+
+	//x`̃pXƂ̔s̎
+	const unsigned int geometryPassCounter(profiler.counter("deferred.geometry (ms)"));
+	const unsigned int lightingPassCounter(profiler.counter("deferred.lighting (ms)"));
+
+	//I񂾐}`̔ԍƌʂo܂ł̒x
+	const unsigned int pickCounter(profiler.counter("pick.id"));
+	const unsigned int pickFramesCounter(profiler.counter("pick.latency (frames)"));
+	const unsigned int pickTimeCounter(profiler.counter("pick.latency (ms)"));
+
+	//Aj[V̓v
+	const unsigned int trackCounter(profiler.counter("anim.tracks"));
+	const unsigned int sampleCounter(profiler.counter("anim.sample (ms)"));
+
+	//p[eBN̐ƐϕƓ]̎
+	const unsigned int particleCounter(profiler.counter("particles.alive"));
+	const unsigned int particleSimulateCounter(profiler.counter("particles.simulate (ms)"));
+	const unsigned int particleUploadCounter(profiler.counter("particles.upload (ms)"));
+
+	//mFp̐̐
+	const unsigned int debugLineCounter(profiler.counter("debug.lines"));
+
+	//I𑜓x̔{Ɨ\Z𒴂t[̐Əkĕ`GPU̎
+	const unsigned int resolutionScaleCounter(profiler.counter("resolution.scale"));
+	const unsigned int resolutionMissCounter(profiler.counter("resolution.misses"));
+	const unsigned int resolutionGpuCounter(profiler.counter("resolution.gpu (ms)"));
+
+	//JXP[hVhE}bv̕Ƃ̉e𗎂Ƃ̂̐ƕ`̎
+	const unsigned int shadowCullCounter(profiler.counter("shadow.cull (ms)"));
+	unsigned int shadowCasterCounter[CascadedShadow::MaxCascades];
+	unsigned int shadowSubmitCounter[CascadedShadow::MaxCascades];
+	unsigned int shadowGpuCounter[CascadedShadow::MaxCascades];
+	for (int c = 0; c < shadows[0]->getCount(); ++c) {
+		const std::string name("shadow.c" + std::to_string(c));
+		shadowCasterCounter[c] = profiler.counter((name + ".casters").c_str());
+		shadowSubmitCounter[c] = profiler.counter((name + ".submit (ms)").c_str());
+		shadowGpuCounter[c] = profiler.counter((name + ".gpu (ms)").c_str());
+	}
 
+	//GPU̗\Zݒ肵ĎނƂ̎gpʂL^
+	GpuMemory& gpuMemory(GpuMemory::instance());
+	gpuMemory.setBudget(GpuMemory::Vertex, 256 << 20);
+	gpuMemory.setBudget(GpuMemory::Index, 128 << 20);
+	gpuMemory.setBudget(GpuMemory::Uniform, 16 << 20);
+	gpuMemory.setBudget(GpuMemory::Stream, 64 << 20);
+	unsigned int gpuMemoryCounter[GpuMemory::CategoryCount];
+	for (int c = 0; c < GpuMemory::CategoryCount; ++c) {
+		const std::string name(std::string("gpu.") + GpuMemory::name(static_cast<GpuMemory::Category>(c)) + " (MB)");
+		gpuMemoryCounter[c] = profiler.counter(name.c_str());
+	}
 
+	//V~[Vƃt[̐iݕ̓v
+	const unsigned int tickCounter(profiler.counter("sim.ticks"));
+	const unsigned int latencyCounter(profiler.counter("pacer.latency (ms)"));
+	const unsigned int missedCounter(profiler.counter("pacer.missed"));
+	unsigned long long ticks(0);
+
+	//L[ƃ}EX{^ANVɌт
+	InputActions actions;
+	actions.bindKey(GLFW_KEY_LEFT, MoveLeft);
+	actions.bindKey(GLFW_KEY_RIGHT, MoveRight);
+	actions.bindKey(GLFW_KEY_DOWN, MoveDown);
+	actions.bindKey(GLFW_KEY_UP, MoveUp);
+	actions.bindMouseButton(GLFW_MOUSE_BUTTON_1, Drag);
+	actions.bindKey(GLFW_KEY_F2, ToggleRenderer);
+	actions.bindKey(GLFW_KEY_F3, TogglePrepass);
+	actions.bindKey(GLFW_KEY_F4, TogglePick);
+	actions.bindKey(GLFW_KEY_F5, ToggleParticles);
+	actions.bindKey(GLFW_KEY_F6, ToggleDebugDraw);
+	actions.bindKey(GLFW_KEY_F7, ToggleResolution);
+
+	//--record [t@C]w肳ĂΓ͂̃CxgL^A
+	//--replay [t@C]w肳Ă΋L^CxgĐčŌ܂ōĐI
+	InputRecorder recorder;
+	const bool recording(argc > 2 && std::strcmp(argv[1], "--record") == 0);
+	const bool replaying(argc > 2 && std::strcmp(argv[1], "--replay") == 0 && recorder.load(argv[2]));
+	std::atomic<bool> replayed(false);
+
+	//͂̃Cxg̐
+	const unsigned int eventCounter(profiler.counter("input.events"));
+	std::atomic<unsigned int> inputEvents(0);
+
+	//ǂݒVF[_[̐ƍŌ̃RpC̎
+	const unsigned int reloadCounter(profiler.counter("reload.count"));
+	const unsigned int compileCounter(profiler.counter("reload.compile (ms)"));
+
+	//GPUɒuĂeNX`̗ʂƃt[Ƃ̓]
+	const unsigned int textureResidentCounter(profiler.counter("texture.resident (MB)"));
+	const unsigned int textureUploadCounter(profiler.counter("texture.upload (KB)"));
+
+	//V~[V60/bŐi߂XbhJn
+	//eXebvŃCxg̃L[ɂăANV̏Ԃɔf
+	Window::EventQueue& events(window.getEvents());
+	unsigned long long tick(0);
+	//--deferredw肳ĂΒx`Ŏn߂iF2L[Ő؂ւj
+	//--prepassw肳Ă΃fvXɕ`iF3L[Ő؂ւj
+	//--cpu-pickw肳ĂCPUŃJ[\̉̐}`IԁiF4L[Ő؂ւj
+	//--gpu-particlesw肳Ă΃p[eBNGPUŐϕiF5L[Ő؂ւj
+	//--debug-draww肳ĂΊmFp̐ƕ`iF6L[Ő؂ւj
+	//--dynamic-resolutionw肳Ă΃t[̎Ԃɍ킹ĕ`𑜓xςiF7L[Ő؂ւj
+	const Simulation initial = { { 0.0f, 0.0f }, 0.0f, 100.0f, hasOption(argc, argv, "--deferred"), hasOption(argc, argv, "--prepass"),
+		{ 0.0f, 0.0f }, hasOption(argc, argv, "--cpu-pick"), hasOption(argc, argv, "--gpu-particles"),
+		hasOption(argc, argv, "--debug-draw"), hasOption(argc, argv, "--dynamic-resolution") };
+	FrameScheduler<Simulation> scheduler(60.0, initial);
+	scheduler.start([&](Simulation& state, double dt) {
+		actions.beginTick();
+		++tick;
+		InputEvent event;
+		while (events.pop(event)) {
+			//Đ͎ۂ̓͂gȂ
+			if (replaying) continue;
+			if (recording) recorder.record(tick, event);
+			actions.apply(event);
+		}
+		if (replaying) {
+			recorder.replay(tick, [&](const InputEvent& e) { actions.apply(e); });
+			if (recorder.finished()) replayed = true;
+		}
+		inputEvents.fetch_add(actions.getEvents(), std::memory_order_relaxed);
+		simulate(state, actions, dt);
+	});
 
 	//EBhEJĂԌJԂ
-	while (window) {
-
-		//EBhE
-		glClear(GL_COLOR_BUFFER_BIT|GL_DEPTH_BUFFER_BIT);
-
-		//ŕ`揈s
-
-		//VF[_[vO̎gpJn
-		glUseProgram(program);
-
-		//eϊs߂
-		const GLfloat* const size(window.getSize());
-		const GLfloat fovy(window.getScale() * 0.01f);
-		const GLfloat aspect(size[0] / size[1]);
-		const Matrix projection(Matrix::perspective(fovy, aspect, 1.0f, 10.0f));
-
-		//fϊs߂
-		const GLfloat* const location(window.getLocation());
-		const Matrix r(Matrix::rotate(static_cast<GLfloat>(glfwGetTime()), 0.0f, 1.0f, 0.0f));
-		const Matrix model(Matrix::translate(location[0], location[1], 0.0f)*r);
-
-		//r[ϊs߂
-		const Matrix view(Matrix::lookat(3.0f, 4.0f, 5.0f, -1.0f, -1.0f, -1.0f, 0.0f, 1.0f, 0.0f));
-
-		//@xNg̕ϊs̊i[
-		GLfloat normalMatrix[9];
-
-		//fr[ϊs߂
-		const Matrix modelview(view * model);
-
-		//@xNg̕ϊs߂
-		modelview.getNormalMatrix(normalMatrix);
-
-		//uniformϐɒlݒ肷
-		glUniformMatrix4fv(projectionLoc, 1, GL_FALSE, projection.data());
-		glUniformMatrix4fv(modelviewLoc, 1, GL_FALSE, modelview.data());
-		glUniformMatrix3fv(normalMatrixLoc, 1, GL_FALSE, normalMatrix);
-		for (int i = 0; i < Lcount; ++i) {
-			glUniform4fv(LposLoc+i, 1, (view * Lpos[i]).data());
-			glUniform3fv(LambLoc, Lcount, Lamb);
-			glUniform3fv(LdiffLoc, Lcount, Ldiff);
-			glUniform3fv(LspecLoc, Lcount, Lspec);
+	pacer.beginFrame();
+	while (window && !replayed && !(window2 && window2->shouldClose())) {
+
+		//t[̈ꎞIȃf[^̗̈i߂ăq[v̊mۂ̉񐔂L^Ă
+		const auto frameStart(std::chrono::high_resolution_clock::now());
+		arena.beginFrame();
+		const std::size_t allocations(AllocationCounter::count());
+
+		//t[̋؂œǂݒVF[_[ɍւ
+		reload.update();
+
+		//Õt[ŗvꂽׂɍ킹GPUɒueNX`̃xς
+		textures.update();
+
+		//Õt[ŋL^mFp̐ƕ
+		debug.clear();
+
+		//V~[V̏Ԃ烂fϊs߂
+		const Simulation simulation(scheduler.interpolate(interpolateSimulation));
+		const Matrix r(Matrix::rotate(simulation.angle, 0.0f, 1.0f, 0.0f));
+		const Matrix model(Matrix::translate(simulation.location[0], simulation.location[1], 0.0f)*r);
+
+		//ς[Jϊsݒ肵ă[hWnւ̕ϊs߂
+		scene.setLocal(objectNode, model);
+		scene.update();
+
+		//_}`̎ɉ
+		pointLights.clear();
+		for (int i = 0; i < pointLightCount; ++i) {
+			const GLfloat a(simulation.angle * 0.5f + 6.283185f * static_cast<GLfloat>(i) / static_cast<GLfloat>(pointLightCount));
+			const GLfloat r(2.5f + 0.8f * static_cast<GLfloat>(i % 3));
+			const PointLights::Light light = {
+				{ r * std::cos(a), -1.5f + 0.5f * static_cast<GLfloat>(i % 4), r * std::sin(a) }, 2.5f,
+				{ 0.5f + 0.5f * std::cos(a), 0.5f + 0.5f * std::cos(a + 2.094395f), 0.5f + 0.5f * std::cos(a + 4.188790f) }
+			};
+			pointLights.add(light);
 		}
 
+		//ȋ̃fϊs߂iV~[V̌oߎԂōĐj
+		if (trackCount > 0) animation.sample(simulation.angle, animated.data());
+
+		//}`̏ォp[eBNoĐi߂i͐}`̉]pƓ1b1iށj
+		const GLfloat particleStep(std::min(std::max(simulation.angle - particleTime, 0.0f), 0.1f));
+		particleTime = simulation.angle;
+		fountain.position[0] = model.data()[12];
+		fountain.position[1] = model.data()[13] + 1.0f;
+		fountain.position[2] = model.data()[14];
+		particles.setEmitter(fountain);
+		particles.setGpu(simulation.gpuParticles);
+		particles.update(particleStep);
+
+		//r[ƂɃJ߂i_r[̔ԍɉySɉ񂷁j
+		//I𑜓xł͐̔{ŏkr[|[gɕ`
+		const GLfloat fovy(simulation.scale * 0.01f);
+		const GLfloat renderScale(simulation.dynamicResolution ? resolution.getScale() : 0.0f);
+		for (unsigned int v = 0; v < viewCount; ++v) {
+			View& view(*views[v]);
+			view.setFramebufferSize(view.getContext() == 0 ? window.getFramebufferSize() : window2->getFramebufferSize(), renderScale);
+			const Matrix eye(Matrix::rotate(static_cast<GLfloat>(v) * 1.5708f, 0.0f, 1.0f, 0.0f));
+			view.setCamera(Matrix::lookat(3.0f, 4.0f, 5.0f, -1.0f, -1.0f, -1.0f, 0.0f, 1.0f, 0.0f) * eye,
+				Matrix::perspective(fovy, view.getAspect(), zNear, zFar));
+
+			//ʏŕ傫eNX`ɕKvȍׂ߂
+			textures.request(groundTexture, TextureCache::screenSize(view.getView() * scene.getWorld(groundNode),
+				view.getProjection(), groundRadius, static_cast<GLfloat>(view.getViewport()[3])));
+		}
 
-		//}``悷
-		material.select(0,0);
-		shape->draw();
+		//CPUőIԂƂ͍ŏ̃r[̃JJ[\ʂ΂Ãt[̕`ɊԂɍ킹
+		if (simulation.cpuPick) {
+			const auto t0(std::chrono::high_resolution_clock::now());
+			const View& view(*views[0]);
+			const GLint* const viewport(view.getOutputViewport());
+			const GLsizei* const size(window.getFramebufferSize());
+			const GLfloat x(2.0f * ((simulation.cursor[0] + 1.0f) * 0.5f * size[0] - viewport[0]) / viewport[2] - 1.0f);
+			const GLfloat y(2.0f * ((simulation.cursor[1] + 1.0f) * 0.5f * size[1] - viewport[1]) / viewport[3] - 1.0f);
+			picked = 0;
+			if (viewport[2] > 0 && viewport[3] > 0 && std::fabs(x) <= 1.0f && std::fabs(y) <= 1.0f) {
+				const Picker::Ray ray(view.getProjection() * view.getView(), x, y);
+				GLfloat t(1.0f);
+				GLuint primitive(0);
+				for (unsigned int i = 0; i < sizeof objects / sizeof objects[0]; ++i) {
+					if (ray.intersect(scene.getWorld(objects[i]), 1.0f, solidSphereVertex.data(), solidSphereIndex.data(),
+						static_cast<GLsizei>(solidSphereIndex.size()), t, primitive)) picked = i + 1;
+				}
+				for (int i = 0; i < trackCount; ++i) {
+					if (ray.intersect(animated[i], 1.0f, occluderVertex.data(), occluderIndex.data(),
+						static_cast<GLsizei>(occluderIndex.size()), t, primitive)) picked = firstTrackId + i;
+				}
+				if (ray.intersect(scene.getWorld(groundNode), cubeRadius, solidCubeVertex, solidCubeIndex, solidCubeIndexCount, t, primitive)) picked = groundId;
+			}
+			profiler.set(pickFramesCounter, 0.0);
+			profiler.set(pickTimeCounter, Profiler::elapsed(t0));
+		}
 
-		//2ڂ̃fr[ϊs߂
-		const Matrix modelview1(modelview * Matrix::translate(0.0f, 0.0f, 3.0f));
+		//r[ƂɃJOĕ`W߂iOpenGLĂ΂Ȃ̂ŕɎsłj
+		//r[̒̃IN[WJOparallelFor͂̃Xbhł̏ŏ
+		pool.parallelFor(viewCount, [&](unsigned int v, unsigned int thread) {
+			views[v]->record([&](View& view) {
+				const Matrix projection(view.getProjection());
+				OcclusionCulling& occlusion(view.getOcclusion());
+
+				//Օ`Đ}`邩ǂׂ
+				for (const SceneGraph::Node node : objects) {
+					occlusion.addOccluder(projection * view.getView() * scene.getWorld(node),
+						occluderVertex.data(), static_cast<GLsizei>(occluderIndex.size()), occluderIndex.data());
+				}
+				occlusion.rasterize();
+
+				//}`̔ԍ̃Xbh̃t[̈ꎞIȔzɏW߂
+				FrameVector<unsigned int> visibleObjects((FrameAllocator<unsigned int>(arena, thread)));
+				visibleObjects.reserve(sizeof objects / sizeof objects[0]);
+				for (unsigned int i = 0; i < sizeof objects / sizeof objects[0]; ++i) {
+					if (occlusion.testSphere(view.getView() * scene.getWorld(objects[i]), projection, 1.0f)) visibleObjects.push_back(i);
+				}
+
+				//ŏ̃r[Ō}`̋EFABꂽ}`̋EԂŎ
+				if (simulation.debugDraw && v == 0) {
+					for (unsigned int i = 0; i < sizeof objects / sizeof objects[0]; ++i) {
+						const bool visible(std::find(visibleObjects.begin(), visibleObjects.end(), i) != visibleObjects.end());
+						debug.sphere(scene.getWorld(objects[i]).data() + 12, 1.0f,
+							visible ? DebugDraw::color(1.0f, 1.0f, 0.0f) : DebugDraw::color(1.0f, 0.0f, 0.0f), thread);
+					}
+				}
+
+				//}`ob`ɒǉifvXɕ`Ƃ͎O牜ɕׂj
+				//͎̊OƗbVbĝĂĎc͈͂`
+				//J[\̉̐}`͍ގς
+				view.getBatch().setFrontToBack(simulation.prepass);
+				meshletStats[v] = Meshlets::Stats();
+				FrameVector<MeshBuffer::Mesh> ranges(sphereMeshlets.getCount(), MeshBuffer::Mesh(), FrameAllocator<MeshBuffer::Mesh>(arena, thread));
+				for (const unsigned int i : visibleObjects) {
+					const Matrix modelview(view.getView() * scene.getWorld(objects[i]));
+					const GLsizei count(sphereMeshlets.cull(meshes.get(sphere), modelview, projection, ranges.data(), meshletStats[v]));
+					view.getBatch().add(ranges.data(), count, modelview, i + 1 == picked ? pickedMaterial : i, i + 1);
+				}
+				for (int i = 0; i < trackCount; ++i) {
+					const Matrix modelview(view.getView() * animated[i]);
+					const GLuint id(firstTrackId + i);
+					if (occlusion.testSphere(modelview, projection, 1.0f)) view.getBatch().add(meshes.get(lightVolume), modelview, id == picked ? pickedMaterial : 1, id);
+				}
+				const Matrix groundModelview(view.getView() * scene.getWorld(groundNode));
+				if (occlusion.testSphere(groundModelview, projection, cubeRadius))
+					view.getBatch().add(meshes.get(cube), groundModelview, groundId == picked ? pickedMaterial : groundMaterial, groundId);
+			});
+
+			//̃r[̎ɍ킹ăVhE}bv̕߁AƂɉe𗎂Ƃ}`W߂
+			CascadedShadow& shadow(*shadows[v]);
+			shadow.setLight(Lpos[0]);
+			shadow.update(views[v]->getView(), fovy, views[v]->getAspect(), zNear, zFar);
+			shadow.record([&](CascadedShadow& s) {
+				for (const SceneGraph::Node node : objects) s.addCaster(meshes.get(sphere), scene.getWorld(node));
+				for (int i = 0; i < trackCount; ++i) s.addCaster(meshes.get(lightVolume), animated[i]);
+			});
+		});
+
+		//Ɠ_͈̓͂͂ŎAÕt[̌vlʂ̍ɏd˂
+		if (simulation.debugDraw) {
+			debug.box(scene.getWorld(groundNode), DebugDraw::color(0.0f, 1.0f, 0.0f));
+			for (int i = 0; i < pointLights.size(); ++i) {
+				const PointLights::Light& light(pointLights[i]);
+				debug.sphere(light.position, light.radius, DebugDraw::color(light.color[0], light.color[1], light.color[2], 0.5f));
+			}
+			char hud[256];
+			std::snprintf(hud, sizeof hud, "record %.2f ms\nparticles %.0f\nmeshlet rejected %.0f\ndebug lines %.0f",
+				profiler.last(recordCounter), profiler.last(particleCounter), profiler.last(meshletRejectedCounter), profiler.last(debugLineCounter));
+			debug.overlayRect(8.0f, 8.0f, 220.0f, 80.0f, DebugDraw::color(0.0f, 0.0f, 0.0f, 0.5f));
+			debug.text(16.0f, 16.0f, hud, DebugDraw::color(1.0f, 1.0f, 1.0f));
+		}
+		debug.upload();
 
-		//2ڂ̖@xNg̕ϊs߂
-		modelview1.getNormalMatrix(normalMatrix);
+		//r[ɕ`悷
+		//ŕ`揈s
+		double recordTime(0.0);
+		for (unsigned int v = 0; v < viewCount; ++v) {
+			View& view(*views[v]);
+			makeCurrent(view.getContext());
+
+			//VhE}bv`
+			shadows[v]->render(material, view.getContext());
+
+			//_̃r[̎_WnɈڂ1Ԃ̌|CgɌ
+			pointLights.upload(view.getView());
+			pointLights.select(1);
+
+			//I𑜓xł͏k`ɕ`ĂEBhEɊg傷iGPU̎ԂGobt@̃pX瑪j
+			//`悪gȂΏkɃEBhEɒڕ`
+			const bool scaled(simulation.dynamicResolution && targets[v]->begin(view.getOutputViewport()));
+			if (simulation.dynamicResolution && !scaled)
+				view.setFramebufferSize(view.getContext() == 0 ? window.getFramebufferSize() : window2->getFramebufferSize(), 0.0f);
+
+			if (simulation.deferred) {
+				//Gobt@ɐ}``ĂfƂɉAet
+				if (deferred.beginGeometry(view.getViewport(), view.getProjection(), view.getContext())) {
+					view.getBatch().draw(GL_TRIANGLES, material, view.getContext(), materialTextures);
+					deferred.endGeometry();
+					if (scaled) targets[v]->bind();
+					view.begin();
+					deferred.light(view.getViewport(), view.getProjection(), view.getView() * Lpos[0], Lamb, Ldiff, Lspec,
+						shadows[v].get(), &probes, view.getView(), pointLights, view.getContext());
+					debug.draw(view.getProjection() * view.getView(), view.getViewport(), view.getContext());
+					view.end();
+					if (scaled) targets[v]->end(view.getViewport(), view.getOutputViewport());
+					recordTime += view.getRecordTime();
+					continue;
+				}
+			}
+
+			if (scaled) targets[v]->bind();
+			view.begin();
+
+			//fvXɕ`AĂfɉAet
+			if (simulation.prepass) {
+				glUseProgram(reload.get(depthProgram));
+				glUniformMatrix4fv(depthProjectionLoc, 1, GL_FALSE, view.getProjection().data());
+				glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+				view.getBatch().drawDepth(GL_TRIANGLES, view.getContext());
+				glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+				glDepthFunc(GL_EQUAL);
+				glDepthMask(GL_FALSE);
+			}
+
+			//VF[_[vO̎gpJn
+			glUseProgram(reload.get(program));
+
+			//uniformϐɒlݒ肷
+			glUniformMatrix4fv(projectionLoc, 1, GL_FALSE, view.getProjection().data());
+			for (int i = 0; i < Lcount; ++i) {
+				glUniform4fv(LposLoc+i, 1, (view.getView() * Lpos[i]).data());
+				glUniform3fv(LambLoc, Lcount, Lamb);
+				glUniform3fv(LdiffLoc, Lcount, Ldiff);
+				glUniform3fv(LspecLoc, Lcount, Lspec);
+			}
+			glUniform1i(pointLightCountLoc, pointLights.size());
+
+			//VhE}bv1ԁÃv[u2Ԃ̃eNX`jbgɌ
+			shadows[v]->bind(1, shadowMapLoc, shadowMatrixLoc, cascadeFarLoc, cascadeCountLoc);
+			probes.bind(2, view.getView(), probeMapLoc, probeMatrixLoc, probeRotationLoc, probeSizeLoc);
+
+			//}`܂Ƃ߂ĕ`悷
+			view.submit(GL_TRIANGLES, material, materialTextures);
+			recordTime += view.getRecordTime();
+			if (simulation.prepass) {
+				glDepthMask(GL_TRUE);
+				glDepthFunc(GL_LESS);
+			}
+
+			//sȐ}`̂ƂŃp[eBN`ix`ł͊̃t[obt@ɃfvXȂ̂ŕ`Ȃj
+			particles.draw(view.getView(), view.getProjection(), view.getContext());
+
+			//mFp̐ƕd˂
+			debug.draw(view.getProjection() * view.getView(), view.getViewport(), view.getContext());
+			if (scaled) targets[v]->end(view.getViewport(), view.getOutputViewport());
+		}
+		makeCurrent(0);
+
+		//GPUőIԂƂ͍ŏ̃r[̃J[\̎ɔԍ`ēǂݏo𔭍sAǂݏoIʂo
+		if (!simulation.cpuPick) {
+			const GLsizei* const size(window.getFramebufferSize());
+			picker.request(views[0]->getBatch(), views[0]->getProjection(), views[0]->getOutputViewport(),
+				(simulation.cursor[0] + 1.0f) * 0.5f * size[0], (simulation.cursor[1] + 1.0f) * 0.5f * size[1]);
+			if (picker.poll()) {
+				picked = picker.getResult().id;
+				profiler.set(pickFramesCounter, picker.getResult().frames);
+				profiler.set(pickTimeCounter, picker.getResult().latency);
+			}
+		}
+		profiler.set(pickCounter, picked);
+
+		//ŏ̃r[̓v\ƂċL^
+		const OcclusionCulling& occlusion(views[0]->getOcclusion());
+		const IndirectBatch& batch(views[0]->getBatch());
+
+		//IN[WJO̓vL^
+		const OcclusionCulling::Stats& stats(occlusion.getStats());
+		profiler.set(occludedCounter, stats.occluded);
+		profiler.set(occluderSetupCounter, stats.setupTime);
+		profiler.set(occluderRasterCounter, stats.rasterTime);
+		profiler.set(occlusionTestCounter, stats.testTime);
+
+		//bVbg̃JO̓vL^
+		profiler.set(meshletRejectedCounter, meshletStats[0].rejected);
+		profiler.set(meshletCullCounter, meshletStats[0].cullTime);
+
+		//`̔s̓vL^
+		profiler.set(submitCounter, batch.getSubmitTime());
+		profiler.set(drawCallCounter, batch.getCallCount());
+
+		//x`̓vL^
+		if (simulation.deferred) {
+			profiler.set(geometryPassCounter, deferred.getStats().geometryTime);
+			profiler.set(lightingPassCounter, deferred.getStats().lightingTime);
+		}
 
-		//uniformϐɒlݒ肷
-		glUniformMatrix4fv(modelviewLoc, 1, GL_FALSE, modelview1.data());
-		glUniformMatrix3fv(normalMatrixLoc, 1, GL_FALSE, normalMatrix);
+		//Aj[V̓vL^
+		profiler.set(trackCounter, static_cast<double>(animation.size()));
+		profiler.set(sampleCounter, animation.getStats().sampleTime);
+
+		//p[eBN̓vL^
+		profiler.set(particleCounter, static_cast<double>(particles.getStats().alive));
+		profiler.set(particleSimulateCounter, particles.getStats().simulateTime + particles.getStats().emitTime);
+		profiler.set(particleUploadCounter, particles.getStats().uploadTime);
+		profiler.set(debugLineCounter, static_cast<double>(debug.getStats().lines));
+
+		//̃t[CPU̎ԂƁAkĕ`r[ƃVhE}bvGPU̎Ԃ玟̃t[̔{߂
+		//GPU̎Ԃ͐t[ǑvȂ̂ŁA͔{ςƂŗlq
+		if (simulation.dynamicResolution) {
+			double gpuTime(0.0);
+			for (unsigned int v = 0; v < viewCount; ++v) {
+				gpuTime += targets[v]->getStats().gpuTime;
+				for (int c = 0; c < shadows[v]->getCount(); ++c) gpuTime += shadows[v]->getStats().gpuTime[c];
+			}
+			resolution.update(Profiler::elapsed(frameStart), gpuTime);
+			profiler.set(resolutionGpuCounter, gpuTime);
+		}
+		profiler.set(resolutionScaleCounter, renderScale > 0.0f ? renderScale : 1.0f);
+		profiler.set(resolutionMissCounter, static_cast<double>(resolution.getStats().misses));
+
+		//VhE}bv̕Ƃ̓vL^
+		const CascadedShadow::Stats& shadowStats(shadows[0]->getStats());
+		profiler.set(shadowCullCounter, shadowStats.cullTime);
+		for (int c = 0; c < shadows[0]->getCount(); ++c) {
+			profiler.set(shadowCasterCounter[c], shadowStats.casters[c]);
+			profiler.set(shadowSubmitCounter[c], shadowStats.submitTime[c]);
+			profiler.set(shadowGpuCounter[c], shadowStats.gpuTime[c]);
+		}
 
-		//2ڂ̐}``悷
-		material.select(0,1);
-		shape->draw();
+		//GPU̎gpʂL^
+		for (int c = 0; c < GpuMemory::CategoryCount; ++c) {
+			const GpuMemory::Usage& usage(gpuMemory.getUsage(static_cast<GpuMemory::Category>(c)));
+			profiler.set(gpuMemoryCounter[c], usage.current / 1048576.0);
+		}
+		gpuMemory.endFrame();
+
+		//t[̃q[v̊mۂ̉񐔂ƃt[̈ꎞIȃf[^̍ōʂL^
+		profiler.set(allocationCounter, static_cast<double>(AllocationCounter::count() - allocations));
+		profiler.set(arenaPeakCounter, arena.getStats().peak / 1024.0);
+
+		//r[̐ƕ`W߂̂ɂԂ̍vL^
+		profiler.set(viewCounter, viewCount);
+		profiler.set(recordCounter, recordTime);
+
+		//̃t[̊Ԃɐi񂾃V~[ṼXebv̐ƕ\܂ł̒xL^
+		const FrameScheduler<Simulation>::Stats schedulerStats(scheduler.getStats());
+		profiler.set(tickCounter, static_cast<double>(schedulerStats.ticks - ticks));
+		ticks = schedulerStats.ticks;
+		profiler.set(latencyCounter, pacer.getStats().latency);
+		profiler.set(missedCounter, static_cast<double>(pacer.getStats().missed));
+		profiler.set(eventCounter, inputEvents.exchange(0, std::memory_order_relaxed));
+		profiler.set(reloadCounter, reload.getStats().reloads);
+		profiler.set(compileCounter, reload.getStats().compileTime);
+		profiler.set(textureResidentCounter, static_cast<double>(textures.getStats().resident) / (1 << 20));
+		profiler.set(textureUploadCounter, static_cast<double>(textures.getStats().uploaded) / (1 << 10));
+		profiler.endFrame();
+
+		//ڂ̃EBhẼCxg͎gȂ̂Ŏ̂Ă
+		//J[obt@͐҂ɓւA҂͍̂ŏ̃EBhEɔC
+		if (window2) {
+			InputEvent discarded;
+			while (window2->getEvents().pop(discarded));
+			window2->swapBuffers();
+		}
 
-		//J[obt@ւ
-		window.swapBuffers();
+		//J[obt@ւĎ̃t[n߂
+		pacer.present(window);
+		pacer.beginFrame();
 	}
+
+	//V~[V~߂ċL^͂̃Cxgۑ
+	scheduler.stop();
+	if (recording) recorder.save(argv[2]);
+	if (replaying) std::cout << "Replayed " << recorder.size() << " input events in " << tick << " ticks." << std::endl;
 }
\ No newline at end of file
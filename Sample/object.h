@@ -1,17 +1,27 @@
 #pragma once
+#include <utility>
 #include <GL/glew.h>
 
+//OpenGL̃IuWFNg̃nh
+#include "GLHandle.h"
+
+//GPU̎gpʂ̋L^
+#include "GpuMemory.h"
+
 
 //}`f[^
 class Object {
-	//_zIuWFNg
-	GLuint vao;
+	//_zIuWFNg
+	GLVertexArray vao;
 	
-	//_obt@IuWFNg
-	GLuint vbo;
+	//_obt@IuWFNg
+	GLBuffer vbo;
 
 	//CfbNX̒_obt@IuWFNg
-	GLuint ibo;
+	GLBuffer ibo;
+
+	//_obt@IuWFNgƃCfbNX̃obt@IuWFNg̃oCg
+	GLsizeiptr vertexBytes, indexBytes;
 
 public:
 	//_
@@ -21,6 +31,9 @@ public:
 
 		//F
 		GLfloat normal[3];
+
+		//eNX`W
+		GLfloat texcoord[2];
 	};
 
 
@@ -31,18 +44,17 @@ public:
 	//vertex:_i[z
 	//indexcount:_̃CfbNX̗vf
 	//index:_̃CfbNXi[z
-	Object(GLint size,GLsizei vertexcount, const Vertex* vertex,GLsizei indexcount=0,const GLuint *index=NULL) {
-		//_zIuWFNg쐬
-		glGenVertexArrays(1, &vao);
+	Object(GLint size,GLsizei vertexcount, const Vertex* vertex,GLsizei indexcount=0,const GLuint *index=NULL)
+		//_zIuWFNgƒ_obt@IuWFNg쐬
+		:vao(GLVertexArray::create()), vbo(GLBuffer::create()), ibo(GLBuffer::create())
+		, vertexBytes(vertexcount * sizeof(Vertex)), indexBytes(indexcount * sizeof(GLuint)) {
 		//_zIuWFNg
-		glBindVertexArray(vao);
+		glBindVertexArray(vao.get());
 
-		//_obt@IuWFNg쐬
-		glGenBuffers(1, &vbo);
 		//_obt@IuWFNg
-		glBindBuffer(GL_ARRAY_BUFFER, vbo);
+		glBindBuffer(GL_ARRAY_BUFFER, vbo.get());
 		//_obt@IuWFNgɃf[^ (_) ]
-		glBufferData(GL_ARRAY_BUFFER, vertexcount * sizeof(Vertex), vertex, GL_STATIC_DRAW);
+		glBufferData(GL_ARRAY_BUFFER, vertexBytes, vertex, GL_STATIC_DRAW);
 
 		//Ă钸_obt@IuWFNginϐQƂł悤ɂ
 		//_obt@IuWFNgattributeϐɊ֘AÂ
@@ -53,35 +65,64 @@ public:
 		//AttributeϐLɂ
 		glEnableVertexAttribArray(1);
 
+		//eNX`W10Ԃgi2`9Ԃ̓CX^X̑j
+		glVertexAttribPointer(10, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), static_cast<Vertex*>(0)->texcoord);
+		glEnableVertexAttribArray(10);
+
 
 		//CfbNX̒_obt@IuWFNg
-		glGenBuffers(1, &ibo);
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ibo);
-		glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexcount * sizeof(GLuint), index, GL_STATIC_DRAW);
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ibo.get());
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexBytes, index, GL_STATIC_DRAW);
+
+		//GPU̎gpʂL^
+		GpuMemory::instance().allocate(GpuMemory::Vertex, vertexBytes);
+		GpuMemory::instance().allocate(GpuMemory::Index, indexBytes);
 	}
 
 	//fXgN^
+	//_zIuWFNgƒ_obt@IuWFNg̓nh폜
 	virtual ~Object() {
-		//_zIuWFNg폜
-		glDeleteVertexArrays(1, &vao);
+		//GPU̎gpʂL^
+		release();
+	}
 
-		//_obt@IuWFNg폜
-		glDeleteBuffers(1, &vbo);
+	//[uRXgN^
+	Object(Object&& o) noexcept
+		:vao(std::move(o.vao)), vbo(std::move(o.vbo)), ibo(std::move(o.ibo))
+		, vertexBytes(o.vertexBytes), indexBytes(o.indexBytes) {
+		o.vertexBytes = o.indexBytes = 0;
+	}
 
-		//CfbNX̒_obt@IuWFNg폜
-		glDeleteBuffers(1, &ibo);
+	//[u
+	Object& operator=(Object&& o) noexcept {
+		if (this != &o) {
+			release();
+			vao = std::move(o.vao);
+			vbo = std::move(o.vbo);
+			ibo = std::move(o.ibo);
+			vertexBytes = o.vertexBytes;
+			indexBytes = o.indexBytes;
+			o.vertexBytes = o.indexBytes = 0;
+		}
+		return *this;
 	}
-private:
-	//Rs[RXgN^ɂRs[֎~
-	Object(const Object& o);
 
-	//ɂRs[֎~
-	Object& operator=(const Object& o);
+	//Rs[֎~
+	Object(const Object& o) = delete;
+	Object& operator=(const Object& o) = delete;
+
+private:
+	//GPU̎gpʂ̋L^O
+	void release() {
+		if (vertexBytes > 0) GpuMemory::instance().release(GpuMemory::Vertex, vertexBytes);
+		if (indexBytes > 0) GpuMemory::instance().release(GpuMemory::Index, indexBytes);
+		vertexBytes = indexBytes = 0;
+	}
 
 public:
 	//_zIuWFNǧ
 	void bind()const {
 		//`悷钸_zIuWFNgw肷
-		glBindVertexArray(vao);
+		glBindVertexArray(vao.get());
 	}
 };
\ No newline at end of file
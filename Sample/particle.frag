@@ -0,0 +1,13 @@
+#version 150 core
+uniform vec4 birthColor;
+uniform vec4 deathColor;
+in vec2 T;
+in float A;
+out vec4 fragment;
+void main()
+{
+	float r=dot(T,T);
+	if(r>=1.0)discard;
+	vec4 c=mix(birthColor,deathColor,A);
+	fragment=vec4(c.rgb,c.a*(1.0-r));
+}
\ No newline at end of file
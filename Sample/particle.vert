@@ -0,0 +1,16 @@
+#version 150 core
+uniform mat4 modelview;
+uniform mat4 projection;
+uniform vec2 size;
+in vec4 position;
+out vec2 T;
+out float A;
+void main()
+{
+	vec2 corner=vec2(gl_VertexID&1,gl_VertexID>>1)*2.0-1.0;
+	vec4 P=modelview*vec4(position.xyz,1.0);
+	P.xy+=corner*mix(size.x,size.y,position.w);
+	T=corner;
+	A=position.w;
+	gl_Position=position.w>=0.0&&position.w<1.0?projection*P:vec4(2.0,2.0,2.0,1.0);
+}
\ No newline at end of file
@@ -0,0 +1,7 @@
+#version 150 core
+flat in uint id;
+out uvec2 fragment;
+void main()
+{
+	fragment = uvec2(id, uint(gl_PrimitiveID));
+}
\ No newline at end of file
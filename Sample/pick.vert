@@ -0,0 +1,11 @@
+#version 150 core
+uniform mat4 projection;
+in vec4 position;
+in mat4 instanceModelview;
+in uint instanceId;
+flat out uint id;
+void main()
+{
+	id = instanceId;
+	gl_Position = projection*(instanceModelview*position);
+}
\ No newline at end of file
@@ -9,21 +9,90 @@ layout (std140) uniform Material{
 	vec3 Kdiff;
 	vec3 Kspec;
 	float Kshi;
+	int Ktex;
 };
+const int MaxPointLights=256;
+layout (std140) uniform PointLights{
+	vec4 pointPosition[MaxPointLights];
+	vec4 pointColor[MaxPointLights];
+};
+uniform int pointLightCount;
+const int MaxCascades=4;
+uniform sampler2DArrayShadow shadowMap;
+uniform mat4 shadowMatrix[MaxCascades];
+uniform float cascadeFar[MaxCascades];
+uniform int cascadeCount;
+uniform sampler3D probeMap;
+uniform mat4 probeMatrix;
+uniform mat3 probeRotation;
+uniform vec3 probeSize;
+vec3 ambient(vec3 P,vec3 N,vec3 Lamb)
+{
+	if(probeSize.x==0.0)return Lamb;
+	vec3 g=clamp((probeMatrix*vec4(P,1.0)).xyz,vec3(0.0),probeSize-1.0);
+	vec3 n=normalize(probeRotation*N);
+	vec2 t=(g.xy+0.5)/probeSize.xy;
+	float depth=probeSize.z*7.0;
+	vec4 c0=texture(probeMap,vec3(t,(g.z+0.5)/depth));
+	vec4 c1=texture(probeMap,vec3(t,(probeSize.z+g.z+0.5)/depth));
+	vec4 c2=texture(probeMap,vec3(t,(probeSize.z*2.0+g.z+0.5)/depth));
+	vec4 c3=texture(probeMap,vec3(t,(probeSize.z*3.0+g.z+0.5)/depth));
+	vec4 c4=texture(probeMap,vec3(t,(probeSize.z*4.0+g.z+0.5)/depth));
+	vec4 c5=texture(probeMap,vec3(t,(probeSize.z*5.0+g.z+0.5)/depth));
+	vec4 c6=texture(probeMap,vec3(t,(probeSize.z*6.0+g.z+0.5)/depth));
+	vec3 E=0.282095*c0.xyz
+		+0.488603*(n.y*vec3(c0.w,c1.xy)+n.z*vec3(c1.zw,c2.x)+n.x*c2.yzw)
+		+1.092548*(n.x*n.y*c3.xyz+n.y*n.z*vec3(c3.w,c4.xy)+n.x*n.z*c5.yzw)
+		+0.315392*(3.0*n.z*n.z-1.0)*vec3(c4.zw,c5.x)
+		+0.546274*(n.x*n.x-n.y*n.y)*c6.xyz;
+	return max(E,vec3(0.0));
+}
 in vec4 P;
 in vec3 N;
+in vec2 T;
+uniform sampler2D diffuseMap;
 out vec4 fragment;
+float shadow()
+{
+	float d=-P.z/P.w;
+	if(cascadeCount==0||d>cascadeFar[cascadeCount-1])return 1.0;
+	int c=0;
+	while(c<cascadeCount-1&&d>cascadeFar[c])++c;
+	vec4 S=shadowMatrix[c]*P;
+	vec3 s=S.xyz/S.w;
+	vec2 texel=1.0/vec2(textureSize(shadowMap,0).xy);
+	float lit=0.0;
+	for(int y=-1;y<=1;++y){
+		for(int x=-1;x<=1;++x){
+			lit+=texture(shadowMap,vec4(s.xy+vec2(x,y)*texel,float(c),min(s.z,1.0)));
+		}
+	}
+	return lit/9.0;
+}
 void main()
 {	
 	vec3 V=-normalize(P.xyz);
+	vec3 albedo=Ktex!=0?texture(diffuseMap,T).rgb:vec3(1.0);
 	vec3 Idiff=vec3(0.0);
 	vec3 Ispec=vec3(0.0);
+	float visibility=shadow();
 	for(int i=0;i<Lcount;++i){
 		vec3 L=normalize((Lpos[i]*P.w-P*Lpos[i].w).xyz);
-		vec3 Iamb=Kamb*Lamb[i];
-		Idiff+=max(dot(N,L),0.0)*Kdiff*Ldiff[i]+Iamb;
+		vec3 Iamb=albedo*Kamb*(i==0?ambient(P.xyz/P.w,N,Lamb[0]):Lamb[i]);
+		float Is=i==0?visibility:1.0;
+		Idiff+=Is*max(dot(N,L),0.0)*albedo*Kdiff*Ldiff[i]+Iamb;
+		vec3 H=normalize(L+V);
+		Ispec+=Is*pow(max(dot(normalize(N),H),0.0),Kshi)*Kspec*Lspec[i];
+	}
+	for(int i=0;i<pointLightCount;++i){
+		vec3 D=pointPosition[i].xyz-P.xyz/P.w;
+		float d=length(D);
+		float a=clamp(1.0-d/pointPosition[i].w,0.0,1.0);
+		if(a<=0.0)continue;
+		vec3 L=D/d;
 		vec3 H=normalize(L+V);
-		Ispec+=pow(max(dot(normalize(N),H),0.0),Kshi)*Kspec*Lspec[i];
+		Idiff+=a*a*max(dot(N,L),0.0)*albedo*Kdiff*pointColor[i].rgb;
+		Ispec+=a*a*pow(max(dot(N,H),0.0),Kshi)*Kspec*pointColor[i].rgb;
 	}
 	fragment = vec4(Idiff+Ispec,1.0);
 }
\ No newline at end of file
@@ -4,11 +4,14 @@ uniform mat4 projection;
 uniform mat3 normalMatrix;
 in vec4 position;
 in vec3 normal;
+in vec2 texcoord;
 out vec4 P;
 out vec3 N;
+out vec2 T;
 void main()
 {
 	P=modelview*position;
 	N=normalize(normalMatrix*normal);
+	T=texcoord;
 	gl_Position = projection*P;
 }
\ No newline at end of file
@@ -0,0 +1,8 @@
+#version 150 core
+uniform mat4 projection;
+in vec4 position;
+in mat4 instanceModelview;
+void main()
+{
+	gl_Position = projection*instanceModelview*position;
+}
\ No newline at end of file
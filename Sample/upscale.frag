@@ -0,0 +1,23 @@
+#version 150 core
+uniform sampler2D source;
+uniform vec4 region;
+uniform vec2 outputOrigin;
+uniform vec2 outputSize;
+uniform float sharpness;
+out vec4 fc;
+vec3 fetch(vec2 p)
+{
+	return texture(source,clamp(p,vec2(0.5),region.xy-0.5)*region.zw).rgb;
+}
+void main()
+{
+	vec2 p=(gl_FragCoord.xy-outputOrigin)*region.xy/outputSize;
+	vec3 c=fetch(p);
+	vec3 n=fetch(p+vec2(0.0,1.0));
+	vec3 s=fetch(p-vec2(0.0,1.0));
+	vec3 e=fetch(p+vec2(1.0,0.0));
+	vec3 w=fetch(p-vec2(1.0,0.0));
+	vec3 lo=min(c,min(min(n,s),min(e,w)));
+	vec3 hi=max(c,max(max(n,s),max(e,w)));
+	fc=vec4(clamp(c+sharpness*(4.0*c-n-s-e-w),lo,hi),1.0);
+}
\ No newline at end of file